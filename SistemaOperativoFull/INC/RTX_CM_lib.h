@@ -48,11 +48,25 @@
  *      Definitions
  *---------------------------------------------------------------------------*/
 
+#if defined (__RTX_POSIX)
+
+/* Host port: control blocks hold 64-bit pointers. */
+#define _declare_box(pool,size,cnt)  uint32_t pool[((((size)+7)/8)*(cnt) + 3)*2] \
+                                     __attribute__((aligned(8)))
+#define _declare_box8(pool,size,cnt) uint64_t pool[(((size)+7)/8)*(cnt) + 3]
+
+#define OS_TCB_SIZE     168
+#define OS_TMR_SIZE     24
+
+#else
+
 #define _declare_box(pool,size,cnt)  uint32_t pool[(((size)+3)/4)*(cnt) + 3]
 #define _declare_box8(pool,size,cnt) uint64_t pool[(((size)+7)/8)*(cnt) + 2]
 
-#define OS_TCB_SIZE     48
-#define OS_TMR_SIZE     8
+#define OS_TCB_SIZE     128
+#define OS_TMR_SIZE     12
+
+#endif
 
 #if defined (__CC_ARM) && !defined (__MICROLIB)
 
@@ -84,18 +98,56 @@ OS_RESULT _os_mut_wait    (uint32_t p, OS_ID mutex, uint16_t timeout) __svc_indi
  *      Global Variables
  *---------------------------------------------------------------------------*/
 
+#ifndef OS_WORK
+ #define OS_WORK        0
+#endif
+
+/* Work queue lane threads (+lanes) */
+#if (OS_WORK != 0)
+#if (OS_WORKLANES < 1) || (OS_WORKLANES > 4)
+ #error "OS_WORKLANES must be 1..4"
+#endif
+#if (OS_WORKLANES > OS_WORKPRIO)
+ #error "OS_WORKPRIO too low for OS_WORKLANES lanes"
+#endif
+#define OS_WORK_CNT  OS_WORKLANES
+#define OS_WORK_STK (OS_WORKLANES*OS_WORKSTKSZ)
+#else
+#define OS_WORK_CNT  0
+#define OS_WORK_STK  0
+#endif
+
 #if (OS_TIMERS != 0)
-#define OS_TASK_CNT (OS_TASKCNT + 1)
-#define OS_PRIV_CNT (OS_PRIVCNT + 2)
-#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE+OS_TIMERSTKSZ))
+#define OS_TASK_CNT (OS_TASKCNT + 1 + OS_WORK_CNT)
+#define OS_PRIV_CNT (OS_PRIVCNT + 2 + OS_WORK_CNT)
+#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE+OS_TIMERSTKSZ+OS_WORK_STK))
 #else
-#define OS_TASK_CNT  OS_TASKCNT
-#define OS_PRIV_CNT (OS_PRIVCNT + 1)
-#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE))
+#define OS_TASK_CNT (OS_TASKCNT + OS_WORK_CNT)
+#define OS_PRIV_CNT (OS_PRIVCNT + 1 + OS_WORK_CNT)
+#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE+OS_WORK_STK))
+#endif
+
+#ifndef OS_STKINIT
+ #define OS_STKINIT     0
+#endif
+
+#ifndef OS_STKPOOL
+ #define OS_STKPOOL     0
+#endif
+
+/* Stacks from the stack memory pool: with OS_STKPOOL every thread but the */
+/* os_idle_demon, else only threads with osThreadDef stacksz (+main,+timer) */
+#if (OS_STKPOOL != 0)
+#define OS_STK_CNT  (OS_TASK_CNT + 1)
+#define OS_BOX_CNT   1
+#else
+#define OS_STK_CNT   OS_PRIV_CNT
+#define OS_BOX_CNT  (OS_TASK_CNT-OS_PRIV_CNT+1)
 #endif
 
 uint16_t const os_maxtaskrun = OS_TASK_CNT;
-uint32_t const os_stackinfo  = (OS_STKCHECK<<24)| (OS_PRIV_CNT<<16) | (OS_STKSIZE*4);
+uint32_t const os_stackinfo  = (OS_STKPOOL<<29) | (OS_STKINIT<<28) | (OS_STKCHECK<<24) |
+                               (OS_PRIV_CNT<<16) | (OS_STKSIZE*4);
 uint32_t const os_rrobin     = (OS_ROBIN << 16) | OS_ROBINTOUT;
 uint32_t const os_tickfreq   = OS_CLOCK;
 uint16_t const os_tickus_i   = OS_CLOCK/1000000;
@@ -112,11 +164,17 @@ _declare_box  (mp_tcb, OS_TCB_SIZE, OS_TASK_CNT);
 uint16_t const mp_tcb_size = sizeof(mp_tcb);
 
 /* Memory pool for System stack allocation (+os_idle_demon). */
-_declare_box8 (mp_stk, OS_STKSIZE*4, OS_TASK_CNT-OS_PRIV_CNT+1);
+_declare_box8 (mp_stk, OS_STKSIZE*4, OS_BOX_CNT);
 uint32_t const mp_stk_size = sizeof(mp_stk);
 
 /* Memory pool for user specified stack allocation (+main, +timer) */
-uint64_t       os_stack_mem[2+OS_PRIV_CNT+(OS_STACK_SZ/8)];
+/* with the TLSF control block of rt_Memory.c: 20 bytes and 17 bytes per  */
+/* first level class, one class per power of 2 of the pool size in 8-byte */
+/* units (OS_STACK_FL is an upper bound of the class count)               */
+#define OS_STACK_FL(n)  (((n) < 0x400)  ?  5 : ((n) < 0x1000)  ?  7 : \
+                         ((n) < 0x4000) ?  9 : ((n) < 0x10000) ? 11 : 14)
+#define OS_STACK_CTL  ((20+17*OS_STACK_FL(8*(2+OS_STK_CNT)+OS_STACK_SZ+0x110)+7)/8)
+uint64_t       os_stack_mem[2+OS_STK_CNT+OS_STACK_CTL+(OS_STACK_SZ/8)];
 uint32_t const os_stack_sz = sizeof(os_stack_mem);
 
 #ifndef OS_FIFOSZ
@@ -124,12 +182,114 @@ uint32_t const os_stack_sz = sizeof(os_stack_mem);
 #endif
 
 /* Fifo Queue buffer for ISR requests.*/
+#if defined (__RTX_POSIX)
+uint32_t       os_fifo[OS_FIFOSZ*4+2] __attribute__((aligned(8)));
+#else
 uint32_t       os_fifo[OS_FIFOSZ*2+1];
+#endif
 uint8_t  const os_fifo_size = OS_FIFOSZ;
 
+#ifndef OS_TRACE
+ #define OS_TRACE       0
+#endif
+
+/* Ring buffer for kernel trace events, 4 words per event. */
+#if (OS_TRACE != 0)
+#if (OS_TRACESZ & (OS_TRACESZ - 1))
+ #error "OS_TRACESZ must be a power of 2"
+#endif
+uint32_t       os_trace_buf[OS_TRACESZ*4];
+uint32_t const os_trace_size = OS_TRACESZ;
+#else
+uint32_t       os_trace_buf[4];
+uint32_t const os_trace_size = 0;
+#endif
+
+#ifndef OS_LOG
+ #define OS_LOG         0
+#endif
+
+/* Ring buffer for binary log records, 8 words per record. */
+#if (OS_LOG != 0)
+#if (OS_LOGSZ & (OS_LOGSZ - 1))
+ #error "OS_LOGSZ must be a power of 2"
+#endif
+uint32_t       os_log_buf[OS_LOGSZ*8];
+uint32_t const os_log_size = OS_LOGSZ;
+#else
+uint32_t       os_log_buf[8];
+uint32_t const os_log_size = 0;
+#endif
+
+#ifndef OS_STATS
+ #define OS_STATS       0
+#endif
+
+/* Thread runtime statistics mode: 0 off, 1 exact, 2 sampled. */
+uint8_t  const os_statmode = OS_STATS;
+
+#ifndef OS_EDFPRIO
+ #define OS_EDFPRIO     0
+#endif
+
+/* Task priority of the EDF class, 0 if disabled. */
+#if (OS_EDFPRIO > 6)
+ #error "OS_EDFPRIO must be 0..6"
+#endif
+#if (OS_EDFPRIO != 0) && (OS_WORK != 0)
+#if (OS_EDFPRIO <= OS_WORKPRIO) && (OS_EDFPRIO > OS_WORKPRIO - OS_WORKLANES)
+ #error "OS_EDFPRIO must not be a work queue lane priority"
+#endif
+#endif
+uint8_t  const os_edfprio = (OS_EDFPRIO != 0) ? OS_EDFPRIO + 1 : 0;
+
+#ifndef OS_SLABSZ
+ #define OS_SLABSZ      0
+#endif
+
+/* Slab memory in pages of 256 bytes and the size class of every page. */
+#if (OS_SLABSZ != 0)
+#if (OS_SLABSZ & 255)
+ #error "OS_SLABSZ must be a multiple of 256"
+#endif
+uint64_t       os_slab_mem[OS_SLABSZ/8];
+uint8_t        os_slab_page[OS_SLABSZ/256];
+#else
+uint64_t       os_slab_mem[1];
+uint8_t        os_slab_page[1];
+#endif
+uint16_t const os_slab_pages = OS_SLABSZ/256;
+
+#ifndef OS_HNDCNT
+ #define OS_HNDCNT      8
+#endif
+
+/* Driver handle table, one entry per open peripheral unit. */
+#if (OS_HNDCNT == 0) || (OS_HNDCNT > 255)
+ #error "OS_HNDCNT must be 1..255"
+#endif
+uint64_t       os_hnd_mem[OS_HNDCNT*2];
+uint8_t  const os_hnd_cnt = OS_HNDCNT;
+
 /* An array of Active task pointers. */
 void *os_active_TCB[OS_TASK_CNT];
 
+/* Free task IDs, one bit per entry of os_active_TCB. */
+uint32_t os_tid_map[(OS_TASK_CNT+31)/32];
+
+#if defined (__RTX_POSIX)
+#include <ucontext.h>
+
+#ifndef OS_HOSTSTKSZ
+ #define OS_HOSTSTKSZ   65536
+#endif
+
+/* Host contexts and host stacks of the threads (+os_idle_demon). */
+ucontext_t     os_host_ctx[OS_TASK_CNT+1];
+uint64_t       os_host_stk[(OS_TASK_CNT+1)*(OS_HOSTSTKSZ/8)];
+uint32_t const os_host_stksz = OS_HOSTSTKSZ;
+#endif
+
 /* User Timers Resources */
 #if (OS_TIMERS != 0)
 extern void osTimerThread (void const *argument);
@@ -144,6 +304,18 @@ osMessageQDef(osTimerMessageQ, 0, void *);
 osMessageQId osMessageQId_osTimerMessageQ;
 #endif
 
+/* Work Queue Resources: per lane the queue heads and the worker thread */
+#if (OS_WORK != 0)
+extern void osWorkThread (void const *argument);
+osThreadDef(osWorkThread, (osPriority)(OS_WORKPRIO-3), OS_WORKLANES, 4*OS_WORKSTKSZ);
+void          *os_work_mem[3*OS_WORKLANES];
+uint8_t  const os_work_lanes = OS_WORKLANES;
+#else
+osThreadDef_t os_thread_def_osWorkThread = { NULL };
+void          *os_work_mem[3];
+uint8_t  const os_work_lanes = 0;
+#endif
+
 /* Legacy RTX User Timers not used */
 //uint32_t       os_tmr = 0; 
 uint32_t const *m_tmr = NULL;
@@ -275,6 +447,17 @@ __asm void __rt_entry (void) {
 }
 #endif
 
+#elif defined (__RTX_POSIX)
+
+__attribute__((constructor)) static void os_host_start (void) {
+  /* Started by the C library before main: main becomes the first thread, */
+  /* the process ends when a thread calls exit().                         */
+  osKernelInitialize();
+  osThreadCreate(&os_thread_def_main, NULL);
+  osKernelStart();
+  for (;;);
+}
+
 #elif defined (__GNUC__)
 
 #ifdef __CS3__
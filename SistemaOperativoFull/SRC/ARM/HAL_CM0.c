@@ -174,6 +174,11 @@ __asm void SVC_Handler (void) {
         POP     {R2,R3}
 
 SVC_Next
+        PUSH    {R2,R3}
+        MOV     R0,R2
+        BL      __cpp(rt_tsk_switch)    ; Switch hook
+        POP     {R2,R3}
+
         STR     R2,[R3]                 ; os_tsk.run = os_tsk.new
 
         LDR     R0,[R2,#TCB_TSTACK]     ; os_tsk.new->tsk_stack
@@ -248,6 +253,11 @@ Sys_Switch
         BL      rt_stk_check            ; Check for Stack overflow
         POP     {R2,R3}
 
+        PUSH    {R2,R3}
+        MOV     R0,R2
+        BL      __cpp(rt_tsk_switch)    ; Switch hook
+        POP     {R2,R3}
+
         STR     R2,[R3]                 ; os_tsk.run = os_tsk.new
 
         LDR     R0,[R2,#TCB_TSTACK]     ; os_tsk.new->tsk_stack
@@ -38,6 +38,7 @@
 #include "rt_HAL_CM.h"
 #include "rt_Task.h"
 #include "rt_MemBox.h"
+#include "rt_Trace.h"
 
 
 /*----------------------------------------------------------------------------
@@ -134,14 +135,35 @@ SVC_Handler_Veneer
         LDRB    R1,[R1,#-2]             ; Load SVC Number
         CBNZ    R1,SVC_User
 
-        LDM     R0,{R0-R3,R12}          ; Read R0-R3,R12 from stack
         PUSH    {R4,LR}                 ; Save EXC_RETURN
+        LDR     R2,=__cpp(&os_trace_on)
+        LDRB    R2,[R2]
+        CBZ     R2,SVC_Call             ; Trace off?
+        LDR     R2,[R0,#16]             ; SVC Function from stacked R12
+        MOVS    R0,#__cpp(TRC_SVC_ENTER)
+        MOVS    R1,#0
+        BL      __cpp(rt_trace)
+        MRS     R0,PSP                  ; Read PSP
+
+SVC_Call
+        LDM     R0,{R0-R3,R12}          ; Read R0-R3,R12 from stack
         BLX     R12                     ; Call SVC Function 
-        POP     {R4,LR}                 ; Restore EXC_RETURN
 
         MRS     R12,PSP                 ; Read PSP
         STM     R12,{R0-R2}             ; Store return values
 
+        LDR     R0,=__cpp(&os_trace_on)
+        LDRB    R0,[R0]
+        CBZ     R0,SVC_Switch           ; Trace off?
+        MOVS    R0,#__cpp(TRC_SVC_EXIT)
+        MOVS    R1,#0
+        LDR     R2,[R12,#16]            ; SVC Function from stacked R12
+        BL      __cpp(rt_trace)
+        MRS     R12,PSP                 ; Read PSP
+
+SVC_Switch
+        POP     {R4,LR}                 ; Restore EXC_RETURN
+
         LDR     R3,=__cpp(&os_tsk)
         LDM     R3,{R1,R2}              ; os_tsk.run, os_tsk.new
         CMP     R1,R2
@@ -166,6 +188,11 @@ SVC_Handler_Veneer
         POP     {R2,R3}
 
 SVC_Next
+        PUSH    {R2,R3}
+        MOV     R0,R2
+        BL      __cpp(rt_tsk_switch)    ; Switch hook
+        POP     {R2,R3}
+
         STR     R2,[R3]                 ; os_tsk.run = os_tsk.new
 
         LDR     R12,[R2,#TCB_TSTACK]    ; os_tsk.new->tsk_stack
@@ -197,11 +224,31 @@ SVC_User
         LDR     R4,=SVC_Table-4
         LDR     R4,[R4,R1,LSL #2]       ; Load SVC Function Address
 
+        LDR     R2,=__cpp(&os_trace_on)
+        LDRB    R2,[R2]
+        CBZ     R2,SVC_UCall            ; Trace off?
+        PUSH    {R0,R1}
+        MOVS    R2,R1                   ; SVC Number
+        MOVS    R0,#__cpp(TRC_SVC_ENTER)
+        MOVS    R1,#0
+        BL      __cpp(rt_trace)
+        POP     {R0,R1}
+
+SVC_UCall
         LDM     R0,{R0-R3,R12}          ; Read R0-R3,R12 from stack
         BLX     R4                      ; Call SVC Function
 
         MRS     R12,PSP
         STM     R12,{R0-R3}             ; Function return values
+
+        LDR     R0,=__cpp(&os_trace_on)
+        LDRB    R0,[R0]
+        CBZ     R0,SVC_Done             ; Trace off?
+        LDR     R2,[R12,#24]            ; Read Saved PC from Stack
+        LDRB    R2,[R2,#-2]             ; Load SVC Number
+        MOVS    R0,#__cpp(TRC_SVC_EXIT)
+        MOVS    R1,#0
+        BL      __cpp(rt_trace)
 SVC_Done
         POP     {R4,PC}                 ; RETI
 
@@ -248,6 +295,11 @@ Sys_Switch
         BL      rt_stk_check            ; Check for Stack overflow
         POP     {R2,R3}
 
+        PUSH    {R2,R3}
+        MOV     R0,R2
+        BL      __cpp(rt_tsk_switch)    ; Switch hook
+        POP     {R2,R3}
+
         STR     R2,[R3]                 ; os_tsk.run = os_tsk.new
 
         LDR     R12,[R2,#TCB_TSTACK]    ; os_tsk.new->tsk_stack
@@ -47,8 +47,6 @@ SVC_Count       DCD     SVC_Cnt
 				IMPORT  __SVC_3
 				IMPORT  __SVC_4
 				IMPORT  __SVC_5
-				IMPORT  __SVC_6
-				IMPORT  __SVC_7
 				IMPORT  __SVC_8
 				IMPORT  __SVC_9
 				IMPORT  __SVC_10
@@ -61,6 +59,7 @@ SVC_Count       DCD     SVC_Cnt
 				IMPORT  __SVC_17
 				IMPORT  __SVC_18
 				IMPORT  __SVC_19
+				IMPORT  __SVC_20
 					
                 EXPORT  SVC_Table
 SVC_Table
@@ -70,8 +69,8 @@ SVC_Table
 				DCD     __SVC_3                 ; user SVC function
 				DCD     __SVC_4                 ; user SVC function
 				DCD     __SVC_5                 ; user SVC function
-				DCD     __SVC_6                 ; user SVC function
-				DCD     __SVC_7                 ; user SVC function
+				DCD     SVC_Free                ; free user SVC number
+				DCD     SVC_Free                ; free user SVC number
 				DCD     __SVC_8                 ; user SVC function
 				DCD     __SVC_9                 ; user SVC function
 				DCD     __SVC_10                ; user SVC function
@@ -84,8 +83,16 @@ SVC_Table
 				DCD     __SVC_17                ; user SVC function
 				DCD     __SVC_18                ; user SVC function
 				DCD     __SVC_19                ; user SVC function
+				DCD     __SVC_20                ; user SVC function
 SVC_End
 
+; Free user SVC numbers return 0.
+                THUMB
+SVC_Free        PROC
+                MOVS    R0,#0
+                BX      LR
+                ENDP
+
                 END
 
 /*----------------------------------------------------------------------------
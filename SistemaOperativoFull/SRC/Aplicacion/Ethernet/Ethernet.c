@@ -17,7 +17,8 @@
 #include "stdlib.h"
 #include "EMAC.h"
 #include "rt_TypeDef.h"
-#include "rt_MemBox.h"
+#include "rt_Slab.h"
+#include "rt_Handle.h"
 #include "RTX_config.h"
 #ifndef extern
 #define extern
@@ -29,57 +30,110 @@
 	uint16_t auxPort=0;
 	uint8_t auxDir[4];
 	uint8_t P_Open=0,A_Open=0;
-	uint8_t i = 1;
-/*MEMORY RESERVE*/
-	P_TCB rt_tid2ptcb (osThreadId thread_id);
-	P_ESYNC esync;
-	_declare_box(eth_pool,1,1);
+/*INTERFACE STARTED, ONE HANDLE PER CONNECTION*/
 	unsigned int e_reserved = 0;
-	_declare_box(epool,22,10); //Modify for requeriments
+/*LAST CONNECTION RELEASED: STACK STATE TO RESET BY THE NETWORK THREAD*/
+	unsigned int e_stop = 0;
+
+/*NETWORK SERVICE THREAD*/
+	osThreadDef(eth_thread, ETH_THREAD_PRIO, 1, 0);
+	osTimerDef(eth_clock, eth_clock);
+	osTimerId eth_tmr;
+/*ESTADO DE LA PILA Y DEL SOCKET: SOLO CON EL MUTEX TOMADO*/
+	osMutexDef(eth_mutex);
+	osMutexId eth_mtx;
 
 /*DECLARACION DE VARIABLES HEADER*/
-//unsigned short activar_systick;
 	unsigned int BytesToSend;
 	unsigned char Status; // status byte 
 	unsigned char *PWebSide;
 
-	struct OS_TETH *first = NULL;
-	struct OS_TETH *last = NULL;
 	struct OS_TETH *run = NULL;
 
 
-P_TETH __svc(4) open_ethernet(osThreadId ID);
-P_TETH __SVC_4      				 (osThreadId ID){
-	P_TCB     id;
-	struct OS_TETH *dir = NULL;
+/**********************************************************
+SVCs: ONLY THE HANDLE TABLE, THE SLAB AND THE NVIC, WHICH
+NEED PRIVILEGED MODE. THE CALLERS HOLD eth_mtx, SO THE
+NETWORK THREAD IS NEVER IN THE MIDDLE OF THE STACK.
+***********************************************************/
+static void eth_release(P_HCB hcb);
+
+os_handle_t __svc(4) open_eth_svc(void);
+os_handle_t __SVC_4      				 (void){
+	os_handle_t eth;
+	struct OS_TETH *dir;
 	
+	/*UNA CONEXION POR HANDLE, DEL HILO QUE LA ABRE*/
+	dir = rt_slab_alloc(sizeof(struct OS_TETH));
+	if(dir == NULL){
+		return(0);
+	}
+	memset(dir,0,sizeof(struct OS_TETH));
+	rt_hnd_driver(HND_ETH, eth_release); //si el dueno termina sin cerrarla
+	eth = rt_hnd_open(HND_ETH, HND_NOUNIT, dir);
+	if(eth == 0){
+		rt_slab_free(dir);
+		return(0);
+	}
 	if(e_reserved == 0){
-		activar_systick=1; //ACTIVAR LA CUENTA DE ISN Y TIMETICK
 		TCPLowLevelInit(); //funcion de inicializacion TCP
-		/*MEMORY RESERVE FOR STRUCT*/
-		rt_init_box(epool,sizeof(epool),sizeof(struct OS_TETH)); //8
-		rt_init_box(eth_pool,sizeof(eth_pool),sizeof(struct E_SYNC_OS));
-		esync = rt_alloc_box(eth_pool);
-		memset(esync,0,sizeof(struct E_SYNC_OS));
+		LPC_EMAC->IntClear = 0xFFFF;
+		LPC_EMAC->IntEnable = INT_RX_DONE; //despertar al hilo de red al recibir una trama
+		NVIC_EnableIRQ(ENET_IRQn);
 		e_reserved = 1;
+		e_stop = 0; //TCPLowLevelInit ya ha reiniciado la pila
+	}
+	return(eth);
+}
+/*CONEXION DEL HANDLE, NULL SI EL HILO NO PUEDE USARLO*/
+struct OS_TETH *__svc(5) eth_conn(os_handle_t eth);
+struct OS_TETH *__SVC_5         (os_handle_t eth){
+	P_HCB hcb;
+	hcb = rt_hnd_get(eth, HND_ETH);
+	if(hcb == NULL){
+		return(NULL);
+	}
+	return(hcb->obj);
+}
+/*CIERRE DE UNA CONEXION, DEVUELVE 1 SI ERA LA ULTIMA*/
+static uint32_t eth_close(P_HCB hcb){
+	if(run == hcb->obj){
+		run = NULL;
+	}
+	memset(hcb->obj,0,sizeof(struct OS_TETH));
+	rt_slab_free(hcb->obj);
+	rt_hnd_close(hcb); //las copias del handle dejan de ser validas
+	if(rt_hnd_count(HND_ETH) != 0){
+		return(0);
 	}
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if((esync->ID == id->task_id) || (esync->ID == 0)){
-		esync->ID = id->task_id;
-		dir = rt_alloc_box(epool);
-		//dir = rt_alloc_mem(struct_dir,sizeof(struct OS_TETH));
-		memset(dir,0,sizeof(struct OS_TETH));
-		dir->ID = id->task_id; // se la asignamos 
+	NVIC_DisableIRQ(ENET_IRQn); //ultima conexion cerrada
+	LPC_EMAC->IntEnable = 0;
+	e_reserved = 0;
+	return(1);
+}
+void __svc(8) close_eth_svc(os_handle_t eth);
+void __SVC_8                (os_handle_t eth){
+	P_HCB hcb;
+	hcb = rt_hnd_get(eth, HND_ETH);
+	if(hcb != NULL && eth_close(hcb)){
+		TCPFlags = 0;
+		SocketStatus = 0;
+		TCPStateMachine = CLOSED;
+	}
+}
+/*EL DUENO TERMINA SIN CERRARLA: eth_mtx no se puede tomar en una SVC,
+  el estado de la pila lo reinicia el hilo de red con el mutex tomado*/
+static void eth_release(P_HCB hcb){
+	if(eth_close(hcb)){
+		e_stop = 1;
+		osSignalSet(eth_tid, ETH_SIG_STOP);
 	}
-	return(dir);
 }
 
-/*FUNCION SVC ENVIAR DATOS VIA ETHERNET*/
-void __svc(5) write_ethernet(char *data_tx, osThreadId ID);
-void __SVC_5       					(char *data_tx, osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(esync->ID == id->task_id){
+/*FUNCION ENVIAR DATOS VIA ETHERNET*/
+void write_ethernet(os_handle_t eth, char *data_tx){
+	osMutexWait(eth_mtx, osWaitForever);
+	if(eth_conn(eth) != NULL){
 		TCPReleaseRxBuffer(); //liberar buffer
 			if (SocketStatus & SOCK_CONNECTED){ //Si ha conectado...
 				if (SocketStatus & SOCK_TX_BUF_RELEASED){ //Y se ha liberado el buffer
@@ -114,125 +168,32 @@ void __SVC_5       					(char *data_tx, osThreadId ID){
 			}
 			else 
 				Status &=~HTTP_SEND_PAGE;
+		osSignalSet(eth_tid, ETH_SIG_POLL); //enviar desde el hilo de red
 	}
+	osMutexRelease(eth_mtx);
 }
-/*FUNCION SVC RECIBIR DATOS VIA ETHERNET*/
-void __svc(6) read_ethernet(unsigned char *data_rx, osThreadId ID);
-void __SVC_6               (unsigned char *data_rx, osThreadId ID){
-	P_TCB     id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(esync->ID == id->task_id){
+/*FUNCION RECIBIR DATOS VIA ETHERNET*/
+void read_ethernet(os_handle_t eth, unsigned char *data_rx){
+	osMutexWait(eth_mtx, osWaitForever);
+	if(eth_conn(eth) != NULL){
 		if(SocketStatus & SOCK_CONNECTED){
 			if(TCPRxDataCount){
 				 memcpy(data_rx,TCP_RX_BUF,TCPRxDataCount);
 			}	
 			TCPReleaseRxBuffer();
+			osSignalSet(eth_tid, ETH_SIG_POLL);
 		}
 	}
+	osMutexRelease(eth_mtx);
 }
-void __svc(8) close_ethernet(osThreadId ID, struct OS_TETH *cls);
-void __SVC_8                (osThreadId ID, struct OS_TETH *cls){
-	P_TCB     id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(esync->ID == id->task_id){
-		liberar(cls);
-		if(first == NULL){
-			activar_systick = 0;
-			TCPFlags = 0;
-			SocketStatus = 0;
-			memset(esync,0,sizeof(struct E_SYNC_OS)); //Primero, limpiar el espacio
-			rt_free_box(eth_pool,esync); //Segundo liberar la memoria
-			e_reserved = 0;
-			TCPStateMachine = CLOSED;
-		}
-	}
-}
-/**********************************************************
-FUNCTION TO ADD ONE MORE STRUCT
-PARAMETER: THE NEW STRUCT;
-***********************************************************/
-void add_element(struct OS_TETH *copy){
-	struct OS_TETH *nuevo;
-	nuevo = first;
-	while(nuevo!=NULL){
-		if(nuevo == copy){ //If there is a same structure
-			i = 1;
-			break;
-		}
-		else{
-			nuevo = nuevo->next;
-			if(nuevo == NULL){ //se ha llegado al final y no se ha encontrado structuras iguales
-				i = 0;
-				break;
-			}
-		}
-	}
-	if((i == 0) || (first == NULL)){ //se añade la nueva estructura	
-		if(first == NULL){ //If first structure
-			first = copy;
-			last = copy;
-		}	
-		else {
-			last->next = copy;
-			last = copy;
-		}
-			i = 0;
-		}
-}
-/**********************************************************
-FUNCTION TO CHECK ALL STRUCTs TO FIND THE NECESSARY STRUCT
-PARAMETER: ID OF THE THREAD THROUGH WHICH WE ARE GOING TO
-						FIND THE NECESSARY STRUCT;
-***********************************************************/
-void check_struct (osThreadId ID,uint8_t num_con){
-	struct OS_TETH *aux;
-	P_TCB     ptcb;
-	
-	ptcb = rt_tid2ptcb(ID); //get task_id
-	
-	aux = first;
-	while(aux != NULL){
-		if(aux->ID == ptcb->task_id){
-			if(aux->n_con == num_con){
-				run = aux;
-				break;
-			}
-			else
-				aux = aux->next;
-		}
-		else 
-			aux = aux->next;
-	}
-}
-/**********************************************************
-FUNCTION TO FREE MEMORY OF THE STRUCTs
-PARAMETER: STRUCT TO ERASE
-***********************************************************/
-void liberar(struct OS_TETH *erase){
-  struct OS_TETH *reco;
-	reco = first;
-    while (reco != NULL){
-			if(erase->ID == reco->ID){
-				if(erase->n_con == reco->n_con){
-					erase = reco;
-					reco = reco->next;
-					memset(erase,0,sizeof(struct OS_TETH));
-					rt_free_box(epool,erase);
-				}
-				else
-					reco = reco->next;
-			}
-			else
-				reco = reco->next;
-    }
-}
-void __svc(7) connect_ethernet(struct OS_TETH *add, osThreadId ID,uint8_t num_con);
-void __SVC_7                  (struct OS_TETH *add, osThreadId ID,uint8_t num_con){
-	P_TCB     id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(esync->ID == id->task_id){
-		add_element(add);
-		check_struct(ID,num_con);
+void connect_ethernet(os_handle_t eth, struct OS_TETH *conf){
+	struct OS_TETH *conn;
+	osMutexWait(eth_mtx, osWaitForever);
+	conn = eth_conn(eth);
+	if(conn != NULL){
+		/*LA CONEXION DEL HANDLE TOMA LA CONFIGURACION DEL HILO*/
+		run = conn;
+		memcpy(run,conf,sizeof(struct OS_TETH));
 		/*ACTUANDO COMO CLIENTE*/
 		if(run->S_C == 1){
 			if(((int)run->IP_1>=0 && run->IP_1<=255) && ((int)run->IP_2>=0 && run->IP_2<=255) && ((int)run->IP_3>=0 && run->IP_3<=255) && ((int)run->IP_4>=0 && run->IP_4<=255)){ // se ha introducido una IP valida
@@ -269,7 +230,98 @@ void __SVC_7                  (struct OS_TETH *add, osThreadId ID,uint8_t num_co
 				P_Open=1;
 			}
 		}
+		osSignalSet(eth_tid, ETH_SIG_POLL);
+	}
+	osMutexRelease(eth_mtx);
+}
+
+/*PILA EASYWEB: SOLO DESDE EL HILO DE RED, CON EL MUTEX TOMADO*/
+static uint32_t eth_service(uint32_t signals){
+	uint32_t n;
+	if(e_reserved == 0){
+		return 0;
+	}
+	if(signals & ETH_SIG_CLOCK){
+		TCPClockHandler(); //ISN y temporizador TCP
+	}
+	/*Procesar las tramas recibidas, como mucho un anillo de descriptores por llamada*/
+	for(n = 0; n < NUM_RX_FRAG; n++){
+		DoNetworkStuff();
+		if(!CheckFrameReceived()){
+			break;
+		}
+	}
+	/*Queda trabajo pendiente: tramas sin procesar o una trama esperando al EMAC*/
+	return (CheckFrameReceived() || (TransmitControl & (SEND_FRAME1 | SEND_FRAME2)));
+}
+/**********************************************************
+NETWORK SERVICE THREAD: WOKEN BY THE EMAC INTERRUPT, THE
+TCP CLOCK TIMER AND THE SOCKET CALLS. THE STACK RUNS IN
+THREAD MODE AT ETH_THREAD_PRIO, SO THE SYSTICK AND HIGHER
+PRIORITY THREADS PREEMPT IT; eth_mtx KEEPS THE SOCKET
+CALLS OUT WHILE A FRAME IS BEING PROCESSED.
+***********************************************************/
+void eth_thread(void const *argument){
+	osEvent evt;
+	uint32_t signals;
+	uint32_t wait = osWaitForever;
+	while(1){
+		evt = osSignalWait(0, wait);
+		if(evt.status == osEventSignal){
+			signals = evt.value.signals;
+		}
+		else{ //reintentar el trabajo pendiente
+			signals = ETH_SIG_POLL;
+		}
+		osMutexWait(eth_mtx, osWaitForever);
+		if(e_stop){ //ultima conexion liberada por un hilo terminado
+			e_stop = 0;
+			TCPFlags = 0;
+			SocketStatus = 0;
+			TCPStateMachine = CLOSED;
+			osTimerStop(eth_tmr);
+		}
+		wait = eth_service(signals) ? 1 : osWaitForever;
+		osMutexRelease(eth_mtx);
+	}
+}
+/*TIMER CALLBACK: TCP CLOCK EVERY ETH_CLOCK_MS*/
+void eth_clock(void const *argument){
+	osSignalSet(eth_tid, ETH_SIG_CLOCK);
+}
+/*EMAC INTERRUPT: WAKE UP THE NETWORK THREAD*/
+void ENET_IRQHandler(void){
+	LPC_EMAC->IntClear = LPC_EMAC->IntStatus;
+	osSignalSet(eth_tid, ETH_SIG_RX);
+}
+/**********************************************************
+OPEN/CLOSE: CREATE THE MUTEX, THE NETWORK THREAD AND THE
+TCP CLOCK ON FIRST USE AND CALL THE SVC WITH THE MUTEX TAKEN
+***********************************************************/
+os_handle_t open_ethernet(void){
+	os_handle_t eth;
+	unsigned int first_open;
+	if(eth_tid == NULL){
+		eth_mtx = osMutexCreate(osMutex(eth_mutex));
+		eth_tid = osThreadCreate(osThread(eth_thread), NULL);
+		eth_tmr = osTimerCreate(osTimer(eth_clock), osTimerPeriodic, NULL);
+	}
+	osMutexWait(eth_mtx, osWaitForever);
+	first_open = (e_reserved == 0);
+	eth = open_eth_svc();
+	if(first_open && e_reserved){
+		osTimerStart(eth_tmr, ETH_CLOCK_MS);
+	}
+	osMutexRelease(eth_mtx);
+	return(eth);
+}
+void close_ethernet(os_handle_t eth){
+	osMutexWait(eth_mtx, osWaitForever);
+	close_eth_svc(eth);
+	if(e_reserved == 0){
+		osTimerStop(eth_tmr); //sin conexiones: el tick puede dormir
 	}
+	osMutexRelease(eth_mtx);
 }
 
 /*********************************************************************************************************
@@ -5,7 +5,6 @@
 #define __EASYWEB_H
 
 typedef struct OS_TETH {
-	unsigned char ID;       //unsigned char id_task;
 	uint8_t IP_1;
 	uint8_t IP_2;
 	uint8_t IP_3;
@@ -13,31 +12,34 @@ typedef struct OS_TETH {
 	uint8_t S_C;
 	uint16_t P_EXT;
 	uint16_t P_INT;
-	uint8_t n_con;
-	struct OS_TETH *next;
 }*P_TETH;
 
-typedef struct E_SYNC_OS{
-	unsigned char ID;
-}*P_ESYNC;
-
 //extern unsigned char Status;                        // status byte 
 //extern unsigned char *PWebSide;
 #define HTTP_SEND_PAGE               0x01        // help flag
 
-P_TETH __svc(4) open_ethernet(osThreadId ID);
-extern void __svc(5) write_ethernet(char *data_tx, osThreadId ID);
-extern void __svc(6) read_ethernet(unsigned char *data_rx, osThreadId ID);
-extern void __svc(7) connect_ethernet(struct OS_TETH *add, osThreadId ID,uint8_t num_con);
-extern void __svc(8) close_ethernet(osThreadId ID, struct OS_TETH *cls);
+/*Network service thread: runs the easyWEB stack in thread mode, below the SysTick*/
+#ifndef ETH_THREAD_PRIO
+#define ETH_THREAD_PRIO		osPriorityAboveNormal //Modify for requeriments
+#endif
+#define ETH_CLOCK_MS		210		//Period of TCPClockHandler (ISN and TCP timer)
+#define ETH_SIG_RX			0x01	//EMAC frame received
+#define ETH_SIG_CLOCK		0x02	//TCP clock elapsed
+#define ETH_SIG_POLL		0x04	//Socket call or pending transmission: run the stack
+#define ETH_SIG_STOP		0x08	//Last connection released by a terminated thread
+
+os_handle_t open_ethernet(void);
+void write_ethernet(os_handle_t eth, char *data_tx);
+void read_ethernet(os_handle_t eth, unsigned char *data_rx);
+void connect_ethernet(os_handle_t eth, struct OS_TETH *conf);
+void close_ethernet(os_handle_t eth);
 //extern unsigned int BytesToSend; // bytes left to send
-extern unsigned short activar_systick;
+extern osThreadId eth_tid;
 
 //extern void *rt_alloc_box  (void *box_mem);
 /*FUNCTIONS ETHERNET.c*/
-void add_element(struct OS_TETH *copy);
-void check_struct (osThreadId ID,uint8_t num_con);
-void liberar(struct OS_TETH *erase);
+void eth_thread(void const *argument);
+void eth_clock(void const *argument);
 /*Define to use in Ethernet*/
 #define SERVER 		0
 #define CLIENT  	1
@@ -6,76 +6,51 @@
 #include <string.h>
 #include "rt_TypeDef.h"
 #include "RTX_config.h"
-#include "debug_frmwrk.h"
 #include "lpc17xx_gpio.h"
 #include "lpc17xx_pinsel.h"
-#include "rt_MemBox.h"
+#include "rt_Handle.h"
 #include "FILE_OS.h"
+#include "LOG_OS.h"
 
-#ifdef __GNUC__
-  /* With GCC/RAISONANCE, small printf (option LD Linker->Libraries->Small printf
-     set to 'Yes') calls __io_putchar() */
-  #define PUTCHAR_PROTOTYPE int __io_putchar(int ch)
-#else
-  #define PUTCHAR_PROTOTYPE int fputc(int ch, FILE *f)
-#endif /* __GNUC__ */
+/*LOS MENSAJES VAN AL LOG BINARIO (LOG_OS.h): registrar cuesta microsegundos
+  dentro de la SVC y el texto lo forma el host al vaciar el log*/
 
 	FATFS fs;         /* Work area (file system object) for logical drive */
 	FIL fsrc;         /* file objects */   
 	FRESULT res;
 	UINT br;
 	unsigned int size;
-	/*MEMORY RESERVE*/
-	P_FSYNC fsync;
-	_declare_box(file_pool,10,10); //Modify for requeriments
-	unsigned int f_reserved = 0; //memory reserved for file struct
-	P_TCB rt_tid2ptcb (osThreadId thread_id);
-	
-void __svc(14) open_file(osThreadId ID);
-void __SVC_14           (osThreadId ID){
 	
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	/*MEMORY RESERVE FOR STRUCT*/
-	if(f_reserved == 0){
-		rt_init_box(file_pool,sizeof(file_pool),sizeof(struct F_SYNC_OS));
-		fsync = rt_alloc_box(file_pool);
-		memset(fsync,0,sizeof(struct F_SYNC_OS));
-		f_reserved = 1;
+os_handle_t __svc(14) open_file(void);
+os_handle_t __SVC_14           (void){
+	os_handle_t sd;
+	/*UNA TARJETA YA ABIERTA POR ESTE HILO, O COMPARTIDA, SE MONTA DE NUEVO*/
+	sd = rt_hnd_find(HND_FILE, 0);
+	if(sd == 0){
+		sd = rt_hnd_open(HND_FILE, 0, NULL); //la tarjeta pasa a ser del hilo que la abre
 	}
-	/*EXTRACTING ID OF THE THREAD*/
-	id = rt_tid2ptcb(ID);
 	/*RUNNING THE CONFIGURATION*/
-	if((fsync->ID == id->task_id) || (fsync->ID == 0)){
-		fsync->ID = id->task_id;
+	if(sd != 0){
 		MSD_SPI_Configuration();
 	
-		debug_frmwrk_init();
-	
-		printf("----------------------------------------------------------------\n");
-		printf("                                                                \n");
-		printf("   Thank you for using LPC1768-Mini-DK Development Board		 		\n");
-		printf("                                                                \n");
-		printf("----------------------------------------------------------------\n");
+		os_log(LOG_FILE_OPEN, 0, 0, 0, 0);
 
 		if( _card_insert() == 0 ){
-			printf("--> SD card detected OK\r\n");
+			os_log(LOG_SD_DETECTED, 0, 0, 0, 0);
 		}
 		else{
-			printf("--> Please insert a SD card\r\n");
+			os_log(LOG_SD_INSERT, 0, 0, 0, 0);
 			while( _card_insert() != 0 );
-			printf("--> SD card connection detected\r\n");
+			os_log(LOG_SD_CONNECTED, 0, 0, 0, 0);
 			//Delay(0xffffff);
 		}
 		f_mount(0,&fs);
 	}
+	return(sd);
 }
-void __svc(15) write_file(uint8_t option, char *text, char *file, osThreadId ID);
-void __SVC_15            (uint8_t option, char *text, char *file, osThreadId ID){
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(fsync->ID == id->task_id){
+void __svc(15) write_file(os_handle_t sd, uint8_t option, char *text, char *file);
+void __SVC_15            (os_handle_t sd, uint8_t option, char *text, char *file){
+	if(rt_hnd_get(sd, HND_FILE) != NULL){
 		switch(option)
 		{
 			case NEW_FILE:
@@ -84,52 +59,50 @@ void __SVC_15            (uint8_t option, char *text, char *file, osThreadId ID)
 					/* Write buffer to file */
 					res = f_write(&fsrc, text, strlen(text), &br);     
  
-					printf("-->File successfully created\r\n");
+					os_log(LOG_FILE_CREATED, 0, 0, 0, 0);
     
 					/*close file */
 					f_close(&fsrc);      
 				}
 				else if ( res == FR_EXIST ){
-					printf("-->File created in the disk\r\n");
+					os_log(LOG_FILE_EXISTS, 0, 0, 0, 0);
 				}
 				break;
 			case MKDIR:
 				res = f_mkdir(file);
 				if( res == FR_OK)
-					printf("-->Directory successfully created\r\n");
+					os_log(LOG_DIR_CREATED, 0, 0, 0, 0);
 				else if(res == FR_EXIST)
-					printf("-->There is a directory with the same name\r\n");
+					os_log(LOG_DIR_EXISTS, 0, 0, 0, 0);
 				else if(res == FR_DENIED)
-					printf("-->No space to allocate a new cluster\r\n");
+					os_log(LOG_DIR_DENIED, 0, 0, 0, 0);
 				break;
 			case OPEN_FILE:
 				res = f_open(&fsrc, file,FA_OPEN_EXISTING | FA_WRITE);
 				if(res == FR_OK){
 					res = f_write(&fsrc, text, strlen(text), &br);
-					printf("-->Successfully written in a existing file\r\n");
+					os_log(LOG_FILE_WRITTEN, 0, 0, 0, 0);
 					f_close(&fsrc);
 				}
 				else if( res == FR_EXIST)
-					printf("-->File doesn't written\r\n");
+					os_log(LOG_FILE_NOT_WRITTEN, 0, 0, 0, 0);
 				break;
 		}
 	}
 }
 
-void __svc(16) read_file(uint8_t option, char *pth, char *file, osThreadId ID);
-void __SVC_16           (uint8_t option, char *pth, char *file, osThreadId ID){
+void __svc(16) read_file(os_handle_t sd, uint8_t option, char *pth, char *file);
+void __SVC_16           (os_handle_t sd, uint8_t option, char *pth, char *file){
 	char data[512];
-		/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(fsync->ID == id->task_id){
+	if(rt_hnd_get(sd, HND_FILE) != NULL){
 		switch(option)
 		{
 			case READ_FILE:
 				res = f_open(&fsrc, file, FA_READ);
 				res = f_read(&fsrc, data, 512, &br);
 				f_close(&fsrc);
-				printf("%s\r\n", data);
+				data[br < sizeof(data) ? br : sizeof(data) - 1] = 0;
+				os_log_str(LOG_FILE_DATA, data);	//los primeros 80 caracteres
 				break;
 			case SHOW_SIZE:
 				SD_TotalSize();
@@ -141,36 +114,33 @@ void __SVC_16           (uint8_t option, char *pth, char *file, osThreadId ID){
 	}
 }
 
-void __svc(17)close_file(uint8_t option, const TCHAR *f_dir, osThreadId ID);
-void __SVC_17 		      (uint8_t option, const TCHAR *f_dir, osThreadId ID){
-		/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(fsync->ID == id->task_id){
+void __svc(17)close_file(os_handle_t sd, uint8_t option, const TCHAR *f_dir);
+void __SVC_17 		      (os_handle_t sd, uint8_t option, const TCHAR *f_dir){
+	P_HCB hcb;
+	hcb = rt_hnd_get(sd, HND_FILE);
+	if(hcb != NULL){
 		switch(option)
 		{
 			case REMOVE:
 				res = f_unlink(f_dir); //remove a File or Directory
 				if(res == FR_OK)
-					printf("-->Removed successfully\r\n");
+					os_log(LOG_FILE_REMOVED, 0, 0, 0, 0);
 				else if(res == FR_INVALID_NAME)
-					printf("-->The path name format is invalid\r\n");
+					os_log(LOG_FILE_BAD_NAME, 0, 0, 0, 0);
 				else if(res == FR_DENIED)
-					printf("-->Acces denied due to prohibited access or directory full\r\n");
+					os_log(LOG_FILE_DENIED, 0, 0, 0, 0);
 				else if(res == FR_INT_ERR)
-					printf("-->Assertion failed\r\n");
+					os_log(LOG_FILE_ASSERT, 0, 0, 0, 0);
 				break;
 			case UNMOUNT:
 				res = f_mount(0,NULL);
 				if(res == FR_OK)
-					printf("-->Unmounted successfully\r\n");
+					os_log(LOG_UNMOUNTED, 0, 0, 0, 0);
 				else if(res == FR_INVALID_DRIVE)
-					printf("-->The logical drive number is invalid\r\n");
+					os_log(LOG_BAD_DRIVE, 0, 0, 0, 0);
 				break;
 			case FREE_MEM:
-				memset(fsync,0,sizeof(struct F_SYNC_OS)); //Primero, limpiar el espacio
-				rt_free_box(file_pool,fsync); //Segundo liberar la memoria
-				f_reserved = 0;
+				rt_hnd_close(hcb); //las copias del handle dejan de ser validas
 			break;
 		}
 	}	
@@ -204,7 +174,9 @@ FRESULT scan_files (char* path){
                 if (res != FR_OK) break;
                 path[i] = 0;
             } else {
-                printf("%s/%s \r\n", path, fn);
+                sprintf(&path[i], "/%s", fn);
+                os_log_str(LOG_FILE_NAME, path);
+                path[i] = 0;
             }
         }
     }
@@ -219,9 +191,7 @@ int SD_TotalSize(void){
     if ( res==FR_OK ) 
     {
 	  /* Print free space in unit of MB (assuming 512 bytes/sector) */
-      printf("\r\n%lu MB total drive space.\r\n"
-           "%lu MB available.\r\n",
-           ((fs->n_fatent - 2) * fs->csize ) / 2 /1024 , (fre_clust * fs->csize) / 2 /1024 );
+      os_log(LOG_DRIVE_SPACE, ((fs->n_fatent - 2) * fs->csize ) / 2 /1024 , (fre_clust * fs->csize) / 2 /1024, 0, 0);
 		
 	  return ENABLE;
 	}
@@ -232,15 +202,6 @@ int SD_TotalSize(void){
 void  Delay (uint32_t nCount){
   for(; nCount != 0; nCount--);
 }
-PUTCHAR_PROTOTYPE{
-	/* wait for current transmission complete - THR must be empty */
-	while (UART_CheckBusy(DEBUG_UART_PORT) == SET);
-	
-	UART_SendByte(DEBUG_UART_PORT, ch);
-	
-	return ch;
-}
-
 /*********************************************************************************************************
       END FILE
 *********************************************************************************************************/
@@ -6,10 +6,10 @@
 #ifndef _FILE_OS
 #define _FILE_OS
 
-extern void __svc(14) open_file(osThreadId ID);
-extern void __svc(15) write_file(uint8_t option, char *text, char *file, osThreadId ID);
-extern void __svc(16) read_file(uint8_t option, char *pth, char *file, osThreadId ID);
-extern void __svc(17) close_file(uint8_t option, const TCHAR *f_dir, osThreadId ID);
+extern os_handle_t __svc(14) open_file(void);
+extern void __svc(15) write_file(os_handle_t sd, uint8_t option, char *text, char *file);
+extern void __svc(16) read_file(os_handle_t sd, uint8_t option, char *pth, char *file);
+extern void __svc(17) close_file(os_handle_t sd, uint8_t option, const TCHAR *f_dir);
 
 /*BASE PROYECT FUNCTIONS*/
 extern void  Delay (uint32_t nCount);
@@ -29,10 +29,6 @@ FRESULT scan_files (char* path);
 #define REMOVE 			0
 #define UNMOUNT			1
 #define FREE_MEM		2
-/*SYNCHRONIZATION BETWEEN THREADs*/
-typedef struct F_SYNC_OS{
-	unsigned char ID;
-}*P_FSYNC;
 
 #endif
 
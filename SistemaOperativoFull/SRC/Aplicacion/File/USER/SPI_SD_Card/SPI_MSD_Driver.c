@@ -22,7 +22,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "SPI_MSD_Driver.h"
-#include <stdio.h>
+#include "LOG_OS.h"
 
 /* Private define ------------------------------------------------------------*/
 #define PRINT_INFO  1	
@@ -158,7 +158,7 @@ int MSD_Init(void)
     if( _card_insert() )
 	{ 
 #ifdef PRINT_INFO 
-		printf("There is no card detected! \r\n");
+		os_log(LOG_MSD_NO_CARD, 0, 0, 0, 0);
 #endif
 	  /* FATFS error flag */
       return -1;
@@ -190,7 +190,7 @@ int MSD_Init(void)
 	if(retry == 0xFFF)
 	{
 #ifdef PRINT_INFO 
-		printf("Reset card into IDLE state failed!\r\n");
+		os_log(LOG_MSD_RESET_FAILED, 0, 0, 0, 0);
 #endif
 		return 1;
 	}
@@ -214,7 +214,7 @@ int MSD_Init(void)
 		 if(r1 != 0x01)
 		 {
 #ifdef PRINT_INFO 
-			printf("Send CMD55 should return 0x01, response=0x%02x\r\n", r1);
+			os_log(LOG_MSD_BAD_CMD, 55, 0x01, r1, 0);
 #endif
 			return r1;
 		 }
@@ -244,21 +244,21 @@ int MSD_Init(void)
 		 if(retry == 0xFFF)
 		 {
 #ifdef PRINT_INFO
-			printf("Send CMD1 should return 0x00, response=0x%02x\r\n", r1);
+			os_log(LOG_MSD_BAD_CMD, 1, 0x00, r1, 0);
 #endif
 			return 2;
 		 }	
 			
 		CardInfo.CardType = CARDTYPE_MMC;		
 #ifdef PRINT_INFO 
-		printf("-->Card Type: MMC\r\n");
+		os_log(LOG_MSD_MMC, 0, 0, 0, 0);
 #endif 				
 	  }		
 		/* SD1.0 card detected, print information */
 #ifdef PRINT_INFO
 	  else
 	  {
-		 printf("-->Card Type: SD V1\r\n");
+		 os_log(LOG_MSD_SDV1, 0, 0, 0, 0);
 	  }
 #endif 
 		
@@ -270,7 +270,7 @@ int MSD_Init(void)
 	  if(r1 != 0x00)
 	  {
 #ifdef PRINT_INFO 
-		  printf("Send CMD59 should return 0x00, response=0x%02x\r\n", r1);
+		  os_log(LOG_MSD_BAD_CMD, 59, 0x00, r1, 0);
 #endif
 		  return r1;		/* response error, return r1 */
 	  }
@@ -280,7 +280,7 @@ int MSD_Init(void)
 	  if(r1 != 0x00)
 	  {
 #ifdef PRINT_INFO
-		  printf("Send CMD16 should return 0x00, response=0x%02x\r\n", r1);
+		  os_log(LOG_MSD_BAD_CMD, 16, 0x00, r1, 0);
 #endif
 		  return r1;		/* response error, return r1 */
 	  }
@@ -308,7 +308,7 @@ int MSD_Init(void)
 			if(r1!=0x01)
 			{
 #ifdef PRINT_INFO 
-				printf("Send CMD55 should return 0x01, response=0x%02x\r\n", r1);
+				os_log(LOG_MSD_BAD_CMD, 55, 0x01, r1, 0);
 #endif
 				return r1;
 			}				
@@ -325,7 +325,7 @@ int MSD_Init(void)
 		if(retry == 0xFFF)
 		{
 #ifdef PRINT_INFO
-			printf("Send ACMD41 should return 0x00, response=0x%02x\r\n", r1);
+			os_log(LOG_MSD_BAD_ACMD, 41, 0x00, r1, 0);
 #endif
 			return 3;
 		}
@@ -335,7 +335,7 @@ int MSD_Init(void)
 	    if(r1!=0x00)
 	    {
 #ifdef PRINT_INFO
-			printf("Send CMD58 should return 0x00, response=0x%02x\r\n", r1);
+			os_log(LOG_MSD_BAD_CMD, 58, 0x00, r1, 0);
 #endif
             return r1;		/* response error, return r1 */
 	    }
@@ -354,14 +354,14 @@ int MSD_Init(void)
 	    {
            CardInfo.CardType = CARDTYPE_SDV2HC;
 #ifdef PRINT_INFO 
-		   printf("-->Card Type: SD V2HC\r\n");
+		   os_log(LOG_MSD_SDV2HC, 0, 0, 0, 0);
 #endif 	
 	    }
 	    else
 	    {
            CardInfo.CardType = CARDTYPE_SDV2;
 #ifdef PRINT_INFO
-		   printf("-->Card Type: SD V2\r\n");
+		   os_log(LOG_MSD_SDV2, 0, 0, 0, 0);
 #endif 	
 	    }
 
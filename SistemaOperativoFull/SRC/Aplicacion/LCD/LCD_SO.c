@@ -3,16 +3,7 @@
 #include "rt_TypeDef.h"
 #include "RTX_config.h"
 #include "LCD_h.h"
-#include "rt_Memory.h"
-#include "rt_MemBox.h"
-
-struct OS_LCD *lcd = NULL;
-/*MEMORY RESERVE*/
-	P_LSYNC lsync;
-_declare_box(lcd_pool,220,1);
-_declare_box(slcd_pool,4,4);
-unsigned int l_reserved = 0; //memory reserved for file struct
-P_TCB rt_tid2ptcb (osThreadId thread_id);
+#include "rt_Handle.h"
 
 /* rotation can be 0, 1, 2 or 3 (3 is the default option)*/
 //    (239,319)|----------------------|(000,319)   (000,000)|----------------------|(000,000)
@@ -37,37 +28,26 @@ P_TCB rt_tid2ptcb (osThreadId thread_id);
 //             |E@              @   @ |                     | @----------------->@E|
 //             |----------------------|            (239,000)|----------------------|(239,319)
 //                    rotation = 2                              rotation = 3 (DEFAULT)
-P_LCD __svc(9) open_lcd(uint16_t color,uint8_t rotation, osThreadId ID);
-P_LCD __SVC_9          (uint16_t color,uint8_t rotation, osThreadId ID){
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	/*MEMORY RESERVE FOR STRUCT*/
-	if(l_reserved == 0){
-		rt_init_box(slcd_pool,sizeof(slcd_pool),sizeof(struct L_SYNC_OS));
-		lsync = rt_alloc_box(slcd_pool);
-		memset(lsync,0,sizeof(struct L_SYNC_OS));
-		l_reserved = 1;
+os_handle_t __svc(9) open_lcd(uint16_t color,uint8_t rotation);
+os_handle_t __SVC_9          (uint16_t color,uint8_t rotation){
+	os_handle_t screen;
+	/*UNA PANTALLA YA ABIERTA POR ESTE HILO, O COMPARTIDA, SE REINICIA*/
+	screen = rt_hnd_find(HND_LCD, 0);
+	if(screen == 0){
+		screen = rt_hnd_open(HND_LCD, 0, NULL); //la pantalla pasa a ser del hilo que la abre
 	}
-	/*EXTRACTING ID OF THE THREAD*/
-	id = rt_tid2ptcb(ID);
 	/*RUNNING THE CONFIGURATION*/
-	if((lsync->ID == id->task_id) || (lsync->ID == 0)){
-		lsync->ID = id->task_id;
+	if(screen != 0){
 		lcdInitDisplay(); //INICIO DE LCD
-		rt_init_box(lcd_pool,sizeof(lcd_pool),sizeof(struct OS_LCD));
-		lcd = rt_alloc_box(lcd_pool);
-		memset(lcd,0,sizeof(struct OS_LCD));
 		fillScreen(color);
 		setRotation(rotation);
 	}
-	return(lcd);
+	return(screen);
 }
  
-void __svc(10) write_lcd(P_LCD lcd, osThreadId ID);
-void __SVC_10           (P_LCD lcd, osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(lsync->ID == id->task_id){
+void __svc(10) write_lcd(os_handle_t screen, P_LCD lcd);
+void __SVC_10           (os_handle_t screen, P_LCD lcd){
+	if(rt_hnd_get(screen, HND_LCD) != NULL){
 		switch (lcd->select)
 		{
 			/*REPRESENTAR EN PANTALLA MENSAJES O SIMPLEMENTE LETRAS*/
@@ -109,15 +89,11 @@ void __SVC_10           (P_LCD lcd, osThreadId ID){
 		}
 	}
 }
-void __svc(11) close_lcd(osThreadId ID);
-void __SVC_11           (osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID); //extraemos la id del hilo
-	if(lsync->ID == id->task_id){
-		memset(lcd,0,sizeof(struct OS_LCD)); //Primero, limpiar el espacio
-		memset(slcd_pool,0,sizeof(struct L_SYNC_OS)); //Primero, limpiar el espacio
-		rt_free_box(lcd_pool,lcd); //Segundo liberar la memoria
-		rt_free_box(slcd_pool,lsync); //Segundo liberar la memoria
-		l_reserved = 0;
+void __svc(11) close_lcd(os_handle_t screen);
+void __SVC_11           (os_handle_t screen){
+	P_HCB hcb;
+	hcb = rt_hnd_get(screen, HND_LCD);
+	if(hcb != NULL){
+		rt_hnd_close(hcb); //las copias del handle dejan de ser validas
 	}
 }
@@ -23,14 +23,9 @@ typedef struct OS_LCD {
 	uint8_t rotflag;
 }*P_LCD;
 
-/*SYNCHRONIZATION BETWEEN THREADs*/
-typedef struct L_SYNC_OS{
-	unsigned char ID;
-}*P_LSYNC;
-
-extern P_LCD __svc(9) open_lcd(uint16_t color,uint8_t rotation, osThreadId ID);
-extern void __svc(10) write_lcd(P_LCD lcd, osThreadId ID);
-extern void __svc(11) close_lcd(osThreadId ID);
+extern os_handle_t __svc(9) open_lcd(uint16_t color,uint8_t rotation);
+extern void __svc(10) write_lcd(os_handle_t screen, P_LCD lcd);
+extern void __svc(11) close_lcd(os_handle_t screen);
 
 
 /*USE THIS TO SELECT OPTION TO VARIABLE "SELECT"*/
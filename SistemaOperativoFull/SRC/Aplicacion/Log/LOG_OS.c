@@ -0,0 +1,69 @@
+/*Vaciado del log binario por una UART*/
+#include "cmsis_os.h"
+#include <LPC17xx.h>
+#include "uartn.h"
+#include "LOG_OS.h"
+
+/*
+ * Los registros salen tal cual, 32 bytes cada uno, precedidos de un
+ * registro de cabecera (os_log_header) con el que el decodificador del
+ * host (POSIX/log2txt.c) se sincroniza. Dos buffers: uno sale por DMA
+ * mientras el hilo lee el log en el otro.
+ */
+
+static void log_thread(void const *argument);
+osThreadDef(log_thread, osPriorityLow, 1, 0);
+
+static uint32_t log_buf[2][LOG_BATCH * 8];
+static uint8_t log_unit;
+static uint32_t log_baudrate;
+
+/*----------------------------------------------------------------------------
+ *   Envia n registros, devuelve 1 si quedan saliendo por DMA
+ *---------------------------------------------------------------------------*/
+static uint32_t log_send(os_handle_t uart, uint32_t *buf, uint32_t n){
+	if(write_uart_dma(uart, (const char *)buf, n * 32) == osOK){
+		return(1);
+	}
+	/*OTRO BLOQUE DE DMA EN EL PUERTO: se copia en tx*/
+	write_uart_wait(uart, (const char *)buf, n * 32, osWaitForever);
+	return(0);
+}
+
+/*----------------------------------------------------------------------------
+ *   Hilo de vaciado
+ *---------------------------------------------------------------------------*/
+static void log_thread(void const *argument){
+	os_handle_t uart;
+	uint32_t n, cur, busy;
+
+	uart = open_uart(log_unit, log_baudrate);
+	if(uart == 0){
+		osThreadTerminate(osThreadGetId());	// puerto de otro hilo
+	}
+	os_log_header(log_buf[0]);
+	busy = log_send(uart, log_buf[0], 1);
+	cur = 1;
+	while(1){
+		n = os_log_read(log_buf[cur], LOG_BATCH);
+		if(n == 0){
+			osDelay(LOG_PERIOD);
+			continue;
+		}
+		if(busy){
+			osSignalWait(UART_SIG_TX, osWaitForever);	// el otro buffer ya salio
+		}
+		busy = log_send(uart, log_buf[cur], n);
+		cur ^= 1;
+	}
+}
+
+osThreadId log_start(uint8_t UARTn, uint32_t baudrate){
+	log_unit = UARTn;
+	log_baudrate = baudrate;
+	return(osThreadCreate(osThread(log_thread), NULL));
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
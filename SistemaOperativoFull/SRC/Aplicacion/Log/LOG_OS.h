@@ -0,0 +1,24 @@
+#include "cmsis_os.h"
+
+#ifndef _LOG_OS
+#define _LOG_OS
+
+/*NUMEROS DE LOS MENSAJES, EN EL ORDEN DE log_msgs.h*/
+#define LOG_MSG(id, fmt)	id,
+enum {
+#include "log_msgs.h"
+	LOG_MSG_CNT
+};
+#undef LOG_MSG
+
+#define LOG_BATCH		8	// registros por envio: 256 bytes por DMA
+#define LOG_PERIOD		10	// ms entre vaciados con el log vacio
+
+/*HILO DE BAJA PRIORIDAD QUE VACIA EL LOG POR EL PUERTO, QUE PASA A SER SUYO*/
+extern osThreadId log_start(uint8_t UARTn, uint32_t baudrate);
+
+#endif
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,48 @@
+/*
+ * Tabla de los mensajes del log binario (os_log, os_log_str). Cada
+ * LOG_MSG(id, formato) da el numero del mensaje en el target (LOG_OS.h) y
+ * su formato al decodificador del host (POSIX/log2txt.c), que es quien
+ * formatea. Los argumentos son palabras de 32 bits; un formato con %s no
+ * lleva otros argumentos y se registra con os_log_str. Los mensajes nuevos
+ * se anaden al final, asi los logs ya guardados se siguen decodificando.
+ * Sin guarda de inclusion: se incluye con distintas definiciones de LOG_MSG.
+ */
+
+/*FILE_OS.c*/
+LOG_MSG(LOG_FILE_OPEN,		"LPC1768-Mini-DK: file system driver started")
+LOG_MSG(LOG_SD_DETECTED,	"--> SD card detected OK")
+LOG_MSG(LOG_SD_INSERT,		"--> Please insert a SD card")
+LOG_MSG(LOG_SD_CONNECTED,	"--> SD card connection detected")
+LOG_MSG(LOG_FILE_CREATED,	"-->File successfully created")
+LOG_MSG(LOG_FILE_EXISTS,	"-->File created in the disk")
+LOG_MSG(LOG_DIR_CREATED,	"-->Directory successfully created")
+LOG_MSG(LOG_DIR_EXISTS,		"-->There is a directory with the same name")
+LOG_MSG(LOG_DIR_DENIED,		"-->No space to allocate a new cluster")
+LOG_MSG(LOG_FILE_WRITTEN,	"-->Successfully written in a existing file")
+LOG_MSG(LOG_FILE_NOT_WRITTEN,	"-->File doesn't written")
+LOG_MSG(LOG_FILE_DATA,		"%s")
+LOG_MSG(LOG_FILE_NAME,		"%s")
+LOG_MSG(LOG_FILE_REMOVED,	"-->Removed successfully")
+LOG_MSG(LOG_FILE_BAD_NAME,	"-->The path name format is invalid")
+LOG_MSG(LOG_FILE_DENIED,	"-->Acces denied due to prohibited access or directory full")
+LOG_MSG(LOG_FILE_ASSERT,	"-->Assertion failed")
+LOG_MSG(LOG_UNMOUNTED,		"-->Unmounted successfully")
+LOG_MSG(LOG_BAD_DRIVE,		"-->The logical drive number is invalid")
+LOG_MSG(LOG_DRIVE_SPACE,	"%u MB total drive space, %u MB available.")
+
+/*Other main/main_log.c*/
+LOG_MSG(LOG_DEMO_START,		"log demo: %u producers, %u Hz time stamps")
+LOG_MSG(LOG_DEMO_TICK,		"producer %u: count %u, sum 0x%08x")
+LOG_MSG(LOG_DEMO_ISR,		"interrupt %u")
+LOG_MSG(LOG_DEMO_TEXT,		"text: %s")
+LOG_MSG(LOG_DEMO_BENCH,		"%u calls: os_log %u ns, snprintf %u ns per call")
+
+/*File/USER/SPI_SD_Card/SPI_MSD_Driver.c*/
+LOG_MSG(LOG_MSD_NO_CARD,	"There is no card detected!")
+LOG_MSG(LOG_MSD_RESET_FAILED,	"Reset card into IDLE state failed!")
+LOG_MSG(LOG_MSD_BAD_CMD,	"Send CMD%u should return 0x%02x, response=0x%02x")
+LOG_MSG(LOG_MSD_BAD_ACMD,	"Send ACMD%u should return 0x%02x, response=0x%02x")
+LOG_MSG(LOG_MSD_MMC,		"-->Card Type: MMC")
+LOG_MSG(LOG_MSD_SDV1,		"-->Card Type: SD V1")
+LOG_MSG(LOG_MSD_SDV2HC,		"-->Card Type: SD V2HC")
+LOG_MSG(LOG_MSD_SDV2,		"-->Card Type: SD V2")
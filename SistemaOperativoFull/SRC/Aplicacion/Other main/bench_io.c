@@ -0,0 +1,37 @@
+#include "cmsis_os.h"
+#include "string.h"
+#include "stdio.h"
+#if !defined (__RTX_POSIX)
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+#include "bench_io.h"
+
+#if !defined (__RTX_POSIX)
+static os_handle_t bench_uart;
+#endif
+
+/*----------------------------------------------------------------------------
+ *   Open UART0 for the calling thread (nothing to do on host)
+ *---------------------------------------------------------------------------*/
+void bench_open(void){
+#if !defined (__RTX_POSIX)
+	bench_uart = open_uart(UART0, 115200);
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Print a string on UART0 (stdout on host) and wait until it is queued
+ *---------------------------------------------------------------------------*/
+void bench_print(const char *msg){
+#if defined (__RTX_POSIX)
+	fputs(msg, stdout);
+	fflush(stdout);
+#else
+	write_uart_wait(bench_uart, msg, strlen(msg), osWaitForever);
+#endif
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,18 @@
+#include "cmsis_os.h"
+
+#ifndef _BENCH_IO
+#define _BENCH_IO
+
+/*
+ * Output of the benchmark and demo programs of this directory: UART0 at
+ * 115200 baud on the target, stdout on the host port (SRC/POSIX). The
+ * thread that calls bench_open owns the port.
+ */
+extern void bench_open(void);
+extern void bench_print(const char *msg);
+
+#endif
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -14,10 +14,10 @@ uint8_t i=1;
  *   Main Thread
  *---------------------------------------------------------------------------*/
 int main (void){
-	osThreadId lcd_id;
-	lcd_id = osThreadGetId();
-	P_LCD s_lcd;
-	s_lcd=open_lcd(WHITE,3,lcd_id);
+	os_handle_t screen;
+	struct OS_LCD lcd = {0};
+	P_LCD s_lcd = &lcd;
+	screen=open_lcd(WHITE,3);
 	s_lcd->select = DRAW_PIXEL;
 	s_lcd-> x = 120;
 	s_lcd-> y = 160;
@@ -34,9 +34,9 @@ int main (void){
 	s_lcd-> length = 120;
 	s_lcd-> rotflag = 1;
 	
-	write_lcd(s_lcd,lcd_id);
+	write_lcd(screen,s_lcd);
 	while(1){
 		if(i==0)
-			close_lcd(lcd_id);
+			close_lcd(screen);
 	}
 }
@@ -29,8 +29,12 @@ char buffer_uart[512];
 char buffer_aux[] = "next thread\r";
 unsigned char buffer_ethernet[256];
 unsigned char buffer_read_eth [] = "Ejecutar la siguiente caracteristica\r";
-P_TETH ethernet;
-P_LCD s_lcd;
+struct OS_TETH ethernet_conf;
+P_TETH ethernet = &ethernet_conf;
+struct OS_LCD lcd;
+P_LCD s_lcd = &lcd;
+/*HANDLES DE LOS PERIFERICOS*/
+os_handle_t uart, eth, screen, touch, sd;
 char path [512] ="0:";
 char text[] = "FIRST FILE FROM OPERATIVE SYSTEM RTX\r\n";
 char file[] = "0:/FILE.TXT";
@@ -42,31 +46,38 @@ char file_text[] = "FILE_DIR IN A DIRECTORY CALLED CARPETA \r\n";
  *   UART Thread
  *---------------------------------------------------------------------------*/
 void uart_thread(void const *argument){
-	open_uart(UART0,115200,uart_id);
-	write_uart(UART0, "Hola UART0,comprobando el funcionamiento del puerto serie en SO RTX\n", uart_id);
+	char saludo[] = "Hola UART0,comprobando el funcionamiento del puerto serie en SO RTX\n";
+	uint32_t len = 0;
+	uart = open_uart(UART0,115200);
+	write_uart(uart, saludo, strlen(saludo));
 	while(1){
-		read_uart(UART0, buffer_uart,uart_id);
-		if(*buffer_uart != NULL){
-			aux = strcmp(buffer_uart, buffer_aux);
-			if(aux == 0){
-				osSignalSet(ethernet_id, 0x01);
-				close_uart(uart_id);
-				//osSignalSet(lcd_id, 0x01);
-				osSignalWait(0x01, osWaitForever);
-			}
-			write_uart(UART0, buffer_uart, uart_id);
-			osDelay(500);
-			memset(buffer_uart, 0, strlen(buffer_uart));
+		/*SE ACUMULA UNA LINEA HASTA EL RETORNO DE CARRO*/
+		if(read_uart_wait(uart, buffer_uart + len, 1, osWaitForever) == 0){
+			continue;
+		}
+		if(buffer_uart[len++] != '\r' && len < sizeof(buffer_uart) - 1){
+			continue;
+		}
+		buffer_uart[len] = 0;
+		aux = strcmp(buffer_uart, buffer_aux);
+		if(aux == 0){
+			osSignalSet(ethernet_id, 0x01);
+			close_uart(uart);
+			//osSignalSet(lcd_id, 0x01);
+			osSignalWait(0x01, osWaitForever);
 		}
+		write_uart(uart, buffer_uart, len);
+		osDelay(500);
+		len = 0;
 	}
 }
 /*----------------------------------------------------------------------------
  *   Ethernet Thread
  *---------------------------------------------------------------------------*/
 void ethernet_thread(void const *argument){
-	//write_uart(UART0, "Ejecutando el periferico Ethernet \n", uart_id);
+	//write_uart(uart, "Ejecutando el periferico Ethernet \n");
 	osSignalWait(0x01, osWaitForever);
-	ethernet = open_ethernet(ethernet_id);
+	eth = open_ethernet();
 	ethernet->IP_1 = 192;
 	ethernet->IP_2 = 168;
 	ethernet->IP_3 = 1;
@@ -74,15 +85,14 @@ void ethernet_thread(void const *argument){
 	ethernet->S_C = SERVER;
 	ethernet->P_EXT = 6000;
 	ethernet->P_INT = 80;
-	ethernet->n_con = 0;
 	
 	while(1){
-		connect_ethernet(ethernet,ethernet_id,0);
-		write_ethernet("Configurado el periferico de la comunicacion Ethernet\n", ethernet_id);
-		read_ethernet(buffer_ethernet, ethernet_id);
+		connect_ethernet(eth,ethernet);
+		write_ethernet(eth, "Configurado el periferico de la comunicacion Ethernet\n");
+		read_ethernet(eth, buffer_ethernet);
 		if(strcmp(buffer_ethernet, buffer_read_eth) == 0){
 			osSignalSet(file_id, 0x01);
-			close_ethernet(ethernet_id, ethernet);
+			close_ethernet(eth);
 			osDelay(500);
 			osSignalWait(0x01, osWaitForever);
 		}		
@@ -93,7 +103,7 @@ void ethernet_thread(void const *argument){
  *---------------------------------------------------------------------------*/
 void lcd_thread(void const *argument){
 	osSignalWait(0x01, osWaitForever);
-	s_lcd = open_lcd(RED,3,lcd_id);
+	screen = open_lcd(RED,3);
 	s_lcd-> select = FILL_CIRCLE;
 	s_lcd-> x = 120;
 	s_lcd-> y = 160;
@@ -109,10 +119,10 @@ void lcd_thread(void const *argument){
 	s_lcd-> height = 50;
 	s_lcd-> length = 120;
 	s_lcd-> rotflag = 1;
-	write_lcd(s_lcd, lcd_id);
+	write_lcd(screen, s_lcd);
 	osDelay(7500);
 	osSignalSet(touch_id, 0x01);
-	close_lcd(lcd_id);
+	close_lcd(screen);
 	osSignalWait(0x01, osWaitForever);
 	while(1);
 }
@@ -121,9 +131,9 @@ void lcd_thread(void const *argument){
  *---------------------------------------------------------------------------*/
 void touch_thread(void const *argument){
 	osSignalWait(0x01, osWaitForever);
-	open_touch(touch_id);
+	touch = open_touch();
 	while(1){
-		write_touch(touch_id);
+		write_touch(touch);
  	}
 }
 /*----------------------------------------------------------------------------
@@ -131,14 +141,14 @@ void touch_thread(void const *argument){
  *---------------------------------------------------------------------------*/
 void file_thread(void const *argument){
 	osSignalWait(0x01, osWaitForever);
-	open_file(file_id);
-	write_file(NEW_FILE, text, file, file_id); //creacion de un archivo nuevo 
-	write_file(MKDIR, 0, directory, file_id);	//creacion de una carpeta nueva
-	write_file(NEW_FILE, file_text, file_Dir, file_id); //creacion de un archivo nuevo en la carpeta
-	read_file(READ_FILE, path, file, file_id); //lectura de lo escrito en el primer archivo
-	read_file(READ_FILE, path, file_Dir, file_id); //lectura de lo escrito en el segundo archivo
-	read_file(SHOW_FILES,path,0,file_id); // muestra todos los archivos
-	close_file(FREE_MEM,0,file_id);
+	sd = open_file();
+	write_file(sd, NEW_FILE, text, file); //creacion de un archivo nuevo 
+	write_file(sd, MKDIR, 0, directory);	//creacion de una carpeta nueva
+	write_file(sd, NEW_FILE, file_text, file_Dir); //creacion de un archivo nuevo en la carpeta
+	read_file(sd, READ_FILE, path, file); //lectura de lo escrito en el primer archivo
+	read_file(sd, READ_FILE, path, file_Dir); //lectura de lo escrito en el segundo archivo
+	read_file(sd, SHOW_FILES,path,0); // muestra todos los archivos
+	close_file(sd, FREE_MEM,0);
 	osDelay(7500);
 	osSignalSet(lcd_id, 0x01);
 	osSignalWait(0x01, osWaitForever);
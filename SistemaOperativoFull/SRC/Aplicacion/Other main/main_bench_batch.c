@@ -0,0 +1,349 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Batch benchmark: moves bursts of BURST items through a message queue and
+ * a mail queue, one call per item against one batch call per burst.
+ *
+ *   message put/get       osMessagePut, then osMessageGet, BURST times
+ *   message batch         os_message_put_batch + os_message_get_batch
+ *   mail put/get          osMailPut, then osMailGet + osMailFree, BURST times
+ *   mail batch            os_mail_put_batch + os_mail_get_batch, osMailFree
+ *   burst wake-up         a higher consumer waits: BURST times osMessagePut
+ *   burst wake-up batch   the same burst with one os_message_put_batch, the
+ *                         consumer drains with os_message_get_batch
+ *
+ * Times are per item (average of BENCH_ROUNDS bursts, mail blocks are
+ * allocated outside the timed part). Every item is checked for order and
+ * value; a batch larger than the free entries must be cut at the queue
+ * size, and a batch get must refill the queue from a waiting sender. The
+ * target counts CPU cycles with the DWT cycle counter and prints on UART0
+ * (RTX_Conf_CM.c needs OS_MAINSTKSIZE >= 256); the host port (SRC/POSIX,
+ * "make bench BENCH=main_bench_batch.c") counts nanoseconds, prints on
+ * stdout and exits with 0 when the checks passed.
+ */
+
+#define BURST			32
+#define BENCH_ROUNDS		200
+#define BENCH_DONE		0x0100		// signal to main: burst complete
+
+#if defined (__RTX_POSIX)
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+void single_consumer(void const *argument);
+void batch_consumer(void const *argument);
+void full_sender(void const *argument);
+
+osThreadDef(single_consumer, osPriorityAboveNormal, 1, 0);
+osThreadDef(batch_consumer, osPriorityAboveNormal, 1, 0);
+osThreadDef(full_sender, osPriorityNormal, 1, 0);
+
+osMessageQDef(bench_q, BURST, uint32_t);
+osMailQDef(bench_mq, BURST, uint32_t);
+
+osThreadId main_id;
+osMessageQId bench_q_id;
+osMailQId bench_mq_id;
+
+volatile uint32_t burst_end;		// time stamp of the last item taken
+volatile uint32_t check_errors;
+uint32_t next_value;			// next value expected by the consumers
+uint32_t item[BURST];
+void *mail[BURST];
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Items carry consecutive values
+ *---------------------------------------------------------------------------*/
+static void item_check(uint32_t value){
+	if(value != next_value){
+		check_errors++;
+	}
+	next_value = value + 1;
+}
+
+/*----------------------------------------------------------------------------
+ *   Consumers of the wake-up tests: one item per call or a batch per call
+ *---------------------------------------------------------------------------*/
+void single_consumer(void const *argument){
+	osEvent evt;
+	uint32_t n = 0;
+
+	while(1){
+		evt = osMessageGet(bench_q_id, osWaitForever);
+		if(evt.status == osEventMessage){
+			item_check(evt.value.v);
+			if(++n == BURST){
+				burst_end = bench_now();
+				n = 0;
+				osSignalSet(main_id, BENCH_DONE);
+			}
+		}
+	}
+}
+
+void batch_consumer(void const *argument){
+	uint32_t buf[BURST];
+	int32_t i, got;
+	uint32_t n = 0;
+
+	while(1){
+		got = os_message_get_batch(bench_q_id, buf, BURST, osWaitForever);
+		for(i = 0; i < got; i++){
+			item_check(buf[i]);
+		}
+		n += (got > 0) ? got : 0;
+		if(n >= BURST){
+			burst_end = bench_now();
+			n -= BURST;
+			osSignalSet(main_id, BENCH_DONE);
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Sender waiting on the full queue, the values follow the ones in it
+ *---------------------------------------------------------------------------*/
+void full_sender(void const *argument){
+	uint32_t i, first = (uint32_t)argument;
+
+	for(i = 0; i < BURST / 2; i++){
+		if(osMessagePut(bench_q_id, first + i, osWaitForever) != osOK) check_errors++;
+	}
+	osThreadTerminate(osThreadGetId());
+}
+
+static void bench_report(const char *name, uint64_t put_sum, uint64_t get_sum){
+	sprintf(bench_msg, "%-20s %8u %8u\r\n", name,
+	        (uint32_t)(put_sum / (BENCH_ROUNDS * BURST)), (uint32_t)(get_sum / (BENCH_ROUNDS * BURST)));
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Burst through a waiting higher consumer, "batch" selects the put call
+ *---------------------------------------------------------------------------*/
+static void burst_run(const char *name, const osThreadDef_t *consumer, int batch){
+	osThreadId id;
+	uint64_t sum = 0;
+	uint32_t r, i, t0;
+
+	osThreadSetPriority(main_id, osPriorityNormal);	// below the consumer
+	id = osThreadCreate(consumer, NULL);
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		for(i = 0; i < BURST; i++){
+			item[i] = next_value + i;
+		}
+		t0 = bench_now();
+		if(batch){
+			if(os_message_put_batch(bench_q_id, item, BURST, 0) != BURST) check_errors++;
+		}
+		else{
+			for(i = 0; i < BURST; i++){
+				if(osMessagePut(bench_q_id, item[i], 0) != osOK) check_errors++;
+			}
+		}
+		osSignalWait(BENCH_DONE, osWaitForever);
+		sum += burst_end - t0;
+	}
+	osThreadTerminate(id);
+	osThreadSetPriority(main_id, osPriorityHigh);
+	sprintf(bench_msg, "%-20s %8u\r\n", name, (uint32_t)(sum / (BENCH_ROUNDS * BURST)));
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	osEvent evt;
+	uint64_t put_sum, get_sum;
+	uint32_t r, i, t0, t1;
+	int32_t n;
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_timer_init();
+	bench_q_id = osMessageCreate(osMessageQ(bench_q), NULL);
+	bench_mq_id = osMailCreate(osMailQ(bench_mq), NULL);
+
+	sprintf(bench_msg, "RTX batch benchmark, bursts of %u items [" BENCH_UNIT " per item]\r\n", BURST);
+	bench_print(bench_msg);
+	bench_print("test                      put      get\r\n");
+
+	/*MENSAJES*/
+	put_sum = get_sum = 0;
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		t0 = bench_now();
+		for(i = 0; i < BURST; i++){
+			osMessagePut(bench_q_id, next_value + i, 0);
+		}
+		t1 = bench_now();
+		for(i = 0; i < BURST; i++){
+			evt = osMessageGet(bench_q_id, 0);
+			item[i] = evt.value.v;
+		}
+		put_sum += t1 - t0;
+		get_sum += bench_now() - t1;
+		for(i = 0; i < BURST; i++){
+			item_check(item[i]);
+		}
+	}
+	bench_report("message put/get", put_sum, get_sum);
+
+	put_sum = get_sum = 0;
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		for(i = 0; i < BURST; i++){
+			item[i] = next_value + i;
+		}
+		t0 = bench_now();
+		if(os_message_put_batch(bench_q_id, item, BURST, 0) != BURST) check_errors++;
+		t1 = bench_now();
+		if(os_message_get_batch(bench_q_id, item, BURST, 0) != BURST) check_errors++;
+		put_sum += t1 - t0;
+		get_sum += bench_now() - t1;
+		for(i = 0; i < BURST; i++){
+			item_check(item[i]);
+		}
+	}
+	bench_report("message batch", put_sum, get_sum);
+
+	/*CORREO*/
+	put_sum = get_sum = 0;
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		for(i = 0; i < BURST; i++){
+			mail[i] = osMailAlloc(bench_mq_id, 0);
+			*(uint32_t *)mail[i] = next_value + i;
+		}
+		t0 = bench_now();
+		for(i = 0; i < BURST; i++){
+			osMailPut(bench_mq_id, mail[i]);
+		}
+		t1 = bench_now();
+		for(i = 0; i < BURST; i++){
+			evt = osMailGet(bench_mq_id, 0);
+			mail[i] = evt.value.p;
+		}
+		put_sum += t1 - t0;
+		get_sum += bench_now() - t1;
+		for(i = 0; i < BURST; i++){
+			item_check(*(uint32_t *)mail[i]);
+			osMailFree(bench_mq_id, mail[i]);
+		}
+	}
+	bench_report("mail put/get", put_sum, get_sum);
+
+	put_sum = get_sum = 0;
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		for(i = 0; i < BURST; i++){
+			mail[i] = osMailAlloc(bench_mq_id, 0);
+			*(uint32_t *)mail[i] = next_value + i;
+		}
+		t0 = bench_now();
+		if(os_mail_put_batch(bench_mq_id, mail, BURST) != BURST) check_errors++;
+		t1 = bench_now();
+		if(os_mail_get_batch(bench_mq_id, mail, BURST, 0) != BURST) check_errors++;
+		put_sum += t1 - t0;
+		get_sum += bench_now() - t1;
+		for(i = 0; i < BURST; i++){
+			item_check(*(uint32_t *)mail[i]);
+			osMailFree(bench_mq_id, mail[i]);
+		}
+	}
+	bench_report("mail batch", put_sum, get_sum);
+
+	/*DESPERTAR DE UN HILO*/
+	burst_run("burst wake-up", osThread(single_consumer), 0);
+	burst_run("burst wake-up batch", osThread(batch_consumer), 1);
+
+	/*LIMITES*/
+	for(i = 0; i < BURST; i++){
+		item[i] = next_value + i;
+	}
+	if(os_message_put_batch(bench_q_id, item, BURST / 2, 0) != BURST / 2) check_errors++;
+	n = os_message_put_batch(bench_q_id, &item[BURST / 2], BURST, 0);	// half of it fits
+	if(n != BURST / 2) check_errors++;
+	if(os_message_put_batch(bench_q_id, item, 1, 0) != 0) check_errors++;	// full
+	if(os_message_get_batch(bench_q_id, item, 2 * BURST, 0) != BURST) check_errors++;
+	for(i = 0; i < BURST; i++){
+		item_check(item[i]);
+	}
+	if(os_message_get_batch(bench_q_id, item, BURST, 1) != 0) check_errors++;	// empty, times out
+
+	/*EMISOR EN ESPERA*/
+	for(i = 0; i < BURST; i++){
+		item[i] = next_value + i;
+	}
+	os_message_put_batch(bench_q_id, item, BURST, 0);
+	osThreadCreate(osThread(full_sender), (void *)(next_value + BURST));
+	osDelay(2);					// sender blocks on the full queue
+	if(os_message_get_batch(bench_q_id, item, BURST / 4, 0) != BURST / 4) check_errors++;
+	for(i = 0; i < BURST / 4; i++){
+		item_check(item[i]);
+	}
+	osDelay(2);					// sender fills the freed entries
+	if(os_message_get_batch(bench_q_id, item, BURST, 0) != BURST) check_errors++;
+	for(i = 0; i < BURST; i++){
+		item_check(item[i]);
+	}
+	osDelay(2);
+	n = os_message_get_batch(bench_q_id, item, BURST, 0);
+	if(n != BURST / 4) check_errors++;
+	for(i = 0; i < (uint32_t)n; i++){
+		item_check(item[i]);
+	}
+	if(os_message_get_batch(NULL, item, BURST, 0) != -1) check_errors++;
+
+	failed = (check_errors != 0);
+	sprintf(bench_msg, "%s, %u errors\r\n", failed ? "FAILED" : "PASSED", check_errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osSignalWait(BENCH_DONE, osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,177 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Thread churn benchmark: main creates CHURN short-lived workers one after
+ * the other.
+ *
+ *   terminate             the worker is below main and main terminates it
+ *                         before it ever runs
+ *   run to exit           the worker is above main, runs at once and
+ *                         returns from its function
+ *
+ * Each test runs with no other thread and with RESIDENT threads created
+ * before, which hold the lowest thread table entries: a search for a free
+ * entry from the start of the table would take longer with them, the free
+ * map does not. Times are per create and terminate cycle (average of CHURN
+ * cycles). Checks: every worker ran, the worker always gets the same (lowest
+ * free) table index, and the ID of a terminated thread is refused. The target
+ * counts CPU cycles with the DWT cycle counter and prints on UART0; the host
+ * port (SRC/POSIX, "make bench BENCH=main_bench_churn.c") counts nanoseconds,
+ * prints on stdout and exits with 0 when the checks passed.
+ */
+
+#define CHURN			10000
+
+#if defined (__RTX_POSIX)
+#define RESIDENT		32
+#define BENCH_UNIT		"ns"
+#else
+#define RESIDENT		4		// OS_TASKCNT 7: main, residents and the worker
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+void resident_thread(void const *argument);
+void low_worker(void const *argument);
+void high_worker(void const *argument);
+
+osThreadDef(resident_thread, osPriorityLow, RESIDENT, 0);
+osThreadDef(low_worker, osPriorityBelowNormal, 1, 0);
+osThreadDef(high_worker, osPriorityRealtime, 1, 0);
+
+osThreadId main_id;
+osThreadId resident_id[RESIDENT];
+
+volatile uint32_t worker_runs, check_errors;
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Threads
+ *---------------------------------------------------------------------------*/
+void resident_thread(void const *argument){
+	osSignalWait(0x0001, osWaitForever);
+}
+
+void low_worker(void const *argument){
+	worker_runs++;				// never runs: terminated first
+}
+
+void high_worker(void const *argument){
+	worker_runs++;
+}
+
+/*----------------------------------------------------------------------------
+ *   CHURN create and terminate cycles, returns the time of one cycle
+ *---------------------------------------------------------------------------*/
+static uint32_t churn(uint32_t run){
+	osThreadId id;
+	uint32_t i, index = 0, t0, t1;
+
+	worker_runs = 0;
+	t0 = bench_now();
+	for(i = 0; i < CHURN; i++){
+		if(run){
+			id = osThreadCreate(osThread(high_worker), NULL);	// runs and exits
+		}
+		else{
+			id = osThreadCreate(osThread(low_worker), NULL);
+			if(i == 0) index = os_thread_get_index(id);
+			if(os_thread_get_index(id) != index) check_errors++;
+			osThreadTerminate(id);
+		}
+		if(id == NULL) check_errors++;
+	}
+	t1 = bench_now();
+
+	if(worker_runs != (run ? CHURN : 0)) check_errors++;
+	if(osThreadGetPriority(id) != osPriorityError) check_errors++;	// terminated
+	if(os_thread_get_index(id) != 0) check_errors++;
+
+	return (t1 - t0) / CHURN;
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t i, t_term[2], t_run[2];
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_timer_init();
+	bench_open();
+	bench_print("RTX thread churn benchmark\r\n");
+
+	/*SIN HILOS RESIDENTES*/
+	t_term[0] = churn(0);
+	t_run[0] = churn(1);
+
+	/*CON HILOS RESIDENTES*/
+	for(i = 0; i < RESIDENT; i++){
+		resident_id[i] = osThreadCreate(osThread(resident_thread), NULL);
+		if(resident_id[i] == NULL) check_errors++;
+	}
+	t_term[1] = churn(0);
+	t_run[1] = churn(1);
+	for(i = 0; i < RESIDENT; i++){
+		if(os_thread_get_by_index(os_thread_get_index(resident_id[i])) != resident_id[i]) check_errors++;
+		osThreadTerminate(resident_id[i]);
+	}
+
+	sprintf(bench_msg, "cycle [%s]    0 resident  %2u resident\r\n", BENCH_UNIT, RESIDENT);
+	bench_print(bench_msg);
+	sprintf(bench_msg, "terminate    %10u  %11u\r\n", t_term[0], t_term[1]);
+	bench_print(bench_msg);
+	sprintf(bench_msg, "run to exit  %10u  %11u\r\n", t_run[0], t_run[1]);
+	bench_print(bench_msg);
+
+	failed = (check_errors != 0);
+	sprintf(bench_msg, "%s, %u errors\r\n", failed ? "FAILED" : "PASSED", check_errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,319 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#include "core_posix.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Event group benchmark: WAITERS threads above main wait for the same event,
+ * main wakes all of them once per round.
+ *
+ *   signal wake-up        osSignalSet to every waiter, each call switches to
+ *                         the waiter and back to main
+ *   group wake-up         one os_group_set, the waiters run one after the
+ *                         other and main runs again after the last one
+ *
+ * Times are from the first call of main until the last waiter ran, per round
+ * and per waiter (average of BENCH_ROUNDS rounds). Checks: wait for all
+ * flags, flags cleared by the waiter that took them (one set wakes one
+ * consumer), timeout, delete of a group with a waiting thread, and flags set
+ * by a timer interrupt every ISR_PERIOD us for ISR_TIME ms. The target counts
+ * CPU cycles with the DWT cycle counter and prints on UART0; the host port
+ * (SRC/POSIX, "make bench BENCH=main_bench_group.c") counts nanoseconds,
+ * prints on stdout and exits with 0 when the checks passed.
+ */
+
+#define WAITERS			8
+#define BENCH_ROUNDS		500
+#define ISR_PERIOD		1000		// interrupt period [us]
+#define ISR_TIME		500		// check time [ms]
+
+#define WAKE_SIG		0x0001		// signal of the signal wake-up
+#define FLAG_A			0x00000100
+#define FLAG_B			0x80000000
+#define FLAG_TAKE		0x00010000	// taken by one consumer
+#define FLAG_ISR		0x00200000	// set by the interrupt
+
+#if defined (__RTX_POSIX)
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+void waiter_thread(void const *argument);
+void take_thread(void const *argument);
+void delete_thread(void const *argument);
+void isr_waiter(void const *argument);
+
+osThreadDef(waiter_thread, osPriorityAboveNormal, WAITERS, 0);
+osThreadDef(take_thread, osPriorityAboveNormal, 2, 0);
+osThreadDef(delete_thread, osPriorityAboveNormal, 1, 0);
+osThreadDef(isr_waiter, osPriorityAboveNormal, 1, 0);
+
+os_group_def(bench_grp);
+os_group_def(delete_grp);
+
+osThreadId main_id;
+os_group_id bench_grp_id, delete_grp_id;
+
+volatile uint32_t woken;		// waiters run in the round
+volatile uint32_t wake_end;		// time stamp of the last one
+volatile uint32_t taken, isr_count, isr_taken, check_errors;
+volatile osStatus delete_status;
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Waiter of the wake-up tests: argument 0 waits for a signal, 1 for the
+ *   flag of its round in the event group (FLAG_A and FLAG_B by turns)
+ *---------------------------------------------------------------------------*/
+void waiter_thread(void const *argument){
+	osEvent evt;
+	uint32_t round;
+
+	for(round = 0; ; round++){
+		if(argument == NULL){
+			evt = osSignalWait(WAKE_SIG, osWaitForever);
+		}
+		else{
+			evt = os_group_wait(bench_grp_id, (round & 1) ? FLAG_B : FLAG_A, 0, osWaitForever);
+		}
+		if(evt.status != osEventSignal) check_errors++;
+		if(++woken == WAITERS){
+			wake_end = bench_now();
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Consumer: takes FLAG_TAKE, one set wakes one of them
+ *---------------------------------------------------------------------------*/
+void take_thread(void const *argument){
+	osEvent evt;
+
+	while(1){
+		evt = os_group_wait(bench_grp_id, FLAG_TAKE, os_group_wait_clear, osWaitForever);
+		if(evt.status == osEventSignal && evt.value.signals == FLAG_TAKE){
+			taken++;
+		}
+		else{
+			check_errors++;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Waits on a group that main deletes
+ *---------------------------------------------------------------------------*/
+void delete_thread(void const *argument){
+	osEvent evt;
+
+	evt = os_group_wait(delete_grp_id, FLAG_A, 0, osWaitForever);
+	delete_status = evt.status;
+	osThreadTerminate(osThreadGetId());
+}
+
+/*----------------------------------------------------------------------------
+ *   Interrupt: sets FLAG_ISR, the waiter takes it
+ *---------------------------------------------------------------------------*/
+static void isr_set(void){
+	isr_count++;
+	if(os_group_set(bench_grp_id, FLAG_ISR) != osOK) check_errors++;
+}
+
+#if !defined (__RTX_POSIX)
+void TIMER0_IRQHandler(void){
+	LPC_TIM0->IR = 1;			// Clear the MR0 interrupt
+	isr_set();
+}
+#endif
+
+static void isr_timer(uint32_t period_us){
+#if defined (__RTX_POSIX)
+	os_host_irq(1, period_us, isr_set);		// IRQ 1 as TIMER0 on the LPC1768
+#else
+	if(period_us != 0){
+		LPC_SC->PCONP |= (1 << 1);		// Power TIMER0, PCLK = CCLK/4
+		LPC_TIM0->TCR = 2;
+		LPC_TIM0->MR0 = SystemCoreClock / 4 / 1000000 * period_us - 1;
+		LPC_TIM0->MCR = 3;			// Interrupt and reset on MR0
+		LPC_TIM0->TCR = 1;
+		NVIC_EnableIRQ(TIMER0_IRQn);
+	}
+	else{
+		LPC_TIM0->TCR = 0;
+		NVIC_DisableIRQ(TIMER0_IRQn);
+	}
+#endif
+}
+
+void isr_waiter(void const *argument){
+	osEvent evt;
+
+	while(1){
+		evt = os_group_wait(bench_grp_id, FLAG_ISR, os_group_wait_clear, osWaitForever);
+		if(evt.status == osEventSignal){
+			isr_taken++;
+		}
+		else{
+			check_errors++;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Wake all waiters BENCH_ROUNDS times, "group" selects the event group
+ *---------------------------------------------------------------------------*/
+static void wake_run(const char *name, uint32_t group){
+	osThreadId id[WAITERS];
+	uint64_t sum = 0;
+	uint32_t r, i, t0;
+
+	osThreadSetPriority(main_id, osPriorityNormal);	// below the waiters
+	os_group_clear(bench_grp_id, 0xFFFFFFFF);
+	for(i = 0; i < WAITERS; i++){
+		id[i] = osThreadCreate(osThread(waiter_thread), (void *)group);
+	}
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		woken = 0;
+		if(group){
+			os_group_clear(bench_grp_id, (r & 1) ? FLAG_A : FLAG_B);
+			t0 = bench_now();
+			os_group_set(bench_grp_id, (r & 1) ? FLAG_B : FLAG_A);
+		}
+		else{
+			t0 = bench_now();
+			for(i = 0; i < WAITERS; i++){
+				osSignalSet(id[i], WAKE_SIG);
+			}
+		}
+		if(woken != WAITERS) check_errors++;	// all ran before main
+		sum += wake_end - t0;
+	}
+	for(i = 0; i < WAITERS; i++){
+		osThreadTerminate(id[i]);
+	}
+	osThreadSetPriority(main_id, osPriorityHigh);
+	sprintf(bench_msg, "%-20s %8u %8u\r\n", name, (uint32_t)(sum / BENCH_ROUNDS),
+	        (uint32_t)(sum / (BENCH_ROUNDS * WAITERS)));
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	osThreadId id[2];
+	osEvent evt;
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_timer_init();
+	bench_grp_id = os_group_create(os_group(bench_grp), 0);
+	delete_grp_id = os_group_create(os_group(delete_grp), 0);
+	if(bench_grp_id == NULL || delete_grp_id == NULL) check_errors++;
+
+	sprintf(bench_msg, "RTX event group benchmark, %u waiters [" BENCH_UNIT "]\r\n", WAITERS);
+	bench_print(bench_msg);
+	bench_print("test                    round   waiter\r\n");
+
+	/*DESPERTAR DE TODOS LOS HILOS*/
+	wake_run("signal wake-up", 0);
+	wake_run("group wake-up", 1);
+
+	/*ESPERA DE TODOS LOS FLAGS*/
+	os_group_clear(bench_grp_id, 0xFFFFFFFF);
+	os_group_set(bench_grp_id, FLAG_A);
+	evt = os_group_wait(bench_grp_id, FLAG_A | FLAG_B, os_group_wait_all, 0);
+	if(evt.status != osOK) check_errors++;		// FLAG_B missing
+	evt = os_group_wait(bench_grp_id, FLAG_A | FLAG_B, 0, 0);
+	if(evt.status != osEventSignal || evt.value.signals != FLAG_A) check_errors++;
+	os_group_set(bench_grp_id, FLAG_B);
+	evt = os_group_wait(bench_grp_id, FLAG_A | FLAG_B, os_group_wait_all | os_group_wait_clear, 0);
+	if(evt.status != osEventSignal || (uint32_t)evt.value.signals != (FLAG_A | FLAG_B)) check_errors++;
+	if(os_group_get(bench_grp_id) != 0) check_errors++;
+	evt = os_group_wait(bench_grp_id, FLAG_A, 0, 2);
+	if(evt.status != osEventTimeout) check_errors++;
+	evt = os_group_wait(bench_grp_id, 0, 0, 0);
+	if(evt.status != osErrorParameter) check_errors++;
+
+	/*CONSUMIDORES*/
+	id[0] = osThreadCreate(osThread(take_thread), NULL);
+	id[1] = osThreadCreate(osThread(take_thread), NULL);
+	os_group_set(bench_grp_id, FLAG_TAKE);
+	osDelay(2);
+	if(taken != 1) check_errors++;			// taken by one of them
+	os_group_set(bench_grp_id, FLAG_TAKE);
+	osDelay(2);
+	if(taken != 2 || os_group_get(bench_grp_id) != 0) check_errors++;
+	osThreadTerminate(id[0]);
+	osThreadTerminate(id[1]);
+
+	/*BORRADO*/
+	delete_status = osOK;
+	osThreadCreate(osThread(delete_thread), NULL);
+	osDelay(2);
+	os_group_delete(delete_grp_id);
+	osDelay(2);
+	if(delete_status != osErrorResource) check_errors++;
+	if(os_group_set(delete_grp_id, FLAG_A) != osErrorParameter) check_errors++;
+
+	/*INTERRUPCIONES*/
+	id[0] = osThreadCreate(osThread(isr_waiter), NULL);
+	isr_timer(ISR_PERIOD);
+	osDelay(ISR_TIME);
+	isr_timer(0);
+	osDelay(2);
+	osThreadTerminate(id[0]);
+	if(isr_taken == 0 || isr_taken > isr_count) check_errors++;
+	sprintf(bench_msg, "interrupt sets %u, wake-ups %u\r\n", isr_count, isr_taken);
+	bench_print(bench_msg);
+
+	failed = (check_errors != 0);
+	sprintf(bench_msg, "%s, %u errors\r\n", failed ? "FAILED" : "PASSED", check_errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
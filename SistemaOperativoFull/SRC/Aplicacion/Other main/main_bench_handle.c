@@ -0,0 +1,245 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#include "rt_TypeDef.h"
+#include "rt_Handle.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Driver handle benchmark: the drivers validate every call with a handle
+ * from their open function instead of the thread ID of the caller.
+ *
+ *   thread ID lookup    the former check of every driver SVC: rt_tid2ptcb
+ *                       on the thread ID passed by the caller, then the
+ *                       task id compared with the owner record
+ *   handle lookup       rt_hnd_get: index, generation and driver in one
+ *                       compare of the handle word, then the owner
+ *   os_handle_check     the same check as a call from a thread (SVC)
+ *
+ * Times are the average of BENCH_CALLS calls. Both lookups cost about the
+ * same; the handle brings the check of the real caller and per-unit
+ * ownership, not speed. Before that a DEMO_DRV unit goes through open,
+ * give, share and close between main and a worker thread; every step
+ * checks who may use the handle, and a handle closed and opened again must
+ * leave the old copies invalid. A handle of a thread that terminates is
+ * closed with it: a new thread that gets the same task id must not pass
+ * the owner check, and the unit can be opened again. The target counts
+ * CPU cycles with the DWT cycle counter and prints on UART0; the host port
+ * (SRC/POSIX, "make bench BENCH=main_bench_handle.c") counts nanoseconds,
+ * prints on stdout and exits with 0 when all checks passed.
+ */
+
+#define DEMO_DRV		0x40		// driver id of the demo, above the drivers of the board
+#define STEP_SIG		0x01		// signal to the worker: next step
+
+#if defined (__RTX_POSIX)
+#define BENCH_CALLS		1000000
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_CALLS		10000
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+P_TCB rt_tid2ptcb (osThreadId thread_id);
+
+void worker_thread(void const *argument);
+void leaver_thread(void const *argument);
+void taker_thread(void const *argument);
+
+osThreadDef(worker_thread, osPriorityAboveNormal, 1, 0);
+osThreadDef(leaver_thread, osPriorityAboveNormal, 1, 0);
+osThreadDef(taker_thread, osPriorityAboveNormal, 1, 0);
+
+osThreadId main_id, worker_id;
+os_handle_t demo;			// handle passed between main and the worker
+volatile osStatus worker_status;	// result of the last worker step
+os_handle_t left;			// handle of a thread that terminated
+volatile int32_t leaver_index, taker_index;
+volatile osStatus taker_status;
+uint32_t check_errors;
+uint32_t demo_obj;
+char bench_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Worker: one step of the handle life per signal from main
+ *---------------------------------------------------------------------------*/
+void worker_thread(void const *argument){
+	uint32_t step = 0;
+
+	while(1){
+		osSignalWait(STEP_SIG, osWaitForever);
+		switch(step++){
+			case 0:				// owned by main
+			case 1:				// given to the worker
+				worker_status = os_handle_check(demo, DEMO_DRV);
+				break;
+			case 2:
+				worker_status = os_handle_share(demo);
+				break;
+			default:
+				worker_status = os_handle_close(demo, DEMO_DRV);
+				break;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Leaver: opens a unit and terminates without closing it
+ *---------------------------------------------------------------------------*/
+void leaver_thread(void const *argument){
+	leaver_index = os_thread_get_index(osThreadGetId());
+	left = os_handle_open(DEMO_DRV, 1, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ *   Taker: created after the leaver, gets its task id and tries its handle
+ *---------------------------------------------------------------------------*/
+void taker_thread(void const *argument){
+	taker_index = os_thread_get_index(osThreadGetId());
+	taker_status = os_handle_check(left, DEMO_DRV);
+}
+
+/*----------------------------------------------------------------------------
+ *   Run one worker step, compare its result and the check of main
+ *---------------------------------------------------------------------------*/
+static void step_expect(osStatus worker, osStatus main){
+	osSignalSet(worker_id, STEP_SIG);	// the worker is higher, runs now
+	if(worker_status != worker) check_errors++;
+	if(os_handle_check(demo, DEMO_DRV) != main) check_errors++;
+}
+
+/*----------------------------------------------------------------------------
+ *   Open, give, share and close between main and the worker
+ *---------------------------------------------------------------------------*/
+static void handle_life(void){
+	os_handle_t again;
+
+	demo = os_handle_open(DEMO_DRV, 0, &demo_obj);
+	if(demo == 0) check_errors++;
+	if(os_handle_open(DEMO_DRV, 0, NULL) != 0) check_errors++;	// unit is open
+	if(os_handle_check(demo, DEMO_DRV + 1) == osOK) check_errors++;	// other driver
+
+	step_expect(osErrorParameter, osOK);		// owned by main
+	if(os_handle_give(demo, worker_id) != osOK) check_errors++;
+	step_expect(osOK, osErrorParameter);		// given to the worker
+	step_expect(osOK, osOK);			// shared by the worker
+	step_expect(osOK, osErrorParameter);		// closed by the worker
+
+	/* The same entry opened again has a new generation */
+	again = os_handle_open(DEMO_DRV, 0, &demo_obj);
+	if((again == 0) || (again == demo)) check_errors++;
+	if((again & 0xFF) != (demo & 0xFF)) check_errors++;
+	if(os_handle_check(demo, DEMO_DRV) == osOK) check_errors++;
+	demo = again;
+
+	/* A terminated thread leaves no handle to the next owner of its id */
+	osThreadCreate(osThread(leaver_thread), NULL);	// higher, runs to its end now
+	osThreadCreate(osThread(taker_thread), NULL);
+	if((left == 0) || (taker_index != leaver_index)) check_errors++;
+	if(taker_status != osErrorParameter) check_errors++;
+	again = os_handle_open(DEMO_DRV, 1, NULL);
+	if(again == 0) check_errors++;
+	os_handle_close(again, DEMO_DRV);
+}
+
+static void bench_report(const char *name, uint32_t t0, uint32_t t1){
+	sprintf(bench_msg, "%-20s %8u\r\n", name, (t1 - t0) / (BENCH_CALLS / 1000));
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	P_TCB ptcb;
+	uint32_t i, t0, t1, hits;
+	uint8_t owner;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityNormal);
+	bench_open();
+	bench_timer_init();
+	worker_id = osThreadCreate(osThread(worker_thread), NULL);
+
+	/*PROPIEDAD DEL HANDLE*/
+	handle_life();
+
+	bench_print("RTX driver handle benchmark [" BENCH_UNIT " per 1000 calls]\r\n");
+
+	/*ANTIGUA COMPROBACION: ID DEL HILO*/
+	owner = ((P_TCB)rt_tid2ptcb(main_id))->task_id;
+	hits = 0;
+	t0 = bench_now();
+	for(i = 0; i < BENCH_CALLS; i++){
+		ptcb = rt_tid2ptcb(main_id);
+		if((ptcb != NULL) && (ptcb->task_id == owner)) hits++;
+	}
+	t1 = bench_now();
+	bench_report("thread ID lookup", t0, t1);
+	if(hits != BENCH_CALLS) check_errors++;
+
+	/*HANDLE*/
+	hits = 0;
+	t0 = bench_now();
+	for(i = 0; i < BENCH_CALLS; i++){
+		if(rt_hnd_get(demo, DEMO_DRV) != NULL) hits++;
+	}
+	t1 = bench_now();
+	bench_report("handle lookup", t0, t1);
+	if(hits != BENCH_CALLS) check_errors++;
+
+	hits = 0;
+	t0 = bench_now();
+	for(i = 0; i < BENCH_CALLS; i++){
+		if(os_handle_check(demo, DEMO_DRV) == osOK) hits++;
+	}
+	t1 = bench_now();
+	bench_report("os_handle_check", t0, t1);
+	if(hits != BENCH_CALLS) check_errors++;
+
+	sprintf(bench_msg, "%s, %u errors\r\n", check_errors ? "FAILED" : "PASSED", check_errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(check_errors != 0);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,374 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Kernel microbenchmarks: latency of the basic kernel primitives.
+ *
+ *   yield             osThreadYield between two threads of equal priority
+ *   semaphore         release/wait ping-pong between two threads (round trip)
+ *   mutex handoff     osMutexRelease until the waiting higher thread owns it
+ *   signal wake-up    osSignalSet until the waiting higher thread runs
+ *   message wake-up   osMessagePut until the waiting higher thread has it
+ *   mail wake-up      osMailAlloc + osMailPut until the higher thread has it
+ *   message put+get   both calls in one thread, no thread switch
+ *   mail cycle        osMailAlloc/Put/Get/Free in one thread
+ *   pool alloc+free   osPoolAlloc + osPoolFree in one thread
+ *
+ * Each test takes BENCH_SAMPLES samples and prints min, avg, percentiles and
+ * max. The target counts CPU cycles with the DWT cycle counter and prints on
+ * UART0; RTX_Conf_CM.c needs OS_MAINSTKSIZE >= 128 for the report. The host
+ * port (SRC/POSIX, "make bench BENCH=main_bench_kernel.c") counts
+ * nanoseconds of the monotonic clock and prints on stdout.
+ */
+
+#define BENCH_SAMPLES		1000
+#define BENCH_DONE		0x0100		// signal to main: samples complete
+#define BENCH_WAKE		0x0001		// signal to the higher thread
+
+#if defined (__RTX_POSIX)
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+void yield_thread(void const *argument);
+void ping_thread(void const *argument);
+void pong_thread(void const *argument);
+void mutex_low(void const *argument);
+void mutex_high(void const *argument);
+void signal_low(void const *argument);
+void signal_high(void const *argument);
+void message_low(void const *argument);
+void message_high(void const *argument);
+void mail_low(void const *argument);
+void mail_high(void const *argument);
+
+osThreadDef(yield_thread, osPriorityNormal, 2, 0);
+osThreadDef(ping_thread, osPriorityNormal, 1, 0);
+osThreadDef(pong_thread, osPriorityNormal, 1, 0);
+osThreadDef(mutex_low, osPriorityNormal, 1, 0);
+osThreadDef(mutex_high, osPriorityAboveNormal, 1, 0);
+osThreadDef(signal_low, osPriorityNormal, 1, 0);
+osThreadDef(signal_high, osPriorityAboveNormal, 1, 0);
+osThreadDef(message_low, osPriorityNormal, 1, 0);
+osThreadDef(message_high, osPriorityAboveNormal, 1, 0);
+osThreadDef(mail_low, osPriorityNormal, 1, 0);
+osThreadDef(mail_high, osPriorityAboveNormal, 1, 0);
+
+osSemaphoreDef(ping_sem);
+osSemaphoreDef(pong_sem);
+osMutexDef(bench_mutex);
+osMessageQDef(bench_q, 4, uint32_t);
+osMailQDef(bench_mq, 4, uint32_t);
+osPoolDef(bench_pool, 4, uint32_t);
+
+osThreadId main_id, high_id;
+osSemaphoreId ping_sem_id, pong_sem_id;
+osMutexId bench_mutex_id;
+osMessageQId bench_q_id;
+osMailQId bench_mq_id;
+osPoolId bench_pool_id;
+
+volatile uint32_t bench_stamp;		// time stamp taken just before the measured call
+volatile uint32_t bench_count;		// samples taken in current test
+uint32_t bench_samples[BENCH_SAMPLES];
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Store one sample, wake up main when the test is complete
+ *---------------------------------------------------------------------------*/
+static void bench_sample(uint32_t delta){
+	if(bench_count < BENCH_SAMPLES){
+		bench_samples[bench_count++] = delta;
+		if(bench_count == BENCH_SAMPLES){
+			osSignalSet(main_id, BENCH_DONE);	// main has highest priority: test ends here
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Yield: time from osThreadYield in one thread to the return in the other
+ *---------------------------------------------------------------------------*/
+void yield_thread(void const *argument){
+	uint32_t now;
+
+	while(1){
+		now = bench_now();
+		if(bench_stamp != 0){
+			bench_sample(now - bench_stamp);
+		}
+		bench_stamp = bench_now();
+		osThreadYield();
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Semaphore ping-pong: round trip of two release/wait pairs
+ *---------------------------------------------------------------------------*/
+void ping_thread(void const *argument){
+	uint32_t t0;
+
+	while(1){
+		t0 = bench_now();
+		osSemaphoreRelease(ping_sem_id);
+		osSemaphoreWait(pong_sem_id, osWaitForever);
+		bench_sample(bench_now() - t0);
+	}
+}
+
+void pong_thread(void const *argument){
+	while(1){
+		osSemaphoreWait(ping_sem_id, osWaitForever);
+		osSemaphoreRelease(pong_sem_id);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Mutex handoff: the higher thread blocks on the mutex owned by the lower
+ *   one, the time runs from the release until the higher thread owns it
+ *---------------------------------------------------------------------------*/
+void mutex_low(void const *argument){
+	while(1){
+		osMutexWait(bench_mutex_id, osWaitForever);
+		osSignalSet(high_id, BENCH_WAKE);		// high thread blocks on the mutex
+		bench_stamp = bench_now();
+		osMutexRelease(bench_mutex_id);
+	}
+}
+
+void mutex_high(void const *argument){
+	uint32_t delta;
+
+	while(1){
+		osSignalWait(BENCH_WAKE, osWaitForever);
+		osMutexWait(bench_mutex_id, osWaitForever);
+		delta = bench_now() - bench_stamp;
+		osMutexRelease(bench_mutex_id);
+		bench_sample(delta);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Signal wake-up: osSignalSet until the waiting higher thread runs
+ *---------------------------------------------------------------------------*/
+void signal_low(void const *argument){
+	while(1){
+		bench_stamp = bench_now();
+		osSignalSet(high_id, BENCH_WAKE);
+	}
+}
+
+void signal_high(void const *argument){
+	while(1){
+		osSignalWait(BENCH_WAKE, osWaitForever);
+		bench_sample(bench_now() - bench_stamp);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Message wake-up: osMessagePut until the waiting higher thread has it
+ *---------------------------------------------------------------------------*/
+void message_low(void const *argument){
+	uint32_t i = 0;
+
+	while(1){
+		bench_stamp = bench_now();
+		osMessagePut(bench_q_id, i++, osWaitForever);
+	}
+}
+
+void message_high(void const *argument){
+	while(1){
+		osMessageGet(bench_q_id, osWaitForever);
+		bench_sample(bench_now() - bench_stamp);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Mail wake-up: osMailAlloc + osMailPut until the higher thread has it
+ *---------------------------------------------------------------------------*/
+void mail_low(void const *argument){
+	uint32_t *mail;
+	uint32_t i = 0;
+
+	while(1){
+		bench_stamp = bench_now();
+		mail = osMailAlloc(bench_mq_id, osWaitForever);
+		*mail = i++;
+		osMailPut(bench_mq_id, mail);
+	}
+}
+
+void mail_high(void const *argument){
+	osEvent evt;
+	uint32_t delta;
+
+	while(1){
+		evt = osMailGet(bench_mq_id, osWaitForever);
+		delta = bench_now() - bench_stamp;
+		osMailFree(bench_mq_id, evt.value.p);
+		bench_sample(delta);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Sort the samples and print min/avg/percentiles/max of a test
+ *---------------------------------------------------------------------------*/
+static void bench_report(const char *name){
+	uint32_t i, j, v, n;
+	uint64_t sum;
+
+	osSignalClear(main_id, BENCH_DONE);		// also set by the tests run in main
+	n = bench_count;
+	if(n == 0){
+		sprintf(bench_msg, "%-18s no samples\r\n", name);
+		bench_print(bench_msg);
+		return;
+	}
+	/*ORDENACION POR INSERCION*/
+	sum = 0;
+	for(i = 0; i < n; i++){
+		v = bench_samples[i];
+		sum += v;
+		for(j = i; j > 0 && bench_samples[j-1] > v; j--){
+			bench_samples[j] = bench_samples[j-1];
+		}
+		bench_samples[j] = v;
+	}
+	sprintf(bench_msg, "%-18s %7u %7u %7u %7u %7u %7u\r\n", name,
+	        bench_samples[0], (uint32_t)(sum / n), bench_samples[n * 50 / 100],
+	        bench_samples[n * 90 / 100], bench_samples[n * 99 / 100], bench_samples[n - 1]);
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Run a two thread test: "high" is created first and waits, "low" drives it
+ *---------------------------------------------------------------------------*/
+static void bench_run(const char *name, const osThreadDef_t *low, const osThreadDef_t *high){
+	osThreadId low_id;
+
+	bench_stamp = 0;
+	bench_count = 0;
+	high_id = osThreadCreate(high, NULL);
+	low_id = osThreadCreate(low, NULL);
+	if((low_id != NULL) && (high_id != NULL)){
+		osSignalWait(BENCH_DONE, osWaitForever);
+	}
+	/*DESTRUCCION DE HILOS*/
+	osThreadTerminate(low_id);
+	osThreadTerminate(high_id);
+	bench_report(name);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	osEvent evt;
+	uint32_t i, t0, *mem;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_timer_init();
+	ping_sem_id = osSemaphoreCreate(osSemaphore(ping_sem), 0);
+	pong_sem_id = osSemaphoreCreate(osSemaphore(pong_sem), 0);
+	bench_mutex_id = osMutexCreate(osMutex(bench_mutex));
+	bench_q_id = osMessageCreate(osMessageQ(bench_q), NULL);
+	bench_mq_id = osMailCreate(osMailQ(bench_mq), NULL);
+	bench_pool_id = osPoolCreate(osPool(bench_pool));
+
+	bench_print("RTX kernel benchmark [" BENCH_UNIT "]\r\n");
+	bench_print("test                   min     avg     p50     p90     p99     max\r\n");
+
+	/*LECTURA DEL CONTADOR*/
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		t0 = bench_now();
+		bench_sample(bench_now() - t0);
+	}
+	bench_report("timer read");
+
+	/*DOS HILOS*/
+	bench_run("yield", osThread(yield_thread), osThread(yield_thread));
+	bench_run("semaphore rtt", osThread(ping_thread), osThread(pong_thread));
+	bench_run("mutex handoff", osThread(mutex_low), osThread(mutex_high));
+	bench_run("signal wake-up", osThread(signal_low), osThread(signal_high));
+	bench_run("message wake-up", osThread(message_low), osThread(message_high));
+	bench_run("mail wake-up", osThread(mail_low), osThread(mail_high));
+
+	/*UN HILO*/
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		t0 = bench_now();
+		osMessagePut(bench_q_id, i, 0);
+		osMessageGet(bench_q_id, 0);
+		bench_sample(bench_now() - t0);
+	}
+	bench_report("message put+get");
+
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		t0 = bench_now();
+		mem = osMailAlloc(bench_mq_id, 0);
+		osMailPut(bench_mq_id, mem);
+		evt = osMailGet(bench_mq_id, 0);
+		osMailFree(bench_mq_id, evt.value.p);
+		bench_sample(bench_now() - t0);
+	}
+	bench_report("mail cycle");
+
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		t0 = bench_now();
+		mem = osPoolAlloc(bench_pool_id);
+		osPoolFree(bench_pool_id, mem);
+		bench_sample(bench_now() - t0);
+	}
+	bench_report("pool alloc+free");
+
+#if defined (__RTX_POSIX)
+	exit(0);
+#endif
+	while(1){
+		osSignalWait(BENCH_DONE, osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,334 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Dynamic memory benchmark: replays randomized allocation traces on the
+ * kernel memory pool (rt_Memory.c, two-level segregated fit) and on a copy
+ * of the former first-fit list allocator, with the same pool size.
+ *
+ * A trace holds MEM_OPS operations on MEM_SLOTS slots: an empty slot gets a
+ * block of random size, a full slot is freed. The size mixes are
+ *
+ *   small    8..64 bytes
+ *   mixed    8..1024 bytes, mostly small
+ *   stacks   128..2048 bytes in steps of 8
+ *
+ * Every call is timed; the report gives average and maximum time of alloc
+ * and free, the failed allocations and, for the kernel pool, the peak usage
+ * and the fragmentation at the end of the trace (free memory that is not
+ * in the largest free block). Allocated blocks are filled and checked
+ * before they are freed, and the kernel pool must be one free block again
+ * when all blocks are freed. The target counts CPU cycles with the DWT cycle
+ * counter and prints on UART0 (RTX_Conf_CM.c needs OS_MAINSTKSIZE >= 128);
+ * the host port (SRC/POSIX, "make bench BENCH=main_bench_mem.c") counts
+ * nanoseconds, prints on stdout and exits with 0 when all checks passed.
+ */
+
+#if defined (__RTX_POSIX)
+#define MEM_POOL		0x10000		// pool size [bytes]
+#define MEM_SLOTS		256
+#define MEM_OPS			20000
+#define BENCH_UNIT		"ns"
+#else
+#define MEM_POOL		0x1000
+#define MEM_SLOTS		32
+#define MEM_OPS			2000
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+#define MEM_TRACES		3
+
+/* Kernel memory pool, see SRC/rt_Memory.h */
+typedef struct mem_info {
+	uint32_t size;
+	uint32_t used;
+	uint32_t max_used;
+	uint32_t max_free;
+	uint16_t blocks;
+	uint16_t frees;
+} MEMINFO;
+
+extern int   rt_init_mem (void *pool, uint32_t size);
+extern void *rt_alloc_mem (void *pool, uint32_t size);
+extern int   rt_free_mem (void *pool, void *mem);
+extern int   rt_info_mem (void *pool, MEMINFO *info);
+
+/* Results of one replay */
+typedef struct {
+	uint64_t alloc_sum, free_sum;
+	uint32_t alloc_max, free_max;
+	uint32_t allocs, frees, failed, errors;
+} replay_t;
+
+const char *trace_name[MEM_TRACES] = {"small", "mixed", "stacks"};
+
+osThreadId main_id;
+uint64_t mem_pool[MEM_POOL / 8];
+uint32_t mem_trace[MEM_OPS];			// slot, size << 16 (0: free)
+void *mem_slot[MEM_SLOTS];
+uint32_t mem_size[MEM_SLOTS];
+uint32_t rand_state;
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Former first-fit allocator: a list of the allocated blocks in address
+ *   order, alloc and free walk the list
+ *---------------------------------------------------------------------------*/
+typedef struct ff_mem {
+	struct ff_mem *next;
+	uint32_t len;
+} FF_MEMP;
+
+static int ff_init(void *pool, uint32_t size){
+	FF_MEMP *ptr = (FF_MEMP *)pool;
+
+	/* The end marker lies entirely inside the pool, not only its next link */
+	ptr->next = (FF_MEMP *)((uint8_t *)pool + size - sizeof(FF_MEMP));
+	ptr->next->next = NULL;
+	ptr->next->len = 0;
+	ptr->len = 0;
+	return 0;
+}
+
+static void *ff_alloc(void *pool, uint32_t size){
+	FF_MEMP *p_search, *p_new;
+	uint32_t hole_size;
+
+	size += sizeof(FF_MEMP);
+	size = (size + 7) & ~7;
+	p_search = (FF_MEMP *)pool;
+	while(1){
+		hole_size = (uint32_t)((uint8_t *)p_search->next - (uint8_t *)p_search) - p_search->len;
+		if(hole_size >= size) break;
+		p_search = p_search->next;
+		if(p_search->next == NULL) return NULL;
+	}
+	if(p_search->len == 0){
+		p_search->len = size;
+		return (uint8_t *)p_search + sizeof(FF_MEMP);
+	}
+	p_new = (FF_MEMP *)((uint8_t *)p_search + p_search->len);
+	p_new->next = p_search->next;
+	p_new->len = size;
+	p_search->next = p_new;
+	return (uint8_t *)p_new + sizeof(FF_MEMP);
+}
+
+static int ff_free(void *pool, void *mem){
+	FF_MEMP *p_search, *p_prev = NULL, *p_return;
+
+	p_return = (FF_MEMP *)((uint8_t *)mem - sizeof(FF_MEMP));
+	p_search = (FF_MEMP *)pool;
+	while(p_search != p_return){
+		p_prev = p_search;
+		p_search = p_search->next;
+		if(p_search == NULL) return 1;
+	}
+	if(p_prev == NULL){
+		p_search->len = 0;
+	}
+	else{
+		p_prev->next = p_search->next;
+	}
+	return 0;
+}
+
+/*----------------------------------------------------------------------------
+ *   Random trace: alternates between the slots, sizes by mix
+ *---------------------------------------------------------------------------*/
+static uint32_t bench_rand(void){
+	rand_state ^= rand_state << 13;		// xorshift32
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static uint32_t trace_size(uint32_t mix){
+	uint32_t r = bench_rand();
+
+	switch(mix){
+		case 0:
+			return 8 + r % 57;
+		case 1:
+			return ((r >> 16) % 8 == 0) ? 8 + r % 1017 : 8 + r % 121;
+		default:
+			return 128 + (r % 241) * 8;
+	}
+}
+
+static void trace_make(uint32_t mix){
+	uint32_t i, slot;
+
+	memset(mem_size, 0, sizeof(mem_size));
+	rand_state = 0x2545F491 + mix;
+	for(i = 0; i < MEM_OPS; i++){
+		slot = bench_rand() % MEM_SLOTS;
+		if(mem_size[slot] == 0){
+			mem_size[slot] = trace_size(mix);
+		}
+		else{
+			mem_size[slot] = 0;
+		}
+		mem_trace[i] = slot | (mem_size[slot] << 16);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Replay the trace on the kernel pool (kernel != 0) or on first-fit
+ *---------------------------------------------------------------------------*/
+static void trace_replay(int kernel, replay_t *r){
+	uint32_t i, slot, size, t0, dt;
+	void *p;
+
+	memset(r, 0, sizeof(*r));
+	memset(mem_slot, 0, sizeof(mem_slot));
+	if(kernel){
+		rt_init_mem(mem_pool, sizeof(mem_pool));
+	}
+	else{
+		ff_init(mem_pool, sizeof(mem_pool));
+	}
+	for(i = 0; i < MEM_OPS; i++){
+		slot = mem_trace[i] & 0xFFFF;
+		size = mem_trace[i] >> 16;
+		if(size != 0){
+			t0 = bench_now();
+			p = kernel ? rt_alloc_mem(mem_pool, size) : ff_alloc(mem_pool, size);
+			dt = bench_now() - t0;
+			r->alloc_sum += dt;
+			if(dt > r->alloc_max) r->alloc_max = dt;
+			r->allocs++;
+			if(p == NULL){
+				r->failed++;		// the trace frees the empty slot later
+				continue;
+			}
+			if(((uint32_t)(uint8_t *)p & 7) != 0) r->errors++;
+			memset(p, slot, size);
+			mem_slot[slot] = p;
+			mem_size[slot] = size;
+		}
+		else if(mem_slot[slot] != NULL){
+			p = mem_slot[slot];
+			for(size = 0; size < mem_size[slot]; size++){
+				if(((uint8_t *)p)[size] != (uint8_t)slot){
+					r->errors++;	// overwritten by another block
+					break;
+				}
+			}
+			t0 = bench_now();
+			if((kernel ? rt_free_mem(mem_pool, p) : ff_free(mem_pool, p)) != 0) r->errors++;
+			dt = bench_now() - t0;
+			r->free_sum += dt;
+			if(dt > r->free_max) r->free_max = dt;
+			r->frees++;
+			mem_slot[slot] = NULL;
+		}
+	}
+}
+
+static void replay_print(const char *trace, const char *alloc, replay_t *r){
+	sprintf(bench_msg, "%-7s %-10s %7u %7u %7u %7u %7u",
+	        trace, alloc, (uint32_t)(r->alloc_sum / (r->allocs ? r->allocs : 1)), r->alloc_max,
+	        (uint32_t)(r->free_sum / (r->frees ? r->frees : 1)), r->free_max, r->failed);
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	replay_t r;
+	MEMINFO info;
+	uint32_t mix, slot, free_bytes, frag, errors = 0;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_timer_init();
+
+	sprintf(bench_msg, "RTX memory pool benchmark, %u bytes, %u slots, %u operations, " BENCH_UNIT "\r\n",
+	        MEM_POOL, MEM_SLOTS, MEM_OPS);
+	bench_print(bench_msg);
+	bench_print("trace   allocator  alloc   max     free    max     failed  peak    frag%\r\n");
+
+	for(mix = 0; mix < MEM_TRACES; mix++){
+		trace_make(mix);
+
+		/*POOL DEL NUCLEO*/
+		trace_replay(1, &r);
+		rt_info_mem(mem_pool, &info);
+		free_bytes = info.size - info.used;
+		frag = (free_bytes != 0) ? 100 - (uint32_t)((uint64_t)info.max_free * 100 / free_bytes) : 0;
+		replay_print(trace_name[mix], "tlsf", &r);
+		sprintf(bench_msg, " %7u %5u\r\n", info.max_used, frag);
+		bench_print(bench_msg);
+		errors += r.errors;
+		if(info.blocks != r.allocs - r.failed - r.frees){
+			errors++;
+		}
+		/* Freeing the rest merges the pool back to one block */
+		for(slot = 0; slot < MEM_SLOTS; slot++){
+			if(mem_slot[slot] != NULL && rt_free_mem(mem_pool, mem_slot[slot]) != 0){
+				errors++;
+			}
+		}
+		rt_info_mem(mem_pool, &info);
+		if(info.used != 0 || info.frees != 1 || info.max_free != info.size - 8){
+			errors++;
+		}
+
+		/*PRIMER AJUSTE*/
+		trace_replay(0, &r);
+		replay_print(trace_name[mix], "first-fit", &r);
+		bench_print("\r\n");
+		errors += r.errors;
+	}
+
+	sprintf(bench_msg, "%s, %u errors\r\n", errors ? "FAILED" : "PASSED", errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(errors != 0);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,422 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#include "core_posix.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Queue benchmark: passes 16 byte telemetry records between threads with
+ * the mail queue pattern (osMailAlloc, copy, osMailPut / osMailGet, copy,
+ * osMailFree) and with a queue of inline payloads (os_queue_put /
+ * os_queue_get, one call and one copy each side).
+ *
+ *   mail cycle        alloc/copy/put/get/copy/free in one thread
+ *   queue put+get     os_queue_put + os_queue_get in one thread
+ *   mail wake-up      alloc/copy/put until the waiting higher thread has it
+ *   queue wake-up     os_queue_put until the waiting higher thread has it
+ *
+ * Then two checks of the queue: a higher producer puts twice as many records
+ * as fit in the queue and waits for free slots, the lower consumer must get
+ * all of them in order; a timer interrupt puts ISR_BURST records per period
+ * for ISR_TIME ms, none may be lost or damaged. The target counts CPU cycles
+ * with the DWT cycle counter, uses TIMER0 and prints on UART0 (RTX_Conf_CM.c
+ * needs OS_MAINSTKSIZE >= 128); the host port (SRC/POSIX, "make bench
+ * BENCH=main_bench_queue.c") counts nanoseconds, emulates the interrupt,
+ * prints on stdout and exits with 0 when the checks passed.
+ */
+
+#define BENCH_SAMPLES		1000
+#define BENCH_DONE		0x0100		// signal to main: samples complete
+#define QUEUE_SZ		8
+#define ISR_PERIOD		1000		// interrupt period [us]
+#define ISR_BURST		4		// records per interrupt
+#define ISR_TIME		1000		// check time [ms]
+
+#if defined (__RTX_POSIX)
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+typedef struct {
+	uint32_t stamp;
+	uint16_t id;
+	uint16_t seq;
+	int16_t value[4];
+} telemetry_t;
+
+void mail_low(void const *argument);
+void mail_high(void const *argument);
+void queue_low(void const *argument);
+void queue_high(void const *argument);
+void full_producer(void const *argument);
+void full_consumer(void const *argument);
+void isr_consumer(void const *argument);
+
+osThreadDef(mail_low, osPriorityNormal, 1, 0);
+osThreadDef(mail_high, osPriorityAboveNormal, 1, 0);
+osThreadDef(queue_low, osPriorityNormal, 1, 0);
+osThreadDef(queue_high, osPriorityAboveNormal, 1, 0);
+osThreadDef(full_producer, osPriorityAboveNormal, 1, 0);
+osThreadDef(full_consumer, osPriorityNormal, 1, 0);
+osThreadDef(isr_consumer, osPriorityAboveNormal, 1, 0);
+
+osMailQDef(bench_mq, QUEUE_SZ, telemetry_t);
+os_queue_def(bench_q, QUEUE_SZ, telemetry_t);
+os_queue_def(isr_q, 4 * ISR_BURST, telemetry_t);
+
+osThreadId main_id, high_id;
+osMailQId bench_mq_id;
+os_queue_id bench_q_id, isr_q_id;
+
+volatile uint32_t bench_stamp;		// time stamp taken just before the measured call
+volatile uint32_t bench_count;		// samples taken in current test
+uint32_t bench_samples[BENCH_SAMPLES];
+char bench_msg[128];
+
+/* Checks */
+volatile uint32_t full_taken, isr_count, isr_posted, isr_taken, check_errors;
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Records: contents follow from the sequence number
+ *---------------------------------------------------------------------------*/
+static void record_make(telemetry_t *rec, uint32_t seq){
+	rec->stamp = seq * 7;
+	rec->id = 0x5A;
+	rec->seq = (uint16_t)seq;
+	rec->value[0] = (int16_t)seq;
+	rec->value[1] = (int16_t)(seq ^ 0x1234);
+	rec->value[2] = (int16_t)-seq;
+	rec->value[3] = (int16_t)(seq >> 3);
+}
+
+static int record_check(const telemetry_t *rec, uint32_t seq){
+	telemetry_t ref;
+
+	record_make(&ref, seq);
+	return memcmp(rec, &ref, sizeof(ref)) == 0;
+}
+
+/*----------------------------------------------------------------------------
+ *   Store one sample, wake up main when the test is complete
+ *---------------------------------------------------------------------------*/
+static void bench_sample(uint32_t delta){
+	if(bench_count < BENCH_SAMPLES){
+		bench_samples[bench_count++] = delta;
+		if(bench_count == BENCH_SAMPLES){
+			osSignalSet(main_id, BENCH_DONE);	// main has highest priority: test ends here
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Mail wake-up: alloc, copy and put until the higher thread has a copy
+ *---------------------------------------------------------------------------*/
+void mail_low(void const *argument){
+	telemetry_t rec, *mail;
+	uint32_t i = 0;
+
+	while(1){
+		record_make(&rec, i++);
+		bench_stamp = bench_now();
+		mail = osMailAlloc(bench_mq_id, osWaitForever);
+		*mail = rec;
+		osMailPut(bench_mq_id, mail);
+	}
+}
+
+void mail_high(void const *argument){
+	telemetry_t rec;
+	osEvent evt;
+	uint32_t delta;
+
+	while(1){
+		evt = osMailGet(bench_mq_id, osWaitForever);
+		rec = *(telemetry_t *)evt.value.p;
+		osMailFree(bench_mq_id, evt.value.p);
+		delta = bench_now() - bench_stamp;
+		if(!record_check(&rec, rec.seq)) check_errors++;
+		bench_sample(delta);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Queue wake-up: put until the higher thread has a copy
+ *---------------------------------------------------------------------------*/
+void queue_low(void const *argument){
+	telemetry_t rec;
+	uint32_t i = 0;
+
+	while(1){
+		record_make(&rec, i++);
+		bench_stamp = bench_now();
+		os_queue_put(bench_q_id, &rec, osWaitForever);
+	}
+}
+
+void queue_high(void const *argument){
+	telemetry_t rec;
+	uint32_t delta;
+
+	while(1){
+		os_queue_get(bench_q_id, &rec, osWaitForever);
+		delta = bench_now() - bench_stamp;
+		if(!record_check(&rec, rec.seq)) check_errors++;
+		bench_sample(delta);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Full queue: the higher producer waits for the slots the consumer frees
+ *---------------------------------------------------------------------------*/
+void full_producer(void const *argument){
+	telemetry_t rec;
+	uint32_t i;
+
+	for(i = 0; i < 2 * QUEUE_SZ; i++){
+		record_make(&rec, i);
+		if(os_queue_put(bench_q_id, &rec, osWaitForever) != osOK) check_errors++;
+	}
+	osThreadTerminate(osThreadGetId());
+}
+
+void full_consumer(void const *argument){
+	telemetry_t rec;
+
+	while(full_taken < 2 * QUEUE_SZ){
+		if(os_queue_get(bench_q_id, &rec, 100) != osOK){
+			check_errors++;			// producer lost
+			break;
+		}
+		if(!record_check(&rec, full_taken)) check_errors++;
+		full_taken++;
+	}
+	osSignalSet(main_id, BENCH_DONE);
+	osThreadTerminate(osThreadGetId());
+}
+
+/*----------------------------------------------------------------------------
+ *   Interrupt: one burst of records per period
+ *---------------------------------------------------------------------------*/
+static void isr_put(void){
+	telemetry_t rec;
+	uint32_t i;
+
+	isr_count++;
+	for(i = 0; i < ISR_BURST; i++){
+		record_make(&rec, isr_posted);
+		if(os_queue_put(isr_q_id, &rec, 0) == osOK){
+			isr_posted++;
+		}
+		else{
+			check_errors++;			// queue full
+		}
+	}
+}
+
+#if !defined (__RTX_POSIX)
+void TIMER0_IRQHandler(void){
+	LPC_TIM0->IR = 1;			// Clear the MR0 interrupt
+	isr_put();
+}
+#endif
+
+static void isr_timer(uint32_t period_us){
+#if defined (__RTX_POSIX)
+	os_host_irq(1, period_us, isr_put);		// IRQ 1 as TIMER0 on the LPC1768
+#else
+	if(period_us != 0){
+		LPC_SC->PCONP |= (1 << 1);		// Power TIMER0, PCLK = CCLK/4
+		LPC_TIM0->TCR = 2;
+		LPC_TIM0->MR0 = SystemCoreClock / 4 / 1000000 * period_us - 1;
+		LPC_TIM0->MCR = 3;			// Interrupt and reset on MR0
+		LPC_TIM0->TCR = 1;
+		NVIC_EnableIRQ(TIMER0_IRQn);
+	}
+	else{
+		LPC_TIM0->TCR = 0;
+		NVIC_DisableIRQ(TIMER0_IRQn);
+	}
+#endif
+}
+
+void isr_consumer(void const *argument){
+	telemetry_t rec;
+
+	while(1){
+		if(os_queue_get(isr_q_id, &rec, osWaitForever) == osOK){
+			if(!record_check(&rec, isr_taken)) check_errors++;
+			isr_taken++;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Sort the samples and print min/avg/percentiles/max of a test
+ *---------------------------------------------------------------------------*/
+static void bench_report(const char *name){
+	uint32_t i, j, v, n;
+	uint64_t sum;
+
+	osSignalClear(main_id, BENCH_DONE);		// also set by the tests run in main
+	n = bench_count;
+	if(n == 0){
+		sprintf(bench_msg, "%-18s no samples\r\n", name);
+		bench_print(bench_msg);
+		return;
+	}
+	/*ORDENACION POR INSERCION*/
+	sum = 0;
+	for(i = 0; i < n; i++){
+		v = bench_samples[i];
+		sum += v;
+		for(j = i; j > 0 && bench_samples[j-1] > v; j--){
+			bench_samples[j] = bench_samples[j-1];
+		}
+		bench_samples[j] = v;
+	}
+	sprintf(bench_msg, "%-18s %7u %7u %7u %7u %7u %7u\r\n", name,
+	        bench_samples[0], (uint32_t)(sum / n), bench_samples[n * 50 / 100],
+	        bench_samples[n * 90 / 100], bench_samples[n * 99 / 100], bench_samples[n - 1]);
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Run a two thread test: "high" is created first and waits, "low" drives it
+ *---------------------------------------------------------------------------*/
+static void bench_run(const char *name, const osThreadDef_t *low, const osThreadDef_t *high){
+	osThreadId low_id;
+
+	bench_stamp = 0;
+	bench_count = 0;
+	high_id = osThreadCreate(high, NULL);
+	low_id = osThreadCreate(low, NULL);
+	if((low_id != NULL) && (high_id != NULL)){
+		osSignalWait(BENCH_DONE, osWaitForever);
+	}
+	/*DESTRUCCION DE HILOS*/
+	osThreadTerminate(low_id);
+	osThreadTerminate(high_id);
+	bench_report(name);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	telemetry_t rec, *mail;
+	osEvent evt;
+	osThreadId consumer_id;
+	uint32_t i, t0;
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_timer_init();
+	bench_mq_id = osMailCreate(osMailQ(bench_mq), NULL);
+	bench_q_id = os_queue_create(os_queue(bench_q));
+	isr_q_id = os_queue_create(os_queue(isr_q));
+
+	sprintf(bench_msg, "RTX queue benchmark, %u byte records [" BENCH_UNIT "]\r\n", (unsigned)sizeof(telemetry_t));
+	bench_print(bench_msg);
+	bench_print("test                   min     avg     p50     p90     p99     max\r\n");
+
+	/*UN HILO*/
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		record_make(&rec, i);
+		t0 = bench_now();
+		mail = osMailAlloc(bench_mq_id, 0);
+		*mail = rec;
+		osMailPut(bench_mq_id, mail);
+		evt = osMailGet(bench_mq_id, 0);
+		rec = *(telemetry_t *)evt.value.p;
+		osMailFree(bench_mq_id, evt.value.p);
+		bench_sample(bench_now() - t0);
+		if(!record_check(&rec, i)) check_errors++;
+	}
+	bench_report("mail cycle");
+
+	bench_count = 0;
+	for(i = 0; i < BENCH_SAMPLES; i++){
+		record_make(&rec, i);
+		t0 = bench_now();
+		os_queue_put(bench_q_id, &rec, 0);
+		os_queue_get(bench_q_id, &rec, 0);
+		bench_sample(bench_now() - t0);
+		if(!record_check(&rec, i)) check_errors++;
+	}
+	bench_report("queue put+get");
+
+	/*DOS HILOS*/
+	bench_run("mail wake-up", osThread(mail_low), osThread(mail_high));
+	bench_run("queue wake-up", osThread(queue_low), osThread(queue_high));
+
+	/*COLA LLENA*/
+	while(os_queue_get(bench_q_id, &rec, 0) == osOK){	// left by queue_low
+	}
+	osThreadCreate(osThread(full_consumer), NULL);
+	osThreadCreate(osThread(full_producer), NULL);
+	osSignalWait(BENCH_DONE, osWaitForever);
+	sprintf(bench_msg, "full queue: %u/%u records in order\r\n", full_taken, 2 * QUEUE_SZ);
+	bench_print(bench_msg);
+
+	/*INTERRUPCION*/
+	consumer_id = osThreadCreate(osThread(isr_consumer), NULL);
+	isr_timer(ISR_PERIOD);
+	osDelay(ISR_TIME);
+	isr_timer(0);
+	osDelay(10);
+	osThreadTerminate(consumer_id);
+	sprintf(bench_msg, "interrupt puts: %u interrupts, %u/%u records\r\n", isr_count, isr_taken, isr_posted);
+	bench_print(bench_msg);
+
+	failed = (check_errors != 0) || (full_taken != 2 * QUEUE_SZ) ||
+	         (isr_count == 0) || (isr_taken != isr_posted);
+	sprintf(bench_msg, "%s, %u errors\r\n", failed ? "FAILED" : "PASSED", check_errors);
+	bench_print(bench_msg);
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osSignalWait(BENCH_DONE, osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,108 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "LPC17xx.h"
+#include "string.h"
+#include "stdio.h"
+#include "uartn.h"
+
+/*
+ * Scheduler benchmark: measures the thread switch latency of osThreadYield
+ * with 2, 8 and 32 ready threads of the same priority. Every yield puts the
+ * running thread back into the ready list behind the other ones, so the cost
+ * of the ready list insert shows up directly in the result.
+ *
+ * RTX_Conf_CM.c needs OS_TASKCNT >= 34 (32 bench threads, main and the
+ * timer thread) for the 32 thread run. Results are printed on UART0 in
+ * CPU cycles (osKernelSysTick), including the cost of the two SVC calls.
+ */
+
+#define BENCH_MAX_THREADS	32
+#define BENCH_SWITCHES		4000
+
+void bench_thread(void const *argument);
+
+osThreadDef(bench_thread, osPriorityNormal, BENCH_MAX_THREADS, 0);
+
+osThreadId main_id;
+osThreadId bench_id[BENCH_MAX_THREADS];
+const uint32_t bench_runs[] = {2, 8, 32};
+
+volatile uint32_t bench_stamp;		// osKernelSysTick read just before yielding
+volatile uint32_t bench_count;		// switches measured in current run
+uint32_t bench_total, bench_min, bench_max;
+char bench_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Bench Thread
+ *---------------------------------------------------------------------------*/
+void bench_thread(void const *argument){
+	uint32_t now, delta;
+
+	while(1){
+		now = osKernelSysTick();
+		if(bench_stamp != 0){
+			delta = now - bench_stamp;
+			bench_total += delta;
+			if(delta < bench_min) bench_min = delta;
+			if(delta > bench_max) bench_max = delta;
+			if(++bench_count >= BENCH_SWITCHES){
+				osSignalSet(main_id, 0x01);		// main has higher priority: run ends here
+			}
+		}
+		bench_stamp = osKernelSysTick();
+		osThreadYield();
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t run, i, n;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityAboveNormal);
+	bench_open();
+	bench_print("RTX scheduler benchmark: osThreadYield latency [cycles]\r\n");
+
+	for(run = 0; run < sizeof(bench_runs)/sizeof(bench_runs[0]); run++){
+		n = bench_runs[run];
+		bench_stamp = 0;
+		bench_count = 0;
+		bench_total = 0;
+		bench_min = 0xFFFFFFFF;
+		bench_max = 0;
+
+		/*CREACION DE HILOS*/
+		for(i = 0; i < n; i++){
+			bench_id[i] = osThreadCreate(osThread(bench_thread), NULL);
+			if(bench_id[i] == NULL){
+				break;
+			}
+		}
+		if(i == n){
+			osSignalWait(0x01, osWaitForever);
+		}
+		/*DESTRUCCION DE HILOS*/
+		while(i > 0){
+			osThreadTerminate(bench_id[--i]);
+		}
+
+		if(bench_count < BENCH_SWITCHES){
+			sprintf(bench_msg, "%2u threads: not enough TCBs, raise OS_TASKCNT\r\n", n);
+		}
+		else{
+			sprintf(bench_msg, "%2u threads: avg %u min %u max %u\r\n",
+			        n, bench_total / bench_count, bench_min, bench_max);
+		}
+		bench_print(bench_msg);
+	}
+
+	while(1){
+		osSignalWait(0x01, osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
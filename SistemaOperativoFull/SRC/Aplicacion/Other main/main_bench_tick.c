@@ -0,0 +1,121 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "LPC17xx.h"
+#include "string.h"
+#include "stdio.h"
+#include "uartn.h"
+#include "easyweb.h"
+
+/*
+ * Tick benchmark: measures how long the CPU is taken away from a busy low
+ * priority thread, while the easyWEB stack is active and the board is
+ * flooded with pings from the host (e.g. "ping -f <board IP>" on Linux).
+ *
+ * The probe thread reads osKernelSysTick in a tight loop. Every gap larger
+ * than the loop itself is time spent in interrupts or higher priority
+ * threads. A gap that contains a tick boundary is charged to the SysTick
+ * handler, all other gaps to the EMAC interrupt and the network thread.
+ * Every 2 seconds the longest and average gaps of both kinds are printed on
+ * UART0 in CPU cycles.
+ *
+ * The wake thread, above the network thread, sleeps one tick at a time and
+ * measures how late after the tick boundary it runs: the tick latency seen
+ * by a real time thread. The stack runs in the network thread in thread
+ * mode, so under the flood this latency must stay at the idle value; when
+ * the stack ran in an SVC, the SysTick and PendSV waited for each frame.
+ * The tick gaps of the probe include the short run of the wake thread.
+ */
+
+#define PROBE_MIN_GAP		40		// loop jitter below this is not a gap [cycles]
+
+void probe_thread(void const *argument);
+void wake_thread(void const *argument);
+
+osThreadDef(probe_thread, osPriorityLow, 1, 0);
+osThreadDef(wake_thread, osPriorityHigh, 1, 0);
+
+osThreadId main_id;
+uint32_t tick_period;
+volatile uint32_t tick_max, tick_sum, tick_cnt;
+volatile uint32_t other_max, other_sum, other_cnt;
+volatile uint32_t wake_max, wake_sum, wake_cnt;
+char bench_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Probe Thread
+ *---------------------------------------------------------------------------*/
+void probe_thread(void const *argument){
+	uint32_t prev, now, gap;
+
+	prev = osKernelSysTick();
+	while(1){
+		now = osKernelSysTick();
+		gap = now - prev;
+		if(gap > PROBE_MIN_GAP){
+			if((now / tick_period) != (prev / tick_period)){
+				tick_sum += gap;
+				tick_cnt++;
+				if(gap > tick_max) tick_max = gap;
+			}
+			else{
+				other_sum += gap;
+				other_cnt++;
+				if(gap > other_max) other_max = gap;
+			}
+		}
+		prev = now;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Wake Thread
+ *---------------------------------------------------------------------------*/
+void wake_thread(void const *argument){
+	uint32_t late;
+
+	while(1){
+		osDelay(1);
+		late = osKernelSysTick() % tick_period;
+		wake_sum += late;
+		wake_cnt++;
+		if(late > wake_max) wake_max = late;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	struct OS_TETH config = {0};
+	os_handle_t eth;
+
+	main_id = osThreadGetId();
+	tick_period = osKernelSysTickMicroSec(1000);
+	bench_open();
+	bench_print("RTX tick benchmark: CPU time taken from a low priority thread [cycles]\r\n");
+
+	/*PILA TCP/IP ACTIVA, ESCUCHANDO EN EL PUERTO 80*/
+	eth = open_ethernet();
+	config.S_C = SERVER;
+	config.P_INT = 80;
+	connect_ethernet(eth, &config);
+
+	osThreadCreate(osThread(probe_thread), NULL);
+	osThreadCreate(osThread(wake_thread), NULL);
+
+	while(1){
+		osDelay(2000);
+		sprintf(bench_msg, "tick: max %5u avg %5u  other: max %5u avg %5u n %u  wake: max %5u avg %5u\r\n",
+		        tick_max, tick_cnt ? tick_sum / tick_cnt : 0,
+		        other_max, other_cnt ? other_sum / other_cnt : 0, other_cnt,
+		        wake_max, wake_cnt ? wake_sum / wake_cnt : 0);
+		tick_max = tick_sum = tick_cnt = 0;
+		other_max = other_sum = other_cnt = 0;
+		wake_max = wake_sum = wake_cnt = 0;
+		bench_print(bench_msg);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,178 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "LPC17xx.h"
+#include "string.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "uartn.h"
+#include "rt_TypeDef.h"
+#include "rt_Wheel.h"
+
+/*
+ * Timer benchmark: compares the sorted delta list used before for thread
+ * delays and osTimer timers with the hierarchical timing wheel (rt_Wheel.c).
+ * Both run on private instances, so the kernel delay and timer lists are not
+ * touched. For 8, 32 and 128 entries with random delays it measures:
+ *   insert - putting one entry (list: walk to its place, wheel: O(1))
+ *   cancel - removing one entry (list: O(1) unlink, wheel: O(1) unlink)
+ *   tick   - advancing one tick, including the expiry of due entries
+ * Results are printed on UART0 in CPU cycles (osKernelSysTick).
+ */
+
+#define BENCH_MAX_ENTRIES	128
+#define BENCH_ROUNDS		64
+#define BENCH_MAX_DELAY		1000
+
+typedef struct bench_dnode {				// Delta list entry (old scheme)
+	struct bench_dnode *next;
+	struct bench_dnode *prev;
+	uint16_t delta;
+} bench_dnode;
+
+bench_dnode bench_dhead;				// Delta list head: delta of first entry
+bench_dnode bench_dlist[BENCH_MAX_ENTRIES];
+struct OS_WNODE bench_wlist[BENCH_MAX_ENTRIES];
+struct OS_WHL bench_wheel;
+uint16_t bench_delay[BENCH_MAX_ENTRIES];
+const uint32_t bench_runs[] = {8, 32, 128};
+
+osThreadId main_id;
+char bench_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Delta list: insert, remove and tick as done by rt_put_dly/rt_dec_dly
+ *---------------------------------------------------------------------------*/
+static void dlist_put(bench_dnode *pn, uint32_t delay){
+	bench_dnode *p = &bench_dhead;
+	uint32_t delta = 0;
+
+	if(p->next != NULL) delta = p->delta;
+	while(p->next != NULL && delta < delay){
+		p = p->next;
+		delta += p->delta;
+	}
+	if(delta < delay){					// End of list
+		pn->next = NULL;
+		p->next = pn;
+		pn->prev = p;
+		p->delta = (uint16_t)(delay - delta);
+		pn->delta = 0;
+		return;
+	}
+	pn->next = p->next;
+	pn->prev = p;
+	p->next = pn;
+	if(pn->next != NULL) pn->next->prev = pn;
+	pn->delta = (uint16_t)(delta - delay);
+	p->delta -= pn->delta;
+}
+
+static void dlist_rmv(bench_dnode *pn){
+	bench_dnode *pb = pn->prev;
+
+	if(pb == NULL) return;
+	pb->next = pn->next;
+	if(pn->next != NULL){
+		pb->delta += pn->delta;
+		pn->next->prev = pb;
+	}
+	else{
+		pb->delta = 0;
+	}
+	pn->next = NULL;
+	pn->prev = NULL;
+}
+
+static uint32_t dlist_tick(void){
+	bench_dnode *p;
+	uint32_t n = 0;
+
+	if(bench_dhead.next == NULL) return 0;
+	bench_dhead.delta--;
+	while(bench_dhead.delta == 0 && (p = bench_dhead.next) != NULL){
+		bench_dhead.delta = p->delta;
+		bench_dhead.next = p->next;
+		if(p->next != NULL) p->next->prev = &bench_dhead;
+		p->next = NULL;
+		p->prev = NULL;
+		n++;
+	}
+	return n;
+}
+
+static uint32_t wheel_tick(void){
+	P_WNODE p;
+	uint32_t n = 0;
+
+	for(p = rt_whl_tick(&bench_wheel); p != NULL; p = p->next){
+		n++;
+	}
+	return n;
+}
+
+/*----------------------------------------------------------------------------
+ *   Run the benchmark with "n" entries, results in cycles per operation
+ *---------------------------------------------------------------------------*/
+static void bench_run(uint32_t n){
+	uint32_t r, i, t0;
+	uint32_t d_ins = 0, d_rmv = 0, d_tick = 0;
+	uint32_t w_ins = 0, w_rmv = 0, w_tick = 0;
+
+	memset(&bench_dhead, 0, sizeof(bench_dhead));
+	rt_whl_init(&bench_wheel);
+	for(r = 0; r < BENCH_ROUNDS; r++){
+		for(i = 0; i < n; i++){
+			bench_delay[i] = (uint16_t)(rand() % BENCH_MAX_DELAY + 1);
+		}
+		/* Insert */
+		t0 = osKernelSysTick();
+		for(i = 0; i < n; i++) dlist_put(&bench_dlist[i], bench_delay[i]);
+		d_ins += osKernelSysTick() - t0;
+		t0 = osKernelSysTick();
+		for(i = 0; i < n; i++) rt_whl_put(&bench_wheel, &bench_wlist[i], bench_delay[i]);
+		w_ins += osKernelSysTick() - t0;
+		/* Tick: run time forward by the mean delay */
+		t0 = osKernelSysTick();
+		for(i = 0; i < BENCH_MAX_DELAY / 2; i++) dlist_tick();
+		d_tick += osKernelSysTick() - t0;
+		t0 = osKernelSysTick();
+		for(i = 0; i < BENCH_MAX_DELAY / 2; i++) wheel_tick();
+		w_tick += osKernelSysTick() - t0;
+		/* Cancel the remaining entries */
+		t0 = osKernelSysTick();
+		for(i = 0; i < n; i++) dlist_rmv(&bench_dlist[i]);
+		d_rmv += osKernelSysTick() - t0;
+		t0 = osKernelSysTick();
+		for(i = 0; i < n; i++) rt_whl_rmv(&bench_wheel, &bench_wlist[i]);
+		w_rmv += osKernelSysTick() - t0;
+	}
+	sprintf(bench_msg, "%3u list:  insert %5u cancel %4u tick %4u\r\n", n,
+	        d_ins / (BENCH_ROUNDS * n), d_rmv / (BENCH_ROUNDS * n), d_tick / (BENCH_ROUNDS * BENCH_MAX_DELAY / 2));
+	bench_print(bench_msg);
+	sprintf(bench_msg, "%3u wheel: insert %5u cancel %4u tick %4u\r\n", n,
+	        w_ins / (BENCH_ROUNDS * n), w_rmv / (BENCH_ROUNDS * n), w_tick / (BENCH_ROUNDS * BENCH_MAX_DELAY / 2));
+	bench_print(bench_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t run;
+
+	main_id = osThreadGetId();
+	bench_open();
+	bench_print("RTX timer benchmark: delta list vs timing wheel [cycles/op]\r\n");
+
+	for(run = 0; run < sizeof(bench_runs)/sizeof(bench_runs[0]); run++){
+		bench_run(bench_runs[run]);
+	}
+
+	while(1){
+		osSignalWait(0x01, osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,142 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Earliest deadline first demo: two periodic control loops use 88% of the
+ * CPU, more than rate-monotonic priorities can schedule here (the bound for
+ * two threads is 83%):
+ *
+ *   loop  period  cost
+ *   fast   20 ms   9 ms
+ *   slow   30 ms  13 ms
+ *
+ * Each loop runs EDF_RUN ms twice: first with rate-monotonic fixed priorities
+ * (the periodic releases and the deadline accounting of os_edf_wait are kept,
+ * the priorities set back with osThreadSetPriority), then in the EDF class
+ * (OS_EDFPRIO in RTX_Conf_CM.c, disabled by default: set it to a level
+ * that is not a work queue lane). Main prints per loop and mode:
+ *
+ *   mode  loop  jobs  misses  late max
+ *
+ * With fixed priorities the slow loop misses deadlines; with EDF the 88% load
+ * is schedulable and misses come only from outside the kernel. The target
+ * prints on UART0; the host port (SRC/POSIX, "make bench BENCH=main_edf.c")
+ * prints on stdout and exits. There preemption of the process by the host
+ * costs misses in both loops, from a few up to dozens on a loaded machine.
+ */
+
+#define LOOPS			2
+#define EDF_RUN			2000		// run time of each mode [ms]
+
+typedef struct {
+	const char *name;
+	uint32_t period;			// [ms]
+	uint32_t cost;				// CPU time of a job [us]
+	osPriority rm_prio;			// rate-monotonic priority
+} loop_t;
+
+void loop_thread(void const *argument);
+
+osThreadDef(loop_thread, osPriorityNormal, LOOPS, 0);
+
+const loop_t loop_set[LOOPS] = {
+	{"fast", 20, 9000, osPriorityHigh},
+	{"slow", 30, 13000, osPriorityAboveNormal},
+};
+
+osThreadId main_id;
+osThreadId loop_id[LOOPS];
+char edf_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Busy for a CPU time: time the thread was preempted does not count
+ *---------------------------------------------------------------------------*/
+static void loop_work(uint32_t us){
+	uint32_t need, done = 0, last, now;
+
+	need = osKernelSysTickMicroSec(us);
+	last = osKernelSysTick();
+	while(done < need){
+		now = osKernelSysTick();
+		if(now - last < osKernelSysTickMicroSec(20)){
+			done += now - last;
+		}
+		last = now;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Control loop: one job per release
+ *---------------------------------------------------------------------------*/
+void loop_thread(void const *argument){
+	const loop_t *l = (const loop_t *)argument;
+
+	while(1){
+		loop_work(l->cost);
+		os_edf_wait();
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Run both loops in one mode and print their deadline statistics
+ *---------------------------------------------------------------------------*/
+static void edf_mode(uint32_t edf){
+	os_edf_stats_t st[LOOPS];
+	uint32_t i;
+
+	for(i = 0; i < LOOPS; i++){
+		loop_id[i] = osThreadCreate(osThread(loop_thread), (void *)&loop_set[i]);
+	}
+	for(i = 0; i < LOOPS; i++){
+		if(os_thread_set_edf(loop_id[i], loop_set[i].period, loop_set[i].period) != osOK){
+			bench_print("# no EDF class, set OS_EDFPRIO in RTX_Conf_CM.c\r\n");
+		}
+		if(!edf){
+			osThreadSetPriority(loop_id[i], loop_set[i].rm_prio);
+		}
+	}
+	osDelay(EDF_RUN);
+
+	for(i = 0; i < LOOPS; i++){
+		os_thread_get_edf(loop_id[i], &st[i]);
+		osThreadTerminate(loop_id[i]);
+	}
+	for(i = 0; i < LOOPS; i++){
+		sprintf(edf_msg, "%-4s  %-4s %5u %7u %6u ms\r\n", edf ? "EDF" : "RM", loop_set[i].name,
+		        st[i].jobs, st[i].misses, st[i].lateness_max);
+		bench_print(edf_msg);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityRealtime);
+	bench_open();
+	bench_print("RTX earliest deadline first\r\nmode  loop  jobs  misses  late max\r\n");
+
+	/*PRIORIDADES FIJAS Y EDF*/
+	edf_mode(0);
+	edf_mode(1);
+
+#if defined (__RTX_POSIX)
+	exit(0);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
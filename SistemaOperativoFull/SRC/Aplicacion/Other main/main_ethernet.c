@@ -43,35 +43,35 @@ osThreadDef(threadY, osPriorityNormal, 1, 0);
  *---------------------------------------------------------------------------*/
 int main (void){
 		int mensaje = 0;
-		P_TETH config;
+		struct OS_TETH config = {0};
+		os_handle_t eth;
 //P_TETH cf;
 	main_id = osThreadGetId();
-	config = open_ethernet(main_id);
+	eth = open_ethernet();
 	/*INICIALIZACION ESTRUCTURA*/
-	config->IP_1 = 192;
-	config->IP_2 = 168;
-	config->IP_3 = 1;
-	config->IP_4 = 135;
-	config->S_C = CLIENT;
-	config->P_EXT = 6000;
-	config->P_INT = 80;
-	config->n_con = 0;
+	config.IP_1 = 192;
+	config.IP_2 = 168;
+	config.IP_3 = 1;
+	config.IP_4 = 135;
+	config.S_C = CLIENT;
+	config.P_EXT = 6000;
+	config.P_INT = 80;
 	
 //threadX_id = osThreadCreate(osThread(threadX), NULL);
 threadY_id = osThreadCreate(osThread(threadY), NULL);
 	while(1){
-			connect_ethernet(config,main_id,0);
-			read_ethernet(mensaje_eth, main_id);
+			connect_ethernet(eth,&config);
+			read_ethernet(eth, mensaje_eth);
 			if(mensaje == 0){
-				write_ethernet("Conexion Placa 1\n",main_id);
+				write_ethernet(eth,"Conexion Placa 1\n");
 				mensaje++;
 				}
 			if(mensaje == 1){
-				write_ethernet("Mensaje 2",main_id);
+				write_ethernet(eth,"Mensaje 2");
 				mensaje++;
 				}
 			if(mensaje == 2){
-				write_ethernet("Mensaje 3",main_id);
+				write_ethernet(eth,"Mensaje 3");
 				mensaje++;
 				}
 				mensaje = 0;
@@ -5,6 +5,8 @@
 #include "LPC17xx.h"
 #include "stdlib.h"
 #include "FILE_OS.h"
+#include "uartn.h"
+#include "LOG_OS.h"
 
 /***********/
 /*VARIABLES*/
@@ -21,24 +23,24 @@ char file_text[] = "FILE_DIR IN A DIRECTORY CALLED CARPETA \r\n";
  *   Main Thread
  *---------------------------------------------------------------------------*/
 int main (void){
-	osThreadId file_id;
-	file_id = osThreadGetId();
-	open_file(file_id);
+	os_handle_t sd;
+	log_start(UART0, 115200); //los mensajes de FILE_OS salen por UART0, decodificados con log2txt
+	sd = open_file();
 	if(i_==1){
-	write_file(NEW_FILE, text, file, file_id);
-	write_file(MKDIR, 0, directory, file_id);
-	write_file(NEW_FILE, file_text, file_Dir, file_id);
-	read_file(READ_FILE, path, file, file_id);
-	read_file(READ_FILE, path, file_Dir, file_id);
-	read_file(SHOW_FILES,path,0,file_id);
-	read_file(SHOW_SIZE, path,0,file_id);
+	write_file(sd, NEW_FILE, text, file);
+	write_file(sd, MKDIR, 0, directory);
+	write_file(sd, NEW_FILE, file_text, file_Dir);
+	read_file(sd, READ_FILE, path, file);
+	read_file(sd, READ_FILE, path, file_Dir);
+	read_file(sd, SHOW_FILES,path,0);
+	read_file(sd, SHOW_SIZE, path,0);
 	}
 	else{
-		close_file(REMOVE, file_Dir, file_id);
-		close_file(REMOVE, directory, file_id);
-		close_file(REMOVE, file, file_id);
+		close_file(sd, REMOVE, file_Dir);
+		close_file(sd, REMOVE, directory);
+		close_file(sd, REMOVE, file);
 		
-		//read_file(SHOW_SIZE,path,0,file_id);
+		//read_file(sd, SHOW_SIZE,path,0);
 	}
 	while(1);
 }
@@ -0,0 +1,174 @@
+#include "cmsis_os.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "core_posix.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+#include "LOG_OS.h"
+
+/*
+ * Binary log demo: LOG_PRODUCERS threads and a timer interrupt log
+ * messages with os_log and os_log_str while the log is drained. Before
+ * that, main measures the cost of os_log against formatting the same
+ * message with snprintf, and logs the result too.
+ *
+ * Nothing is formatted on the target: the drain sends the records in
+ * binary and POSIX/log2txt.c turns them into text with the format strings
+ * of Aplicacion/Log/log_msgs.h. The target drains over UART0 with the
+ * thread of Log/LOG_OS.c (log_start) and needs OS_LOG = 1 in
+ * RTX_Conf_CM.c; the host port (SRC/POSIX, "make log") writes the stream
+ * to stdout and pipes it into log2txt.
+ */
+
+#define LOG_PRODUCERS		2
+#define LOG_TIME		50		// demo time [ms]
+#define LOG_IRQ_PERIOD		5000		// interrupt period [us]
+#define LOG_CALLS		256		// calls per measurement, fit in the ring
+#define LOG_REPS		16		// measurements
+
+void prod_thread(void const *argument);
+
+osThreadDef(prod_thread, osPriorityNormal, LOG_PRODUCERS, 0);
+
+osThreadId main_id;
+uint32_t log_buf[LOG_BATCH * 8];
+char log_text[64];
+volatile uint32_t irq_count;
+
+/*----------------------------------------------------------------------------
+ *   Producer: logs its count every tick
+ *---------------------------------------------------------------------------*/
+void prod_thread(void const *argument){
+	uint32_t id = (uint32_t)argument, i = 0, sum = 0;
+
+	while(1){
+		sum = sum * 31 + i;
+		os_log(LOG_DEMO_TICK, id, i++, sum, 0);
+		osDelay(1);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Interrupt: logs its number
+ *---------------------------------------------------------------------------*/
+static void log_irq(void){
+	os_log(LOG_DEMO_ISR, ++irq_count, 0, 0, 0);
+}
+
+#if !defined (__RTX_POSIX)
+void TIMER0_IRQHandler(void){
+	LPC_TIM0->IR = 1;			// Clear the MR0 interrupt
+	log_irq();
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ *   Start (period != 0) or stop the interrupt
+ *---------------------------------------------------------------------------*/
+static void log_timer(uint32_t period_us){
+#if defined (__RTX_POSIX)
+	os_host_irq(1, period_us, log_irq);		// IRQ 1 as TIMER0 on the LPC1768
+#else
+	if(period_us != 0){
+		LPC_SC->PCONP |= (1 << 1);		// Power TIMER0, PCLK = CCLK/4
+		LPC_TIM0->TCR = 2;
+		LPC_TIM0->MR0 = SystemCoreClock / 4 / 1000000 * period_us - 1;
+		LPC_TIM0->MCR = 3;			// Interrupt and reset on MR0
+		LPC_TIM0->TCR = 1;
+		NVIC_EnableIRQ(TIMER0_IRQn);
+	}
+	else{
+		LPC_TIM0->TCR = 0;
+		NVIC_DisableIRQ(TIMER0_IRQn);
+	}
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Send the records logged so far (the thread of LOG_OS.c on the target)
+ *---------------------------------------------------------------------------*/
+static void log_drain(void){
+#if defined (__RTX_POSIX)
+	uint32_t n;
+
+	while((n = os_log_read(log_buf, LOG_BATCH)) != 0){
+		fwrite(log_buf, 32, n, stdout);
+	}
+	fflush(stdout);
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Time LOG_CALLS calls of os_log and of snprintf, in ns per call
+ *---------------------------------------------------------------------------*/
+static void log_bench(void){
+	uint32_t r, i, t0, t_log = 0, t_fmt = 0;
+
+	for(r = 0; r < LOG_REPS; r++){
+		t0 = osKernelSysTick();
+		for(i = 0; i < LOG_CALLS; i++){
+			os_log(LOG_DEMO_TICK, 0, i, r, 0);
+		}
+		t_log += osKernelSysTick() - t0;
+		/*SE DESCARTA LO MEDIDO, NO SE MIDE EL VACIADO*/
+		while(os_log_read(log_buf, LOG_BATCH) != 0);
+
+		t0 = osKernelSysTick();
+		for(i = 0; i < LOG_CALLS; i++){
+			snprintf(log_text, sizeof(log_text), "producer %u: count %u, sum 0x%08x", 0, i, r);
+		}
+		t_fmt += osKernelSysTick() - t0;
+	}
+	os_log(LOG_DEMO_BENCH, LOG_CALLS * LOG_REPS,
+	       (uint32_t)((uint64_t)t_log * 1000000000 / osKernelSysTickFrequency / (LOG_CALLS * LOG_REPS)),
+	       (uint32_t)((uint64_t)t_fmt * 1000000000 / osKernelSysTickFrequency / (LOG_CALLS * LOG_REPS)), 0);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t i, t;
+
+	main_id = osThreadGetId();
+#if defined (__RTX_POSIX)
+	os_log_header(log_buf);
+	fwrite(log_buf, 32, 1, stdout);
+#else
+	log_start(UART0, 115200);
+#endif
+	log_bench();
+	os_log(LOG_DEMO_START, LOG_PRODUCERS, osKernelSysTickFrequency, 0, 0);
+	os_log_str(LOG_DEMO_TEXT, "strings are copied into the log, up to 80 characters");
+	log_drain();
+
+	/*CREACION DE HILOS*/
+	osThreadSetPriority(main_id, osPriorityLow);
+	for(i = 0; i < LOG_PRODUCERS; i++){
+		osThreadCreate(osThread(prod_thread), (void *)i);
+	}
+	log_timer(LOG_IRQ_PERIOD);
+
+	/*VACIADO, EN EL TARGET LO HACE EL HILO DE LOG_OS.c*/
+	for(t = 0; t < LOG_TIME; t += LOG_PERIOD){
+		osDelay(LOG_PERIOD);
+		log_drain();
+	}
+	log_timer(0);
+
+#if defined (__RTX_POSIX)
+	log_drain();
+	exit(0);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,129 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Round robin time slice demo: one throughput thread with a long slice and
+ * two interactive threads with the short slice of their priority level share
+ * osPriorityNormal, all three busy all the time. Every thread measures its
+ * own slices: a slice ends when the thread sees a gap in osKernelSysTick.
+ * Main prints once per ROBIN_PERIOD ms:
+ *
+ *   thread  slice  slices  mean  max
+ *
+ * slice is the time slice set [ticks] (os_thread_get_slice), mean and max
+ * the measured slice lengths [ticks]. Needs OS_ROBIN = 1 in RTX_Conf_CM.c;
+ * the host port (SRC/POSIX, "make bench BENCH=main_robin.c") prints
+ * ROBIN_REPORTS periods on stdout and exits. There the host also preempts
+ * the process now and then, which splits some slices in two.
+ */
+
+#define WORKERS			3
+#define ROBIN_PERIOD		1000		// report period [ms]
+#define ROBIN_REPORTS		2		// reports on the host port
+#define LONG_SLICE		20		// slice of the throughput thread [ticks]
+#define SHORT_SLICE		2		// slice of osPriorityNormal [ticks]
+#define SLICE_GAP		500		// gap that ends a slice [us]
+
+typedef struct {
+	uint32_t slices;			// slices measured in the period
+	uint32_t run;				// run time in the period [sys ticks]
+	uint32_t max;				// longest slice in the period [sys ticks]
+} slice_t;
+
+void work_thread(void const *argument);
+
+osThreadDef(work_thread, osPriorityNormal, WORKERS, 0);
+
+osThreadId main_id;
+osThreadId work_id[WORKERS];
+volatile slice_t work_slice[WORKERS];
+char robin_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Worker: busy, measures the slices it runs
+ *---------------------------------------------------------------------------*/
+void work_thread(void const *argument){
+	volatile slice_t *sl = &work_slice[(uint32_t)argument];
+	uint32_t start, last, now;
+
+	start = last = osKernelSysTick();
+	while(1){
+		now = osKernelSysTick();
+		if(now - last > osKernelSysTickMicroSec(SLICE_GAP)){
+			/* Preempted between last and now: the slice ended at last */
+			sl->slices++;
+			sl->run += last - start;
+			if(last - start > sl->max){
+				sl->max = last - start;
+			}
+			start = now;
+		}
+		last = now;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   One line per worker with the slices of the last period
+ *---------------------------------------------------------------------------*/
+static void robin_report(void){
+	uint32_t i, tick, mean;
+
+	tick = osKernelSysTickMicroSec(1000);		// 1 ms ticks
+	for(i = 0; i < WORKERS; i++){
+		mean = work_slice[i].slices ? work_slice[i].run / work_slice[i].slices : 0;
+		sprintf(robin_msg, "%-11s %5u %7u %3u.%u %4u\r\n", (i == 0) ? "throughput" : "interactive",
+		        os_thread_get_slice(work_id[i]), work_slice[i].slices,
+		        mean / tick, (mean % tick) * 10 / tick, (work_slice[i].max + tick / 2) / tick);
+		bench_print(robin_msg);
+		work_slice[i].slices = 0;
+		work_slice[i].run = 0;
+		work_slice[i].max = 0;
+	}
+	bench_print("\r\n");
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t i, n;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_print("RTX round robin time slices [ticks]\r\nthread      slice  slices  mean  max\r\n");
+
+	/*RODAJAS DE TIEMPO*/
+	if(os_priority_set_slice(osPriorityNormal, SHORT_SLICE) != osOK){
+		bench_print("# no round robin, set OS_ROBIN in RTX_Conf_CM.c\r\n");
+	}
+
+	/*CREACION DE HILOS*/
+	for(i = 0; i < WORKERS; i++){
+		work_id[i] = osThreadCreate(osThread(work_thread), (void *)i);
+	}
+	os_thread_set_slice(work_id[0], LONG_SLICE);
+
+	/*INFORMES PERIODICOS*/
+	for(n = 0; ; n++){
+#if defined (__RTX_POSIX)
+		if(n == ROBIN_REPORTS){
+			exit(0);
+		}
+#endif
+		osDelay(ROBIN_PERIOD);
+		robin_report();
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
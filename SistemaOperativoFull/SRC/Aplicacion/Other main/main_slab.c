@@ -0,0 +1,159 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Slab memory demo: two worker threads keep a changing set of blocks of
+ * random size from os_slab_alloc, a third thread takes records from a memory
+ * pool defined with os_pool_slab_def, whose limit of POOL_RECORDS blocks it
+ * tries to exceed. Main prints the use of every size class once per
+ * SLAB_PERIOD ms:
+ *
+ *   class  used  peak  pages  allocs  failures
+ *
+ * The peak of a class, rounded up to whole pages, is the memory it needs;
+ * the sum over the classes is the OS_SLABSZ of the application (drivers
+ * included). Before that, main frees one block twice: the second free
+ * must be refused, or the free list of the class would loop. The target
+ * prints on UART0; the host port (SRC/POSIX, "make bench
+ * BENCH=main_slab.c") prints SLAB_REPORTS periods on stdout and exits
+ * with 0 when the double free was refused.
+ */
+
+#define WORKERS			2
+#define WORK_BLOCKS		8		// blocks held per worker
+#define POOL_RECORDS		6
+#define SLAB_PERIOD		500		// report period [ms]
+#define SLAB_REPORTS		3		// reports on the host port
+
+typedef struct {
+	uint32_t stamp;
+	uint16_t id;
+	int16_t value[5];
+} record_t;
+
+void work_thread(void const *argument);
+void pool_thread(void const *argument);
+
+osThreadDef(work_thread, osPriorityNormal, WORKERS, 0);
+osThreadDef(pool_thread, osPriorityNormal, 1, 0);
+
+os_pool_slab_def(record_pool, POOL_RECORDS, record_t);
+
+osThreadId main_id;
+osPoolId record_pool_id;
+volatile uint32_t pool_refused;			// osPoolAlloc NULL at the limit
+uint32_t check_errors;
+char slab_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Worker: replaces one of its blocks by a block of random size per tick
+ *---------------------------------------------------------------------------*/
+void work_thread(void const *argument){
+	void *blk[WORK_BLOCKS] = {NULL};
+	uint32_t seed = (uint32_t)argument, i;
+
+	while(1){
+		seed = seed * 1103515245 + 12345;
+		i = (seed >> 16) % WORK_BLOCKS;
+		if(blk[i] != NULL){
+			os_slab_free(blk[i]);
+		}
+		blk[i] = os_slab_alloc(8 + (seed >> 8) % 120);
+		osDelay(1);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Pool user: takes one record more than the pool limit, then frees all
+ *---------------------------------------------------------------------------*/
+void pool_thread(void const *argument){
+	record_t *rec[POOL_RECORDS + 1];
+	uint32_t i;
+
+	while(1){
+		for(i = 0; i <= POOL_RECORDS; i++){
+			rec[i] = osPoolCAlloc(record_pool_id);
+			if(rec[i] == NULL){
+				pool_refused++;
+			}
+			osDelay(2);
+		}
+		for(i = 0; i <= POOL_RECORDS; i++){
+			if(rec[i] != NULL){
+				osPoolFree(record_pool_id, rec[i]);
+			}
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   One line per size class
+ *---------------------------------------------------------------------------*/
+static void slab_report(void){
+	os_slab_stats_t s;
+	uint32_t cls, pages = 0;
+
+	for(cls = 0; os_slab_get_stats(cls, &s) == osOK; cls++){
+		sprintf(slab_msg, "%5u %5u %5u %6u %7u %9u\r\n", s.block_size, s.used, s.max_used,
+		        s.pages, s.allocs, s.failures);
+		bench_print(slab_msg);
+		pages = s.free_pages;
+	}
+	if(cls == 0){
+		bench_print("# no slab memory, set OS_SLABSZ in RTX_Conf_CM.c\r\n");
+		return;
+	}
+	sprintf(slab_msg, "free pages %u, pool limit refused %u\r\n\r\n", pages, pool_refused);
+	bench_print(slab_msg);
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t i, n;
+	void *blk;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_print("RTX slab memory\r\nclass  used  peak  pages  allocs  failures\r\n");
+	record_pool_id = osPoolCreate(osPool(record_pool));
+
+	/*UN BLOQUE LIBERADO DOS VECES SE RECHAZA*/
+	blk = os_slab_alloc(24);
+	if(blk == NULL || os_slab_free(blk) != osOK) check_errors++;
+	if(os_slab_free(blk) == osOK){
+		check_errors++;
+		bench_print("# double free accepted\r\n");
+	}
+
+	/*CREACION DE HILOS*/
+	for(i = 0; i < WORKERS; i++){
+		osThreadCreate(osThread(work_thread), (void *)(i + 1));
+	}
+	osThreadCreate(osThread(pool_thread), NULL);
+
+	/*INFORMES PERIODICOS*/
+	for(n = 0; ; n++){
+#if defined (__RTX_POSIX)
+		if(n == SLAB_REPORTS){
+			exit(check_errors != 0);
+		}
+#endif
+		osDelay(SLAB_PERIOD);
+		slab_report();
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,149 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Stack use demo: threads with different osThreadDef stack sizes run a
+ * recursive function to a depth of their own, main prints the stack size and
+ * the peak stack use of every thread and of the idle demon:
+ *
+ *   thread  depth  size  peak  free
+ *
+ * The peak comes from os_thread_get_stack (OS_STKINIT in RTX_Conf_CM.c):
+ * the deepest stack word that no longer holds the fill pattern. Stacks of
+ * the threads with stacksz come from the stack memory, OS_PRIVCNT and
+ * OS_PRIVSTKSIZE must cover them (3 threads, 1536 bytes), or OS_STKPOOL
+ * takes every stack from there. The target prints on UART0; the host port
+ * (SRC/POSIX, "make bench BENCH=main_stack.c") reports the host stacks of
+ * the threads on stdout and exits.
+ */
+
+#define STACK_PERIOD		500		// report period [ms]
+#define STACK_REPORTS		2		// reports on the host port
+
+void small_thread(void const *argument);
+void large_thread(void const *argument);
+void default_thread(void const *argument);
+
+osThreadDef(small_thread, osPriorityNormal, 2, 256);
+osThreadDef(large_thread, osPriorityNormal, 1, 1024);
+osThreadDef(default_thread, osPriorityNormal, 1, 0);
+
+const uint32_t small_depth[2] = {1, 2};
+const uint32_t large_depth = 10;
+const uint32_t default_depth = 1;
+
+osThreadId main_id;
+osThreadId stack_id[5];				// last entry NULL: idle demon
+const uint32_t *stack_depth[5] = {&small_depth[0], &small_depth[1], &large_depth, &default_depth, NULL};
+char stack_msg[96];
+volatile uint32_t stack_seed[8];
+
+/*----------------------------------------------------------------------------
+ *   Recursion with a frame of 8 words per level, every level reads the frame
+ *   of its caller so that the frames stay on the stack
+ *---------------------------------------------------------------------------*/
+static uint32_t stack_dive(uint32_t depth, volatile uint32_t *up){
+	volatile uint32_t frame[8];
+	uint32_t i;
+
+	for(i = 0; i < 8; i++){
+		frame[i] = up[i] + depth;
+	}
+	if(depth == 0){
+		return frame[0];
+	}
+	return stack_dive(depth - 1, frame) + frame[7];
+}
+
+/*----------------------------------------------------------------------------
+ *   Threads: dive to their depth once per period
+ *---------------------------------------------------------------------------*/
+void small_thread(void const *argument){
+	while(1){
+		stack_dive(*(const uint32_t *)argument, stack_seed);
+		osDelay(STACK_PERIOD / 2);
+	}
+}
+
+void large_thread(void const *argument){
+	while(1){
+		stack_dive(*(const uint32_t *)argument, stack_seed);
+		osDelay(STACK_PERIOD / 2);
+	}
+}
+
+void default_thread(void const *argument){
+	while(1){
+		stack_dive(*(const uint32_t *)argument, stack_seed);
+		osDelay(STACK_PERIOD / 2);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   One line per thread
+ *---------------------------------------------------------------------------*/
+static void stack_report(void){
+	os_thread_stack_t st;
+	uint32_t i;
+
+	for(i = 0; i < 5; i++){
+		if((i < 4) && (stack_id[i] == NULL)){
+			bench_print("# thread not created, set OS_PRIVCNT and OS_PRIVSTKSIZE in RTX_Conf_CM.c\r\n");
+			continue;
+		}
+		if(os_thread_get_stack(stack_id[i], &st) != osOK){
+			bench_print("# no stack watermark, set OS_STKINIT in RTX_Conf_CM.c\r\n");
+			return;
+		}
+		if(stack_depth[i] != NULL){
+			sprintf(stack_msg, "%-7s %5u %5u %5u %5u\r\n", (i < 2) ? "small" : (i == 2) ? "large" : "default",
+			        *stack_depth[i], st.size, st.max_used, st.size - st.max_used);
+		}else{
+			sprintf(stack_msg, "%-7s %5s %5u %5u %5u\r\n", "idle", "-", st.size, st.max_used,
+			        st.size - st.max_used);
+		}
+		bench_print(stack_msg);
+	}
+	bench_print("\r\n");
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t n;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	bench_print("RTX thread stack use [bytes]\r\nthread  depth  size  peak  free\r\n");
+
+	/*CREACION DE HILOS*/
+	stack_id[0] = osThreadCreate(osThread(small_thread), (void *)&small_depth[0]);
+	stack_id[1] = osThreadCreate(osThread(small_thread), (void *)&small_depth[1]);
+	stack_id[2] = osThreadCreate(osThread(large_thread), (void *)&large_depth);
+	stack_id[3] = osThreadCreate(osThread(default_thread), (void *)&default_depth);
+
+	/*INFORMES PERIODICOS*/
+	for(n = 0; ; n++){
+#if defined (__RTX_POSIX)
+		if(n == STACK_REPORTS){
+			exit(0);
+		}
+#endif
+		osDelay(STACK_PERIOD);
+		stack_report();
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
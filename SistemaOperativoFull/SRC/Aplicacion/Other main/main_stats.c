@@ -0,0 +1,120 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Thread runtime statistics demo: three worker threads load the CPU with
+ * different duty cycles (busy for work_load ms out of every 10 ms) and main
+ * prints the CPU usage, switch count and ready to running latency of every
+ * thread and of the idle demon once per STATS_PERIOD ms:
+ *
+ *   thread  cpu%  switches  lat max  <256 <1k <4k <16k <64k <256k <1M >=1M
+ *
+ * Usage, switches and latency histogram of a period are the difference of
+ * two os_thread_get_stats readings, lat max is the longest since start.
+ * Needs OS_STATS = 1 (exact) or 2 (sampled) in RTX_Conf_CM.c; the host
+ * port (SRC/POSIX, "make bench BENCH=main_stats.c") prints STATS_REPORTS
+ * periods on stdout and exits.
+ */
+
+#define WORKERS			3
+#define STATS_PERIOD		1000		// report period [ms]
+#define STATS_REPORTS		3		// reports on the host port
+
+void work_thread(void const *argument);
+
+osThreadDef(work_thread, osPriorityNormal, WORKERS, 0);
+
+const uint32_t work_load[WORKERS] = {1, 3, 5};	// busy ms per 10 ms
+
+osThreadId main_id;
+osThreadId work_id[WORKERS + 1];		// last entry NULL: idle demon
+os_thread_stats_t stats_last[WORKERS + 1];
+char stats_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Worker: busy for its load, then sleeps the rest of the 10 ms
+ *---------------------------------------------------------------------------*/
+void work_thread(void const *argument){
+	uint32_t load = *(const uint32_t *)argument;
+	uint32_t t0;
+
+	while(1){
+		t0 = osKernelSysTick();
+		while(osKernelSysTick() - t0 < osKernelSysTickMicroSec(load * 1000)){
+		}
+		osDelay(10 - load);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   One line per thread with the values of the last period
+ *---------------------------------------------------------------------------*/
+static void stats_report(void){
+	os_thread_stats_t s;
+	uint32_t i, b, usage;
+	char *p;
+
+	for(i = 0; i <= WORKERS; i++){
+		if(os_thread_get_stats(work_id[i], &s) != osOK){
+			bench_print("# no statistics, set OS_STATS in RTX_Conf_CM.c\r\n");
+			return;
+		}
+		usage = (uint32_t)((s.run_time - stats_last[i].run_time) * 1000 /
+		                   (s.total_time - stats_last[i].total_time));
+		p = stats_msg;
+		p += sprintf(p, "%-6s %3u.%u %9u %8u ", (i < WORKERS) ? "worker" : "idle",
+		             usage / 10, usage % 10, s.switches - stats_last[i].switches, s.latency_max);
+		for(b = 0; b < 8; b++){
+			p += sprintf(p, " %5u", (uint16_t)(s.latency[b] - stats_last[i].latency[b]));
+		}
+		sprintf(p, "\r\n");
+		bench_print(stats_msg);
+		stats_last[i] = s;
+	}
+	bench_print("\r\n");
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t i, n;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	sprintf(stats_msg, "RTX thread statistics, latency in cycles at %u Hz\r\n",
+	        (uint32_t)osKernelSysTickFrequency);
+	bench_print(stats_msg);
+	bench_print("thread  cpu%  switches  lat max   <256   <1k   <4k  <16k  <64k <256k   <1M  >=1M\r\n");
+
+	/*CREACION DE HILOS*/
+	for(i = 0; i < WORKERS; i++){
+		work_id[i] = osThreadCreate(osThread(work_thread), (void *)&work_load[i]);
+		os_thread_get_stats(work_id[i], &stats_last[i]);
+	}
+	os_thread_get_stats(NULL, &stats_last[WORKERS]);
+
+	/*INFORMES PERIODICOS*/
+	for(n = 0; ; n++){
+#if defined (__RTX_POSIX)
+		if(n == STATS_REPORTS){
+			exit(0);
+		}
+#endif
+		osDelay(STATS_PERIOD);
+		stats_report();
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,189 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "core_posix.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * ISR post stress test: a 1 kHz timer interrupt posts STRESS_SEMS semaphore
+ * tokens, one signal and one message per interrupt, 10k posts per second,
+ * and every STRESS_STORM-th interrupt a storm of STRESS_STORM_SEMS tokens
+ * and signals. The storm alone is larger than the ISR FIFO (OS_FIFOSZ):
+ * the kernel merges signals per thread and tokens per semaphore, only the
+ * messages take a FIFO entry each, so no FIFO overflow error may occur.
+ *
+ * After STRESS_TIME ms main stops the interrupt and checks that every
+ * token and every message arrived and that all signal flags were seen.
+ * The target uses TIMER0 and prints on UART0; the host port (SRC/POSIX,
+ * "make bench BENCH=main_stress_isr.c") emulates the timer interrupt,
+ * prints on stdout and exits with 0 when the test passed.
+ */
+
+#define STRESS_PERIOD		1000		// interrupt period [us]
+#define STRESS_TIME		2000		// test time [ms]
+#define STRESS_SEMS		8		// tokens per interrupt
+#define STRESS_STORM		100		// interrupts between storms
+#define STRESS_STORM_SEMS	64		// tokens and signals per storm
+
+void sem_thread(void const *argument);
+void sig_thread(void const *argument);
+void msg_thread(void const *argument);
+
+osThreadDef(sem_thread, osPriorityAboveNormal, 1, 0);
+osThreadDef(sig_thread, osPriorityAboveNormal, 1, 0);
+osThreadDef(msg_thread, osPriorityNormal, 1, 0);
+
+osSemaphoreDef(stress_sem);
+osMessageQDef(stress_q, 16, uint32_t);
+
+osThreadId main_id, sig_id;
+osSemaphoreId stress_sem_id;
+osMessageQId stress_q_id;
+
+/* Counted by the interrupt */
+volatile uint32_t irq_count, sems_posted, msgs_posted, posts_failed;
+
+/* Counted by the threads */
+volatile uint32_t sems_taken, msgs_taken, msgs_lost, sig_wakeups, sig_seen;
+char stress_msg[96];
+
+/*----------------------------------------------------------------------------
+ *   Interrupt: the posts of one period
+ *---------------------------------------------------------------------------*/
+static void stress_irq(void){
+	uint32_t i, n;
+
+	n = ++irq_count;
+	for(i = 0; i < STRESS_SEMS; i++){
+		if(osSemaphoreRelease(stress_sem_id) == osOK) sems_posted++; else posts_failed++;
+	}
+	osSignalSet(sig_id, 1 << (n & 7));
+	if(osMessagePut(stress_q_id, n, 0) == osOK) msgs_posted++; else posts_failed++;
+
+	if(n % STRESS_STORM == 0){
+		/*TORMENTA*/
+		for(i = 0; i < STRESS_STORM_SEMS; i++){
+			if(osSemaphoreRelease(stress_sem_id) == osOK) sems_posted++; else posts_failed++;
+			osSignalSet(sig_id, 1 << (i & 7));
+		}
+	}
+}
+
+#if !defined (__RTX_POSIX)
+void TIMER0_IRQHandler(void){
+	LPC_TIM0->IR = 1;			// Clear the MR0 interrupt
+	stress_irq();
+}
+#endif
+
+/*----------------------------------------------------------------------------
+ *   Start (period != 0) or stop the interrupt
+ *---------------------------------------------------------------------------*/
+static void stress_timer(uint32_t period_us){
+#if defined (__RTX_POSIX)
+	os_host_irq(1, period_us, stress_irq);		// IRQ 1 as TIMER0 on the LPC1768
+#else
+	if(period_us != 0){
+		LPC_SC->PCONP |= (1 << 1);		// Power TIMER0, PCLK = CCLK/4
+		LPC_TIM0->TCR = 2;
+		LPC_TIM0->MR0 = SystemCoreClock / 4 / 1000000 * period_us - 1;
+		LPC_TIM0->MCR = 3;			// Interrupt and reset on MR0
+		LPC_TIM0->TCR = 1;
+		NVIC_EnableIRQ(TIMER0_IRQn);
+	}
+	else{
+		LPC_TIM0->TCR = 0;
+		NVIC_DisableIRQ(TIMER0_IRQn);
+	}
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Consumers
+ *---------------------------------------------------------------------------*/
+void sem_thread(void const *argument){
+	while(1){
+		if(osSemaphoreWait(stress_sem_id, osWaitForever) > 0){
+			sems_taken++;
+		}
+	}
+}
+
+void sig_thread(void const *argument){
+	osEvent evt;
+
+	while(1){
+		evt = osSignalWait(0, osWaitForever);
+		if(evt.status == osEventSignal){
+			sig_wakeups++;
+			sig_seen |= evt.value.signals;
+		}
+	}
+}
+
+void msg_thread(void const *argument){
+	osEvent evt;
+	uint32_t last = 0;
+
+	while(1){
+		evt = osMessageGet(stress_q_id, osWaitForever);
+		if(evt.status == osEventMessage){
+			msgs_taken++;
+			msgs_lost += evt.value.v - last - 1;
+			last = evt.value.v;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	stress_sem_id = osSemaphoreCreate(osSemaphore(stress_sem), 0);
+	stress_q_id = osMessageCreate(osMessageQ(stress_q), NULL);
+
+	/*CREACION DE HILOS*/
+	osThreadCreate(osThread(sem_thread), NULL);
+	sig_id = osThreadCreate(osThread(sig_thread), NULL);
+	osThreadCreate(osThread(msg_thread), NULL);
+
+	/*PRUEBA*/
+	bench_print("RTX ISR post stress test\r\n");
+	stress_timer(STRESS_PERIOD);
+	osDelay(STRESS_TIME);
+	stress_timer(0);
+	osDelay(10);
+
+	/*RESULTADOS*/
+	sprintf(stress_msg, "interrupts %u, posts/s %u\r\n", irq_count,
+	        (sems_posted + msgs_posted + irq_count + irq_count / STRESS_STORM * STRESS_STORM_SEMS) * 1000 / STRESS_TIME);
+	bench_print(stress_msg);
+	sprintf(stress_msg, "tokens %u/%u, messages %u/%u lost %u, signals 0x%02x in %u wake-ups\r\n",
+	        sems_taken, sems_posted, msgs_taken, msgs_posted, msgs_lost, sig_seen, sig_wakeups);
+	bench_print(stress_msg);
+	failed = (irq_count == 0) || (posts_failed != 0) || (sems_taken != sems_posted) ||
+	         (msgs_taken != msgs_posted) || (msgs_lost != 0) || (sig_seen != 0xFF);
+	bench_print(failed ? "FAILED\r\n" : "PASSED\r\n");
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -24,9 +24,10 @@ osThreadId threadY_id;
  *   Main Thread
  *---------------------------------------------------------------------------*/
 int main (void){
+	os_handle_t touch;
 	main_id = osThreadGetId();
-	open_touch(main_id);
+	touch = open_touch();
 	while(1){
-	write_touch(main_id);
+	write_touch(touch);
 	}
 }
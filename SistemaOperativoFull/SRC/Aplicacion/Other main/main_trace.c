@@ -0,0 +1,144 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Kernel event trace demo: a producer and a consumer thread exchange
+ * messages and share a mutex and a semaphore while the kernel records its
+ * events. Main captures TRACE_WINDOWS windows of TRACE_WINDOW ms each and
+ * streams the recorded events after every window, so that the dump itself
+ * is not traced.
+ *
+ * Output format, one line per event, all fields in hex:
+ *
+ *   # RTX trace <osKernelSysTickFrequency in decimal>
+ *   <sequence+1> <time stamp> <event | task id << 8 | par << 16> <arg>
+ *
+ * POSIX/trace2json.c converts it to the Chrome trace event format (open it
+ * in chrome://tracing or ui.perfetto.dev). The target prints on UART0 and
+ * needs OS_TRACE = 1 in RTX_Conf_CM.c; the host port (SRC/POSIX,
+ * "make bench BENCH=main_trace.c") prints on stdout.
+ */
+
+#define TRACE_WINDOWS		4
+#define TRACE_WINDOW		10		// capture time per window [ms]
+#define TRACE_LINES		4		// events per UART write
+
+void prod_thread(void const *argument);
+void cons_thread(void const *argument);
+
+osThreadDef(prod_thread, osPriorityNormal, 1, 0);
+osThreadDef(cons_thread, osPriorityAboveNormal, 1, 0);
+
+osMessageQDef(trace_q, 4, uint32_t);
+osMutexDef(trace_mutex);
+osSemaphoreDef(trace_sem);
+
+osThreadId main_id;
+osMessageQId trace_q_id;
+osMutexId trace_mutex_id;
+osSemaphoreId trace_sem_id;
+
+uint32_t trace_buf[TRACE_LINES * 4];
+char trace_msg[TRACE_LINES * 40];
+volatile uint32_t shared_count;
+
+/*----------------------------------------------------------------------------
+ *   Producer: sends a message every tick, then works on the shared counter
+ *---------------------------------------------------------------------------*/
+void prod_thread(void const *argument){
+	uint32_t i = 0;
+
+	while(1){
+		osMessagePut(trace_q_id, i, osWaitForever);
+		os_trace_user(1, i);
+		osMutexWait(trace_mutex_id, osWaitForever);
+		shared_count++;
+		osSemaphoreRelease(trace_sem_id);
+		osDelay(1);
+		osMutexRelease(trace_mutex_id);
+		i++;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Consumer: waits for the message, the semaphore and the mutex
+ *---------------------------------------------------------------------------*/
+void cons_thread(void const *argument){
+	osEvent evt;
+
+	while(1){
+		evt = osMessageGet(trace_q_id, osWaitForever);
+		osSemaphoreWait(trace_sem_id, osWaitForever);
+		osMutexWait(trace_mutex_id, osWaitForever);
+		shared_count += evt.value.v;
+		osMutexRelease(trace_mutex_id);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Stream all recorded events, TRACE_LINES per write
+ *---------------------------------------------------------------------------*/
+static void trace_dump(void){
+	uint32_t i, n;
+	char *p;
+
+	while((n = os_trace_read(trace_buf, TRACE_LINES)) != 0){
+		p = trace_msg;
+		for(i = 0; i < n; i++){
+			p += sprintf(p, "%08x %08x %08x %08x\r\n", trace_buf[4*i], trace_buf[4*i+1],
+			             trace_buf[4*i+2], trace_buf[4*i+3]);
+		}
+		bench_print(trace_msg);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	uint32_t w;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityHigh);
+	bench_open();
+	trace_q_id = osMessageCreate(osMessageQ(trace_q), NULL);
+	trace_mutex_id = osMutexCreate(osMutex(trace_mutex));
+	trace_sem_id = osSemaphoreCreate(osSemaphore(trace_sem), 0);
+
+	sprintf(trace_msg, "# RTX trace %u\r\n", (uint32_t)osKernelSysTickFrequency);
+	bench_print(trace_msg);
+
+	/*CREACION DE HILOS*/
+	osThreadCreate(osThread(cons_thread), NULL);
+	osThreadCreate(osThread(prod_thread), NULL);
+
+	/*CAPTURA Y VOLCADO*/
+	for(w = 0; w < TRACE_WINDOWS; w++){
+		if(os_trace_start() != osOK){
+			bench_print("# no trace buffer, set OS_TRACE in RTX_Conf_CM.c\r\n");
+			break;
+		}
+		osDelay(TRACE_WINDOW);
+		os_trace_stop();
+		trace_dump();
+	}
+
+#if defined (__RTX_POSIX)
+	exit(0);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -4,24 +4,21 @@
 #include "string.h"
 
 char buffer[] = "Quiero enviar un mensaje por el puerto serie\r\n";
-char buffer_rec[512];
-char aux[512];
-osThreadId main_id;
+char buffer_rec[64];
+os_handle_t uart0;
 
 int main(void){
-	main_id = osThreadGetId();
-	open(UART0, 115200, main_id);
-	write(UART0, buffer, main_id);
+	uint32_t n;
+	uart0 = open_uart(UART0, 115200);
+	/*EL MENSAJE SALE POR DMA, SE ESPERA A QUE EL BUFFER QUEDE LIBRE*/
+	if(write_uart_dma(uart0, buffer, strlen(buffer)) == osOK){
+		osSignalWait(UART_SIG_TX, osWaitForever);
+	}
 	
 	while(1){
-		read(UART0, buffer_rec, main_id);
-		
-		if(*buffer_rec != NULL){
-			if(strlen(aux) != strlen(buffer_rec))
-				write(UART0, buffer_rec, main_id);
-			memcpy(aux,buffer_rec,strlen(buffer_rec));
-			//memset(buffer_rec,0,strlen(buffer_rec));
-		}
+		/*ECO DE LO RECIBIDO: el hilo duerme hasta que llega algo*/
+		n = read_uart_wait(uart0, buffer_rec, sizeof(buffer_rec), osWaitForever);
+		write_uart_wait(uart0, buffer_rec, n, osWaitForever);
 	}
 }
 
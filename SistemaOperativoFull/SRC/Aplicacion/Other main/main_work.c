@@ -0,0 +1,234 @@
+#include "cmsis_os.h"
+#include "bench_io.h"
+#include "string.h"
+#include "stdio.h"
+#if defined (__RTX_POSIX)
+#include "stdlib.h"
+#include "time.h"
+#include "core_posix.h"
+#else
+#include "LPC17xx.h"
+#include "uartn.h"
+#endif
+
+/*
+ * Work queue demo: interrupt handlers and threads hand work to the lane
+ * threads of the kernel (OS_WORK in RTX_Conf_CM.c, 2 lanes) instead of
+ * doing it themselves.
+ *
+ *   interrupt work        a timer interrupt submits a coalescing item on
+ *                         lane 0 every ISR_PERIOD us: submits of a queued
+ *                         item are merged, the work runs once for them
+ *   counted work          main submits a counting item COUNT times, the
+ *                         work runs COUNT times
+ *   order                 items of one lane run in submit order, lane 0
+ *                         before lane 1
+ *   delayed work          a debounce restarted before it expired runs once,
+ *                         DEBOUNCE ms after the last submit; a cancelled
+ *                         delay does not run
+ *
+ * Main also times os_work_submit from a thread. The target counts CPU cycles
+ * with the DWT cycle counter and prints on UART0; the host port (SRC/POSIX,
+ * "make bench BENCH=main_work.c") counts nanoseconds, prints on stdout and
+ * exits with 0 when the checks passed.
+ */
+
+#define COUNT			100
+#define ISR_PERIOD		200		// interrupt period [us]
+#define ISR_TIME		500		// interrupt run time [ms]
+#define DEBOUNCE		50		// debounce delay [ms]
+
+#if defined (__RTX_POSIX)
+#define BENCH_UNIT		"ns"
+#else
+#define BENCH_UNIT		"cycles"
+#define DEMCR			(*((volatile uint32_t *)0xE000EDFC))
+#define DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT		(*((volatile uint32_t *)0xE0001004))
+#endif
+
+void isr_work(void const *argument);
+void count_work(void const *argument);
+void order_work(void const *argument);
+void debounce_work(void const *argument);
+
+os_work_def(isr_item, isr_work, 0, 1);
+os_work_def(count_item, count_work, 1, 0);
+os_work_def(order_a, order_work, 1, 1);
+os_work_def(order_b, order_work, 1, 1);
+os_work_def(order_c, order_work, 0, 1);
+os_work_def(debounce_item, debounce_work, 1, 1);
+
+osThreadId main_id;
+os_work_id isr_id, count_id, order_id[3], debounce_id;
+
+volatile uint32_t isr_count, isr_runs, count_runs, debounce_runs, check_errors;
+char order_log[8];
+volatile uint32_t order_len;
+char work_msg[128];
+
+/*----------------------------------------------------------------------------
+ *   Time stamp: CPU cycles on target, nanoseconds on host
+ *---------------------------------------------------------------------------*/
+static __inline uint32_t bench_now(void){
+#if defined (__RTX_POSIX)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#else
+	return DWT_CYCCNT;
+#endif
+}
+
+static void bench_timer_init(void){
+#if !defined (__RTX_POSIX)
+	DEMCR |= 0x01000000;			// TRCENA: enable DWT
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;				// CYCCNTENA
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Work functions, run by the lane threads
+ *---------------------------------------------------------------------------*/
+void isr_work(void const *argument){
+	isr_runs++;
+}
+
+void count_work(void const *argument){
+	count_runs++;
+}
+
+void order_work(void const *argument){
+	if(order_len < sizeof(order_log) - 1){
+		order_log[order_len++] = *(const char *)argument;
+	}
+}
+
+void debounce_work(void const *argument){
+	debounce_runs++;
+}
+
+/*----------------------------------------------------------------------------
+ *   Interrupt: defers its work to lane 0
+ *---------------------------------------------------------------------------*/
+static void isr_submit(void){
+	isr_count++;
+	if(os_work_submit(isr_id) != osOK) check_errors++;
+}
+
+#if !defined (__RTX_POSIX)
+void TIMER0_IRQHandler(void){
+	LPC_TIM0->IR = 1;			// Clear the MR0 interrupt
+	isr_submit();
+}
+#endif
+
+static void isr_timer(uint32_t period_us){
+#if defined (__RTX_POSIX)
+	os_host_irq(1, period_us, isr_submit);		// IRQ 1 as TIMER0 on the LPC1768
+#else
+	if(period_us != 0){
+		LPC_SC->PCONP |= (1 << 1);		// Power TIMER0, PCLK = CCLK/4
+		LPC_TIM0->TCR = 2;
+		LPC_TIM0->MR0 = SystemCoreClock / 4 / 1000000 * period_us - 1;
+		LPC_TIM0->MCR = 3;			// Interrupt and reset on MR0
+		LPC_TIM0->TCR = 1;
+		NVIC_EnableIRQ(TIMER0_IRQn);
+	}
+	else{
+		LPC_TIM0->TCR = 0;
+		NVIC_DisableIRQ(TIMER0_IRQn);
+	}
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	os_work_stats_t st;
+	uint32_t i, t0, t1;
+	int failed;
+
+	main_id = osThreadGetId();
+	osThreadSetPriority(main_id, osPriorityRealtime);
+	bench_timer_init();
+	bench_open();
+	bench_print("RTX work queues\r\n");
+
+	isr_id = os_work_create(os_work(isr_item), NULL);
+	count_id = os_work_create(os_work(count_item), NULL);
+	order_id[0] = os_work_create(os_work(order_a), "a");
+	order_id[1] = os_work_create(os_work(order_b), "b");
+	order_id[2] = os_work_create(os_work(order_c), "c");
+	debounce_id = os_work_create(os_work(debounce_item), NULL);
+	if(isr_id == NULL || count_id == NULL || order_id[2] == NULL || debounce_id == NULL){
+		bench_print("# no work queues, set OS_WORK in RTX_Conf_CM.c\r\n");
+		check_errors++;
+	}
+
+	/*TRABAJO CONTADO: main corre por encima de los carriles*/
+	t0 = bench_now();
+	for(i = 0; i < COUNT; i++){
+		os_work_submit(count_id);
+	}
+	t1 = bench_now();
+	osDelay(2);
+	if(count_runs != COUNT) check_errors++;
+	sprintf(work_msg, "thread submit %u %s, counted runs %u of %u\r\n",
+	        (t1 - t0) / COUNT, BENCH_UNIT, count_runs, COUNT);
+	bench_print(work_msg);
+
+	/*ORDEN: carril 1 en orden de envio, carril 0 antes*/
+	os_work_submit(order_id[0]);
+	os_work_submit(order_id[1]);
+	os_work_submit(order_id[0]);		// queued: merged
+	os_work_submit(order_id[2]);
+	osDelay(2);
+	if(strcmp(order_log, "cab") != 0) check_errors++;
+	sprintf(work_msg, "run order %s\r\n", order_log);
+	bench_print(work_msg);
+
+	/*INTERRUPCIONES*/
+	isr_timer(ISR_PERIOD);
+	osDelay(ISR_TIME);
+	isr_timer(0);
+	osDelay(2);
+	os_work_get_stats(isr_id, &st);
+	if(isr_runs == 0 || isr_runs > isr_count || st.submits != isr_count || st.runs != isr_runs) check_errors++;
+	sprintf(work_msg, "interrupt submits %u, runs %u\r\n", st.submits, st.runs);
+	bench_print(work_msg);
+
+	/*TRABAJO DIFERIDO*/
+	os_work_submit_delayed(debounce_id, DEBOUNCE);
+	osDelay(DEBOUNCE / 2);
+	os_work_submit_delayed(debounce_id, DEBOUNCE);	// restarts the delay
+	osDelay(DEBOUNCE / 2 + DEBOUNCE / 4);
+	if(debounce_runs != 0) check_errors++;
+	osDelay(DEBOUNCE / 2);
+	if(debounce_runs != 1) check_errors++;
+	os_work_submit_delayed(debounce_id, DEBOUNCE);
+	if(os_work_cancel(debounce_id) != osOK) check_errors++;
+	if(os_work_cancel(debounce_id) != osErrorResource) check_errors++;
+	osDelay(2 * DEBOUNCE);
+	if(debounce_runs != 1) check_errors++;
+	sprintf(work_msg, "debounce runs %u\r\n", debounce_runs);
+	bench_print(work_msg);
+
+	failed = (check_errors != 0);
+	sprintf(work_msg, "%s, %u errors\r\n", failed ? "FAILED" : "PASSED", check_errors);
+	bench_print(work_msg);
+
+#if defined (__RTX_POSIX)
+	exit(failed);
+#endif
+	while(1){
+		osDelay(osWaitForever);
+	}
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -33,6 +33,7 @@
  *---------------------------------------------------------------------------*/
 
 #include "cmsis_os.h"
+#include "LPC17xx.h"
 
 
 /*----------------------------------------------------------------------------
@@ -48,7 +49,7 @@
 //   <i> Defines max. number of threads that will run at the same time.
 //   <i> Default: 6
 #ifndef OS_TASKCNT
- #define OS_TASKCNT     6
+ #define OS_TASKCNT     7
 #endif
 
 //   <o>Default Thread stack size [bytes] <64-4096:8><#/4>
@@ -72,13 +73,22 @@
  #define OS_PRIVCNT     0
 #endif
 
-//   <o>Total stack size [bytes] for threads with user-provided stack size <0-4096:8><#/4>
+//   <o>Total stack size [bytes] for threads with user-provided stack size <0-16384:8><#/4>
 //   <i> Defines the combined stack size for threads with user-provided stack size.
+//   <i> With the stack memory pool: combined stack size of all threads but main.
 //   <i> Default: 0
 #ifndef OS_PRIVSTKSIZE
  #define OS_PRIVSTKSIZE 0
 #endif
 
+// <q>Default stacks from the stack memory pool
+// <i> Threads with osThreadDef stacksz = 0 take the default stack size from the
+// <i> memory for user-provided stacks instead of a fixed stack reserved per thread,
+// <i> so every thread only takes its own size. Size the memory with the stack peaks.
+#ifndef OS_STKPOOL
+ #define OS_STKPOOL     0
+#endif
+
 // <q>Check for stack overflow
 // <i> Includes the stack checking code for stack overflow.
 // <i> Note that additional code reduces the Kernel performance.
@@ -86,6 +96,14 @@
  #define OS_STKCHECK    1
 #endif
 
+// <q>Stack usage watermark
+// <i> Fills the thread stacks with a pattern when the threads are created,
+// <i> os_thread_get_stack then reports the peak stack use of every thread.
+// <i> Note that this increases the execution time of osThreadCreate.
+#ifndef OS_STKINIT
+ #define OS_STKINIT     1
+#endif
+
 // <o>Processor mode for thread execution 
 //   <0=> Unprivileged mode 
 //   <1=> Privileged mode
@@ -118,6 +136,14 @@
  #define OS_TICK        1000
 #endif
 
+//   <q>Tickless idle
+//   <i> Stops the periodic timer tick while no thread is ready to run
+//   <i> and sleeps until the next thread delay or timer expires.
+//   <i> Default: 0  (disabled)
+#ifndef OS_TICKLESS
+ #define OS_TICKLESS    0
+#endif
+
 // </h>
 
 // <h>System Configuration
@@ -133,6 +159,8 @@
 
 //   <o>Round-Robin Timeout [ticks] <1-1000>
 //   <i> Defines how long a thread will execute before a thread switch.
+//   <i> os_thread_set_slice and os_priority_set_slice override it per thread
+//   <i> and per priority level.
 //   <i> Default: 5
 #ifndef OS_ROBINTOUT
  #define OS_ROBINTOUT   5
@@ -144,7 +172,7 @@
 // ==============
 //   <i> Enables user Timers
 #ifndef OS_TIMERS
- #define OS_TIMERS      0
+ #define OS_TIMERS      1
 #endif
 
 //   <o>Timer Thread Priority
@@ -174,6 +202,42 @@
 
 // </e>
 
+// <e>Work Queues
+// ==============
+//   <i> Enables work queues: lane threads that run work items submitted
+//   <i> by threads, interrupt handlers or after a delay (os_work_submit).
+#ifndef OS_WORK
+ #define OS_WORK        1
+#endif
+
+//   <o>Number of lanes <1-4>
+//   <i> Each lane has its own worker thread, lane 0 at the lane priority
+//   <i> and each next lane one priority lower.
+//   <i> Default: 2
+#ifndef OS_WORKLANES
+ #define OS_WORKLANES   2
+#endif
+
+//   <o>Lane 0 Thread Priority
+//                        <1=> Low
+//     <2=> Below Normal  <3=> Normal  <4=> Above Normal
+//                        <5=> High
+//                        <6=> Realtime (highest)
+//   <i> Defines priority for the worker thread of lane 0.
+//   <i> Default: Above Normal
+#ifndef OS_WORKPRIO
+ #define OS_WORKPRIO    4
+#endif
+
+//   <o>Lane Thread stack size [bytes] <64-4096:8><#/4>
+//   <i> Defines stack size for each worker thread.
+//   <i> Default: 200
+#ifndef OS_WORKSTKSZ
+ #define OS_WORKSTKSZ   50
+#endif
+
+// </e>
+
 //   <o>ISR FIFO Queue size<4=>   4 entries  <8=>   8 entries
 //                         <12=> 12 entries  <16=> 16 entries
 //                         <24=> 24 entries  <32=> 32 entries
@@ -181,11 +245,90 @@
 //                         <96=> 96 entries
 //   <i> ISR functions store requests to this buffer,
 //   <i> when they are called from the interrupt handler.
+//   <i> Signals take one entry per thread and semaphore tokens one entry
+//   <i> per semaphore until processed, messages one entry each.
 //   <i> Default: 16 entries
 #ifndef OS_FIFOSZ
  #define OS_FIFOSZ      16
 #endif
 
+// <e>Kernel Event Trace
+// =====================
+//   <i> Records thread switches, SVC calls, interrupts and object waits
+//   <i> with a time stamp into a RAM ring buffer, see os_trace_start.
+#ifndef OS_TRACE
+ #define OS_TRACE       0
+#endif
+
+//   <o>Trace buffer size <16=>   16 events  <64=>   64 events
+//                        <256=> 256 events  <1024=> 1024 events
+//   <i> Every event takes 16 bytes.
+//   <i> Default: 256 events
+#ifndef OS_TRACESZ
+ #define OS_TRACESZ     256
+#endif
+
+// </e>
+
+// <e>Binary Log
+// =============
+//   <i> Keeps log records (message id, arguments and time stamp) in a RAM
+//   <i> ring buffer, formatted on the host, see os_log.
+#ifndef OS_LOG
+ #define OS_LOG         1
+#endif
+
+//   <o>Log buffer size <16=>   16 records  <64=>   64 records
+//                      <256=> 256 records  <1024=> 1024 records
+//   <i> Every record takes 32 bytes, a string up to 4 records.
+//   <i> Default: 64 records
+#ifndef OS_LOGSZ
+ #define OS_LOGSZ       64
+#endif
+
+// </e>
+
+//   <o>Thread Runtime Statistics <0=> Off <1=> Exact <2=> Sampled
+//   <i> Exact: running time measured at every thread switch with the cycle counter.
+//   <i> Sampled: running time counted in system ticks, latency of every 16th ready thread.
+//   <i> Read with os_thread_get_stats.
+//   <i> Default: Off
+#ifndef OS_STATS
+ #define OS_STATS       0
+#endif
+
+//   <o>EDF Thread Priority
+//                        <0=> Disabled
+//                        <1=> Low
+//     <2=> Below Normal  <3=> Normal  <4=> Above Normal
+//                        <5=> High
+//                        <6=> Realtime (highest)
+//   <i> Priority level of the earliest deadline first class: threads put into it with
+//   <i> os_thread_set_edf run by absolute deadline inside this level.
+//   <i> Must differ from the work queue lane priorities.
+//   <i> Default: Disabled
+#ifndef OS_EDFPRIO
+ #define OS_EDFPRIO     0
+#endif
+
+//   <o>Slab memory size [bytes] <0-65280:256>
+//   <i> Memory for os_slab_alloc, the driver control blocks and the
+//   <i> memory pools defined with os_pool_slab_def, in pages of 256 bytes.
+//   <i> Every page serves one size class: 8, 16, 32, 64, 128 or 256 bytes.
+//   <i> os_slab_get_stats reports use, peak and failures of every class.
+//   <i> Default: 2048
+#ifndef OS_SLABSZ
+ #define OS_SLABSZ      2048
+#endif
+
+//   <o>Number of driver handles <1-255>
+//   <i> Entries of the handle table: every open UART port, LCD, touch panel,
+//   <i> file system and Ethernet connection takes one until it is closed.
+//   <i> Default: 8
+#ifndef OS_HNDCNT
+ #define OS_HNDCNT      8
+#endif
+
 // </h>
 
 //------------- <<< end of configuration section >>> -----------------------
@@ -217,6 +360,19 @@ void os_idle_demon (void) {
 
   for (;;) {
     /* HERE: include optional user code to be executed when no thread runs.*/
+#if (OS_TICKLESS)
+    /* Sleep until an interrupt or the next kernel deadline wakes us up.     */
+    /* WFE instead of WFI: an interrupt between the check and the sleep     */
+    /* sets the event register on its return, so WFE falls through and the  */
+    /* check sees the request. The first WFE only clears the event left by  */
+    /* the return from os_tickless_enter.                                   */
+    if (os_tickless_enter () != 0) {
+      while (os_tickless_sleep () != 0) {
+        __WFE ();
+      }
+      os_tickless_exit ();
+    }
+#endif
   }
 }
 
@@ -252,6 +408,22 @@ void os_tick_irqack (void) {
   /* ... */
 }
 
+/*--------------------------- os_tick_stretch -------------------------------*/
+
+// Stretch current alternative hardware timer period to end 'ticks' ticks later
+// Return: number of ticks the period covers, 0 - not stretched
+uint32_t os_tick_stretch (uint32_t ticks) {
+  return (0);
+}
+
+/*--------------------------- os_tick_restore -------------------------------*/
+
+// Restart normal alternative hardware timer period at the next tick boundary
+// Return: number of the stretched ticks elapsed
+uint32_t os_tick_restore (uint32_t ticks) {
+  return (ticks);
+}
+
 #endif   // (OS_SYSTICK == 0)
 
 /*--------------------------- os_error --------------------------------------*/
@@ -5,55 +5,38 @@
 #include "GLCD.h"
 #include "TouchPanel.h"
 #include "TouchPanel_OS.h"
-#include "rt_MemBox.h"
+#include "rt_Handle.h"
 
-	/*MEMORY RESERVE*/
-	P_TSYNC tsync;
-	_declare_box(touch_pool,4,4); //Modify for requeriments
-	unsigned int t_reserved = 0; //memory reserved for file struct
-	/*FUNCTIONS PRIMITIVES*/
-	P_TCB rt_tid2ptcb (osThreadId thread_id);
-	
-void __svc(12) open_touch(osThreadId ID);
-void __SVC_12            (osThreadId ID){
-	
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	/*MEMORY RESERVE FOR STRUCT*/
-	if(t_reserved == 0){
-		rt_init_box(touch_pool,sizeof(touch_pool),sizeof(struct T_SYNC_OS));
-		tsync = rt_alloc_box(touch_pool);
-		memset(tsync,0,sizeof(struct T_SYNC_OS));
-		t_reserved = 1;
+os_handle_t __svc(12) open_touch(void);
+os_handle_t __SVC_12            (void){
+	os_handle_t touch;
+	/*UN PANEL YA ABIERTO POR ESTE HILO, O COMPARTIDO, SE RECALIBRA*/
+	touch = rt_hnd_find(HND_TOUCH, 0);
+	if(touch == 0){
+		touch = rt_hnd_open(HND_TOUCH, 0, NULL); //el panel pasa a ser del hilo que lo abre
 	}
-	/*EXTRACTING ID OF THE THREAD*/
-	id = rt_tid2ptcb(ID);
 	/*RUNNING THE CONFIGURATION*/
-	if((tsync->ID == id->task_id) || (tsync->ID == 0)){
-		tsync->ID = id->task_id;
+	if(touch != 0){
 		TP_Init();
 		LCD_Initializtion();
 		TouchPanel_Calibrate();
 	}
+	return(touch);
 }
-void __svc(13) write_touch(osThreadId ID);
-void __SVC_13             (osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID);
-	if(tsync->ID == id->task_id){
+void __svc(13) write_touch(os_handle_t touch);
+void __SVC_13             (os_handle_t touch){
+	if(rt_hnd_get(touch, HND_TOUCH) != NULL){
 			getDisplayPoint(&display,Read_Ads7846(),&matrix);
 			TP_DrawPoint(display.x,display.y);
 		}
 }
 
-void __svc(18) close_touch(osThreadId ID);
-void __SVC_18             (osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID);
-	if(tsync->ID == id->task_id){
-		memset(tsync,0,sizeof(struct T_SYNC_OS)); //Primero, limpiar el espacio
-		rt_free_box(touch_pool,tsync); //Segundo liberar la memoria
-		t_reserved = 0;
+void __svc(18) close_touch(os_handle_t touch);
+void __SVC_18             (os_handle_t touch){
+	P_HCB hcb;
+	hcb = rt_hnd_get(touch, HND_TOUCH);
+	if(hcb != NULL){
+		rt_hnd_close(hcb); //las copias del handle dejan de ser validas
 	}
 }
 /*********************************************************************************************************
@@ -4,14 +4,9 @@
 
 #ifndef _TOUCH
 #define _TOUCH
-extern void __svc(12) open_touch(osThreadId ID);
-extern void __svc(13) write_touch(osThreadId ID);
-extern void __svc(18) close_touch(osThreadId ID);
-
-/*SYNCHRONIZATION BETWEEN THREADs*/
-typedef struct T_SYNC_OS{
-	unsigned char ID;
-}*P_TSYNC;
+extern os_handle_t __svc(12) open_touch(void);
+extern void __svc(13) write_touch(os_handle_t touch);
+extern void __svc(18) close_touch(os_handle_t touch);
 #endif
 
 /*********************************************************************************************************
@@ -2,25 +2,46 @@
 #include "cmsis_os.h"
 #include <LPC17xx.h>
 #include <string.h>
-#include "rt_MemBox.h"
 #include "rt_TypeDef.h"
 #include "RTX_config.h"
+#include "rt_Handle.h"
+#include "rt_Task.h"
+#include "rt_Time.h"
 #include "uartn.h"
 
-	char bufferUART[512];	// Buffer de recepción
-	char *ptr_rx_0, *ptr_rx_1, *ptr_rx_2, *ptr_rx_3;	// puntero de recepción
-	char rx_completa_0, rx_completa_1, rx_completa_2, rx_completa_3; // Flag de recepción de cadena completa que se activa al recibir CR(0x0D)
-	char *ptr_tx_0, *ptr_tx_1, *ptr_tx_2, *ptr_tx_3;			// puntero de transmisión
-	char tx_completa_0,tx_completa_1,tx_completa_2,tx_completa_3; // Flag de transmisión de cadena completa
-	char enviado[30];
-	char mensaje[30];
-	uint8_t solo_rx = 0;
-	uint8_t solo_tx = 0;
-	/*MEMORY RESERVE*/
-	P_USYNC usync;
-	_declare_box(uart_pool,1,1); //Modify for requeriments
-	unsigned int u_reserved = 0; //memory reserved for file struct
-	P_TCB rt_tid2ptcb (osThreadId thread_id);
+/*BUFFERS CIRCULARES DE RECEPCION Y TRANSMISION DE CADA PUERTO*/
+static uint8_t uart0_rx_mem[UART0_RX_SIZE], uart0_tx_mem[UART0_TX_SIZE];
+static uint8_t uart1_rx_mem[UART1_RX_SIZE], uart1_tx_mem[UART1_TX_SIZE];
+static uint8_t uart2_rx_mem[UART2_RX_SIZE], uart2_tx_mem[UART2_TX_SIZE];
+static uint8_t uart3_rx_mem[UART3_RX_SIZE], uart3_tx_mem[UART3_TX_SIZE];
+
+#define UART_RING(mem)	{ (mem), sizeof(mem) - 1, 0, 0 }
+
+uart_port_t uart_port[4] = {
+	{ LPC_UART0, UART_RING(uart0_rx_mem), UART_RING(uart0_tx_mem), 0, 0, 0 },
+	{ (LPC_UART_TypeDef *)LPC_UART1, UART_RING(uart1_rx_mem), UART_RING(uart1_tx_mem), 0, 0, 0 },
+	{ LPC_UART2, UART_RING(uart2_rx_mem), UART_RING(uart2_tx_mem), 0, 0, 0 },
+	{ LPC_UART3, UART_RING(uart3_rx_mem), UART_RING(uart3_tx_mem), 0, 0, 0 },
+};
+
+#if UART_DMA
+#if (UART0_RX_SIZE/2 > UART_DMA_MAX) || (UART1_RX_SIZE/2 > UART_DMA_MAX) || \
+    (UART2_RX_SIZE/2 > UART_DMA_MAX) || (UART3_RX_SIZE/2 > UART_DMA_MAX)
+ #error "UARTn_RX_SIZE/2 no cabe en una transferencia de DMA"
+#endif
+
+#define UART_DMA_CH(c)	((LPC_GPDMACH_TypeDef *)(LPC_GPDMACH0_BASE + 0x20*(c)))
+
+/*LISTA ENLAZADA DE RECEPCION: cada mitad de rx apunta a la otra*/
+typedef struct {
+	uint32_t src;
+	uint32_t dst;
+	uint32_t next;
+	uint32_t ctrl;
+} uart_lli_t;
+
+static uart_lli_t uart_rx_lli[4][2];
+#endif
 
 static int uartn_set_baudrate(uint8_t UARTn, unsigned int baudrate) {
     int errorStatus = -1; //< Fallo de calculo
@@ -119,261 +140,511 @@ static int uartn_set_baudrate(uint8_t UARTn, unsigned int baudrate) {
 
     return errorStatus;
 }
-void __svc(1) open_uart(uint8_t UARTn, uint32_t baudrate, osThreadId ID);
-void __SVC_1 			     (uint8_t UARTn, uint32_t baudrate, osThreadId ID){
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-	/*MEMORY RESERVE FOR STRUCT*/
-	if(u_reserved == 0){
-		rt_init_box(uart_pool,sizeof(uart_pool),sizeof(struct U_SYNC_OS));
-		usync = rt_alloc_box(uart_pool);
-		memset(usync,0,sizeof(struct U_SYNC_OS));
-		u_reserved = 1;
+
+/*----------------------------------------------------------------------------
+ *   Carga la FIFO de transmision vacia con hasta UART_TX_FIFO bytes de tx
+ *---------------------------------------------------------------------------*/
+static uint32_t uart_tx_fill(uart_port_t *p){
+	uint32_t tail, n, i;
+
+	tail = p->tx.tail;
+	n = p->tx.head - tail;
+	if(n > UART_TX_FIFO){
+		n = UART_TX_FIFO;
+	}
+	for(i = 0; i < n; i++){
+		p->reg->THR = p->tx.buf[(tail + i) & p->tx.mask];
 	}
-	/*EXTRACTING ID OF THE THREAD*/
-	id = rt_tid2ptcb(ID);
-	/*RUNNING THE CONFIGURATION*/
-	if((usync->ID == id->task_id) || (usync->ID == 0)){
-		usync->ID = id->task_id;
-		/*Punteros*/
-		ptr_rx_0=bufferUART;
-		ptr_rx_1=bufferUART;
-		ptr_rx_2=bufferUART;
-		ptr_rx_3=bufferUART;
+	p->tx.tail = tail + n;		// el hueco se libera despues de copiar
+	return(n);
+}
+
+#if UART_DMA
+/*----------------------------------------------------------------------------
+ *   Enciende el GPDMA la primera vez que se abre un puerto
+ *---------------------------------------------------------------------------*/
+static void uart_dma_init(void){
+	if((LPC_SC->PCONP & (1 << 29)) == 0){
+		LPC_SC->PCONP |= (1 << 29);		// PCGPDMA
+		LPC_GPDMA->DMACConfig = 1;		// controlador activo, little-endian
+		NVIC_EnableIRQ(DMA_IRQn);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Recepcion continua: el canal escribe las dos mitades de rx sin parar
+ *---------------------------------------------------------------------------*/
+static void uart_dma_rx_start(uart_port_t *p){
+	uint32_t c, half;
+	LPC_GPDMACH_TypeDef *ch;
+	uart_lli_t *lli;
+
+	c = UART_DMA_RX_CH(p - uart_port);
+	ch = UART_DMA_CH(c);
+	lli = uart_rx_lli[p - uart_port];
+	half = (p->rx.mask + 1) / 2;
+
+	ch->DMACCConfig = 0;
+	LPC_GPDMA->DMACIntTCClear = 1 << c;
+	LPC_GPDMA->DMACIntErrClr = 1 << c;
+	lli[0].src = lli[1].src = (uint32_t)&p->reg->RBR;
+	lli[0].dst = (uint32_t)p->rx.buf;
+	lli[1].dst = (uint32_t)p->rx.buf + half;
+	lli[0].next = (uint32_t)&lli[1];
+	lli[1].next = (uint32_t)&lli[0];
+	lli[0].ctrl = lli[1].ctrl = half | DMA_CTRL_DI | DMA_CTRL_I;	// bytes, rafaga de 1
+	p->rx_halves = 0;
+	ch->DMACCSrcAddr = lli[0].src;
+	ch->DMACCDestAddr = lli[0].dst;
+	ch->DMACCLLI = lli[0].next;
+	ch->DMACCControl = lli[0].ctrl;
+	ch->DMACCConfig = DMA_CFG_E | (UART_DMA_RX_CONN(p - uart_port) << 1) | DMA_CFG_P2M | DMA_CFG_IE | DMA_CFG_ITC;
+}
+
+/*----------------------------------------------------------------------------
+ *   Calcula rx.head con la direccion de destino del canal. Las mitades
+ *   contadas por la interrupcion dan la vuelta; la direccion, el resto
+ *---------------------------------------------------------------------------*/
+static void uart_dma_rx_sync(uart_port_t *p){
+	uint32_t done, pos, head;
+
+	done = p->rx_halves * ((p->rx.mask + 1) / 2);	// antes que la direccion
+	pos = UART_DMA_CH(UART_DMA_RX_CH(p - uart_port))->DMACCDestAddr - (uint32_t)p->rx.buf;
+	head = done + ((pos - done) & p->rx.mask);
+	if(head - p->rx.tail > p->rx.mask + 1){
+		/*EL DMA HA DADO LA VUELTA SOBRE LO NO LEIDO*/
+		p->rx_dropped += head - p->rx.tail - (p->rx.mask + 1);
+		p->rx.tail = head - (p->rx.mask + 1);
+	}
+	p->rx.head = head;
+}
+
+/*----------------------------------------------------------------------------
+ *   Envia el bloque de write_uart_dma sin pasar por la CPU
+ *---------------------------------------------------------------------------*/
+static void uart_dma_tx_start(uart_port_t *p){
+	LPC_GPDMACH_TypeDef *ch;
+
+	ch = UART_DMA_CH(UART_DMA_TX_CH(p - uart_port));
+	p->dma_tx_run = 1;
+	ch->DMACCSrcAddr = (uint32_t)p->dma_tx_src;
+	ch->DMACCDestAddr = (uint32_t)&p->reg->THR;
+	ch->DMACCLLI = 0;
+	ch->DMACCControl = p->dma_tx_len | DMA_CTRL_SI | DMA_CTRL_I;
+	ch->DMACCConfig = DMA_CFG_E | (UART_DMA_TX_CONN(p - uart_port) << 6) | DMA_CFG_M2P | DMA_CFG_IE | DMA_CFG_ITC;
+}
+#endif
+
+static void uart_release(P_HCB hcb);
+
+os_handle_t __svc(1) open_uart(uint8_t UARTn, uint32_t baudrate);
+os_handle_t __SVC_1 			     (uint8_t UARTn, uint32_t baudrate){
+	os_handle_t uart;
+	uart_port_t *p;
+	if(UARTn > UART3){
+		return(0);
+	}
+	p = &uart_port[UARTn];
+	/*UN PUERTO YA ABIERTO POR ESTE HILO, O COMPARTIDO, SE RECONFIGURA*/
+	uart = rt_hnd_find(HND_UART, UARTn);
+	if(uart == 0){
+		rt_hnd_driver(HND_UART, uart_release); //si el dueno termina sin cerrarlo
+		uart = rt_hnd_open(HND_UART, UARTn, NULL); //el puerto pasa a ser del hilo que lo abre
+		if(uart != 0){
+			/*Buffers vacios para el nuevo dueno*/
+			p->reg->IER = 0;
+			p->rx.head = p->rx.tail = 0;
+			p->tx.head = p->tx.tail = 0;
+			p->tx_busy = 0;
+			p->rx_dropped = 0;
+			p->irq_count = 0;
+			p->rx_wait = 0;
+			p->tx_wait = 0;
+			p->rx_tid = NULL;
+			p->tx_tid = NULL;
+			p->dma_tx_tid = NULL;
+#if UART_DMA
+			uart_dma_init();
+			UART_DMA_CH(UART_DMA_TX_CH(UARTn))->DMACCConfig = 0;
+			p->dma_tx_len = 0;
+			p->dma_tx_run = 0;
+			p->dma_irq_count = 0;
+			uart_dma_rx_start(p);
+#endif
+		}
+	}
+	if(uart != 0){
 		switch(UARTn){
 			case UART0 :
 				LPC_PINCON->PINSEL0|=(1<<4)|(1<<6); //Configuracion pines RXD0 y TXD0  
-				LPC_UART0->LCR &= ~STOP_1_BIT & ~PARITY_NONE; // Set 8N1 mode (8 bits/dato, sin pariad, y 1 bit de stop)
-				LPC_UART0->LCR |= CHAR_8_BIT;
-
-				uartn_set_baudrate(UARTn, baudrate);// Se calcula el baudrate
-			
-				LPC_UART0->IER = THRE_IRQ_ENABLE|RBR_IRQ_ENABLE;// Se habilita las interrupciones TX y RX  
-				NVIC_EnableIRQ(UART0_IRQn);// Enable the UART interrupt (for Cortex-CM3 NVIC)
 				break;
-			
 			case UART1 :
 				LPC_PINCON->PINSEL0|= (1<<30); //Configuracion pin y TXD1
 				LPC_PINCON->PINSEL1|= (1<<0); //Configuracion pin RXD1
-				LPC_UART1->LCR &= ~STOP_1_BIT & ~PARITY_NONE;
-				LPC_UART1->LCR |= CHAR_8_BIT;
-			
-				uartn_set_baudrate(UARTn, baudrate);// Se calcula el baudrate
-			
-				LPC_UART1->IER = THRE_IRQ_ENABLE | RBR_IRQ_ENABLE;
-				NVIC_EnableIRQ(UART1_IRQn);
 				break;
 			case UART2 :
 				LPC_PINCON->PINSEL0|= (1<<20)|(1<<22); //Configuracion pines RXD2 y TXD2
 				LPC_SC->PCONP|=(1<<24); //Se  habilita la UART2
-				LPC_UART2->LCR &= ~STOP_1_BIT & ~PARITY_NONE;
-				LPC_UART2->LCR |= CHAR_8_BIT;
-		
-				uartn_set_baudrate(UARTn, baudrate);// Se calcula el baudrate
-			
-				LPC_UART2->IER = THRE_IRQ_ENABLE|RBR_IRQ_ENABLE;
-				NVIC_EnableIRQ(UART2_IRQn);
 				break;
 			case UART3 :
 				LPC_PINCON->PINSEL9|= (3<<24)|(3<<26); //Configuracion pines RXD3 y TXD3 P4.28 - P4.29
 				LPC_SC->PCONP|=(1<<25); //Se habilita la UART3
-				LPC_UART3->LCR &= ~STOP_1_BIT & ~PARITY_NONE;
-				LPC_UART3->LCR |= CHAR_8_BIT;
-		
-				uartn_set_baudrate(UARTn, baudrate);// Se calcula el baudrate
-			
-				LPC_UART3->IER = THRE_IRQ_ENABLE | RBR_IRQ_ENABLE;
-				NVIC_EnableIRQ(UART3_IRQn);	
 				break;
 		}
-	}	
+		p->reg->LCR &= ~STOP_1_BIT & ~PARITY_NONE; // Set 8N1 mode (8 bits/dato, sin pariad, y 1 bit de stop)
+		p->reg->LCR |= CHAR_8_BIT;
+
+		uartn_set_baudrate(UARTn, baudrate);// Se calcula el baudrate
+#if UART_DMA
+		/*FIFOs de 16 bytes en modo DMA: cada byte recibido es una peticion al canal de rx*/
+		p->reg->FCR = FIFO_ENABLE|RX_FIFO_RESET|TX_FIFO_RESET|FIFO_DMA_MODE;
+
+		p->reg->IER = THRE_IRQ_ENABLE|RLS_IRQ_ENABLE;// RX por DMA: interrupciones TX y errores de linea
+#else
+		/*FIFOs de 16 bytes: la interrupcion de recepcion salta al nivel de disparo o por time-out*/
+		p->reg->FCR = FIFO_ENABLE|RX_FIFO_RESET|TX_FIFO_RESET|((UART_RX_TRIGGER & 3) << 6);
+
+		p->reg->IER = THRE_IRQ_ENABLE|RBR_IRQ_ENABLE|RLS_IRQ_ENABLE;// Se habilita las interrupciones TX, RX y errores de linea
+#endif
+		NVIC_EnableIRQ((IRQn_Type)(UART0_IRQn + UARTn));// Enable the UART interrupt (for Cortex-CM3 NVIC)
+	}
+	return(uart);
 }
-void __svc(2) write_uart(uint8_t UARTn, char *datos, osThreadId ID); //enviar datos
-void __SVC_2 			      (uint8_t UARTn, char *datos, osThreadId ID){
-	/*VARIABLE FOR SYNCHRONIZATION*/
-	P_TCB id;
-		if(solo_tx == 0){
-		ptr_tx_0=datos;
-		ptr_tx_1=datos;
-		ptr_tx_2=datos;
-		ptr_tx_3=datos;
-		solo_tx = 1;
+uint32_t __svc(2) write_uart(os_handle_t uart, const char *datos, uint32_t n); //enviar datos
+uint32_t __SVC_2 			      (os_handle_t uart, const char *datos, uint32_t n){
+	/*COPIA EN EL BUFFER tx LO QUE CABE, NO ESPERA*/
+	P_HCB hcb;
+	uart_port_t *p;
+	uint32_t head, free, i;
+	hcb = rt_hnd_get(uart, HND_UART);
+	if(hcb == NULL){
+		return(0);
 	}
-	id = rt_tid2ptcb(ID);
-	if(usync->ID == id->task_id){
-		switch(UARTn){
-			case UART0 :
-				while(tx_completa_0==0){
-				ptr_tx_0=datos;
-				tx_completa_0=1;
-				LPC_UART0->THR=*ptr_tx_0++; //se introduce el primer dato para activar el flag de interrupcion;
-				}
-				break;
-			case UART1 :
-				while(tx_completa_1==0){
-				ptr_tx_1=datos;
-				tx_completa_1=1;
-				LPC_UART1->THR=*ptr_tx_1++; //se introduce el primer dato para activar el flag de interrupcion;
-				}
-				break;
-			case UART2 :
-				while(tx_completa_2==0){
-				ptr_tx_2=datos;
-				tx_completa_2=1;
-				LPC_UART2->THR=*ptr_tx_2++; //se introduce el primer dato para activar el flag de interrupcion;
-				}
-				break;
-			case UART3 :
-				while(tx_completa_3==0){
-				ptr_tx_3=datos;
-				tx_completa_3=1;
-				LPC_UART3->THR=*ptr_tx_3++; //se introduce el primer dato para activar el flag de interrupcion;
-				}
-				break;
+	p = &uart_port[hcb->unit];
+	head = p->tx.head;
+	free = p->tx.mask + 1 - (head - p->tx.tail);
+	if(n > free){
+		n = free;
+		/*ANTES DE PUBLICAR: THRE ve el aviso aunque vacie tx enseguida*/
+		p->tx_tid = (osThreadId)os_tsk.run;
+		p->tx_wait = 1;
+	}
+	for(i = 0; i < n; i++){
+		p->tx.buf[(head + i) & p->tx.mask] = datos[i];
+	}
+	p->tx.head = head + n;		// los bytes se publican despues de copiarlos
+	/*TRANSMISOR PARADO: la FIFO esta vacia, al vaciarse salta THRE*/
+	if(p->tx_busy == 0 && p->tx.tail != p->tx.head){
+		p->tx_busy = 1;
+		uart_tx_fill(p);
+	}
+	return(n);
+}
+uint32_t __svc(3) read_uart(os_handle_t uart, char *datos_rx, uint32_t n); //recibir datos
+uint32_t __SVC_3 			     (os_handle_t uart, char *datos_rx, uint32_t n){
+	/*COPIA LO RECIBIDO HASTA n BYTES, NO ESPERA*/
+	P_HCB hcb;
+	uart_port_t *p;
+	uint32_t tail, used, i;
+	hcb = rt_hnd_get(uart, HND_UART);
+	if(hcb == NULL){
+		return(0);
+	}
+	p = &uart_port[hcb->unit];
+	p->rx_tid = (osThreadId)os_tsk.run;	// recibe UART_SIG_RX
+#if UART_DMA
+	uart_dma_rx_sync(p);
+#endif
+	if(p->rx.head == p->rx.tail){
+		/*RX VACIO: la siguiente interrupcion de recepcion avisa al hilo*/
+		p->rx_wait = 1;
+#if UART_DMA
+		p->reg->IER |= RBR_IRQ_ENABLE;	// el DMA no avisa por byte: una interrupcion
+		uart_dma_rx_sync(p);		// lo llegado mientras se armaba
+#endif
+	}
+	tail = p->rx.tail;
+	used = p->rx.head - tail;
+	if(n > used){
+		n = used;
+	}
+	for(i = 0; i < n; i++){
+		datos_rx[i] = p->rx.buf[(tail + i) & p->rx.mask];
+	}
+	p->rx.tail = tail + n;		// el hueco se libra despues de copiar
+	return(n);
+}
+osStatus __svc(20) write_uart_dma(os_handle_t uart, const char *datos, uint32_t n); //enviar un bloque
+osStatus __SVC_20 				  (os_handle_t uart, const char *datos, uint32_t n){
+	/*EL BLOQUE NO SE COPIA: no se modifica hasta recibir UART_SIG_TX*/
+	P_HCB hcb;
+	uart_port_t *p;
+	hcb = rt_hnd_get(uart, HND_UART);
+	if(hcb == NULL || n == 0 || n > UART_DMA_MAX){
+		return(osErrorParameter);
+	}
+	p = &uart_port[hcb->unit];
+	if(p->dma_tx_len != 0){
+		return(osErrorResource);	// el bloque anterior aun no ha salido
+	}
+#if UART_DMA
+	if(n >= UART_DMA_MIN){
+		p->dma_tx_tid = (osThreadId)os_tsk.run;
+		p->dma_tx_src = datos;
+		p->dma_tx_len = n;		// si tx se esta vaciando, THRE lo arranca al acabar
+		if(p->tx_busy == 0){
+			p->tx_busy = 1;
+			uart_dma_tx_start(p);
 		}
+		return(osOK);
 	}
+#endif
+	/*BLOQUE CORTO: se copia en tx y sale por interrupcion*/
+	if(p->tx.mask + 1 - (p->tx.head - p->tx.tail) < n){
+		return(osErrorResource);
+	}
+	__SVC_2(uart, datos, n);
+	osSignalSet((osThreadId)os_tsk.run, UART_SIG_TX);
+	return(osOK);
 }
-void __svc(3) read_uart(uint8_t UARTn, char *datos_rx, osThreadId ID); //enviar datos
-void __SVC_3 			     (uint8_t UARTn, char *datos_rx, osThreadId ID){
-	P_TCB id;
-	if(solo_rx == 0){
-		ptr_rx_0=datos_rx;
-		ptr_rx_1=datos_rx;
-		ptr_rx_2=datos_rx;
-		ptr_rx_3=datos_rx;
-		solo_rx = 1;
+/*----------------------------------------------------------------------------
+ *   Milisegundos que quedan de millisec desde el tick start, 0: agotado
+ *---------------------------------------------------------------------------*/
+static uint32_t uart_wait_left(uint32_t start, uint32_t millisec){
+	uint32_t spent;
+
+	if(millisec == osWaitForever){
+		return(osWaitForever);
 	}
-	id = rt_tid2ptcb(ID);
-	if(usync->ID == id->task_id){
-		switch(UARTn){
-			case UART0 :
-				//while(rx_completa_0==0);
-				if(rx_completa_0 == 0)
-					break;
-				memcpy(datos_rx,ptr_rx_0,strlen(ptr_rx_0));
-				rx_completa_0=0;
-				break;
-			case UART1 :
-				if(rx_completa_1 == 0)
-					break;
-				memcpy(datos_rx,ptr_rx_1,strlen(ptr_rx_1));
-				rx_completa_1=0;
+	spent = ((os_time - start) * os_clockrate) / 1000;
+	return(spent >= millisec ? 0 : millisec - spent);
+}
+
+uint32_t read_uart_wait(os_handle_t uart, char *datos_rx, uint32_t n, uint32_t millisec){
+	/*DUERME HASTA QUE LLEGA ALGO: devuelve de 1 a n bytes, 0 si vence el plazo*/
+	uint32_t start, got, left;
+	osEvent evt;
+
+	start = os_time;
+	while((got = read_uart(uart, datos_rx, n)) == 0 && n != 0){
+		/*DESPUES DE read_uart: un cierre posterior despierta al lector armado*/
+		if(os_handle_check(uart, HND_UART) != osOK){
+			break;				// handle cerrado, o llamada desde una interrupcion
+		}
+		left = uart_wait_left(start, millisec);
+		if(left == 0){
+			break;
+		}
+		evt = osSignalWait(UART_SIG_RX, left);
+		if(evt.status != osEventSignal && evt.status != osEventTimeout){
+			break;				// llamada desde una interrupcion
+		}
+	}
+	return(got);
+}
+
+uint32_t write_uart_wait(os_handle_t uart, const char *datos, uint32_t n, uint32_t millisec){
+	/*DUERME MIENTRAS tx ESTA LLENO: devuelve n, o lo copiado si vence el plazo*/
+	uint32_t start, sent, left;
+	osEvent evt;
+
+	start = os_time;
+	sent = write_uart(uart, datos, n);
+	while(sent < n){
+		if(os_handle_check(uart, HND_UART) != osOK){
+			break;
+		}
+		left = uart_wait_left(start, millisec);
+		if(left == 0){
+			break;
+		}
+		evt = osSignalWait(UART_SIG_TXFREE, left);
+		if(evt.status != osEventSignal && evt.status != osEventTimeout){
+			break;
+		}
+		sent += write_uart(uart, datos + sent, n - sent);
+	}
+	return(sent);
+}
+
+/*----------------------------------------------------------------------------
+ *   Cierre de un puerto: close_uart, o el dueno termina sin cerrarlo
+ *---------------------------------------------------------------------------*/
+static void uart_release(P_HCB hcb){
+	uart_port_t *p;
+	/*PUERTO PARADO: sin interrupciones ni DMA que avisen a hilos del dueno anterior*/
+	p = &uart_port[hcb->unit];
+	p->reg->IER = 0;
+	NVIC_DisableIRQ((IRQn_Type)(UART0_IRQn + hcb->unit));
+#if UART_DMA
+	UART_DMA_CH(UART_DMA_RX_CH(hcb->unit))->DMACCConfig = 0;
+	UART_DMA_CH(UART_DMA_TX_CH(hcb->unit))->DMACCConfig = 0;
+	LPC_GPDMA->DMACIntTCClear = (1 << UART_DMA_RX_CH(hcb->unit)) | (1 << UART_DMA_TX_CH(hcb->unit));
+	LPC_GPDMA->DMACIntErrClr = (1 << UART_DMA_RX_CH(hcb->unit)) | (1 << UART_DMA_TX_CH(hcb->unit));
+	if(p->dma_tx_len != 0){
+		osSignalSet(p->dma_tx_tid, UART_SIG_TX); //canal parado: el bloque ya no se lee
+	}
+	p->dma_tx_len = 0;
+	p->dma_tx_run = 0;
+#endif
+	p->tx_busy = 0;
+	/*LOS HILOS QUE ESPERAN CON EL HANDLE COMPARTIDO SE DESPIERTAN Y VEN EL CIERRE*/
+	if(p->rx_wait){
+		osSignalSet(p->rx_tid, UART_SIG_RX);
+	}
+	if(p->tx_wait){
+		osSignalSet(p->tx_tid, UART_SIG_TXFREE);
+	}
+	p->rx_wait = 0;
+	p->tx_wait = 0;
+	p->rx_tid = NULL;
+	p->tx_tid = NULL;
+	p->dma_tx_tid = NULL;
+	rt_hnd_close(hcb); //las copias del handle dejan de ser validas
+}
+
+void __svc(19) close_uart(os_handle_t uart);
+void __SVC_19				     (os_handle_t uart){
+	P_HCB hcb;
+	hcb = rt_hnd_get(uart, HND_UART);
+	if(hcb != NULL){
+		uart_release(hcb);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Interrupcion comun de los puertos: productor de rx y consumidor de tx
+ *---------------------------------------------------------------------------*/
+static void uart_irq(uart_port_t *p){
+	uint32_t iir, head;
+	uint8_t dato;
+
+	p->irq_count++;
+	iir = p->reg->IIR;
+#if UART_DMA
+	if((iir & IIR_NO_INTERRUPT) && (p->reg->IER & RBR_IRQ_ENABLE)){
+		iir = RDA_INTERRUPT;				/* el DMA se llevo el byte que la disparo */
+	}
+#endif
+	while((iir & IIR_NO_INTERRUPT) == 0){
+		switch(iir & 0x0E){
+			case RLS_INTERRUPT:				/* RLS, error de linea: overrun */
+				if(p->reg->LSR & UART_LSR_OE){
+					p->rx_dropped++;
+				}
 				break;
-			case UART2 :
-				if(rx_completa_2 == 0)
-					break;
-				memcpy(datos_rx,ptr_rx_2,strlen(ptr_rx_2));
-				rx_completa_2=0;
+			case RDA_INTERRUPT:				/* RBR, Receiver Buffer Ready */
+			case CTI_INTERRUPT:				/* Character Time-out: resto de una rafaga */
+#if UART_DMA
+				/*LOS BYTES LOS MUEVE EL DMA: solo se despierta al lector*/
+				p->reg->IER &= ~RBR_IRQ_ENABLE;
+#else
+				/*SE VACIA TODA LA FIFO EN UNA PASADA*/
+				while(p->reg->LSR & UART_LSR_RDR){
+					dato = p->reg->RBR;		/* lee el dato recibido */
+					head = p->rx.head;
+					if(head - p->rx.tail > p->rx.mask){
+						p->rx_dropped++;	/* buffer lleno: se pierde */
+					}
+					else{
+						p->rx.buf[head & p->rx.mask] = dato;
+						p->rx.head = head + 1;
+					}
+				}
+#endif
+				if(p->rx_wait){
+					p->rx_wait = 0;
+					osSignalSet(p->rx_tid, UART_SIG_RX);
+				}
 				break;
-			case UART3 :
-				if(rx_completa_3 == 0)
-					break;
-				memcpy(datos_rx,ptr_rx_3,strlen(ptr_rx_3));
-				rx_completa_3=0;
+			case THRE_INTERRUPT:				/* THRE, FIFO de transmision vacia */
+#if UART_DMA
+				if(p->dma_tx_run && (UART_DMA_CH(UART_DMA_TX_CH(p - uart_port))->DMACCConfig & DMA_CFG_E)){
+					break;				/* la FIFO la llena el DMA */
+				}
+#endif
+				if(uart_tx_fill(p) == 0){		/* carga hasta 16 datos */
+#if UART_DMA
+					if(p->dma_tx_len != 0 && p->dma_tx_run == 0){
+						uart_dma_tx_start(p);	/* bloque esperando a que se vacie tx */
+					}
+					else{
+						p->tx_busy = 0;		/* transmision completa */
+					}
+#else
+					p->tx_busy = 0;			/* transmision completa */
+#endif
+				}
+				if(p->tx_wait && p->tx.head - p->tx.tail <= (p->tx.mask + 1) / 2){
+					p->tx_wait = 0;			/* hueco para el escritor que espera */
+					osSignalSet(p->tx_tid, UART_SIG_TXFREE);
+				}
 				break;
 		}
+		iir = p->reg->IIR;
 	}
 }
-void __svc(19) close_uart(osThreadId ID);
-void __SVC_19				     (osThreadId ID){
-	P_TCB id;
-	id = rt_tid2ptcb(ID);
-	if(usync->ID == id->task_id){
-		memset(usync,0,sizeof(struct U_SYNC_OS)); //Primero, limpiar el espacio
-		rt_free_box(uart_pool,usync); //Segundo liberar la memoria
-		u_reserved = 0;
-		solo_rx = 0;
-		solo_tx = 0;
-	}
-}
-void UART0_IRQHandler(void) {
 
-    switch(LPC_UART0->IIR&0x0E) {
-	
-	case 0x04:								 /* RBR, Receiver Buffer Ready */
-		*ptr_rx_0=LPC_UART0->RBR; 	   			 /* lee el dato recibido y lo almacena */
-	    if (*ptr_rx_0++ == 13){			// Caracter return --> Cadena completa
-					*ptr_rx_0 = 10;
-					*ptr_rx_0++ = 0;		/* Añadimos el caracter null para tratar los datos recibidos como una cadena*/ 
-					rx_completa_0 = 1;  /* rx completa */
-					ptr_rx_0=bufferUART;	/* puntero al inicio del bufferUART para nueva recepción */
-	    }	
-		break;
-			
-   case 0x02:								/* THRE, Transmit Holding Register empty */
-		if (*ptr_tx_0!=0)
-			LPC_UART0->THR=*ptr_tx_0++;		/* carga un nuevo dato para ser transmitido */
-		else tx_completa_0=0; 				//se pone a 1 diciendo que ha completado la transferencia
-		break;
-    }
+void UART0_IRQHandler(void) {
+	uart_irq(&uart_port[UART0]);
 }
 
 void UART1_IRQHandler(void) {
-	
-    switch(LPC_UART1->IIR&0x0E) {
-	
-	case 0x04:								 /* RBR, Receiver Buffer Ready */
-		*ptr_rx_1=LPC_UART1->RBR; 	   			 /* lee el dato recibido y lo almacena */
-	    if (*ptr_rx_1++ == 13){				// Caracter return --> Cadena completa
-				*ptr_rx_1 = 10;
-	    	*ptr_rx_1=0;		/* Añadimos el caracter null para tratar los datos recibidos como una cadena*/ 
-				rx_completa_1 = 1;/* rx completa */
-				ptr_rx_1=bufferUART;	/* puntero al inicio del bufferUART para nueva recepción */
-		}	
-		break;
-   case 0x02:								/* THRE, Transmit Holding Register empty */
-		if (*ptr_tx_1!=0) 
-			LPC_UART1->THR=*ptr_tx_1++;	/* carga un nuevo dato para ser transmitido */
-		else tx_completa_1=0;
-		break;
-
-    }
+	uart_irq(&uart_port[UART1]);
 }
 
 void UART2_IRQHandler(void) {
-	
-    switch(LPC_UART2->IIR&0x0E) {
-	
-	case 0x04:								 /* RBR, Receiver Buffer Ready */
-	*ptr_rx_2=LPC_UART2->RBR; 	   			 /* lee el dato recibido y lo almacena */
-	    if (*ptr_rx_2++ == 13){			// Caracter return --> Cadena completa
-				*ptr_rx_2 = 10;
-	    	*ptr_rx_2=0;		/* Añadimos el caracter null para tratar los datos recibidos como una cadena*/ 
-				rx_completa_2 = 1;/* rx completa */
-				ptr_rx_2=bufferUART;	/* puntero al inicio del bufferUART para nueva recepción */
-	    }	
-		break;
-	
-    
-   case 0x02:								/* THRE, Transmit Holding Register empty */
-		if (*ptr_tx_2!=0) 
-			LPC_UART2->THR=*ptr_tx_2++;	/* carga un nuevo dato para ser transmitido */
-		else tx_completa_2=0;
-		break;
-
-    }
+	uart_irq(&uart_port[UART2]);
 }
 
 void UART3_IRQHandler(void) {
-	
-    switch(LPC_UART3->IIR&0x0E) {
-		case 0x04:								 /* RBR, Receiver Buffer Ready */
-			*ptr_rx_3=LPC_UART3->RBR; 	   			 /* lee el dato recibido y lo almacena */
-			if (*ptr_rx_3++ == 13){ 				// Caracter return --> Cadena completa
-					*ptr_rx_3 = 10;
-	    		*ptr_rx_3 = 0;		/* Añadimos el caracter null para tratar los datos recibidos como una cadena*/ 
-					rx_completa_3 = 1;/* rx completa */
-				ptr_rx_3=bufferUART;	/* puntero al inicio del bufferUART para nueva recepción */
-	    	}	
-			break;
-		case 0x02:								/* THRE, Transmit Holding Register empty */
-			if (*ptr_tx_3!=0) 
-				LPC_UART3->THR=*ptr_tx_3++;	/* carga un nuevo dato para ser transmitido */
-			else tx_completa_3=0;
-			break;
+	uart_irq(&uart_port[UART3]);
+}
 
-    }
+#if UART_DMA
+/*----------------------------------------------------------------------------
+ *   Interrupcion del GPDMA: fin de mitad de rx y fin de bloque de tx. Solo
+ *   atiende y borra los canales de los puertos, los demas son de otros
+ *---------------------------------------------------------------------------*/
+void uart_dma_irq(void) {
+	uint32_t tc, err, ch, i;
+	uart_port_t *p;
+
+	for(i = UART0; i <= UART3; i++){
+		ch = (1 << UART_DMA_RX_CH(i)) | (1 << UART_DMA_TX_CH(i));
+		tc = LPC_GPDMA->DMACIntTCStat & ch;
+		err = LPC_GPDMA->DMACIntErrStat & ch;
+		if((tc | err) == 0){
+			continue;
+		}
+		LPC_GPDMA->DMACIntTCClear = tc;
+		LPC_GPDMA->DMACIntErrClr = err;
+		p = &uart_port[i];
+		p->dma_irq_count++;
+		if(tc & (1 << UART_DMA_RX_CH(i))){		/* otra mitad de rx llena */
+			p->rx_halves++;
+			if(p->rx_wait){				/* solo si un lector espera */
+				p->rx_wait = 0;
+				osSignalSet(p->rx_tid, UART_SIG_RX);
+			}
+		}
+		if(err & (1 << UART_DMA_RX_CH(i))){
+			p->rx_dropped++;			/* error de bus: el canal se para */
+		}
+		if((tc | err) & (1 << UART_DMA_TX_CH(i))){	/* bloque de tx entregado a la FIFO */
+			p->dma_tx_run = 0;
+			p->dma_tx_len = 0;
+			osSignalSet(p->dma_tx_tid, UART_SIG_TX);
+		}
+	}
+}
+
+#if UART_DMA_IRQ
+void DMA_IRQHandler(void) {
+	uart_dma_irq();
 }
+#endif
+#endif
 /*********************************************************************************************************
       END FILE
 *********************************************************************************************************/
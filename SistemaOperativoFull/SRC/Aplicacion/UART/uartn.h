@@ -15,24 +15,147 @@
 #define PARITY_NONE                     (0 << 3)
 #define DLAB_ENABLE                     (1 << 7)
 #define FIFO_ENABLE                     (1 << 0)
+#define RX_FIFO_RESET                   (1 << 1)
+#define TX_FIFO_RESET                   (1 << 2)
+#define FIFO_DMA_MODE                   (1 << 3)
+#define UART_TX_FIFO                    16      // bytes de la FIFO de transmision
 #define RBR_IRQ_ENABLE                  (1 << 0)
 #define THRE_IRQ_ENABLE                 (1 << 1)
+#define RLS_IRQ_ENABLE                  (1 << 2)
+#define UART_LSR_RDR                    (1 << 0)
+#define UART_LSR_OE                     (1 << 1)
 #define UART_LSR_THRE   								(1 << 5)
+#define IIR_NO_INTERRUPT                (1 << 0)
+#define RLS_INTERRUPT                   (3 << 1)
 #define RDA_INTERRUPT                   (2 << 1)
 #define CTI_INTERRUPT                   (6 << 1)
+#define THRE_INTERRUPT                  (1 << 1)
+#define DMA_CTRL_SI                     (1UL << 26)     // incrementa el origen
+#define DMA_CTRL_DI                     (1UL << 27)     // incrementa el destino
+#define DMA_CTRL_I                      (1UL << 31)     // interrupcion al terminar la cuenta
+#define DMA_CFG_E                       (1UL << 0)      // canal activo, lo borra el hardware al terminar
+#define DMA_CFG_M2P                     (1UL << 11)
+#define DMA_CFG_P2M                     (2UL << 11)
+#define DMA_CFG_IE                      (1UL << 14)     // interrupcion de error
+#define DMA_CFG_ITC                     (1UL << 15)     // interrupcion de fin de cuenta
 
-extern char bufferUART[512];	// Buffer de recepcin
-extern char *ptr_rx_0, *ptr_rx_1, *ptr_rx_2, *ptr_rx_3;	// puntero de recepcion
-extern char rx_completa_0,rx_completa_1,rx_completa_2,rx_completa_3;// Flag de recepcion de cadena completa que se activa al recibir CR(0x0D)
-extern char *ptr_tx_0, *ptr_tx_1, *ptr_tx_2, *ptr_tx_3;			// puntero de transmision
-extern char tx_completa_0,tx_completa_1,tx_completa_2,tx_completa_3;		// Flag de transmision de 
-extern char enviado[30];
+/*NIVEL DE DISPARO DE LA FIFO DE RECEPCION: 0 = 1 byte, 1 = 4, 2 = 8, 3 = 14*/
+/*Por debajo del nivel los bytes llegan con la interrupcion de time-out (CTI)*/
+#ifndef UART_RX_TRIGGER
+ #define UART_RX_TRIGGER                2
+#endif
+
+/*DMA (GPDMA): recepcion en doble buffer y envio de bloques con write_uart_dma.
+  Con UART_DMA = 0 los puertos solo usan interrupciones*/
+#ifndef UART_DMA
+ #define UART_DMA                       1
+#endif
+/*Bloques mas cortos se copian en tx y salen por interrupcion*/
+#ifndef UART_DMA_MIN
+ #define UART_DMA_MIN                   32
+#endif
+#define UART_DMA_MAX                    4095    // TransferSize maximo de un canal
+/*CANALES DEL GPDMA DE CADA PUERTO: por defecto los 8, dos por puerto. Un puerto
+  abierto toma los suyos; otro driver que use el GPDMA debe cambiar este reparto
+  para quedarse con canales que no abra ningun puerto*/
+#ifndef UART_DMA_RX_CH
+ #define UART_DMA_RX_CH(n)              (2*(n))         // canal 0 = mayor prioridad
+#endif
+#ifndef UART_DMA_TX_CH
+ #define UART_DMA_TX_CH(n)              (2*(n) + 1)
+#endif
+/*DMA_IRQHandler es comun a todos los canales. Con UART_DMA_IRQ = 0 el driver no
+  lo define: la aplicacion lo escribe y llama a uart_dma_irq, que solo atiende y
+  borra los canales de los puertos*/
+#ifndef UART_DMA_IRQ
+ #define UART_DMA_IRQ                   1
+#endif
+#define UART_DMA_TX_CONN(n)             (8 + 2*(n))     // GPDMA_CONN_UARTn_Tx
+#define UART_DMA_RX_CONN(n)             (9 + 2*(n))     // GPDMA_CONN_UARTn_Rx
+
+/*SENALES AL HILO DUENO DE LA OPERACION*/
+#define UART_SIG_TX                     0x4000  // el bloque de write_uart_dma ya se puede reutilizar
+#define UART_SIG_RX                     0x8000  // datos en rx: interrupcion de recepcion o mitad llena por DMA
+#define UART_SIG_TXFREE                 0x2000  // tx vaciado hasta la mitad para un escritor que espera
+
+/*TAMANO DE LOS BUFFERS CIRCULARES DE CADA PUERTO (potencia de 2)*/
+#ifndef UART_RX_SIZE
+ #define UART_RX_SIZE                   256
+#endif
+#ifndef UART_TX_SIZE
+ #define UART_TX_SIZE                   256
+#endif
+#ifndef UART0_RX_SIZE
+ #define UART0_RX_SIZE                  UART_RX_SIZE
+#endif
+#ifndef UART0_TX_SIZE
+ #define UART0_TX_SIZE                  UART_TX_SIZE
+#endif
+#ifndef UART1_RX_SIZE
+ #define UART1_RX_SIZE                  UART_RX_SIZE
+#endif
+#ifndef UART1_TX_SIZE
+ #define UART1_TX_SIZE                  UART_TX_SIZE
+#endif
+#ifndef UART2_RX_SIZE
+ #define UART2_RX_SIZE                  UART_RX_SIZE
+#endif
+#ifndef UART2_TX_SIZE
+ #define UART2_TX_SIZE                  UART_TX_SIZE
+#endif
+#ifndef UART3_RX_SIZE
+ #define UART3_RX_SIZE                  UART_RX_SIZE
+#endif
+#ifndef UART3_TX_SIZE
+ #define UART3_TX_SIZE                  UART_TX_SIZE
+#endif
+
+/*
+ * Buffer circular de un solo productor y un solo consumidor: head solo lo
+ * escribe el productor y tail solo el consumidor, por eso la interrupcion
+ * y las llamadas de los hilos no necesitan bloqueos. Los indices cuentan
+ * sin limite, head - tail son los bytes guardados.
+ */
+typedef struct {
+	uint8_t *buf;			// memoria del buffer
+	uint32_t mask;			// tamano - 1
+	volatile uint32_t head;		// siguiente byte a escribir (productor)
+	volatile uint32_t tail;		// siguiente byte a leer (consumidor)
+} uart_ring_t;
+
+typedef struct {
+	LPC_UART_TypeDef *reg;		// registros del puerto (UART1 con el mismo mapa)
+	uart_ring_t rx;			// productor: interrupcion, consumidor: read_uart
+	uart_ring_t tx;			// productor: write_uart, consumidor: interrupcion
+	volatile uint8_t tx_busy;	// transmisor en marcha, la interrupcion vacia tx
+	uint32_t rx_dropped;		// bytes recibidos con rx lleno o perdidos (overrun)
+	uint32_t irq_count;		// interrupciones atendidas
+	volatile uint8_t rx_wait;	// un lector encontro rx vacio: la interrupcion le avisa
+	volatile uint8_t tx_wait;	// un escritor no cupo en tx: THRE le avisa
+	osThreadId tx_tid;		// ese escritor, recibe UART_SIG_TXFREE
+	/*DMA: rx es el destino del canal, head se calcula con su direccion actual*/
+	volatile uint32_t rx_halves;	// mitades de rx completadas por el DMA
+	osThreadId rx_tid;		// hilo que lee, recibe UART_SIG_RX
+	const char *volatile dma_tx_src;	// bloque de write_uart_dma, pendiente o en curso
+	volatile uint32_t dma_tx_len;	// 0: canal de tx libre
+	volatile uint8_t dma_tx_run;	// el canal de tx llena la FIFO, THRE no la toca
+	osThreadId dma_tx_tid;		// hilo que lo envia, recibe UART_SIG_TX
+	uint32_t dma_irq_count;		// interrupciones de DMA del puerto
+} uart_port_t;
 
-extern void __svc(1) open_uart(uint8_t UARTn, uint32_t baudrate, osThreadId ID);
-extern void __svc(2) write_uart(uint8_t UARTn,char *datos, osThreadId ID);
-extern void __svc(3) read_uart(uint8_t UARTn,char *datos_rx, osThreadId ID);
-extern void __svc(19) close_uart(osThreadId ID);
-extern char mensaje[30];
+extern uart_port_t uart_port[4];
+
+extern os_handle_t __svc(1) open_uart(uint8_t UARTn, uint32_t baudrate);
+extern uint32_t __svc(2) write_uart(os_handle_t uart, const char *datos, uint32_t n);
+extern uint32_t __svc(3) read_uart(os_handle_t uart, char *datos_rx, uint32_t n);
+extern osStatus __svc(20) write_uart_dma(os_handle_t uart, const char *datos, uint32_t n);
+extern void __svc(19) close_uart(os_handle_t uart);
+extern void uart_dma_irq(void);
+
+/*VERSIONES QUE BLOQUEAN AL HILO HASTA millisec (osWaitForever: sin limite), solo desde hilos;
+  VUELVEN TAMBIEN SI OTRO HILO CIERRA EL PUERTO*/
+extern uint32_t read_uart_wait(os_handle_t uart, char *datos_rx, uint32_t n, uint32_t millisec);
+extern uint32_t write_uart_wait(os_handle_t uart, const char *datos, uint32_t n, uint32_t millisec);
 
 /*USE THIS FOR CHOOSE THE UART*/
 #define UART0		0
@@ -40,11 +163,6 @@ extern char mensaje[30];
 #define UART2		2
 #define UART3   3
 
-/*SYNCHRONIZATION BETWEEN THREADs*/
-typedef struct U_SYNC_OS{
-	unsigned char ID;
-}*P_USYNC;
-
 
 #endif
 
@@ -90,11 +90,38 @@ void rt_init_stack (P_TCB p_TCB, FUNCP task_body) {
   /* Task entry point. */
   p_TCB->ptask = task_body;
 
+  /* Fill the free stack with a pattern for the stack peak (watermark). */
+  if (os_stackinfo & STK_INIT) {
+    for (i = 1; &p_TCB->stack[i] < stk; i++) {
+      p_TCB->stack[i] = MAGIC_PATTERN;
+    }
+  }
+
   /* Set a magic word for checking of stack overflow. */
   p_TCB->stack[0] = MAGIC_WORD;
 }
 
 
+/*--------------------------- rt_stk_peak -----------------------------------*/
+
+U32 rt_stk_peak (P_TCB p_TCB, U32 *size) {
+  /* Peak use of the stack of a task in bytes: the stack is used from the   */
+  /* lowest word that does not hold the fill pattern of rt_init_stack.     */
+  U32 *stk,*top;
+
+  *size = p_TCB->priv_stack;
+  if (*size == 0) {
+    *size = (U16)os_stackinfo;
+  }
+  top = &p_TCB->stack[*size >> 2];
+  stk = &p_TCB->stack[1];
+  while ((stk < top) && (*stk == MAGIC_PATTERN)) {
+    stk++;
+  }
+  return ((U32)top - (U32)stk);
+}
+
+
 /*--------------------------- rt_ret_val ----------------------------------*/
 
 static __inline U32 *rt_ret_regs (P_TCB p_TCB) {
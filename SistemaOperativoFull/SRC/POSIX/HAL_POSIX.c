@@ -0,0 +1,519 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    HAL_POSIX.C
+ *      Purpose: Hardware Abstraction Layer for a POSIX host
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include <signal.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_Task.h"
+#include "rt_MemBox.h"
+#include "rt_Trace.h"
+#include "rt_HAL_CM.h"
+
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Emulated core state: the kernel runs in "handler mode" while os_ipsr is  */
+/* not 0 or PRIMASK is set. The interrupt signals are blocked meanwhile.    */
+volatile U32 os_ipsr;                   /* 11=SVCall, 14=PendSV, 15=SysTick  */
+volatile U32 os_control;                /* CONTROL register                  */
+volatile U32 os_primask;                /* PRIMASK register                  */
+volatile U32 os_icsr;                   /* Pending PendSV and SysTick        */
+volatile U32 os_st_ctrl;                /* SysTick enable and TICKINT        */
+
+/* Host contexts and stacks of the threads, declared in RTX_CM_lib.h */
+extern ucontext_t     os_host_ctx[];
+extern U64            os_host_stk[];
+extern U32 const      os_host_stksz;
+
+static sigset_t os_irq_sigs;            /* Signals emulating interrupts      */
+static U64      os_tick_ns;             /* Tick period [ns]                  */
+static U64      os_tick_stamp;          /* Host time of the last tick [ns]   */
+
+static void   (*os_irq_handler)(void);  /* Emulated peripheral interrupt     */
+static U32      os_irq_num;             /* Its IRQ number                    */
+static timer_t  os_irq_timer;           /* Host timer firing it              */
+
+#define ICSR_PENDSTSET  (1 << 26)
+#define ICSR_PENDSVSET  (1 << 28)
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_host_ns ------------------------------------*/
+
+static U64 rt_host_ns (void) {
+  /* Host monotonic time in nanoseconds. */
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ((U64)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+
+/*--------------------------- rt_host_ctx -----------------------------------*/
+
+static ucontext_t *rt_host_ctx (P_TCB p_TCB) {
+  /* Host context slot of a task, slot 0 is used by the idle demon. */
+  return (&os_host_ctx[(p_TCB->task_id == 255) ? 0 : p_TCB->task_id]);
+}
+
+
+/*--------------------------- rt_task_entry ---------------------------------*/
+
+static void rt_task_entry (void) {
+  /* First return to thread mode of a task: run the task body with its      */
+  /* argument, then the function found in LR of the initial stack frame.    */
+  P_TCB p_TCB = os_tsk.run;
+  U32  *stk   = (U32 *)(uintptr_t)p_TCB->tsk_stack;
+
+  os_ipsr = 0;
+  sigprocmask (SIG_UNBLOCK, &os_irq_sigs, NULL);
+  ((void (*)(void *))p_TCB->ptask) (p_TCB->msg);
+  if (stk[13] != 0) {
+    ((FUNCP)(uintptr_t)stk[13]) ();
+  }
+  for (;;);
+}
+
+
+/*--------------------------- rt_host_fill ----------------------------------*/
+
+static void rt_host_fill (U32 *stk, U32 size) {
+  /* Fill a host stack with the pattern of rt_stk_peak. */
+  U32 i;
+
+  for (i = 0; i < size / 4; i++) {
+    stk[i] = MAGIC_PATTERN;
+  }
+}
+
+
+/*--------------------------- rt_host_switch --------------------------------*/
+
+static void rt_host_switch (P_TCB p_old, P_TCB p_new) {
+  /* Switch the host context from task "p_old" (NULL if deleted) to task    */
+  /* "p_new". A task not started yet gets its host context here.            */
+  ucontext_t *ctx = rt_host_ctx (p_new);
+  U32        *stk = (U32 *)(uintptr_t)p_new->tsk_stack;
+  U32         idx;
+
+  if (stk[15] == INITIAL_xPSR) {
+    idx = (U32)(ctx - os_host_ctx);
+    if (os_stackinfo & STK_INIT) {
+      /* Fill the host stack with the pattern for the stack peak. */
+      rt_host_fill ((U32 *)((U8 *)os_host_stk + idx * os_host_stksz), os_host_stksz);
+    }
+    getcontext (ctx);
+    ctx->uc_stack.ss_sp   = (U8 *)os_host_stk + idx * os_host_stksz;
+    ctx->uc_stack.ss_size = os_host_stksz;
+    ctx->uc_link          = NULL;
+    makecontext (ctx, rt_task_entry, 0);
+    stk[15] = 0;
+  }
+  if (p_old == NULL) {
+    setcontext (ctx);
+  }
+  swapcontext (rt_host_ctx (p_old), ctx);
+}
+
+
+/*--------------------------- rt_exc_return ---------------------------------*/
+
+static void rt_exc_return (void) {
+  /* Leave handler mode: tail-chain the pending PendSV and SysTick handlers */
+  /* and switch to the scheduled task, as on exception return. The calling */
+  /* task continues here when it is scheduled again.                       */
+  P_TCB p_old = os_tsk.run;
+
+  for (;;) {
+    if (os_tsk.run != os_tsk.new) {
+      if (os_tsk.run != NULL) {
+        rt_stk_check ();
+      }
+      rt_tsk_switch (os_tsk.new);
+      os_tsk.run = os_tsk.new;
+    }
+    if (os_icsr & ICSR_PENDSVSET) {
+      os_icsr &= ~ICSR_PENDSVSET;
+      os_ipsr  = 14;
+      rt_pop_req ();
+    }
+    else if (os_icsr & ICSR_PENDSTSET) {
+      os_icsr &= ~ICSR_PENDSTSET;
+      os_ipsr  = 15;
+      rt_systick ();
+    }
+    else {
+      break;
+    }
+  }
+  if (os_tsk.run != p_old) {
+    rt_host_switch (p_old, os_tsk.run);
+  }
+}
+
+
+/*--------------------------- rt_tick_signal --------------------------------*/
+
+static void rt_tick_signal (int sig) {
+  /* Interval timer signal: the SysTick interrupt of the host port. */
+  os_tick_stamp = rt_host_ns ();
+  if (os_st_ctrl & 0x0002) {
+    os_icsr |= ICSR_PENDSTSET;
+  }
+  if (os_icsr & (ICSR_PENDSTSET | ICSR_PENDSVSET)) {
+    os_ipsr = 15;
+    rt_exc_return ();
+    os_ipsr = 0;
+  }
+}
+
+
+/*--------------------------- rt_irq_signal ---------------------------------*/
+
+static void rt_irq_signal (int sig) {
+  /* Timer signal of os_host_irq: a peripheral interrupt of the host port. */
+  os_ipsr = 16 + os_irq_num;
+  os_irq_handler ();
+  if (os_icsr & (ICSR_PENDSTSET | ICSR_PENDSVSET)) {
+    rt_exc_return ();
+  }
+  os_ipsr = 0;
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- __disable_irq ---------------------------------*/
+
+U32 __disable_irq (void) {
+  /* Set PRIMASK, returns the previous PRIMASK value. */
+  if (os_primask) {
+    return (1);
+  }
+  if (os_ipsr == 0) {
+    sigprocmask (SIG_BLOCK, &os_irq_sigs, NULL);
+  }
+  os_primask = 1;
+  return (0);
+}
+
+
+/*--------------------------- __enable_irq ----------------------------------*/
+
+void __enable_irq (void) {
+  /* Clear PRIMASK, take the exceptions pended meanwhile in thread mode. */
+  if (os_primask == 0) {
+    return;
+  }
+  os_primask = 0;
+  if (os_ipsr == 0) {
+    if (os_icsr & (ICSR_PENDSTSET | ICSR_PENDSVSET)) {
+      os_ipsr = 14;
+      rt_exc_return ();
+      os_ipsr = 0;
+    }
+    sigprocmask (SIG_UNBLOCK, &os_irq_sigs, NULL);
+  }
+}
+
+
+/*--------------------------- os_pend_irq -----------------------------------*/
+
+void os_pend_irq (U32 pend) {
+  /* Set pending bits of PendSV and SysTick in the emulated ICSR. */
+  os_icsr |= pend & (ICSR_PENDSTSET | ICSR_PENDSVSET);
+  if ((os_ipsr == 0) && (os_primask == 0) && (os_icsr != 0)) {
+    /* Thread mode with interrupts enabled: taken at once. */
+    sigprocmask (SIG_BLOCK, &os_irq_sigs, NULL);
+    os_ipsr = 14;
+    rt_exc_return ();
+    os_ipsr = 0;
+    sigprocmask (SIG_UNBLOCK, &os_irq_sigs, NULL);
+  }
+}
+
+
+/*--------------------------- os_svc_enter ----------------------------------*/
+
+void os_svc_enter (U32 svc) {
+  /* SVC exception entry from a thread calling SVC function "svc". */
+  if (os_primask == 0) {
+    sigprocmask (SIG_BLOCK, &os_irq_sigs, NULL);
+  }
+  os_ipsr = 11;
+  TRC_EVENT(TRC_SVC_ENTER, 0, svc);
+}
+
+
+/*--------------------------- os_svc_exit -----------------------------------*/
+
+void os_svc_exit (U32 svc, U32 *regs) {
+  /* SVC exception return: store the return values "regs" to R0..R3 of the */
+  /* caller's stack frame, switch tasks and load R0..R3 when the caller    */
+  /* runs again.                                                            */
+  U32 *stk;
+
+  TRC_EVENT(TRC_SVC_EXIT, 0, svc);
+  if (os_tsk.run != NULL) {
+    stk = (U32 *)(uintptr_t)os_tsk.run->tsk_stack;
+    memcpy (&stk[8], regs, 4*4);
+  }
+  rt_exc_return ();
+  stk = (U32 *)(uintptr_t)os_tsk.run->tsk_stack;
+  memcpy (regs, &stk[8], 4*4);
+  os_ipsr = 0;
+  if (os_primask == 0) {
+    sigprocmask (SIG_UNBLOCK, &os_irq_sigs, NULL);
+  }
+}
+
+
+/*--------------------------- rt_svc_init -----------------------------------*/
+
+void rt_svc_init (void) {
+  /* Set up the signals emulating the interrupts. */
+  sigemptyset (&os_irq_sigs);
+  sigaddset (&os_irq_sigs, SIGALRM);
+  sigaddset (&os_irq_sigs, SIGUSR1);
+}
+
+
+/*--------------------------- os_host_irq -----------------------------------*/
+
+void os_host_irq (U32 irqn, U32 period_us, void (*handler)(void)) {
+  /* Call "handler" as interrupt "irqn" every "period_us" microseconds, a  */
+  /* period of 0 stops the interrupt.                                      */
+  struct sigaction  sa;
+  struct sigevent   se;
+  struct itimerspec it;
+
+  if (os_irq_handler == NULL) {
+    memset (&sa, 0, sizeof(sa));
+    sa.sa_handler = rt_irq_signal;
+    sa.sa_mask    = os_irq_sigs;
+    sa.sa_flags   = SA_RESTART;
+    sigaction (SIGUSR1, &sa, NULL);
+
+    memset (&se, 0, sizeof(se));
+    se.sigev_notify = SIGEV_SIGNAL;
+    se.sigev_signo  = SIGUSR1;
+    timer_create (CLOCK_MONOTONIC, &se, &os_irq_timer);
+  }
+  os_irq_num     = irqn;
+  os_irq_handler = handler;
+
+  it.it_interval.tv_sec  = period_us / 1000000;
+  it.it_interval.tv_nsec = (period_us % 1000000) * 1000;
+  it.it_value            = it.it_interval;
+  timer_settime (os_irq_timer, 0, &it, NULL);
+}
+
+
+/*--------------------------- rt_systick_init -------------------------------*/
+
+void rt_systick_init (void) {
+  /* Start the interval timer with the period of the system tick. */
+  struct sigaction sa;
+  struct itimerval it;
+
+  memset (&sa, 0, sizeof(sa));
+  sa.sa_handler = rt_tick_signal;
+  sa.sa_mask    = os_irq_sigs;
+  sa.sa_flags   = SA_RESTART;
+  sigaction (SIGALRM, &sa, NULL);
+
+  os_tick_ns    = (U64)os_clockrate * 1000;
+  os_tick_stamp = rt_host_ns ();
+  os_st_ctrl    = 0x0007;
+
+  it.it_interval.tv_sec  = os_clockrate / 1000000;
+  it.it_interval.tv_usec = os_clockrate % 1000000;
+  it.it_value            = it.it_interval;
+  setitimer (ITIMER_REAL, &it, NULL);
+}
+
+
+/*--------------------------- rt_systick_val --------------------------------*/
+
+unsigned int rt_systick_val (void) {
+  /* Counts of the current tick period, 0..os_trv. */
+  U64 ns = rt_host_ns () - os_tick_stamp;
+
+  if (ns >= os_tick_ns) {
+    /* Tick signal pending: continue in the next period. */
+    ns -= os_tick_ns;
+    if (ns >= os_tick_ns) {
+      ns = os_tick_ns - 1;
+    }
+  }
+  return ((U32)(ns * (os_trv + 1) / os_tick_ns));
+}
+
+
+/*--------------------------- rt_systick_ovf --------------------------------*/
+
+unsigned int rt_systick_ovf (void) {
+  /* Tick period has elapsed, the tick signal is not handled yet. */
+  return ((rt_host_ns () - os_tick_stamp) >= os_tick_ns);
+}
+
+
+/*--------------------------- rt_stamp_val ----------------------------------*/
+
+unsigned int rt_stamp_val (void) {
+  /* Time stamp in OS_CLOCK cycles, the host port counts nanoseconds. */
+  return ((U32)rt_host_ns ());
+}
+
+
+/*--------------------------- rt_init_stack ---------------------------------*/
+
+void rt_init_stack (P_TCB p_TCB, FUNCP task_body) {
+  /* Prepare TCB and the emulated exception frame for a first time start of */
+  /* a task. The frame holds the R0..R3 return values and the LR; the task  */
+  /* itself runs on a host stack (see rt_host_switch).                      */
+  U32 *stk,i,size;
+
+  size = p_TCB->priv_stack >> 2;
+  if (size == 0) {
+    size = (U16)os_stackinfo >> 2;
+  }
+
+  /* Write to the top of stack, 8-byte aligned. */
+  stk = &p_TCB->stack[size];
+  if ((uintptr_t)stk & 0x04) {
+    stk--;
+  }
+  stk -= 16;
+
+  /* Default xPSR marks the task not started yet, initial PC */
+  stk[15] = INITIAL_xPSR;
+  stk[14] = (U32)(uintptr_t)task_body;
+
+  /* Clear R4-R11,R0-R3,R12,LR registers. */
+  for (i = 0; i < 14; i++) {
+    stk[i] = 0;
+  }
+  stk[8] = (U32)(uintptr_t)p_TCB->msg;
+
+  p_TCB->tsk_stack = (U32)(uintptr_t)stk;
+  p_TCB->ptask     = task_body;
+
+  /* Set a magic word for checking of stack overflow. */
+  p_TCB->stack[0] = MAGIC_WORD;
+}
+
+
+/*--------------------------- rt_stk_peak -----------------------------------*/
+
+U32 rt_stk_peak (P_TCB p_TCB, U32 *size) {
+  /* Peak use of the stack of a task in bytes. The task runs on its host    */
+  /* stack, filled with the pattern when the task is started.              */
+  U32 *stk,*top;
+
+  *size = os_host_stksz;
+  if (((U32 *)(uintptr_t)p_TCB->tsk_stack)[15] == INITIAL_xPSR) {
+    /* Not started yet */
+    return (0);
+  }
+  stk = (U32 *)((U8 *)os_host_stk + (rt_host_ctx (p_TCB) - os_host_ctx) * os_host_stksz);
+  top = stk + os_host_stksz / 4;
+  while ((stk < top) && (*stk == MAGIC_PATTERN)) {
+    stk++;
+  }
+  return ((U32)((U8 *)top - (U8 *)stk));
+}
+
+
+/*--------------------------- rt_ret_val ------------------------------------*/
+
+void rt_ret_val (P_TCB p_TCB, U32 v0) {
+  U32 *ret = (U32 *)(uintptr_t)p_TCB->tsk_stack + 8;
+
+  ret[0] = v0;
+}
+
+void rt_ret_val2(P_TCB p_TCB, U32 v0, U32 v1) {
+  U32 *ret = (U32 *)(uintptr_t)p_TCB->tsk_stack + 8;
+
+  ret[0] = v0;
+  ret[1] = v1;
+}
+
+
+/*--------------------------- rt_set_PSP ------------------------------------*/
+
+void rt_set_PSP (U32 stack) {
+  /* The stack frame of a task does not move on the host. */
+  (void)stack;
+}
+
+
+/*--------------------------- rt_get_PSP ------------------------------------*/
+
+U32 rt_get_PSP (void) {
+  return (os_tsk.run->tsk_stack);
+}
+
+
+/*--------------------------- _alloc_box ------------------------------------*/
+
+void *_alloc_box (void *box_mem) {
+  /* Memory boxes are interrupt safe, no SVC needed on the host. */
+  return (rt_alloc_box (box_mem));
+}
+
+
+/*--------------------------- _free_box -------------------------------------*/
+
+int _free_box (void *box_mem, void *box) {
+  return (rt_free_box (box_mem, box));
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,236 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RTX_Conf_POSIX.C
+ *      Purpose: Configuration of CMSIS RTX Kernel for the POSIX host port
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "cmsis_os.h"
+#include "core_posix.h"
+
+
+/*----------------------------------------------------------------------------
+ *      RTX User configuration part BEGIN
+ *---------------------------------------------------------------------------*/
+
+// Thread Configuration: threads run on host stacks of OS_HOSTSTKSZ bytes,
+// the kernel stacks below only hold the emulated exception frame and all come
+// from the stack memory pool (OS_STKPOOL). The stack peak is the host stack use.
+#ifndef OS_TASKCNT
+ #define OS_TASKCNT     40
+#endif
+
+#ifndef OS_STKSIZE
+ #define OS_STKSIZE     50
+#endif
+
+#ifndef OS_MAINSTKSIZE
+ #define OS_MAINSTKSIZE 50
+#endif
+
+#ifndef OS_PRIVCNT
+ #define OS_PRIVCNT     0
+#endif
+
+#ifndef OS_PRIVSTKSIZE
+ #define OS_PRIVSTKSIZE 2000
+#endif
+
+#ifndef OS_STKPOOL
+ #define OS_STKPOOL     1
+#endif
+
+#ifndef OS_STKCHECK
+ #define OS_STKCHECK    1
+#endif
+
+#ifndef OS_STKINIT
+ #define OS_STKINIT     1
+#endif
+
+#ifndef OS_RUNPRIV
+ #define OS_RUNPRIV     0
+#endif
+
+#ifndef OS_HOSTSTKSZ
+ #define OS_HOSTSTKSZ   65536
+#endif
+
+// Kernel Timer Tick Configuration: the tick is an interval timer signal,
+// osKernelSysTick counts host nanoseconds.
+#ifndef OS_SYSTICK
+ #define OS_SYSTICK     1
+#endif
+
+#ifndef OS_CLOCK
+ #define OS_CLOCK       1000000000
+#endif
+
+#ifndef OS_TICK
+ #define OS_TICK        1000
+#endif
+
+// Tickless idle is not supported by the host port.
+#ifndef OS_TICKLESS
+ #define OS_TICKLESS    0
+#endif
+
+// System Configuration
+#ifndef OS_ROBIN
+ #define OS_ROBIN       1
+#endif
+
+#ifndef OS_ROBINTOUT
+ #define OS_ROBINTOUT   5
+#endif
+
+#ifndef OS_TIMERS
+ #define OS_TIMERS      1
+#endif
+
+#ifndef OS_TIMERPRIO
+ #define OS_TIMERPRIO   5
+#endif
+
+#ifndef OS_TIMERSTKSZ
+ #define OS_TIMERSTKSZ  50
+#endif
+
+#ifndef OS_TIMERCBQS
+ #define OS_TIMERCBQS   4
+#endif
+
+#ifndef OS_WORK
+ #define OS_WORK        1
+#endif
+
+#ifndef OS_WORKLANES
+ #define OS_WORKLANES   2
+#endif
+
+#ifndef OS_WORKPRIO
+ #define OS_WORKPRIO    4
+#endif
+
+#ifndef OS_WORKSTKSZ
+ #define OS_WORKSTKSZ   50
+#endif
+
+#ifndef OS_FIFOSZ
+ #define OS_FIFOSZ      16
+#endif
+
+// Kernel event trace: the time stamps count host nanoseconds.
+#ifndef OS_TRACE
+ #define OS_TRACE       1
+#endif
+
+#ifndef OS_TRACESZ
+ #define OS_TRACESZ     1024
+#endif
+
+// Binary log records, time stamps in host nanoseconds.
+#ifndef OS_LOG
+ #define OS_LOG         1
+#endif
+
+#ifndef OS_LOGSZ
+ #define OS_LOGSZ       1024
+#endif
+
+// Thread runtime statistics: 1 exact, 2 sampled.
+#ifndef OS_STATS
+ #define OS_STATS       1
+#endif
+
+// Earliest deadline first class on osPriorityHigh, above the work lanes.
+#ifndef OS_EDFPRIO
+ #define OS_EDFPRIO     5
+#endif
+
+// Slab memory for os_slab_alloc and os_pool_slab_def pools.
+#ifndef OS_SLABSZ
+ #define OS_SLABSZ      4096
+#endif
+
+// Driver handle table.
+#ifndef OS_HNDCNT
+ #define OS_HNDCNT      16
+#endif
+
+#ifndef OS_MUTEXCNT
+ #define OS_MUTEXCNT    8
+#endif
+
+/*----------------------------------------------------------------------------
+ *      RTX User configuration part END
+ *---------------------------------------------------------------------------*/
+
+#define OS_TRV          ((uint32_t)(((double)OS_CLOCK*(double)OS_TICK)/1E6)-1)
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- os_idle_demon ---------------------------------*/
+
+void os_idle_demon (void) {
+  /* The idle demon is a system thread, running when no other thread is      */
+  /* ready to run.                                                           */
+
+  for (;;) {
+    /* Sleep until the next tick signal. */
+    __WFI ();
+  }
+}
+
+/*--------------------------- os_error --------------------------------------*/
+
+void os_error (uint32_t err_code) {
+  /* This function is called when a runtime error is detected. Parameter */
+  /* 'err_code' holds the runtime error code (defined in RTL.H).         */
+
+  fprintf (stderr, "RTX runtime error %u\n", err_code);
+  abort ();
+}
+
+
+/*----------------------------------------------------------------------------
+ *      RTX Configuration Functions
+ *---------------------------------------------------------------------------*/
+
+#include "RTX_CM_lib.h"
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
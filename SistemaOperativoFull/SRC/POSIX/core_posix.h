@@ -0,0 +1,86 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    CORE_POSIX.H
+ *      Purpose: Cortex-M core intrinsics emulated on a POSIX host
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#ifndef __CORE_POSIX_H
+#define __CORE_POSIX_H
+
+#include <stdint.h>
+#include <unistd.h>
+
+/* The host port runs the kernel in a single Linux process: threads are    */
+/* host contexts, SysTick is an interval timer signal and the exception     */
+/* state of the core is kept in the variables below (see HAL_POSIX.c).      */
+
+/* Variables */
+extern volatile uint32_t os_ipsr;       /* Active exception, 0=Thread mode   */
+extern volatile uint32_t os_control;    /* CONTROL register                  */
+
+/* Functions */
+extern void     __enable_irq  (void);
+extern uint32_t __disable_irq (void);
+
+/* Peripheral interrupt emulation: "handler" runs as interrupt "irqn" every */
+/* "period_us" microseconds, period 0 stops it.                              */
+extern void     os_host_irq   (uint32_t irqn, uint32_t period_us, void (*handler)(void));
+
+static inline uint32_t __get_IPSR (void) {
+  return (os_ipsr);
+}
+
+static inline uint32_t __get_CONTROL (void) {
+  return (os_control);
+}
+
+static inline void __set_CONTROL (uint32_t control) {
+  os_control = control;
+}
+
+static inline void __set_PSP (uint32_t topOfProcStack) {
+  /* Thread stacks are host stacks, the PSP value is not used. */
+  (void)topOfProcStack;
+}
+
+#define __INLINE        inline
+
+#define __NOP()         __asm volatile ("nop")
+#define __DSB()         __sync_synchronize ()
+#define __ISB()         __sync_synchronize ()
+#define __DMB()         __sync_synchronize ()
+#define __WFI()         pause ()
+
+#endif
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Decodes a binary log stream (os_log, os_log_str; see Aplicacion/Log/LOG_OS.c
+ * and Aplicacion/Other main/main_log.c) to text, one line per message:
+ *
+ *   log2txt < capture.bin
+ *
+ * The stream is a sequence of 32-byte little-endian records. It starts with
+ * a header record (0, "RLOG", time stamp frequency); bytes before the first
+ * header are skipped, so a capture may start anywhere. The format strings
+ * come from the same table the target is built with, Aplicacion/Log/log_msgs.h.
+ * Gaps in the sequence numbers (records overwritten before they were read)
+ * are reported. The record layout matches SRC/rt_Log.h.
+ */
+
+#define LOG_WORDS		8
+#define LOG_ARGS		5
+#define LOG_MAGIC		0x474F4C52
+#define LOG_STR_MAX		(4 * LOG_ARGS * 4)
+
+#define LOG_MSG(id, fmt)	fmt,
+static const char *fmts[] = {
+#include "../Aplicacion/Log/log_msgs.h"
+};
+#undef LOG_MSG
+#define LOG_MSG_CNT		(sizeof(fmts) / sizeof(fmts[0]))
+
+static double   freq = 1e9;			// time stamp frequency [Hz]
+static double   now;				// time of the current record [s]
+
+/*----------------------------------------------------------------------------
+ *   Read one record, 0 at the end of the input
+ *---------------------------------------------------------------------------*/
+static int record(uint32_t *rec){
+	uint8_t b[LOG_WORDS * 4];
+	int i;
+
+	if(fread(b, sizeof(b), 1, stdin) != 1){
+		return 0;
+	}
+	for(i = 0; i < LOG_WORDS; i++){
+		rec[i] = b[4*i] | (b[4*i+1] << 8) | (b[4*i+2] << 16) | ((uint32_t)b[4*i+3] << 24);
+	}
+	return 1;
+}
+
+/*----------------------------------------------------------------------------
+ *   Skip input up to the first header record, 0 at the end of the input
+ *---------------------------------------------------------------------------*/
+static int sync_header(uint32_t *rec){
+	uint8_t b[LOG_WORDS * 4];
+	int c, i;
+
+	if(fread(b, sizeof(b), 1, stdin) != 1){
+		return 0;
+	}
+	for(;;){
+		if(b[0] == 0 && b[1] == 0 && b[2] == 0 && b[3] == 0 &&
+		   b[4] == 'R' && b[5] == 'L' && b[6] == 'O' && b[7] == 'G'){
+			break;
+		}
+		if((c = getchar()) == EOF){
+			return 0;
+		}
+		memmove(b, b + 1, sizeof(b) - 1);
+		b[sizeof(b) - 1] = (uint8_t)c;
+	}
+	for(i = 0; i < LOG_WORDS; i++){
+		rec[i] = b[4*i] | (b[4*i+1] << 8) | (b[4*i+2] << 16) | ((uint32_t)b[4*i+3] << 24);
+	}
+	return 1;
+}
+
+/*----------------------------------------------------------------------------
+ *   Print "fmt" with 32-bit arguments "arg" or the string "str" for %s
+ *---------------------------------------------------------------------------*/
+static void format(const char *fmt, const uint32_t *arg, const char *str){
+	char spec[32];
+	const char *p;
+	int n, a = 0;
+
+	for(p = fmt; *p != 0; p++){
+		if(*p != '%'){
+			putchar(*p);
+			continue;
+		}
+		if(p[1] == '%'){
+			putchar('%');
+			p++;
+			continue;
+		}
+		/* Copy flags, width and precision, drop the length modifiers */
+		n = 0;
+		spec[n++] = *p++;
+		while(*p != 0 && strchr("-+ #0123456789.", *p) != NULL && n < (int)sizeof(spec) - 3){
+			spec[n++] = *p++;
+		}
+		while(*p != 0 && strchr("hlLqjzt", *p) != NULL){
+			p++;
+		}
+		if(*p == 0){
+			break;
+		}
+		spec[n++] = *p;
+		spec[n] = 0;
+		switch(*p){
+			case 's':
+				printf(spec, str != NULL ? str : "");
+				break;
+			case 'd':
+			case 'i':
+				printf(spec, (int)(int32_t)(a < 4 ? arg[a++] : 0));
+				break;
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			case 'c':
+				printf(spec, (unsigned)(a < 4 ? arg[a++] : 0));
+				break;
+			case 'p':
+				printf("0x%08x", (unsigned)(a < 4 ? arg[a++] : 0));
+				break;
+			default:
+				fputs(spec, stdout);
+				break;
+		}
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main
+ *---------------------------------------------------------------------------*/
+int main(void){
+	uint32_t rec[LOG_WORDS], arg[4], last_seq = 0, last_stamp = 0, seq, info, id, cnt, i, k;
+	uint64_t lost = 0;
+	int64_t  ticks = 0;
+	char     str[LOG_STR_MAX + 1];
+	int      ok;
+
+	ok = sync_header(rec);
+	while(ok){
+		/* Header: a new stream, e.g. after a reset of the target */
+		if(rec[0] == 0 && rec[1] == LOG_MAGIC){
+			if(rec[2] != 0){
+				freq = rec[2];
+			}
+			printf("# RTX log, %.0f Hz time stamps\n", freq);
+			last_seq = 0;
+			ok = record(rec);
+			continue;
+		}
+		seq  = rec[0];
+		info = rec[2];
+		id   = info & 0xFFFF;
+		cnt  = info >> 24;
+		/* Time stamps wrap around: extend them by the signed difference */
+		if(last_seq != 0){
+			ticks += (int32_t)(rec[1] - last_stamp);
+			if(seq != last_seq + 1){
+				lost += seq - last_seq - 1;
+				printf("# %u records lost\n", seq - last_seq - 1);
+			}
+		}
+		last_stamp = rec[1];
+		last_seq = seq;
+		now = ticks / freq;
+		if(cnt == 0){
+			ok = record(rec);			// rest of a string whose start was lost
+			continue;
+		}
+		/* The string of a %s message fills the argument words of its records */
+		memcpy(arg, &rec[3], sizeof(arg));
+		memset(str, 0, sizeof(str));
+		for(k = 0; k < cnt && k < 4; k++){
+			if(k != 0){
+				if(!(ok = record(rec)) || rec[0] != last_seq + 1 || (rec[2] >> 24) != 0){
+					break;
+				}
+				last_seq = rec[0];
+			}
+			for(i = 0; i < LOG_ARGS * 4; i++){
+				str[k * LOG_ARGS * 4 + i] = (char)(rec[3 + i/4] >> (8 * (i & 3)));
+			}
+		}
+		printf("%12.6f task %3u: ", now, (info >> 16) & 0xFF);
+		if(id < LOG_MSG_CNT){
+			format(fmts[id], arg, str);
+		}
+		else{
+			printf("message %u: %08x %08x %08x %08x", id, arg[0], arg[1], arg[2], arg[3]);
+		}
+		putchar('\n');
+		if(k == cnt || k == 4){
+			ok = record(rec);
+		}
+		/* else rec holds the record that ended the string, decode it next */
+	}
+	if(lost != 0){
+		fprintf(stderr, "log2txt: %llu records lost\n", (unsigned long long)lost);
+	}
+	return 0;
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cmsis_os.h"
+
+/*
+ * Host port smoke run: main and two worker threads exchange signals,
+ * messages and mails, share a mutex and a semaphore and count the runs of
+ * a periodic timer. Prints a line per check and exits with 0 when all of
+ * them passed, so it can be run from a script after a kernel change.
+ */
+
+#define POSIX_ROUNDS		1000
+
+void ping_thread(void const *argument);
+void pong_thread(void const *argument);
+void tick_timer(void const *argument);
+
+osThreadDef(ping_thread, osPriorityNormal, 1, 0);
+osThreadDef(pong_thread, osPriorityNormal, 1, 0);
+osTimerDef(tick_timer, tick_timer);
+osMessageQDef(ping_q, 4, uint32_t);
+osMailQDef(pong_q, 4, uint32_t);
+osMutexDef(count_mutex);
+osSemaphoreDef(done_sem);
+
+osThreadId main_id, ping_id, pong_id;
+osMessageQId ping_q_id;
+osMailQId pong_q_id;
+osMutexId count_mutex_id;
+osSemaphoreId done_sem_id;
+
+volatile uint32_t timer_runs;
+uint32_t shared_count;
+int failed;
+
+/*----------------------------------------------------------------------------
+ *   Ping Thread: sends numbers to pong, waits for each reply
+ *---------------------------------------------------------------------------*/
+void ping_thread(void const *argument){
+	uint32_t i;
+	osEvent evt;
+
+	for(i = 1; i <= POSIX_ROUNDS; i++){
+		osMessagePut(ping_q_id, i, osWaitForever);
+		evt = osSignalWait(0x01, osWaitForever);
+		if(evt.status != osEventSignal){
+			failed = 1;
+		}
+		osMutexWait(count_mutex_id, osWaitForever);
+		shared_count++;
+		osMutexRelease(count_mutex_id);
+	}
+	osSemaphoreRelease(done_sem_id);
+}
+
+/*----------------------------------------------------------------------------
+ *   Pong Thread: replies to each message with a mail and a signal
+ *---------------------------------------------------------------------------*/
+void pong_thread(void const *argument){
+	uint32_t *mail;
+	osEvent evt;
+
+	while(1){
+		evt = osMessageGet(ping_q_id, osWaitForever);
+		if(evt.status != osEventMessage){
+			failed = 1;
+			continue;
+		}
+		mail = osMailAlloc(pong_q_id, osWaitForever);
+		*mail = evt.value.v * 2;
+		osMailPut(pong_q_id, mail);
+		osSignalSet(ping_id, 0x01);
+		osMutexWait(count_mutex_id, osWaitForever);
+		shared_count++;
+		osMutexRelease(count_mutex_id);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Periodic timer callback
+ *---------------------------------------------------------------------------*/
+void tick_timer(void const *argument){
+	timer_runs++;
+}
+
+/*----------------------------------------------------------------------------
+ *   Print one check
+ *---------------------------------------------------------------------------*/
+static void check(const char *what, int ok){
+	printf("%-40s %s\n", what, ok ? "ok" : "FAILED");
+	if(!ok){
+		failed = 1;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main Thread
+ *---------------------------------------------------------------------------*/
+int main (void){
+	osTimerId tmr;
+	osEvent evt;
+	uint32_t i, sum, t0, t1;
+
+	main_id = osThreadGetId();
+	ping_q_id = osMessageCreate(osMessageQ(ping_q), NULL);
+	pong_q_id = osMailCreate(osMailQ(pong_q), NULL);
+	count_mutex_id = osMutexCreate(osMutex(count_mutex));
+	done_sem_id = osSemaphoreCreate(osSemaphore(done_sem), 0);
+	check("objects created", ping_q_id && pong_q_id && count_mutex_id && done_sem_id);
+
+	/*DELAY*/
+	t0 = osKernelSysTick();
+	osDelay(20);
+	t1 = osKernelSysTick();
+	check("osDelay(20) takes 19..40 ms", (t1 - t0) >= osKernelSysTickMicroSec(19000) &&
+	                                     (t1 - t0) <= osKernelSysTickMicroSec(40000));
+
+	/*TIMER*/
+	tmr = osTimerCreate(osTimer(tick_timer), osTimerPeriodic, NULL);
+	osTimerStart(tmr, 5);
+	osDelay(52);
+	osTimerStop(tmr);
+	check("periodic 5 ms timer ran 8..11 times", timer_runs >= 8 && timer_runs <= 11);
+	osTimerDelete(tmr);
+
+	/*THREADS AND QUEUES*/
+	ping_id = osThreadCreate(osThread(ping_thread), NULL);
+	pong_id = osThreadCreate(osThread(pong_thread), NULL);
+	sum = 0;
+	for(i = 0; i < POSIX_ROUNDS; i++){
+		evt = osMailGet(pong_q_id, osWaitForever);
+		if(evt.status != osEventMail){
+			break;
+		}
+		sum += *(uint32_t *)evt.value.p;
+		osMailFree(pong_q_id, evt.value.p);
+	}
+	check("mail replies received", sum == POSIX_ROUNDS * (POSIX_ROUNDS + 1));
+	check("ping thread done", osSemaphoreWait(done_sem_id, 1000) > 0);
+	osDelay(1);
+	check("mutex protected count", shared_count == 2 * POSIX_ROUNDS);
+	osThreadTerminate(pong_id);
+
+	/*TIMEOUTS*/
+	evt = osSignalWait(0x02, 10);
+	check("signal wait timeout", evt.status == osEventTimeout);
+	evt = osMessageGet(ping_q_id, 10);
+	check("message get timeout", evt.status == osEventTimeout);
+
+	printf("%s\n", failed ? "FAILED" : "PASSED");
+	exit(failed);
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Converts a kernel event trace dump (see Aplicacion/Other main/main_trace.c)
+ * to the Chrome trace event format:
+ *
+ *   trace2json < dump.txt > trace.json
+ *
+ * Every task gets a track with a slice while it runs and nested slices for
+ * its SVC calls; interrupts are instants on an own track, object waits and
+ * wake-ups are instants on the track of the task. Lines that are not part
+ * of the dump are skipped, gaps in the sequence numbers (events overwritten
+ * before they were read) are marked. The event codes match SRC/rt_Trace.h.
+ */
+
+#define TRC_TASK_SWITCH		0x01
+#define TRC_SVC_ENTER		0x02
+#define TRC_SVC_EXIT		0x03
+#define TRC_ISR_ENTER		0x04
+#define TRC_SEM_BLOCK		0x10
+#define TRC_SEM_WAKE		0x11
+#define TRC_MUT_BLOCK		0x12
+#define TRC_MUT_WAKE		0x13
+#define TRC_MBX_BLOCK		0x14
+#define TRC_MBX_WAKE		0x15
+#define TRC_GRP_BLOCK		0x16
+#define TRC_GRP_WAKE		0x17
+#define TRC_USER		0x80
+
+#define TID_NONE		256		// no task running yet
+#define TID_ISR			1000		// track of the interrupts
+
+static double   freq = 1e9;			// time stamp frequency [Hz]
+static double   now;				// time of the current event [us]
+static int      running = TID_NONE;		// task running at the current event
+static int      svc_open[256];			// open SVC slices per task
+static char     named[256];			// thread name written per task
+static int      first = 1;
+
+/*----------------------------------------------------------------------------
+ *   Write one trace event, "rest" holds further members or is empty
+ *---------------------------------------------------------------------------*/
+static void emit(const char *ph, int tid, const char *name, const char *rest){
+	printf("%s\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", first ? "" : ",", ph, tid, now);
+	if(name != NULL){
+		printf(",\"name\":\"%s\"", name);
+	}
+	printf("%s}", rest);
+	first = 0;
+}
+
+static void task_name(int tid){
+	char rest[64];
+
+	if(tid < 256 && !named[tid]){
+		named[tid] = 1;
+		if(tid == 255){
+			sprintf(rest, ",\"args\":{\"name\":\"idle\"}");
+		}
+		else{
+			sprintf(rest, ",\"args\":{\"name\":\"task %d\"}", tid);
+		}
+		emit("M", tid, "thread_name", rest);
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Task switch: close the slices of the old task, open one for the new task
+ *---------------------------------------------------------------------------*/
+static void task_switch(int tid){
+	if(tid == running){
+		return;
+	}
+	if(running != TID_NONE){
+		while(svc_open[running] > 0){
+			emit("E", running, NULL, "");
+			svc_open[running]--;
+		}
+		emit("E", running, NULL, "");
+	}
+	if(tid != TID_NONE){
+		task_name(tid);
+		emit("B", tid, tid == 255 ? "idle" : "running", "");
+	}
+	running = tid;
+}
+
+/*----------------------------------------------------------------------------
+ *   One event of the dump
+ *---------------------------------------------------------------------------*/
+static void event(uint32_t info, uint32_t arg){
+	static const char *obj[] = {"semaphore", "mutex", "mailbox", "event group"};
+	uint32_t code = info & 0xFF;
+	int      tid  = (info >> 8) & 0xFF;
+	uint32_t par  = info >> 16;
+	char     name[64], rest[96];
+
+	/* The recorded task is the running one, also after a gap in the dump */
+	task_switch(tid);
+
+	switch(code){
+		case TRC_TASK_SWITCH:
+			task_switch(arg & 0xFF);
+			break;
+		case TRC_SVC_ENTER:
+			sprintf(name, arg < 256 ? "svc %u" : "svc 0x%08x", arg);
+			emit("B", tid, name, "");
+			svc_open[tid]++;
+			break;
+		case TRC_SVC_EXIT:
+			if(svc_open[tid] > 0){		// else the task was switched out in the call
+				emit("E", tid, NULL, "");
+				svc_open[tid]--;
+			}
+			break;
+		case TRC_ISR_ENTER:
+			if(arg == 14){
+				strcpy(name, "PendSV");
+			}
+			else if(arg == 15){
+				strcpy(name, "SysTick");
+			}
+			else{
+				sprintf(name, "IRQ %d", (int)arg - 16);
+			}
+			emit("i", TID_ISR, name, ",\"s\":\"t\"");
+			break;
+		case TRC_SEM_BLOCK:
+		case TRC_MUT_BLOCK:
+		case TRC_MBX_BLOCK:
+		case TRC_GRP_BLOCK:
+			sprintf(name, "%s wait", obj[(code - TRC_SEM_BLOCK) / 2]);
+			sprintf(rest, ",\"s\":\"t\",\"args\":{\"object\":\"0x%08x\",\"timeout\":%u}", arg, par);
+			emit("i", tid, name, rest);
+			break;
+		case TRC_SEM_WAKE:
+		case TRC_MUT_WAKE:
+		case TRC_MBX_WAKE:
+		case TRC_GRP_WAKE:
+			sprintf(name, "%s wake", obj[(code - TRC_SEM_WAKE) / 2]);
+			sprintf(rest, ",\"s\":\"t\",\"args\":{\"object\":\"0x%08x\",\"task\":%u}", arg, par);
+			emit("i", tid, name, rest);
+			break;
+		case TRC_USER:
+			sprintf(name, "user %u", par);
+			sprintf(rest, ",\"s\":\"t\",\"args\":{\"value\":%u}", arg);
+			emit("i", tid, name, rest);
+			break;
+		default:
+			sprintf(name, "event 0x%02x", code);
+			emit("i", tid, name, ",\"s\":\"t\"");
+			break;
+	}
+}
+
+/*----------------------------------------------------------------------------
+ *   Main
+ *---------------------------------------------------------------------------*/
+int main(void){
+	char     line[256], rest[64];
+	uint32_t seq, stamp, info, arg, last_seq = 0, last_stamp = 0;
+	uint64_t lost = 0;
+	int64_t  ticks = 0;
+	double   f;
+
+	printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	emit("M", TID_ISR, "thread_name", ",\"args\":{\"name\":\"interrupts\"}");
+	while(fgets(line, sizeof(line), stdin) != NULL){
+		if(sscanf(line, "# RTX trace %lf", &f) == 1 && f > 0){
+			freq = f;
+			continue;
+		}
+		if(sscanf(line, "%x %x %x %x", &seq, &stamp, &info, &arg) != 4){
+			continue;
+		}
+		/* Time stamps wrap around: extend them by the signed difference */
+		if(last_seq != 0){
+			ticks += (int32_t)(stamp - last_stamp);
+		}
+		last_stamp = stamp;
+		now = ticks * 1e6 / freq;
+		if(last_seq != 0 && seq != last_seq + 1){
+			lost += seq - last_seq - 1;
+			sprintf(rest, ",\"s\":\"g\",\"args\":{\"events\":%u}", seq - last_seq - 1);
+			emit("i", TID_ISR, "events lost", rest);
+		}
+		last_seq = seq;
+		event(info, arg);
+	}
+	task_switch(TID_NONE);
+	printf("\n]}\n");
+	if(lost != 0){
+		fprintf(stderr, "trace2json: %llu events lost\n", (unsigned long long)lost);
+	}
+	return 0;
+}
+
+/*********************************************************************************************************
+      END FILE
+*********************************************************************************************************/
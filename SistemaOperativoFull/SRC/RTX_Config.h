@@ -40,6 +40,8 @@
 
 /* Definitions */
 #define BOX_ALIGN_8                   0x80000000
+#define STK_INIT                      0x10000000 /* os_stackinfo: watermark */
+#define STK_POOL                      0x20000000 /* os_stackinfo: stack pool */
 #define _declare_box(pool,size,cnt)   U32 pool[(((size)+3)/4)*(cnt) + 3]
 #define _declare_box8(pool,size,cnt)  U64 pool[(((size)+7)/8)*(cnt) + 2]
 #define _init_box8(pool,size,bsize)   _init_box (pool,size,(bsize) | BOX_ALIGN_8)
@@ -48,7 +50,13 @@
 extern U32 mp_tcb[];
 extern U64 mp_stk[];
 extern U32 os_fifo[];
+extern U32 os_trace_buf[];
+extern U32 os_log_buf[];
+extern U64 os_slab_mem[];
+extern U8  os_slab_page[];
+extern U64 os_hnd_mem[];
 extern void *os_active_TCB[];
+extern U32 os_tid_map[];
 
 /* Constants */
 extern U16 const os_maxtaskrun;
@@ -63,6 +71,12 @@ extern U32 const mp_stk_size;
 extern U32 const *m_tmr;
 extern U16 const mp_tmr_size;
 extern U8  const os_fifo_size;
+extern U32 const os_trace_size;
+extern U32 const os_log_size;
+extern U8  const os_statmode;
+extern U8  const os_edfprio;
+extern U16 const os_slab_pages;
+extern U8  const os_hnd_cnt;
 
 /* Functions */
 extern void os_idle_demon   (void);
@@ -70,6 +84,8 @@ extern int  os_tick_init    (void);
 extern U32  os_tick_val     (void);
 extern U32  os_tick_ovf     (void);
 extern void os_tick_irqack  (void);
+extern U32  os_tick_stretch (U32 ticks);
+extern U32  os_tick_restore (U32 ticks);
 extern void os_tmr_call     (U16  info);
 extern void os_error        (U32 err_code);
 
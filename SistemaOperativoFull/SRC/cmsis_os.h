@@ -452,7 +452,7 @@ os_InRegs osEvent osWait (uint32_t millisec);
 extern const osTimerDef_t os_timer_def_##name
 #else                            // define the object
 #define osTimerDef(name, function)  \
-uint32_t os_timer_cb_##name[5]; \
+void *os_timer_cb_##name[6]; \
 const osTimerDef_t os_timer_def_##name = \
 { (function), (os_timer_cb_##name) }
 #endif
@@ -527,7 +527,7 @@ os_InRegs osEvent osSignalWait (int32_t signals, uint32_t millisec);
 extern const osMutexDef_t os_mutex_def_##name
 #else                            // define the object
 #define osMutexDef(name)  \
-uint32_t os_mutex_cb_##name[3]; \
+void *os_mutex_cb_##name[3]; \
 const osMutexDef_t os_mutex_def_##name = { (os_mutex_cb_##name) }
 #endif
 
@@ -577,7 +577,7 @@ osStatus osMutexDelete (osMutexId mutex_id);
 extern const osSemaphoreDef_t os_semaphore_def_##name
 #else                            // define the object
 #define osSemaphoreDef(name)  \
-uint32_t os_semaphore_cb_##name[2]; \
+void *os_semaphore_cb_##name[3]; \
 const osSemaphoreDef_t os_semaphore_def_##name = { (os_semaphore_cb_##name) }
 #endif
 
@@ -632,7 +632,7 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id);
 extern const osPoolDef_t os_pool_def_##name
 #else                            // define the object
 #define osPoolDef(name, no, type)   \
-uint32_t os_pool_m_##name[3+((sizeof(type)+3)/4)*(no)]; \
+void *os_pool_m_##name[3+((sizeof(type)+sizeof(void *)-1)/sizeof(void *))*(no)]; \
 const osPoolDef_t os_pool_def_##name = \
 { (no), sizeof(type), (os_pool_m_##name) }
 #endif
@@ -687,7 +687,7 @@ osStatus osPoolFree (osPoolId pool_id, void *block);
 extern const osMessageQDef_t os_messageQ_def_##name
 #else                            // define the object
 #define osMessageQDef(name, queue_sz, type)   \
-uint32_t os_messageQ_q_##name[4+(queue_sz)]; \
+void *os_messageQ_q_##name[4+(queue_sz)]; \
 const osMessageQDef_t os_messageQ_def_##name = \
 { (queue_sz), (os_messageQ_q_##name) }
 #endif
@@ -739,8 +739,8 @@ os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec);
 extern const osMailQDef_t os_mailQ_def_##name
 #else                            // define the object
 #define osMailQDef(name, queue_sz, type) \
-uint32_t os_mailQ_q_##name[4+(queue_sz)]; \
-uint32_t os_mailQ_m_##name[3+((sizeof(type)+3)/4)*(queue_sz)]; \
+void *os_mailQ_q_##name[4+(queue_sz)]; \
+void *os_mailQ_m_##name[3+((sizeof(type)+sizeof(void *)-1)/sizeof(void *))*(queue_sz)]; \
 void *   os_mailQ_p_##name[2] = { (os_mailQ_q_##name), os_mailQ_m_##name }; \
 const osMailQDef_t os_mailQ_def_##name =  \
 { (queue_sz), sizeof(type), (os_mailQ_p_##name) }
@@ -798,6 +798,478 @@ osStatus osMailFree (osMailQId queue_id, void *mail);
 #endif  // Mail Queues available
 
 
+//  ==== RTX Extensions ====
+
+/// Stretch the system tick up to the next kernel deadline and suspend the thread scheduler.
+/// \return number of ticks the system can sleep, 0 if sleeping is not possible now.
+/// \note Called by the idle demon only; a non-zero return must be followed by \ref os_tickless_exit.
+uint32_t os_tickless_enter (void);
+
+/// Check whether the tickless sleep goes on: the tick has not ended it and no interrupt
+/// has requested a post service since \ref os_tickless_enter.
+/// \return non-zero while the idle demon may sleep, 0 when it must call \ref os_tickless_exit.
+/// \note Called by the idle demon only, as the condition of a WFE loop.
+uint32_t os_tickless_sleep (void);
+
+/// Restore the periodic system tick after sleeping and resume the thread scheduler.
+/// \note Called by the idle demon only.
+void os_tickless_exit (void);
+
+/// Start recording kernel events into the trace buffer (OS_TRACE in RTX_Conf_CM.c).
+/// \return status code that indicates the execution status of the function.
+osStatus os_trace_start (void);
+
+/// Stop recording kernel events, recorded events can still be read.
+void os_trace_stop (void);
+
+/// Record the entry of an interrupt handler, called at the start of the handler.
+void os_trace_isr (void);
+
+/// Record an application event.
+/// \param[in]     id            application event number 0..65535.
+/// \param[in]     arg           application event value.
+void os_trace_user (uint32_t id, uint32_t arg);
+
+/// Copy recorded events not read yet to a buffer, oldest first.
+/// \param[out]    buf           buffer of 4 words per event: sequence number + 1, time stamp
+///                              in \ref osKernelSysTickFrequency cycles, event code | task id << 8 |
+///                              par << 16, arg.
+/// \param[in]     count         maximum number of events to copy.
+/// \return number of events copied.
+/// \note One reader only; events overwritten before they were read are skipped.
+uint32_t os_trace_read (uint32_t *buf, uint32_t count);
+
+/// Record a log message into the log buffer (OS_LOG in RTX_Conf_CM.c) without formatting it.
+/// \param[in]     id            message number 0..65535, index of the format string on the host.
+/// \param[in]     a0..a3        arguments of the format string, unused ones are ignored.
+/// \note Can be called from interrupt service routines.
+void os_log (uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/// Record a log message with a copy of a string of up to 80 characters, for a %s format.
+/// \param[in]     id            message number 0..65535.
+/// \param[in]     str           string to copy.
+/// \note Can be called from interrupt service routines.
+void os_log_str (uint32_t id, const char *str);
+
+/// Copy log records not read yet to a buffer, oldest first.
+/// \param[out]    buf           buffer of 8 words per record: sequence number + 1, time stamp
+///                              in \ref osKernelSysTickFrequency cycles, id | task id << 16 |
+///                              records of the message << 24, 5 argument words.
+/// \param[in]     count         maximum number of records to copy.
+/// \return number of records copied.
+/// \note One reader only; records overwritten before they were read are skipped.
+uint32_t os_log_read (uint32_t *buf, uint32_t count);
+
+/// Fill the 8 words of the record that starts a log stream for the host decoder.
+/// \param[out]    buf           header record: 0, "RLOG", \ref osKernelSysTickFrequency.
+void os_log_header (uint32_t *buf);
+
+/// Runtime statistics of a thread, see \ref os_thread_get_stats.
+typedef struct os_thread_stats  {
+  uint64_t                run_time;    ///< running time in \ref osKernelSysTickFrequency cycles
+  uint64_t              total_time;    ///< time since the kernel start in \ref osKernelSysTickFrequency cycles
+  uint32_t                switches;    ///< number of times the thread was switched in
+  uint32_t             latency_max;    ///< longest ready to running latency in cycles
+  uint16_t              latency[8];    ///< latency histogram: bin n < 7 counts latencies below 256 << 2n cycles, bin 7 longer ones
+} os_thread_stats_t;
+
+/// Get the runtime statistics of a thread (OS_STATS in RTX_Conf_CM.c).
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId, NULL for the idle demon.
+/// \param[out]    stats         statistics of the thread.
+/// \return status code that indicates the execution status of the function.
+/// \note The CPU usage of the thread is run_time / total_time; the idle demon run_time includes the time slept.
+osStatus os_thread_get_stats (osThreadId thread_id, os_thread_stats_t *stats);
+
+/// Stack use of a thread, see \ref os_thread_get_stack.
+typedef struct os_thread_stack  {
+  uint32_t                    size;    ///< stack size in bytes
+  uint32_t                max_used;    ///< peak stack use in bytes since the thread was created
+} os_thread_stack_t;
+
+/// Get the stack size and the peak stack use of a thread (OS_STKINIT in RTX_Conf_CM.c).
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId, NULL for the idle demon.
+/// \param[out]    stack         stack use of the thread.
+/// \return status code that indicates the execution status of the function.
+/// \note The peak is the deepest stack word that no longer holds the fill pattern; size
+///       osThreadDef stacksz or OS_STKSIZE from it with a margin for untested paths.
+osStatus os_thread_get_stack (osThreadId thread_id, os_thread_stack_t *stack);
+
+/// Get the index of a thread in the kernel thread table, in constant time.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return index 1..number of threads (OS_TASKCNT plus the kernel threads), 0 for no active thread.
+/// \note Can be called from interrupt service routines. A freed index is given to the next
+///       thread created, lowest index first.
+uint32_t os_thread_get_index (osThreadId thread_id);
+
+/// Get the thread at an index of the kernel thread table, in constant time.
+/// \param[in]     index         index of the thread, see \ref os_thread_get_index.
+/// \return thread ID or NULL when no thread has the index.
+/// \note Can be called from interrupt service routines.
+osThreadId os_thread_get_by_index (uint32_t index);
+
+/// Set the round robin time slice of a thread (OS_ROBIN in RTX_Conf_CM.c).
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \param[in]     ticks         time slice in system ticks, 0 for the slice of its priority level.
+/// \return status code that indicates the execution status of the function.
+/// \note The slice of a thread only runs while another ready thread has the same priority.
+osStatus os_thread_set_slice (osThreadId thread_id, uint32_t ticks);
+
+/// Set the round robin time slice of the threads of a priority level without an own slice.
+/// \param[in]     priority      priority level.
+/// \param[in]     ticks         time slice in system ticks, 0 for OS_ROBINTOUT of RTX_Conf_CM.c.
+/// \return status code that indicates the execution status of the function.
+osStatus os_priority_set_slice (osPriority priority, uint32_t ticks);
+
+/// Get the round robin time slice a thread runs with: its own, of its priority level or OS_ROBINTOUT.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return time slice in system ticks, 0 in case of error or with round robin disabled.
+uint32_t os_thread_get_slice (osThreadId thread_id);
+
+/// Put a thread into the earliest deadline first class (OS_EDFPRIO in RTX_Conf_CM.c) or back
+/// to fixed priority. EDF threads run on the EDF priority level ordered by the absolute
+/// deadline of their current job; their first job is released now.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \param[in]     period        release period in millisec, 0 to leave the EDF class.
+/// \param[in]     deadline      deadline relative to each release in millisec, 1..period, 0 for period.
+/// \return status code that indicates the execution status of the function.
+/// \note A thread that leaves the EDF class keeps the EDF priority until \ref osThreadSetPriority.
+osStatus os_thread_set_edf (osThreadId thread_id, uint32_t period, uint32_t deadline);
+
+/// End the current job of the running EDF thread and wait for the release of the next job,
+/// one period after the release of the current one.
+/// \return status code that indicates the execution status of the function.
+/// \note A job that ends after its deadline counts as a deadline miss.
+osStatus os_edf_wait (void);
+
+/// EDF parameters and deadline statistics of a thread, see \ref os_thread_get_edf.
+typedef struct os_edf_stats  {
+  uint32_t                  period;    ///< release period in millisec
+  uint32_t                deadline;    ///< relative deadline in millisec
+  uint32_t                    jobs;    ///< jobs ended with \ref os_edf_wait
+  uint32_t                  misses;    ///< jobs ended after their deadline
+  uint32_t            lateness_max;    ///< longest time a job ended after its deadline in millisec
+} os_edf_stats_t;
+
+/// Get the EDF parameters and deadline statistics of a thread.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \param[out]    stats         parameters and statistics of the thread.
+/// \return status code that indicates the execution status of the function.
+osStatus os_thread_get_edf (osThreadId thread_id, os_edf_stats_t *stats);
+
+/// Allocate a block of the kernel slab memory (OS_SLABSZ in RTX_Conf_CM.c).
+/// \param[in]     size          block size in bytes, 1..256.
+/// \return address of the block, 8-byte aligned, or NULL if the size class has no free block.
+/// \note Can be called from threads and interrupt service routines.
+void *os_slab_alloc (uint32_t size);
+
+/// Return a block allocated by \ref os_slab_alloc to the slab memory.
+/// \param[in]     block         address of the block.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from threads and interrupt service routines.
+osStatus os_slab_free (void *block);
+
+/// Use of a size class of the slab memory, see \ref os_slab_get_stats.
+typedef struct os_slab_stats  {
+  uint32_t              block_size;    ///< block size of the class in bytes
+  uint32_t                  allocs;    ///< successful allocations since the kernel start
+  uint32_t                failures;    ///< failed allocations since the kernel start
+  uint16_t                    used;    ///< blocks in use
+  uint16_t                max_used;    ///< maximum of blocks in use
+  uint16_t                   pages;    ///< 256 byte pages taken by the class
+  uint16_t              free_pages;    ///< pages of the slab memory not taken by any class
+} os_slab_stats_t;
+
+/// Get the use of a size class of the slab memory.
+/// \param[in]     cls           size class 0..5 for blocks of 8 << cls bytes.
+/// \param[out]    stats         use of the class.
+/// \return status code that indicates the execution status of the function.
+/// \note Pages stay with their class: pages * 256 bytes cover the peak of the class.
+osStatus os_slab_get_stats (uint32_t cls, os_slab_stats_t *stats);
+
+#if (defined (osFeature_Pool)  &&  (osFeature_Pool != 0))
+/// Define a Memory Pool whose blocks are taken from the slab memory when allocated,
+/// created and used like a pool of \ref osPoolDef.
+/// \param         name          name of the memory pool.
+/// \param         no            maximum number of blocks in use.
+/// \param         type          data type of a single block, up to 256 bytes.
+#if defined (osObjectsExternal)  // object is external
+#define os_pool_slab_def(name, no, type)   \
+extern const osPoolDef_t os_pool_def_##name
+#else                            // define the object
+#define os_pool_slab_def(name, no, type)   \
+const osPoolDef_t os_pool_def_##name = \
+{ (no), sizeof(type), NULL }
+#endif
+#endif
+
+/// Handle of an opened driver unit, returned by the open functions of the drivers, 0 if not opened.
+/// It names the driver, the table entry and its generation: a closed handle is rejected
+/// even when the entry is open again.
+typedef uint32_t os_handle_t;
+
+/// Open a unit of a driver in the driver handle table (OS_HNDCNT in RTX_Conf_CM.c).
+/// \param[in]     driver        driver id 1..255.
+/// \param[in]     unit          unit of the driver 0..254, only one handle per unit;
+///                              255 for drivers that are opened many times.
+/// \param[in]     obj           object of the driver kept with the handle or NULL.
+/// \return handle owned by the calling thread, 0 if the unit is open or the table is full.
+/// \note A handle its owner still holds when it terminates is closed; the object kept
+///       with it stays with the driver.
+os_handle_t os_handle_open (uint32_t driver, uint32_t unit, void *obj);
+
+/// Check that the calling thread may use a handle.
+/// \param[in]     handle        handle obtained from an open function.
+/// \param[in]     driver        driver id the handle must belong to.
+/// \return status code: osOK, osErrorParameter if the handle is closed, of another driver or owned by another thread.
+osStatus os_handle_check (os_handle_t handle, uint32_t driver);
+
+/// Let every thread use a handle, e.g. to share one UART port between several threads.
+/// \param[in]     handle        handle usable by the calling thread.
+/// \return status code that indicates the execution status of the function.
+osStatus os_handle_share (os_handle_t handle);
+
+/// Make a thread the only user of a handle; the thread may then share or give it again.
+/// \param[in]     handle        handle usable by the calling thread.
+/// \param[in]     thread_id     thread ID of the new owner.
+/// \return status code that indicates the execution status of the function.
+osStatus os_handle_give (os_handle_t handle, osThreadId thread_id);
+
+/// Close a handle opened with \ref os_handle_open, all its copies become invalid.
+/// \param[in]     handle        handle usable by the calling thread.
+/// \param[in]     driver        driver id the handle must belong to.
+/// \return status code that indicates the execution status of the function.
+/// \note The drivers close their handles with their own close functions.
+osStatus os_handle_close (os_handle_t handle, uint32_t driver);
+
+/// Queue ID identifies a queue of inline payloads (pointer to a queue control block).
+typedef struct os_queue_cb *os_queue_id;
+
+/// Definition structure for a queue of inline payloads, see \ref os_queue_def.
+typedef struct os_queue_def  {
+  uint32_t                queue_sz;    ///< number of payloads in the queue
+  uint32_t                 item_sz;    ///< size of a payload in bytes
+  void                       *pool;    ///< memory array for the payloads
+} os_queue_def_t;
+
+/// Define a queue whose slots hold copies of payloads of a fixed size.
+/// \param         name          name of the queue.
+/// \param         queue_sz      maximum number of payloads in the queue.
+/// \param         type          data type of a payload, up to 1020 bytes.
+#if defined (osObjectsExternal)  // object is external
+#define os_queue_def(name, queue_sz, type)   \
+extern const os_queue_def_t os_queue_def_##name
+#else                            // define the object
+#define os_queue_def(name, queue_sz, type)   \
+void *os_queue_q_##name[4+(((queue_sz)*((sizeof(type)+3)&~3)+sizeof(void *)-1)/sizeof(void *))]; \
+const os_queue_def_t os_queue_def_##name = \
+{ (queue_sz), sizeof(type), (os_queue_q_##name) }
+#endif
+
+/// Access a queue definition.
+/// \param         name          name of the queue.
+#define os_queue(name)  \
+&os_queue_def_##name
+
+/// Create and initialize a queue of inline payloads.
+/// \param[in]     queue_def     queue definition referenced with \ref os_queue.
+/// \return queue ID for reference by other functions or NULL in case of error.
+os_queue_id os_queue_create (const os_queue_def_t *queue_def);
+
+/// Copy a payload to a queue.
+/// \param[in]     queue_id      queue ID obtained with \ref os_queue_create.
+/// \param[in]     data          payload of item_sz bytes, 4-byte aligned.
+/// \param[in]     millisec      timeout value or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from interrupt service routines with millisec 0.
+osStatus os_queue_put (os_queue_id queue_id, const void *data, uint32_t millisec);
+
+/// Copy the oldest payload from a queue or wait for one.
+/// \param[in]     queue_id      queue ID obtained with \ref os_queue_create.
+/// \param[out]    data          buffer of item_sz bytes, 4-byte aligned.
+/// \param[in]     millisec      timeout value or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from threads only.
+osStatus os_queue_get (os_queue_id queue_id, void *data, uint32_t millisec);
+
+/// Event group ID identifies an event group of 32 flags (pointer to an event group control block).
+typedef struct os_group_cb *os_group_id;
+
+/// Definition structure for an event group, see \ref os_group_def.
+typedef struct os_group_def  {
+  void                      *group;    ///< pointer to internal data
+} os_group_def_t;
+
+/// Define an event group, the flags of it are shared by all threads.
+/// \param         name          name of the event group.
+#if defined (osObjectsExternal)  // object is external
+#define os_group_def(name)  \
+extern const os_group_def_t os_group_def_##name
+#else                            // define the object
+#define os_group_def(name)  \
+void *os_group_cb_##name[4]; \
+const os_group_def_t os_group_def_##name = { (os_group_cb_##name) }
+#endif
+
+/// Access an event group definition.
+/// \param         name          name of the event group.
+#define os_group(name)  \
+&os_group_def_##name
+
+/// Options of \ref os_group_wait.
+#define os_group_wait_all      0x01    ///< wait for all flags, otherwise for any of them
+#define os_group_wait_clear    0x02    ///< clear the flags that ended the wait
+
+/// Create and initialize an event group.
+/// \param[in]     group_def     event group definition referenced with \ref os_group.
+/// \param[in]     flags         flags set at the start.
+/// \return event group ID for reference by other functions or NULL in case of error.
+os_group_id os_group_create (const os_group_def_t *group_def, uint32_t flags);
+
+/// Set flags of an event group; every waiting thread whose wait is met becomes ready in
+/// one pass and the caller is preempted at most once.
+/// \param[in]     group_id      event group ID obtained with \ref os_group_create.
+/// \param[in]     flags         flags to set.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from interrupt service routines.
+osStatus os_group_set (os_group_id group_id, uint32_t flags);
+
+/// Clear flags of an event group.
+/// \param[in]     group_id      event group ID obtained with \ref os_group_create.
+/// \param[in]     flags         flags to clear.
+/// \return status code that indicates the execution status of the function.
+osStatus os_group_clear (os_group_id group_id, uint32_t flags);
+
+/// Get the flags of an event group.
+/// \param[in]     group_id      event group ID obtained with \ref os_group_create.
+/// \return flags of the event group, 0 in case of error.
+/// \note Can be called from interrupt service routines.
+uint32_t os_group_get (os_group_id group_id);
+
+/// Wait for any or all of some flags of an event group.
+/// \param[in]     group_id      event group ID obtained with \ref os_group_create.
+/// \param[in]     flags         flags to wait for, not 0.
+/// \param[in]     options       0 or \ref os_group_wait_all and \ref os_group_wait_clear.
+/// \param[in]     millisec      timeout value or 0 in case of no time-out.
+/// \return event flag information or error code: status osEventSignal with the awaited flags
+///         that are set in value.signals, osEventTimeout or osOK when they are not set.
+/// \note Flags stay set unless \ref os_group_wait_clear is given, so that one set wakes all
+///       threads waiting for it; with it the flags go to the waiting threads by priority.
+os_InRegs osEvent os_group_wait (os_group_id group_id, uint32_t flags, uint32_t options, uint32_t millisec);
+
+/// Delete an event group, waiting threads return with osErrorResource.
+/// \param[in]     group_id      event group ID obtained with \ref os_group_create.
+/// \return status code that indicates the execution status of the function.
+osStatus os_group_delete (os_group_id group_id);
+
+/// Work item ID identifies a work item (pointer to a work item control block).
+typedef struct os_work_cb *os_work_id;
+
+/// Definition structure for a work item, see \ref os_work_def.
+typedef struct os_work_def  {
+  os_ptimer                  func;     ///< work function
+  uint8_t                    lane;     ///< lane of the worker thread, 0 is the highest priority
+  uint8_t                coalesce;     ///< submits of a queued item run it once
+  void                      *work;     ///< pointer to internal data
+} os_work_def_t;
+
+/// Submit and run counts of a work item, see \ref os_work_get_stats.
+typedef struct os_work_stats {
+  uint32_t               submits;      ///< submits since the creation
+  uint32_t                  runs;      ///< runs of the work function since the creation
+} os_work_stats_t;
+
+/// Define a work item run by the worker thread of a lane (OS_WORKLANES in RTX_Conf_CM.c).
+/// \param         name          name of the work item.
+/// \param         function      name of the work function.
+/// \param         lane          lane of the worker thread, 0 is the highest priority.
+/// \param         coalesce      1: submits of a queued item run it once; 0: each submit runs it.
+#if defined (osObjectsExternal)  // object is external
+#define os_work_def(name, function, lane, coalesce)  \
+extern const os_work_def_t os_work_def_##name
+#else                            // define the object
+#define os_work_def(name, function, lane, coalesce)  \
+void *os_work_cb_##name[11]; \
+const os_work_def_t os_work_def_##name = \
+{ (function), (lane), (coalesce), (os_work_cb_##name) }
+#endif
+
+/// Access a work item definition.
+/// \param         name          name of the work item.
+#define os_work(name)  \
+&os_work_def_##name
+
+/// Create a work item.
+/// \param[in]     work_def      work item definition referenced with \ref os_work.
+/// \param[in]     argument      argument to the work function.
+/// \return work item ID for reference by other functions or NULL in case of error.
+os_work_id os_work_create (const os_work_def_t *work_def, void *argument);
+
+/// Submit a work item to the worker thread of its lane; the worker runs the queued items
+/// in submit order.
+/// \param[in]     work_id       work item ID obtained with \ref os_work_create.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from interrupt service routines, the submit does not block.
+osStatus os_work_submit (os_work_id work_id);
+
+/// Submit a work item after a delay, a running delay of the item is restarted.
+/// \param[in]     work_id       work item ID obtained with \ref os_work_create.
+/// \param[in]     millisec      delay, 0 submits at once.
+/// \return status code that indicates the execution status of the function.
+osStatus os_work_submit_delayed (os_work_id work_id, uint32_t millisec);
+
+/// Cancel the delay of a work item; a submit already queued still runs.
+/// \param[in]     work_id       work item ID obtained with \ref os_work_create.
+/// \return status code that indicates the execution status of the function.
+osStatus os_work_cancel (os_work_id work_id);
+
+/// Get the submit and run counts of a work item.
+/// \param[in]     work_id       work item ID obtained with \ref os_work_create.
+/// \param[out]    stats         submit and run counts.
+/// \return status code that indicates the execution status of the function.
+/// \note Can be called from interrupt service routines.
+osStatus os_work_get_stats (os_work_id work_id, os_work_stats_t *stats);
+
+#if (defined (osFeature_MessageQ)  &&  (osFeature_MessageQ != 0))
+/// Put up to count messages to a message queue in one kernel call, waiting threads
+/// are made ready and the caller is preempted once for the whole batch.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[in]     info          array of count message information.
+/// \param[in]     count         number of messages to put.
+/// \param[in]     millisec      timeout value when none fits or 0 in case of no time-out.
+/// \return number of messages put, -1 in case of a parameter error.
+/// \note Can be called from interrupt service routines with millisec 0.
+int32_t os_message_put_batch (osMessageQId queue_id, const uint32_t *info, uint32_t count, uint32_t millisec);
+
+/// Get up to count messages from a message queue in one kernel call.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[out]    info          array for count message information.
+/// \param[in]     count         maximum number of messages to get.
+/// \param[in]     millisec      timeout value when the queue is empty or 0 in case of no time-out.
+/// \return number of messages got, -1 in case of a parameter error.
+/// \note Can be called from interrupt service routines with millisec 0.
+int32_t os_message_get_batch (osMessageQId queue_id, uint32_t *info, uint32_t count, uint32_t millisec);
+#endif
+
+#if (defined (osFeature_MailQ)  &&  (osFeature_MailQ != 0))
+/// Put up to count mails allocated with \ref osMailAlloc to a mail queue in one kernel call.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[in]     mail          array of count pointers to memory blocks.
+/// \param[in]     count         number of mails to put.
+/// \return number of mails put, -1 in case of a parameter error.
+/// \note Can be called from interrupt service routines.
+int32_t os_mail_put_batch (osMailQId queue_id, void *const *mail, uint32_t count);
+
+/// Get up to count mails from a mail queue in one kernel call, each is freed with \ref osMailFree.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[out]    mail          array for count pointers to memory blocks.
+/// \param[in]     count         maximum number of mails to get.
+/// \param[in]     millisec      timeout value when the queue is empty or 0 in case of no time-out.
+/// \return number of mails got, -1 in case of a parameter error.
+/// \note Can be called from interrupt service routines with millisec 0.
+int32_t os_mail_get_batch (osMailQId queue_id, void **mail, uint32_t count, uint32_t millisec);
+#endif
+
+
 #ifdef  __cplusplus
 }
 #endif
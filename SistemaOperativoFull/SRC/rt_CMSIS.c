@@ -40,6 +40,8 @@
   #include "core_cm3.h"
 #elif defined (__CORTEX_M0)
   #include "core_cm0.h"
+#elif defined (__RTX_POSIX)
+  #include "core_posix.h"
 #else
   #error "Missing __CORTEX_Mx definition"
 #endif
@@ -54,8 +56,18 @@
 #include "rt_Mutex.h"
 #include "rt_Semaphore.h"
 #include "rt_Mailbox.h"
+#include "rt_Queue.h"
+#include "rt_Group.h"
 #include "rt_MemBox.h"
 #include "rt_Memory.h"
+#include "rt_Wheel.h"
+#include "rt_Trace.h"
+#include "rt_Log.h"
+#include "rt_Stats.h"
+#include "rt_Slab.h"
+#include "rt_Handle.h"
+#include "rt_Robin.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
 #define os_thread_cb OS_TCB
@@ -133,6 +145,93 @@ static __inline   t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                       \
 #define SVC_1_2 SVC_1_1 
 #define SVC_1_3 SVC_1_1 
 #define SVC_2_3 SVC_2_1 
+#define SVC_4_3 SVC_4_1 
+
+#elif defined (__RTX_POSIX)     /* Host port (GNU Compiler) */
+
+#define __NO_RETURN __attribute__((noreturn))
+
+#define osEvent_type       osEvent
+#define osEvent_ret_status ret
+#define osEvent_ret_value  ret
+#define osEvent_ret_msg    ret
+#define osEvent_ret_mail   ret
+
+#define osCallback_type    osCallback
+#define osCallback_ret     ret
+
+// Return values pass through R0..R3 of the caller's exception frame, so a
+// value set by rt_ret_val while the thread is blocked reaches the caller.
+#define SVC_Put_RET_pointer    __r[0] = (uint32_t)(uintptr_t)ret;
+#define SVC_Put_RET_int32_t    __r[0] = (uint32_t)ret;
+#define SVC_Put_RET_uint32_t   __r[0] = (uint32_t)ret;
+#define SVC_Put_RET_osStatus   __r[0] = (uint32_t)ret;
+#define SVC_Put_RET_osPriority __r[0] = (uint32_t)ret;
+#define SVC_Put_RET_osEvent                                                    \
+  __r[0] = (uint32_t)ret.status;                                               \
+  __r[1] = ret.value.v;                                                        \
+  __r[2] = (uint32_t)(uintptr_t)ret.def.message_id;
+#define SVC_Put_RET_osCallback                                                 \
+  __r[0] = (uint32_t)(uintptr_t)ret.fp;                                        \
+  __r[1] = (uint32_t)(uintptr_t)ret.arg;
+
+#define SVC_Get_RET_pointer(t)    ret = (t)(uintptr_t)__r[0];
+#define SVC_Get_RET_int32_t(t)    ret = (t)__r[0];
+#define SVC_Get_RET_uint32_t(t)   ret = (t)__r[0];
+#define SVC_Get_RET_osStatus(t)   ret = (t)__r[0];
+#define SVC_Get_RET_osPriority(t) ret = (t)__r[0];
+#define SVC_Get_RET_osEvent(t)                                                 \
+  ret.status = (osStatus)__r[0];                                               \
+  ret.value.p = (void *)(uintptr_t)__r[1];                                     \
+  ret.def.message_id = (osMessageQId)(uintptr_t)__r[2];
+#define SVC_Get_RET_osCallback(t)                                              \
+  ret.fp  = (void *)(uintptr_t)__r[0];                                         \
+  ret.arg = (void *)(uintptr_t)__r[1];
+
+#define SVC_Call(f,t,rv,args)                                                  \
+  t ret;                                                                       \
+  uint32_t __r[4];                                                             \
+  os_svc_enter((uint32_t)(uintptr_t)f);                                        \
+  ret = f args;                                                                \
+  SVC_Put_##rv                                                                 \
+  os_svc_exit((uint32_t)(uintptr_t)f, __r);                                    \
+  SVC_Get_##rv(t)                                                              \
+  return ret;
+
+#define SVC_0_1(f,t,rv)                                                        \
+                  t     f (void);                                              \
+static inline  t __##f (void) {                                                \
+  SVC_Call(f,t,rv,())                                                          \
+}
+
+#define SVC_1_1(f,t,t1,rv)                                                     \
+                  t     f (t1 a1);                                             \
+static inline  t __##f (t1 a1) {                                               \
+  SVC_Call(f,t,rv,(a1))                                                        \
+}
+
+#define SVC_2_1(f,t,t1,t2,rv)                                                  \
+                  t     f (t1 a1, t2 a2);                                      \
+static inline  t __##f (t1 a1, t2 a2) {                                        \
+  SVC_Call(f,t,rv,(a1,a2))                                                     \
+}
+
+#define SVC_3_1(f,t,t1,t2,t3,rv)                                               \
+                  t     f (t1 a1, t2 a2, t3 a3);                               \
+static inline  t __##f (t1 a1, t2 a2, t3 a3) {                                 \
+  SVC_Call(f,t,rv,(a1,a2,a3))                                                  \
+}
+
+#define SVC_4_1(f,t,t1,t2,t3,t4,rv)                                            \
+                  t     f (t1 a1, t2 a2, t3 a3, t4 a4);                        \
+static inline  t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                          \
+  SVC_Call(f,t,rv,(a1,a2,a3,a4))                                               \
+}
+
+#define SVC_1_2 SVC_1_1 
+#define SVC_1_3 SVC_1_1 
+#define SVC_2_3 SVC_2_1 
+#define SVC_4_3 SVC_4_1 
 
 #elif defined (__GNUC__)        /* GNU Compiler */
 
@@ -260,6 +359,7 @@ static inline  t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                          \
 #define SVC_1_2 SVC_1_1 
 #define SVC_1_3 SVC_1_1 
 #define SVC_2_3 SVC_2_1 
+#define SVC_4_3 SVC_4_1 
 
 #elif defined (__ICCARM__)      /* IAR Compiler */
 
@@ -371,6 +471,21 @@ static inline t __##f (t1 a1, t2 a2) {                                         \
   return ret;                                                                  \
 }
 
+#define SVC_4_3(f,t,t1,t2,t3,t4,rr)                                            \
+t f (t1 a1, t2 a2, t3 a3, t4 a4);                                              \
+void f##_ (t1 a1, t2 a2, t3 a3, t4 a4) {                                       \
+  f(a1,a2,a3,a4);                                                              \
+  SVC_Ret3();                                                                  \
+}                                                                              \
+_Pragma("swi_number=0") __swi void _##f (t1 a1, t2 a2, t3 a3, t4 a4);          \
+static inline t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                           \
+  t ret;                                                                       \
+  SVC_Setup(f##_);                                                             \
+  _##f(a1,a2,a3,a4);                                                           \
+  __asm("" : rr : :);                                                            \
+  return ret;                                                                  \
+}
+
 #endif
 
 
@@ -397,6 +512,11 @@ extern       osThreadId      osThreadId_osTimerThread;
 extern const osMessageQDef_t os_messageQ_def_osTimerMessageQ;
 extern       osMessageQId    osMessageQId_osTimerMessageQ;
 
+// OS Work Queues external resources
+extern const osThreadDef_t   os_thread_def_osWorkThread;
+extern       void           *os_work_mem[];
+extern const uint8_t         os_work_lanes;
+
 
 // ==== Helper Functions ====
 
@@ -432,6 +552,10 @@ P_TCB rt_tid2ptcb (osThreadId thread_id) {
 
   if (ptcb->cb_type != TCB) return NULL;
 
+  // Active threads only: a terminated thread is no longer in the TCB table
+  if ((ptcb->task_id == 0) || (ptcb->task_id > os_maxtaskrun)) return NULL;
+  if (os_active_TCB[ptcb->task_id - 1] != ptcb) return NULL;
+
   return ptcb;
 }
 
@@ -461,10 +585,14 @@ SVC_0_1(svcKernelInitialize, osStatus, RET_osStatus)
 SVC_0_1(svcKernelStart,      osStatus, RET_osStatus)
 SVC_0_1(svcKernelRunning,    int32_t,  RET_int32_t)
 SVC_0_1(svcKernelSysTick,    uint32_t, RET_uint32_t)
+SVC_0_1(svcKernelTicklessEnter, uint32_t, RET_uint32_t)
+SVC_0_1(svcKernelTicklessExit,  uint32_t, RET_uint32_t)
 
 static void  sysThreadError   (osStatus status);
 osThreadId   svcThreadCreate  (const osThreadDef_t *thread_def, void *argument);
 osMessageQId svcMessageCreate (const osMessageQDef_t *queue_def, osThreadId thread_id);
+osStatus     svcThreadSetPriority (osThreadId thread_id, osPriority priority);
+void         sysWorkInit      (void);
 
 // Kernel Control Service Calls
 
@@ -488,6 +616,8 @@ osStatus svcKernelInitialize (void) {
     // Create OS Timers resources (Message Queue & Thread)
     osMessageQId_osTimerMessageQ = svcMessageCreate (&os_messageQ_def_osTimerMessageQ, NULL);
     osThreadId_osTimerThread = svcThreadCreate(&os_thread_def_osTimerThread, NULL);
+    // Create OS Work Queue resources (lane Threads)
+    sysWorkInit();
   }
 
   sysThreadError(osOK);
@@ -534,6 +664,17 @@ uint32_t svcKernelSysTick (void) {
   return tick;
 }
 
+/// Stretch the system tick up to the next kernel deadline
+uint32_t svcKernelTicklessEnter (void) {
+  return rt_tickless_enter();
+}
+
+/// Restore the periodic system tick after tickless sleep
+uint32_t svcKernelTicklessExit (void) {
+  rt_tickless_exit();
+  return 0;
+}
+
 // Kernel Control Public API
 
 /// Initialize the RTOS Kernel for creating objects
@@ -594,6 +735,389 @@ uint32_t osKernelSysTick (void) {
   return __svcKernelSysTick();
 }
 
+/// Enter tickless sleep (idle demon only)
+uint32_t os_tickless_enter (void) {
+  if (__get_IPSR() != 0) return 0;              // Not allowed in ISR
+  return __svcKernelTicklessEnter();
+}
+
+/// Check whether tickless sleep goes on (idle demon only)
+uint32_t os_tickless_sleep (void) {
+  return rt_tickless_sleep();
+}
+
+/// Leave tickless sleep (idle demon only)
+void os_tickless_exit (void) {
+  if (__get_IPSR() != 0) return;                // Not allowed in ISR
+  __svcKernelTicklessExit();
+}
+
+
+// ==== Trace Recorder ====
+
+// Trace Recorder Service Calls declarations
+SVC_0_1(svcTraceStart, osStatus, RET_osStatus)
+SVC_2_1(svcTraceUser,  osStatus, uint32_t, uint32_t, RET_osStatus)
+
+// Trace Recorder Service Calls
+
+/// Start recording kernel events
+osStatus svcTraceStart (void) {
+  if (rt_trace_start() == __FALSE) return osErrorResource;
+  return osOK;
+}
+
+/// Record an application event
+osStatus svcTraceUser (uint32_t id, uint32_t arg) {
+  TRC_EVENT(TRC_USER, id, arg);
+  return osOK;
+}
+
+// Trace Recorder Public API
+
+/// Start recording kernel events into the trace buffer
+osStatus os_trace_start (void) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcTraceStart();
+}
+
+/// Stop recording kernel events
+void os_trace_stop (void) {
+  os_trace_on = 0;
+}
+
+/// Record the entry of an interrupt handler
+void os_trace_isr (void) {
+  TRC_EVENT(TRC_ISR_ENTER, 0, __get_IPSR());
+}
+
+/// Record an application event
+void os_trace_user (uint32_t id, uint32_t arg) {
+  if (!os_trace_on) return;                     // Not recording
+  if ((__get_IPSR() != 0) || ((__get_CONTROL() & 1) == 0)) {
+    // in ISR or Privileged: the time stamp counter is accessible
+    rt_trace(TRC_USER, id, arg);
+  } else {
+    __svcTraceUser(id, arg);
+  }
+}
+
+/// Copy recorded events to a buffer, oldest first
+uint32_t os_trace_read (uint32_t *buf, uint32_t count) {
+  return rt_trace_read(buf, count);
+}
+
+
+// ==== Binary Log ====
+
+// Binary Log Service Calls declarations
+SVC_3_1(svcLog,    osStatus, uint32_t, uint32_t *, uint32_t, RET_osStatus)
+SVC_2_1(svcLogStr, osStatus, uint32_t, const char *,         RET_osStatus)
+
+// Binary Log Service Calls
+
+/// Record a log message
+osStatus svcLog (uint32_t id, uint32_t *args, uint32_t cnt) {
+  rt_log(id, args, cnt);
+  return osOK;
+}
+
+/// Record a log message with a string
+osStatus svcLogStr (uint32_t id, const char *str) {
+  rt_log_str(id, str);
+  return osOK;
+}
+
+// Binary Log Public API
+
+/// Record a log message with up to 4 arguments, formatted by the host
+void os_log (uint32_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3) {
+  uint32_t args[4];
+
+  if (os_log_size == 0) return;                 // No log buffer
+  args[0] = a0;
+  args[1] = a1;
+  args[2] = a2;
+  args[3] = a3;
+  if ((__get_IPSR() != 0) || ((__get_CONTROL() & 1) == 0)) {
+    // in ISR, SVC or Privileged: the time stamp counter is accessible
+    rt_log(id, args, 4);
+  } else {
+    __svcLog(id, args, 4);
+  }
+}
+
+/// Record a log message with a copy of a string
+void os_log_str (uint32_t id, const char *str) {
+  if ((os_log_size == 0) || (str == NULL)) return;
+  if ((__get_IPSR() != 0) || ((__get_CONTROL() & 1) == 0)) {
+    rt_log_str(id, str);
+  } else {
+    __svcLogStr(id, str);
+  }
+}
+
+/// Copy log records to a buffer, oldest first
+uint32_t os_log_read (uint32_t *buf, uint32_t count) {
+  return rt_log_read(buf, count);
+}
+
+/// Fill the header record of a log stream
+void os_log_header (uint32_t *buf) {
+  uint32_t i;
+
+  buf[0] = 0;                                   // No sequence number
+  buf[1] = LOG_MAGIC;
+  buf[2] = osKernelSysTickFrequency;
+  for (i = 3; i < LOG_WORDS; i++) {
+    buf[i] = 0;
+  }
+}
+
+
+// ==== Thread Statistics ====
+
+// Thread Statistics Service Calls declarations
+SVC_2_1(svcThreadGetStats, osStatus, osThreadId, os_thread_stats_t *, RET_osStatus)
+SVC_2_1(svcThreadGetStack, osStatus, osThreadId, os_thread_stack_t *, RET_osStatus)
+
+// Thread Statistics Service Calls
+
+/// Get the runtime statistics of a thread
+osStatus svcThreadGetStats (osThreadId thread_id, os_thread_stats_t *stats) {
+  P_TCB    ptcb;
+  uint32_t i;
+
+  if (os_statmode == 0) return osErrorResource; // Statistics disabled
+  if (stats == NULL) return osErrorParameter;
+
+  if (thread_id == NULL) {
+    ptcb = &os_idle_TCB;                        // Idle demon
+  } else {
+    ptcb = rt_tid2ptcb(thread_id);              // Get TCB pointer
+    if (ptcb == NULL) return osErrorParameter;
+  }
+
+  stats->run_time    = rt_stat_run(ptcb);
+  stats->total_time  = rt_stat_wall();
+  stats->switches    = ptcb->switches;
+  stats->latency_max = ptcb->lat_max;
+  for (i = 0; i < STAT_BINS; i++) {
+    stats->latency[i] = ptcb->lat_hist[i];
+  }
+
+  return osOK;
+}
+
+/// Get the stack size and the peak stack use of a thread
+osStatus svcThreadGetStack (osThreadId thread_id, os_thread_stack_t *stack) {
+  P_TCB ptcb;
+
+  if ((os_stackinfo & STK_INIT) == 0) return osErrorResource; // No watermark
+  if (stack == NULL) return osErrorParameter;
+
+  if (thread_id == NULL) {
+    ptcb = &os_idle_TCB;                        // Idle demon
+  } else {
+    ptcb = rt_tid2ptcb(thread_id);              // Get TCB pointer
+    if (ptcb == NULL) return osErrorParameter;
+  }
+
+  stack->max_used = rt_stk_peak(ptcb, &stack->size);
+
+  return osOK;
+}
+
+// Thread Statistics Public API
+
+/// Get the runtime statistics of a thread
+osStatus os_thread_get_stats (osThreadId thread_id, os_thread_stats_t *stats) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadGetStats(thread_id, stats);
+}
+
+/// Get the stack size and the peak stack use of a thread
+osStatus os_thread_get_stack (osThreadId thread_id, os_thread_stack_t *stack) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadGetStack(thread_id, stack);
+}
+
+/// Get the index of a thread in the TCB table
+uint32_t os_thread_get_index (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return 0;
+
+  return ptcb->task_id;
+}
+
+/// Get the thread at an index of the TCB table
+osThreadId os_thread_get_by_index (uint32_t index) {
+  if ((index == 0) || (index > os_maxtaskrun)) return NULL;
+  return (osThreadId)os_active_TCB[index - 1];
+}
+
+
+// ==== Thread Time Slices ====
+
+// Thread Time Slice Service Calls declarations
+SVC_2_1(svcThreadSetSlice,   osStatus, osThreadId, uint32_t, RET_osStatus)
+SVC_2_1(svcPrioritySetSlice, osStatus, osPriority, uint32_t, RET_osStatus)
+SVC_1_1(svcThreadGetSlice,   uint32_t, osThreadId,           RET_uint32_t)
+
+// Thread Time Slice Service Calls
+
+/// Set the round robin time slice of a thread
+osStatus svcThreadSetSlice (osThreadId thread_id, uint32_t ticks) {
+  P_TCB ptcb;
+
+  if ((os_rrobin >> 16) == 0) return osErrorResource; // Round robin disabled
+  if (ticks > 0xFFFF) return osErrorValue;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return osErrorParameter;
+
+  ptcb->rr_slice = (uint16_t)ticks;
+  if (os_robin.task == ptcb) {
+    os_robin.task = NULL;                       // Restart the running slice
+  }
+
+  return osOK;
+}
+
+/// Set the round robin time slice of a priority level
+osStatus svcPrioritySetSlice (osPriority priority, uint32_t ticks) {
+  uint32_t prio;
+
+  if ((os_rrobin >> 16) == 0) return osErrorResource; // Round robin disabled
+  if (ticks > 0xFFFF) return osErrorValue;
+  if ((priority < osPriorityIdle) || (priority > osPriorityRealtime)) {
+    return osErrorValue;
+  }
+
+  prio = priority - osPriorityIdle + 1;
+  os_robin_slice[prio] = (uint16_t)ticks;
+  if ((os_robin.task != NULL) && (os_robin.task->prio == prio)) {
+    os_robin.task = NULL;                       // Restart the running slice
+  }
+
+  return osOK;
+}
+
+/// Get the round robin time slice a thread runs with
+uint32_t svcThreadGetSlice (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  if ((os_rrobin >> 16) == 0) return 0;         // Round robin disabled
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return 0;
+
+  return rt_robin_slice(ptcb);
+}
+
+// Thread Time Slice Public API
+
+/// Set the round robin time slice of a thread
+osStatus os_thread_set_slice (osThreadId thread_id, uint32_t ticks) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadSetSlice(thread_id, ticks);
+}
+
+/// Set the round robin time slice of a priority level
+osStatus os_priority_set_slice (osPriority priority, uint32_t ticks) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcPrioritySetSlice(priority, ticks);
+}
+
+/// Get the round robin time slice a thread runs with
+uint32_t os_thread_get_slice (osThreadId thread_id) {
+  if (__get_IPSR() != 0) return 0;              // Not allowed in ISR
+  return __svcThreadGetSlice(thread_id);
+}
+
+
+// ==== Earliest Deadline First ====
+
+// EDF Service Calls declarations
+SVC_3_1(svcThreadSetEdf, osStatus, osThreadId, uint32_t, uint32_t, RET_osStatus)
+SVC_0_1(svcEdfWait,      osStatus,                                RET_osStatus)
+SVC_2_1(svcThreadGetEdf, osStatus, osThreadId, os_edf_stats_t *,  RET_osStatus)
+
+// EDF Service Calls
+
+/// Put a thread into the EDF class or back to fixed priority
+osStatus svcThreadSetEdf (osThreadId thread_id, uint32_t period, uint32_t deadline) {
+  P_TCB ptcb;
+
+  if (os_edfprio == 0) return osErrorResource;  // EDF class disabled
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return osErrorParameter;
+
+  if (period == 0) {
+    ptcb->edf_period = 0;                       // Fixed priority again
+    return osOK;
+  }
+  if (deadline == 0) deadline = period;
+  if (deadline > period) return osErrorValue;
+  period   = rt_ms2tick(period);
+  deadline = rt_ms2tick(deadline);
+  if (period >= 0xFFFE) return osErrorValue;
+
+  rt_edf_set(ptcb, period, deadline);
+  rt_tsk_prio(ptcb->task_id, os_edfprio);       // Move to the EDF level
+
+  return osOK;
+}
+
+/// End the job of the running EDF thread and wait for the next release
+osStatus svcEdfWait (void) {
+  if (os_tsk.run->edf_period == 0) return osErrorResource; // Not EDF class
+  rt_edf_wait();
+  return osOK;
+}
+
+/// Get the EDF parameters and deadline statistics of a thread
+osStatus svcThreadGetEdf (osThreadId thread_id, os_edf_stats_t *stats) {
+  P_TCB ptcb;
+
+  if (stats == NULL) return osErrorParameter;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return osErrorParameter;
+  if (ptcb->edf_period == 0) return osErrorResource; // Not EDF class
+
+  stats->period       = ptcb->edf_period * os_clockrate / 1000;
+  stats->deadline     = ptcb->edf_rel_dl * os_clockrate / 1000;
+  stats->jobs         = ptcb->edf_jobs;
+  stats->misses       = ptcb->edf_misses;
+  stats->lateness_max = ptcb->edf_late_max * os_clockrate / 1000;
+
+  return osOK;
+}
+
+// EDF Public API
+
+/// Put a thread into the EDF class or back to fixed priority
+osStatus os_thread_set_edf (osThreadId thread_id, uint32_t period, uint32_t deadline) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadSetEdf(thread_id, period, deadline);
+}
+
+/// End the job of the running EDF thread and wait for the next release
+osStatus os_edf_wait (void) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcEdfWait();
+}
+
+/// Get the EDF parameters and deadline statistics of a thread
+osStatus os_thread_get_edf (osThreadId thread_id, os_edf_stats_t *stats) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcThreadGetEdf(thread_id, stats);
+}
+
 
 // ==== Thread Management ====
 
@@ -616,9 +1140,10 @@ SVC_1_1(svcThreadGetPriority, osPriority,       osThreadId,                  RET
 
 /// Create a thread and add it to Active Threads and set it to state READY
 osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
-  P_TCB  ptcb;
-  OS_TID tsk;
-  void  *stk;
+  P_TCB    ptcb;
+  OS_TID   tsk;
+  void    *stk;
+  uint32_t size;
 
   if ((thread_def == NULL) ||
       (thread_def->pthread == NULL) ||
@@ -628,10 +1153,15 @@ osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
     return NULL; 
   }
 
-  if (thread_def->stacksize != 0) {             // Custom stack size
+  size = thread_def->stacksize;
+  if ((size == 0) && (os_stackinfo & STK_POOL)) {
+    size = (uint16_t)os_stackinfo;              // Default size from stack pool
+  }
+
+  if (size != 0) {                              // Custom stack size
     stk = rt_alloc_mem(                         // Allocate stack
       os_stack_mem,
-      thread_def->stacksize
+      size
     );
     if (stk == NULL) { 
       sysThreadError(osErrorNoMemory);          // Out of memory
@@ -644,7 +1174,7 @@ osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
   tsk = rt_tsk_create(                          // Create task
     (FUNCP)thread_def->pthread,                 // Task function pointer
     (thread_def->tpriority-osPriorityIdle+1) |  // Task priority
-    (thread_def->stacksize << 8),               // Task stack size in bytes
+    (size << 8),                                // Task stack size in bytes
     stk,                                        // Pointer to task's stack
     argument                                    // Argument to the task
   );
@@ -856,67 +1386,32 @@ os_InRegs osEvent osWait (uint32_t millisec) {
 // Timer structures 
 
 typedef struct os_timer_cb_ {                   // Timer Control Block
-  struct os_timer_cb_ *next;                    // Pointer to next active Timer
+  struct os_timer_cb_  *next;                   // Pointer to next Timer in wheel slot
+  struct os_timer_cb_ **pprev;                  // Link to this Timer, NULL if not active
+  uint16_t             tcnt;                    // Timer Expiry Time
+  uint16_t             icnt;                    // Timer Initial Count 
   uint8_t             state;                    // Timer State
   uint8_t              type;                    // Timer Type (Periodic/One-shot)
   uint16_t         reserved;                    // Reserved
-  uint16_t             tcnt;                    // Timer Delay Count
-  uint16_t             icnt;                    // Timer Initial Count 
   void                 *arg;                    // Timer Function Argument
   const osTimerDef_t *timer;                    // Pointer to Timer definition
 } os_timer_cb;
 
 // Timer variables
-os_timer_cb *os_timer_head;                     // Pointer to first active Timer
+struct OS_WHL os_timer_wheel;                   // Timing wheel of active Timers
 
 
 // Timer Helper Functions
 
-// Insert Timer into the list sorted by time
+// Insert Timer into the timing wheel
 static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
-  os_timer_cb *p, *prev;
-
-  prev = NULL;
-  p = os_timer_head;
-  while (p != NULL) {
-    if (tcnt < p->tcnt) break;
-    tcnt -= p->tcnt;
-    prev = p;
-    p = p->next;
-  }
-  pt->next = p;
-  pt->tcnt = (uint16_t)tcnt;
-  if (p != NULL) {
-    p->tcnt -= pt->tcnt;
-  }
-  if (prev != NULL) {
-    prev->next = pt;
-  } else {
-    os_timer_head = pt;
-  }
+  rt_whl_put(&os_timer_wheel, (P_WNODE)pt, (uint16_t)tcnt);
 }
 
-// Remove Timer from the list
+// Remove Timer from the timing wheel
 static int rt_timer_remove (os_timer_cb *pt) {
-  os_timer_cb *p, *prev;
-
-  prev = NULL;
-  p = os_timer_head;
-  while (p != NULL) {
-    if (p == pt) break;
-    prev = p;
-    p = p->next;
-  }
-  if (p == NULL) return -1;
-  if (prev != NULL) {
-    prev->next = pt->next;
-  } else {
-    os_timer_head = pt->next;
-  }
-  if (pt->next != NULL) {
-    pt->next->tcnt += pt->tcnt;
-  }
-
+  if (pt->pprev == NULL) return -1;
+  rt_whl_rmv(&os_timer_wheel, (P_WNODE)pt);
   return 0;
 }
 
@@ -1062,14 +1557,10 @@ static __INLINE osStatus isrMessagePut (osMessageQId queue_id, uint32_t info, ui
 void sysTimerTick (void) {
   os_timer_cb *pt, *p;
 
-  p = os_timer_head;
-  if (p == NULL) return;
-
-  p->tcnt--;
-  while ((p != NULL) && (p->tcnt == 0)) {
+  p = (os_timer_cb *)rt_whl_tick(&os_timer_wheel);
+  while (p != NULL) {
     pt = p;
     p = p->next;
-    os_timer_head = p;
     isrMessagePut(osMessageQId_osTimerMessageQ, (uint32_t)pt, 0);
     if (pt->type == osTimerPeriodic) {
       rt_timer_insert(pt, pt->icnt);
@@ -1079,6 +1570,24 @@ void sysTimerTick (void) {
   }
 }
 
+/// Get user timers wake-up time
+uint32_t sysUserTimerWakeupTime (void) {
+  return rt_whl_next(&os_timer_wheel);
+}
+
+/// Update user timers on resume
+void sysUserTimerUpdate (uint32_t sleep_time) {
+  uint32_t n;
+
+  while (sleep_time) {
+    n = rt_whl_skip(&os_timer_wheel, sleep_time);
+    sleep_time -= n;
+    if (sleep_time == 0) break;
+    sysTimerTick();
+    sleep_time--;
+  }
+}
+
 
 // Timer Management Public API
 
@@ -1135,6 +1644,337 @@ __NO_RETURN void osTimerThread (void const *argument) {
 }
 
 
+// ==== Work Queues ====
+
+// Work Queue definitions
+#define osWorkSignal    0x0001                  // Signal of a lane worker: items queued
+
+// Work Queue structures
+
+typedef struct os_work_cb_ {                    // Work Item Control Block
+  struct os_work_cb_   *next;                   // Pointer to next Item in wheel slot
+  struct os_work_cb_  **pprev;                  // Link to this Item, NULL if not delayed
+  uint16_t              tcnt;                   // Delay Expiry Time
+  uint8_t              valid;                   // Item created
+  uint8_t               lane;                   // Lane of the Item
+  struct os_work_cb_  *q_next;                  // Pointer to next Item in lane queue
+  uint32_t           pending;                   // Submits not run yet, 0 if not queued
+  uint32_t           run_cnt;                   // Runs due of the Item taken by the lane
+  uint32_t          coalesce;                   // Submits of a queued Item are merged
+  void                  *arg;                   // Work Function Argument
+  const os_work_def_t  *work;                   // Pointer to Work definition
+  uint32_t           submits;                   // Submits since creation
+  uint32_t              runs;                   // Runs since creation
+} os_work_cb;
+
+typedef struct os_work_lane_ {                  // Work Queue Lane
+  os_work_cb           *head;                   // Submitted Items, last submitted first
+  os_work_cb          *first;                   // Items taken by the worker, in order
+  osThreadId          thread;                   // Worker Thread of the lane
+} os_work_lane;
+
+// Work Queue variables
+struct OS_WHL os_work_wheel;                    // Timing wheel of delayed Items
+#define os_work_lane_of(pw)  (&((os_work_lane *)os_work_mem)[(pw)->lane])
+
+
+// Work Queue Helper Functions
+
+// Count a submit of an Item and queue it on its lane unless it is queued
+// Return: 1 when the lane queue was empty and the worker has to be signaled
+static uint32_t rt_work_put (os_work_cb *pw) {
+  os_work_lane *pl;
+  os_work_cb   *head;
+
+  rt_add32(&pw->submits, 1);
+  if (pw->coalesce) {
+    if (rt_swp32(&pw->pending, 1) != 0) return 0;   // Merged with the queued submit
+  } else {
+    if (rt_add32(&pw->pending, 1) != 0) return 0;   // Counted on the queued Item
+  }
+
+  // Push the Item: lock-free, the worker takes the whole queue at once
+  pl = os_work_lane_of(pw);
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    head = (os_work_cb *)__ldrex((uint32_t *)&pl->head);
+    pw->q_next = head;
+  } while (__strex((uint32_t)pw, (uint32_t *)&pl->head));
+#else
+  __disable_irq();
+  head = pl->head;
+  pw->q_next = head;
+  pl->head = pw;
+  __enable_irq();
+#endif
+
+  return (head == NULL);
+}
+
+// Take all Items submitted to a lane
+// Return: Items in submit order, linked with q_next
+static os_work_cb *rt_work_take (os_work_lane *pl) {
+  os_work_cb *pw, *next, *first;
+
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    pw = (os_work_cb *)__ldrex((uint32_t *)&pl->head);
+  } while (__strex(0, (uint32_t *)&pl->head));
+#else
+  __disable_irq();
+  pw = pl->head;
+  pl->head = NULL;
+  __enable_irq();
+#endif
+
+  first = NULL;
+  while (pw != NULL) {                          // Reverse to submit order
+    next = pw->q_next;
+    pw->q_next = first;
+    first = pw;
+    pw = next;
+  }
+
+  return first;
+}
+
+
+// Work Queue Service Calls declarations
+SVC_2_1(svcWorkCreate,    os_work_id, const os_work_def_t *, void *,   RET_pointer)
+SVC_1_1(svcWorkSubmit,    osStatus,         os_work_id,                RET_osStatus)
+SVC_2_1(svcWorkDelay,     osStatus,         os_work_id,      uint32_t, RET_osStatus)
+SVC_1_1(svcWorkCancel,    osStatus,         os_work_id,                RET_osStatus)
+SVC_1_1(svcWorkNext,      void *,           void *,                    RET_pointer)
+
+// Work Queue Service Calls
+
+/// Create a work item
+os_work_id svcWorkCreate (const os_work_def_t *work_def, void *argument) {
+  os_work_cb *pw;
+
+  if ((work_def == NULL) || (work_def->func == NULL)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  pw = work_def->work;
+  if (pw == NULL) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  if (work_def->lane >= os_work_lanes) {
+    sysThreadError((os_work_lanes == 0) ? osErrorResource : osErrorValue);
+    return NULL;
+  }
+
+  if (pw->valid != 0) {
+    sysThreadError(osErrorResource);
+    return NULL;
+  }
+
+  pw->valid    = 1;
+  pw->lane     = work_def->lane;
+  pw->coalesce = work_def->coalesce;
+  pw->arg      = argument;
+  pw->work     = work_def;
+
+  return (os_work_id)pw;
+}
+
+/// Submit a work item to its lane
+osStatus svcWorkSubmit (os_work_id work_id) {
+  os_work_cb *pw;
+
+  pw = rt_id2obj(work_id);
+  if ((pw == NULL) || (pw->valid == 0)) return osErrorParameter;
+
+  if (rt_work_put(pw)) {
+    rt_evt_set(osWorkSignal, ((P_TCB)os_work_lane_of(pw)->thread)->task_id);
+  }
+
+  return osOK;
+}
+
+/// Submit a work item after a delay, restart the delay if it is running
+osStatus svcWorkDelay (os_work_id work_id, uint32_t millisec) {
+  os_work_cb *pw;
+
+  pw = rt_id2obj(work_id);
+  if ((pw == NULL) || (pw->valid == 0)) return osErrorParameter;
+
+  if (millisec == osWaitForever) return osErrorValue;
+
+  rt_whl_rmv(&os_work_wheel, (P_WNODE)pw);
+  if (millisec == 0) {
+    return svcWorkSubmit(work_id);
+  }
+  rt_whl_put(&os_work_wheel, (P_WNODE)pw, (uint16_t)rt_ms2tick(millisec));
+
+  return osOK;
+}
+
+/// Cancel the delay of a work item
+osStatus svcWorkCancel (os_work_id work_id) {
+  os_work_cb *pw;
+
+  pw = rt_id2obj(work_id);
+  if ((pw == NULL) || (pw->valid == 0)) return osErrorParameter;
+
+  if (pw->pprev == NULL) return osErrorResource;
+
+  rt_whl_rmv(&os_work_wheel, (P_WNODE)pw);
+
+  return osOK;
+}
+
+/// Get the next work item of a lane with the runs due (used by the lane worker)
+void *svcWorkNext (void *lane) {
+  os_work_lane *pl = lane;
+  os_work_cb   *pw;
+
+  if (pl->first == NULL) {
+    pl->first = rt_work_take(pl);
+  }
+  pw = pl->first;
+  if (pw == NULL) return NULL;
+
+  // Unlinked before the pending submits are taken: a later submit queues it again
+  pl->first = pw->q_next;
+  pw->run_cnt = rt_swp32(&pw->pending, 0);
+  pw->runs += pw->run_cnt;
+
+  return pw;
+}
+
+
+// Work Queue ISR Calls
+
+/// Submit a work item to its lane
+static __INLINE osStatus isrWorkSubmit (os_work_id work_id) {
+  os_work_cb *pw;
+
+  pw = rt_id2obj(work_id);
+  if ((pw == NULL) || (pw->valid == 0)) return osErrorParameter;
+
+  if (rt_work_put(pw)) {
+    isr_evt_set(osWorkSignal, ((P_TCB)os_work_lane_of(pw)->thread)->task_id);
+  }
+
+  return osOK;
+}
+
+/// Create the lane worker threads, lane 0 at the highest priority
+void sysWorkInit (void) {
+  os_work_lane *pl;
+  uint32_t      i;
+
+  for (i = 0; i < os_work_lanes; i++) {
+    pl = &((os_work_lane *)os_work_mem)[i];
+    pl->thread = svcThreadCreate(&os_thread_def_osWorkThread, pl);
+    if (pl->thread != NULL) {
+      svcThreadSetPriority(pl->thread, (osPriority)(os_thread_def_osWorkThread.tpriority - (int32_t)i));
+    }
+  }
+}
+
+/// Work Tick (called each SysTick)
+void sysWorkTick (void) {
+  os_work_cb *pw, *p;
+
+  p = (os_work_cb *)rt_whl_tick(&os_work_wheel);
+  while (p != NULL) {
+    pw = p;
+    p = p->next;
+    isrWorkSubmit((os_work_id)pw);
+  }
+}
+
+/// Get delayed work items wake-up time
+uint32_t sysWorkWakeupTime (void) {
+  return rt_whl_next(&os_work_wheel);
+}
+
+/// Update delayed work items on resume
+void sysWorkUpdate (uint32_t sleep_time) {
+  uint32_t n;
+
+  while (sleep_time) {
+    n = rt_whl_skip(&os_work_wheel, sleep_time);
+    sleep_time -= n;
+    if (sleep_time == 0) break;
+    sysWorkTick();
+    sleep_time--;
+  }
+}
+
+
+// Work Queue Public API
+
+/// Create a work item
+os_work_id os_work_create (const os_work_def_t *work_def, void *argument) {
+  if (__get_IPSR() != 0) return NULL;           // Not allowed in ISR
+  if (((__get_CONTROL() & 1) == 0) && (os_running == 0)) {
+    // Privileged and not running
+    return   svcWorkCreate(work_def, argument);
+  } else {
+    return __svcWorkCreate(work_def, argument);
+  }
+}
+
+/// Submit a work item to its lane
+osStatus os_work_submit (os_work_id work_id) {
+  if (__get_IPSR() != 0) {                      // in ISR
+    return   isrWorkSubmit(work_id);
+  } else {                                      // in Thread
+    return __svcWorkSubmit(work_id);
+  }
+}
+
+/// Submit a work item after a delay, restart the delay if it is running
+osStatus os_work_submit_delayed (os_work_id work_id, uint32_t millisec) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcWorkDelay(work_id, millisec);
+}
+
+/// Cancel the delay of a work item
+osStatus os_work_cancel (os_work_id work_id) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcWorkCancel(work_id);
+}
+
+/// Get the submit and run counts of a work item
+osStatus os_work_get_stats (os_work_id work_id, os_work_stats_t *stats) {
+  os_work_cb *pw;
+
+  pw = rt_id2obj(work_id);
+  if ((pw == NULL) || (pw->valid == 0) || (stats == NULL)) return osErrorParameter;
+
+  stats->submits = pw->submits;
+  stats->runs    = pw->runs;
+
+  return osOK;
+}
+
+
+// Work Queue Lane Thread
+__NO_RETURN void osWorkThread (void const *argument) {
+  os_work_cb *pw;
+  uint32_t    n;
+
+  for (;;) {
+    pw = __svcWorkNext((void *)argument);
+    if (pw == NULL) {
+      osSignalWait(osWorkSignal, osWaitForever);
+      continue;
+    }
+    for (n = pw->run_cnt; n != 0; n--) {
+      (*pw->work->func)(pw->arg);
+    }
+  }
+}
+
+
 // ==== Signal Management ====
 
 // Signal Service Calls declarations
@@ -1188,15 +2028,143 @@ os_InRegs osEvent_type svcSignalWait (int32_t signals, uint32_t millisec) {
     return osEvent_ret_status;
   }
 
-  if (signals != 0) {                           // Wait for all specified signals
-    res = rt_evt_wait(signals, rt_ms2tick(millisec), __TRUE);
-  } else {                                      // Wait for any signal
-    res = rt_evt_wait(0xFFFF,  rt_ms2tick(millisec), __FALSE);
-  }
+  if (signals != 0) {                           // Wait for all specified signals
+    res = rt_evt_wait(signals, rt_ms2tick(millisec), __TRUE);
+  } else {                                      // Wait for any signal
+    res = rt_evt_wait(0xFFFF,  rt_ms2tick(millisec), __FALSE);
+  }
+
+  if (res == OS_R_EVT) {
+    ret.status = osEventSignal;
+    ret.value.signals = signals ? signals : os_tsk.run->waits;
+  } else {
+    ret.status = millisec ? osEventTimeout : osOK;
+    ret.value.signals = 0;
+  }
+
+  return osEvent_ret_value;
+}
+
+
+// Signal ISR Calls
+
+/// Set the specified Signal Flags of an active thread
+static __INLINE int32_t isrSignalSet (osThreadId thread_id, int32_t signals) {
+  P_TCB   ptcb;
+  int32_t sig;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return 0x80000000;
+
+  if (signals & (0xFFFFFFFF << osFeature_Signals)) return 0x80000000;
+
+  sig = ptcb->events | ptcb->psh_events;        // Previous signal flags
+
+  isr_evt_set(signals, ptcb->task_id);          // Set event flags
+
+  return sig;
+}
+
+
+// Signal Public API
+
+/// Set the specified Signal Flags of an active thread
+int32_t osSignalSet (osThreadId thread_id, int32_t signals) {
+  if (__get_IPSR() != 0) {                      // in ISR
+    return   isrSignalSet(thread_id, signals); 
+  } else {                                      // in Thread
+    return __svcSignalSet(thread_id, signals);
+  }
+}
+
+/// Clear the specified Signal Flags of an active thread
+int32_t osSignalClear (osThreadId thread_id, int32_t signals) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcSignalClear(thread_id, signals);
+}
+
+/// Wait for one or more Signal Flags to become signaled for the current RUNNING thread
+os_InRegs osEvent osSignalWait (int32_t signals, uint32_t millisec) {
+  osEvent ret;
+
+  if (__get_IPSR() != 0) {                      // Not allowed in ISR
+    ret.status = osErrorISR;
+    return ret;
+  }
+  return __svcSignalWait(signals, millisec);
+}
+
+
+// ==== Event Groups ====
+
+// Event Group Service Calls declarations
+SVC_2_1(svcGroupCreate,  os_group_id,       const os_group_def_t *, uint32_t,                     RET_pointer)
+SVC_2_1(svcGroupSet,     osStatus,          os_group_id,            uint32_t,                     RET_osStatus)
+SVC_2_1(svcGroupClear,   osStatus,          os_group_id,            uint32_t,                     RET_osStatus)
+SVC_4_3(svcGroupWait,    os_InRegs osEvent, os_group_id,            uint32_t, uint32_t, uint32_t, RET_osEvent)
+SVC_1_1(svcGroupDelete,  osStatus,          os_group_id,                                          RET_osStatus)
+
+// Event Group Service Calls
+
+/// Create and Initialize an Event Group
+os_group_id svcGroupCreate (const os_group_def_t *group_def, uint32_t flags) {
+  P_ECB grp;
+
+  if ((group_def == NULL) || (group_def->group == NULL)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  grp = group_def->group;
+  if (grp->cb_type != 0) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  rt_grp_init(grp, flags);                      // Initialize Event Group
+
+  return (os_group_id)grp;
+}
+
+/// Set Flags of an Event Group and wake up all threads whose wait is met
+osStatus svcGroupSet (os_group_id group_id, uint32_t flags) {
+  P_ECB grp = (P_ECB)group_id;
+
+  if ((grp == NULL) || (grp->cb_type != ECB)) return osErrorParameter;
+
+  rt_grp_set(grp, flags);                       // Set flags, wake up waiters
+
+  return osOK;
+}
+
+/// Clear Flags of an Event Group
+osStatus svcGroupClear (os_group_id group_id, uint32_t flags) {
+  P_ECB grp = (P_ECB)group_id;
+
+  if ((grp == NULL) || (grp->cb_type != ECB)) return osErrorParameter;
+
+  rt_grp_clr(grp, flags);                       // Clear flags
+
+  return osOK;
+}
+
+/// Wait for any or all of the specified Flags of an Event Group
+os_InRegs osEvent_type svcGroupWait (os_group_id group_id, uint32_t flags, uint32_t options, uint32_t millisec) {
+  P_ECB   grp = (P_ECB)group_id;
+  U32     got;
+  osEvent ret;
+
+  if ((grp == NULL) || (grp->cb_type != ECB) || (flags == 0) ||
+      (options & ~(os_group_wait_all | os_group_wait_clear))) {
+    ret.status = osErrorParameter;
+    return osEvent_ret_status;
+  }
+
+  got = rt_grp_wait(grp, flags, options, rt_ms2tick(millisec));
 
-  if (res == OS_R_EVT) {
+  if (got != 0) {
     ret.status = osEventSignal;
-    ret.value.signals = signals ? signals : os_tsk.run->waits;
+    ret.value.signals = got;
   } else {
     ret.status = millisec ? osEventTimeout : osOK;
     ret.value.signals = 0;
@@ -1205,53 +2173,84 @@ os_InRegs osEvent_type svcSignalWait (int32_t signals, uint32_t millisec) {
   return osEvent_ret_value;
 }
 
+/// Delete an Event Group that was created by os_group_create
+osStatus svcGroupDelete (os_group_id group_id) {
+  P_ECB grp = (P_ECB)group_id;
 
-// Signal ISR Calls
+  if ((grp == NULL) || (grp->cb_type != ECB)) return osErrorParameter;
 
-/// Set the specified Signal Flags of an active thread
-static __INLINE int32_t isrSignalSet (osThreadId thread_id, int32_t signals) {
-  P_TCB   ptcb;
-  int32_t sig;
+  rt_grp_delete(grp);                           // Delete Event Group
 
-  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
-  if (ptcb == NULL) return 0x80000000;
+  return osOK;
+}
 
-  if (signals & (0xFFFFFFFF << osFeature_Signals)) return 0x80000000;
 
-  sig = ptcb->events;                           // Previous signal flags
+// Event Group ISR Calls
 
-  isr_evt_set(signals, ptcb->task_id);          // Set event flags
+/// Set Flags of an Event Group
+static __INLINE osStatus isrGroupSet (os_group_id group_id, uint32_t flags) {
+  P_ECB grp = (P_ECB)group_id;
 
-  return sig;
+  if ((grp == NULL) || (grp->cb_type != ECB)) return osErrorParameter;
+
+  isr_grp_set(grp, flags);                      // Set flags
+
+  return osOK;
 }
 
 
-// Signal Public API
+// Event Group Public API
 
-/// Set the specified Signal Flags of an active thread
-int32_t osSignalSet (osThreadId thread_id, int32_t signals) {
+/// Create and Initialize an Event Group
+os_group_id os_group_create (const os_group_def_t *group_def, uint32_t flags) {
+  if (__get_IPSR() != 0) return NULL;           // Not allowed in ISR
+  if (((__get_CONTROL() & 1) == 0) && (os_running == 0)) {
+    // Privileged and not running
+    return   svcGroupCreate(group_def, flags);
+  } else {
+    return __svcGroupCreate(group_def, flags);
+  }
+}
+
+/// Set Flags of an Event Group and wake up all threads whose wait is met
+osStatus os_group_set (os_group_id group_id, uint32_t flags) {
   if (__get_IPSR() != 0) {                      // in ISR
-    return   isrSignalSet(thread_id, signals); 
+    return   isrGroupSet(group_id, flags);
   } else {                                      // in Thread
-    return __svcSignalSet(thread_id, signals);
+    return __svcGroupSet(group_id, flags);
   }
 }
 
-/// Clear the specified Signal Flags of an active thread
-int32_t osSignalClear (osThreadId thread_id, int32_t signals) {
+/// Clear Flags of an Event Group
+osStatus os_group_clear (os_group_id group_id, uint32_t flags) {
   if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
-  return __svcSignalClear(thread_id, signals);
+  return __svcGroupClear(group_id, flags);
 }
 
-/// Wait for one or more Signal Flags to become signaled for the current RUNNING thread
-os_InRegs osEvent osSignalWait (int32_t signals, uint32_t millisec) {
+/// Get the Flags of an Event Group
+uint32_t os_group_get (os_group_id group_id) {
+  P_ECB grp = (P_ECB)group_id;
+
+  if ((grp == NULL) || (grp->cb_type != ECB)) return 0;
+
+  return (grp->flags | grp->psh_flags);         // Flags set by ISRs included
+}
+
+/// Wait for any or all of the specified Flags of an Event Group
+os_InRegs osEvent os_group_wait (os_group_id group_id, uint32_t flags, uint32_t options, uint32_t millisec) {
   osEvent ret;
 
   if (__get_IPSR() != 0) {                      // Not allowed in ISR
     ret.status = osErrorISR;
     return ret;
   }
-  return __svcSignalWait(signals, millisec);
+  return __svcGroupWait(group_id, flags, options, millisec);
+}
+
+/// Delete an Event Group that was created by os_group_create
+osStatus os_group_delete (os_group_id group_id) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcGroupDelete(group_id);
 }
 
 
@@ -1472,7 +2471,9 @@ static __INLINE osStatus isrSemaphoreRelease (osSemaphoreId semaphore_id) {
 
   if (((P_SCB)sem)->cb_type != SCB) return osErrorParameter;
 
-  if (((P_SCB)sem)->tokens == osFeature_Semaphore) return osErrorResource;
+  if (((P_SCB)sem)->tokens + ((P_SCB)sem)->psh_tokens >= osFeature_Semaphore) {
+    return osErrorResource;
+  }
 
   isr_sem_send(sem);                            // Release Semaphore
 
@@ -1541,16 +2542,33 @@ SVC_2_1(sysPoolFree,   osStatus,       osPoolId,      void *,   RET_osStatus)
 /// Create and Initialize memory pool
 osPoolId svcPoolCreate (const osPoolDef_t *pool_def) {
   uint32_t blk_sz;
+  P_SP     pool;
 
   if ((pool_def == NULL) ||
       (pool_def->pool_sz == 0) ||
-      (pool_def->item_sz == 0) ||
-      (pool_def->pool == NULL)) {
+      (pool_def->item_sz == 0)) {
     sysThreadError(osErrorParameter);
     return NULL;
   }
 
-  blk_sz = (pool_def->item_sz + 3) & ~3;
+  blk_sz = (pool_def->item_sz + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+  if (pool_def->pool == NULL) {                 // Blocks drawn from the slab
+    if (blk_sz > SLAB_PAGE) {
+      sysThreadError(osErrorParameter);
+      return NULL;
+    }
+    pool = rt_slab_alloc(sizeof(struct OS_SP));
+    if (pool == NULL) {
+      sysThreadError(osErrorNoMemory);
+      return NULL;
+    }
+    pool->cnt      = 0;
+    pool->end      = NULL;
+    pool->blk_size = blk_sz;
+    pool->max      = pool_def->pool_sz;
+    return (osPoolId)pool;
+  }
 
   _init_box(pool_def->pool, sizeof(struct OS_BM) + pool_def->pool_sz * blk_sz, blk_sz);
 
@@ -1563,7 +2581,11 @@ void *sysPoolAlloc (osPoolId pool_id, uint32_t clr) {
 
   if (pool_id == NULL) return NULL;
 
-  ptr = rt_alloc_box(pool_id);
+  if (((P_BM)pool_id)->end == NULL) {
+    ptr = rt_slab_pool_alloc((P_SP)pool_id);
+  } else {
+    ptr = rt_alloc_box(pool_id);
+  }
   if (clr) {
     rt_clr_box(pool_id, ptr);
   }
@@ -1577,7 +2599,11 @@ osStatus sysPoolFree (osPoolId pool_id, void *block) {
     
   if (pool_id == NULL) return osErrorParameter;
 
-  res = rt_free_box(pool_id, block);
+  if (((P_BM)pool_id)->end == NULL) {
+    res = rt_slab_pool_free((P_SP)pool_id, block);
+  } else {
+    res = rt_free_box(pool_id, block);
+  }
   if (res != 0) return osErrorValue;
 
   return osOK;
@@ -1625,12 +2651,177 @@ osStatus osPoolFree (osPoolId pool_id, void *block) {
 }
 
 
+// ==== Slab Memory ====
+
+// Slab Memory Service Calls declarations
+SVC_1_1(sysSlabAlloc,    void *,   uint32_t,                       RET_pointer)
+SVC_1_1(sysSlabFree,     osStatus, void *,                         RET_osStatus)
+SVC_2_1(svcSlabGetStats, osStatus, uint32_t, os_slab_stats_t *,    RET_osStatus)
+
+// Slab Memory Service & ISR Calls
+
+/// Allocate a block of the slab memory
+void *sysSlabAlloc (uint32_t size) {
+  return rt_slab_alloc(size);
+}
+
+/// Return a block to the slab memory
+osStatus sysSlabFree (void *block) {
+  if (block == NULL) return osErrorParameter;
+  if (rt_slab_free(block) != 0) return osErrorValue;
+  return osOK;
+}
+
+/// Get the use of a size class of the slab memory
+osStatus svcSlabGetStats (uint32_t cls, os_slab_stats_t *stats) {
+  P_SLAB slab;
+
+  if (os_slab_pages == 0) return osErrorResource; // Slab memory disabled
+  if ((cls >= SLAB_CLASSES) || (stats == NULL)) return osErrorParameter;
+
+  slab = &os_slab[cls];
+  stats->block_size = SLAB_MIN << cls;
+  stats->allocs     = slab->allocs;
+  stats->failures   = slab->fails;
+  stats->used       = slab->used;
+  stats->max_used   = slab->max_used;
+  stats->pages      = slab->pages;
+  stats->free_pages = os_slab_pages;
+  for (cls = 0; cls < SLAB_CLASSES; cls++) {
+    stats->free_pages -= os_slab[cls].pages;
+  }
+
+  return osOK;
+}
+
+// Slab Memory Public API
+
+/// Allocate a block of the slab memory
+void *os_slab_alloc (uint32_t size) {
+  if ((__get_IPSR() != 0) || ((__get_CONTROL() & 1) == 0)) {    // in ISR or Privileged
+    return   sysSlabAlloc(size);
+  } else {                                      // in Thread
+    return __sysSlabAlloc(size);
+  }
+}
+
+/// Return a block to the slab memory
+osStatus os_slab_free (void *block) {
+  if ((__get_IPSR() != 0) || ((__get_CONTROL() & 1) == 0)) {    // in ISR or Privileged
+    return   sysSlabFree(block);
+  } else {                                      // in Thread
+    return __sysSlabFree(block);
+  }
+}
+
+/// Get the use of a size class of the slab memory
+osStatus os_slab_get_stats (uint32_t cls, os_slab_stats_t *stats) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcSlabGetStats(cls, stats);
+}
+
+
+// ==== Driver Handles ====
+
+// Driver Handles Service Calls declarations
+SVC_3_1(svcHandleOpen,   os_handle_t, uint32_t,    uint32_t,   void *, RET_uint32_t)
+SVC_2_1(svcHandleCheck,  osStatus,    os_handle_t, uint32_t,           RET_osStatus)
+SVC_1_1(svcHandleShare,  osStatus,    os_handle_t,                     RET_osStatus)
+SVC_2_1(svcHandleGive,   osStatus,    os_handle_t, osThreadId,         RET_osStatus)
+SVC_2_1(svcHandleClose,  osStatus,    os_handle_t, uint32_t,           RET_osStatus)
+
+// Driver Handles Service Calls
+
+/// Open a unit of a driver for the running thread
+os_handle_t svcHandleOpen (uint32_t driver, uint32_t unit, void *obj) {
+  if ((driver == 0) || (driver > 0xFF) || (unit > HND_NOUNIT)) return 0;
+  return rt_hnd_open(driver, unit, obj);
+}
+
+/// Check that the running thread may use a handle
+osStatus svcHandleCheck (os_handle_t handle, uint32_t driver) {
+  if (driver == 0) return osErrorParameter;     // Driver 0 marks free entries
+  if (rt_hnd_get(handle, driver) == NULL) return osErrorParameter;
+  return osOK;
+}
+
+/// Let every thread use a handle
+osStatus svcHandleShare (os_handle_t handle) {
+  P_HCB hcb;
+
+  if (HND_DRV(handle) == 0) return osErrorParameter;
+  hcb = rt_hnd_get(handle, HND_DRV(handle));
+  if (hcb == NULL) return osErrorParameter;
+  hcb->owner = HND_SHARED;
+  return osOK;
+}
+
+/// Make a thread the only user of a handle
+osStatus svcHandleGive (os_handle_t handle, osThreadId thread_id) {
+  P_HCB hcb;
+  P_TCB ptcb;
+
+  if (HND_DRV(handle) == 0) return osErrorParameter;
+  hcb = rt_hnd_get(handle, HND_DRV(handle));
+  if (hcb == NULL) return osErrorParameter;
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) return osErrorParameter;
+  hcb->owner = ptcb->task_id;
+  return osOK;
+}
+
+/// Close a handle, all its copies become invalid
+osStatus svcHandleClose (os_handle_t handle, uint32_t driver) {
+  P_HCB hcb;
+
+  if (driver == 0) return osErrorParameter;
+  hcb = rt_hnd_get(handle, driver);
+  if (hcb == NULL) return osErrorParameter;
+  rt_hnd_close(hcb);
+  return osOK;
+}
+
+// Driver Handles Public API
+
+/// Open a unit of a driver for the running thread
+os_handle_t os_handle_open (uint32_t driver, uint32_t unit, void *obj) {
+  if (__get_IPSR() != 0) return 0;              // Not allowed in ISR
+  return __svcHandleOpen(driver, unit, obj);
+}
+
+/// Check that the running thread may use a handle
+osStatus os_handle_check (os_handle_t handle, uint32_t driver) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcHandleCheck(handle, driver);
+}
+
+/// Let every thread use a handle
+osStatus os_handle_share (os_handle_t handle) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcHandleShare(handle);
+}
+
+/// Make a thread the only user of a handle
+osStatus os_handle_give (os_handle_t handle, osThreadId thread_id) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcHandleGive(handle, thread_id);
+}
+
+/// Close a handle, all its copies become invalid
+osStatus os_handle_close (os_handle_t handle, uint32_t driver) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcHandleClose(handle, driver);
+}
+
+
 // ==== Message Queue Management Functions ====
 
 // Message Queue Management Service Calls declarations
 SVC_2_1(svcMessageCreate,        osMessageQId, const osMessageQDef_t *, osThreadId,           RET_pointer)
 SVC_3_1(svcMessagePut,           osStatus,           osMessageQId,      uint32_t,   uint32_t, RET_osStatus)
 SVC_2_3(svcMessageGet, os_InRegs osEvent,            osMessageQId,      uint32_t,             RET_osEvent)
+SVC_4_1(svcMessagePutBatch,      int32_t,            osMessageQId,      void *,     uint32_t, uint32_t, RET_int32_t)
+SVC_4_1(svcMessageGetBatch,      int32_t,            osMessageQId,      void *,     uint32_t, uint32_t, RET_int32_t)
 
 // Message Queue Service Calls
 
@@ -1649,7 +2840,7 @@ osMessageQId svcMessageCreate (const osMessageQDef_t *queue_def, osThreadId thre
     return NULL;
   }
 
-  rt_mbx_init(queue_def->pool, 4*(queue_def->queue_sz + 4));
+  rt_mbx_init(queue_def->pool, sizeof(struct OS_MCB) + sizeof(void *)*(queue_def->queue_sz - 1));
 
   return queue_def->pool;
 }
@@ -1698,6 +2889,26 @@ os_InRegs osEvent_type svcMessageGet (osMessageQId queue_id, uint32_t millisec)
   return osEvent_ret_value;
 }
 
+/// Put up to count Messages (words) or Mails (pointers) to a Queue without waiting
+int32_t svcMessagePutBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t words) {
+
+  if ((queue_id == NULL) || (buf == NULL)) return -1;
+
+  if (((P_MCB)queue_id)->cb_type != MCB) return -1;
+
+  return rt_mbx_send_n(queue_id, buf, count, words);
+}
+
+/// Get up to count Messages (words) or Mails (pointers) from a Queue without waiting
+int32_t svcMessageGetBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t words) {
+
+  if ((queue_id == NULL) || (buf == NULL)) return -1;
+
+  if (((P_MCB)queue_id)->cb_type != MCB) return -1;
+
+  return rt_mbx_wait_n(queue_id, buf, count, words);
+}
+
 
 // Message Queue ISR Calls
 
@@ -1746,6 +2957,46 @@ static __INLINE os_InRegs osEvent isrMessageGet (osMessageQId queue_id, uint32_t
   return ret;
 }
 
+/// Put up to count Messages (words) or Mails (pointers) to a Queue
+static int32_t isrMessagePutBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t words) {
+  uint32_t n;
+
+  if ((queue_id == NULL) || (buf == NULL)) return -1;
+
+  if (((P_MCB)queue_id)->cb_type != MCB) return -1;
+
+  // Posts are queued until the ISR ends: send no more than fit now
+  n = rt_mbx_check(queue_id);
+  if (count > n) count = n;
+
+  for (n = 0; n < count; n++) {
+    isr_mbx_send(queue_id, words ? (void *)((uint32_t *)buf)[n] : ((void **)buf)[n]);
+  }
+
+  return n;
+}
+
+/// Get up to count Messages (words) or Mails (pointers) from a Queue
+static int32_t isrMessageGetBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t words) {
+  uint32_t n;
+  void    *msg;
+
+  if ((queue_id == NULL) || (buf == NULL)) return -1;
+
+  if (((P_MCB)queue_id)->cb_type != MCB) return -1;
+
+  for (n = 0; n < count; n++) {
+    if (isr_mbx_receive(queue_id, &msg) != OS_R_MBX) break;
+    if (words) {
+      ((uint32_t *)buf)[n] = (uint32_t)msg;
+    } else {
+      ((void **)buf)[n] = msg;
+    }
+  }
+
+  return n;
+}
+
 
 // Message Queue Management Public API
 
@@ -1778,6 +3029,172 @@ os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec) {
   }
 }
 
+/// Put up to count Messages (words) or Mails (pointers) to a Queue
+static int32_t messagePutBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t millisec, uint32_t words) {
+  int32_t n;
+
+  if (__get_IPSR() != 0) {                      // in ISR
+    if (millisec != 0) return -1;
+    return   isrMessagePutBatch(queue_id, buf, count, words);
+  }
+  n = __svcMessagePutBatch(queue_id, buf, count, words);
+  if ((n == 0) && (count != 0) && (millisec != 0)) {
+    // Queue full: wait for a free entry for the first one
+    if (__svcMessagePut(queue_id, words ? ((uint32_t *)buf)[0] : (uint32_t)((void **)buf)[0], millisec) == osOK) {
+      n = 1;
+    }
+  }
+  return n;
+}
+
+/// Get up to count Messages (words) or Mails (pointers) from a Queue
+static int32_t messageGetBatch (osMessageQId queue_id, void *buf, uint32_t count, uint32_t millisec, uint32_t words) {
+  osEvent evt;
+  int32_t n;
+
+  if (__get_IPSR() != 0) {                      // in ISR
+    if (millisec != 0) return -1;
+    return   isrMessageGetBatch(queue_id, buf, count, words);
+  }
+  n = __svcMessageGetBatch(queue_id, buf, count, words);
+  if ((n == 0) && (count != 0) && (millisec != 0)) {
+    // Queue empty: wait for the first one
+    evt = __svcMessageGet(queue_id, millisec);
+    if (evt.status == osEventMessage) {
+      if (words) {
+        ((uint32_t *)buf)[0] = evt.value.v;
+      } else {
+        ((void **)buf)[0] = evt.value.p;
+      }
+      n = 1;
+    }
+  }
+  return n;
+}
+
+/// Put up to count Messages to a Queue
+int32_t os_message_put_batch (osMessageQId queue_id, const uint32_t *info, uint32_t count, uint32_t millisec) {
+  return messagePutBatch(queue_id, (void *)info, count, millisec, 1);
+}
+
+/// Get up to count Messages from a Queue or Wait for the first one
+int32_t os_message_get_batch (osMessageQId queue_id, uint32_t *info, uint32_t count, uint32_t millisec) {
+  return messageGetBatch(queue_id, info, count, millisec, 1);
+}
+
+
+// ==== Queue of Inline Payloads ====
+
+// Queue Service Calls declarations
+SVC_1_1(svcQueueCreate,          os_queue_id, const os_queue_def_t *,                       RET_pointer)
+SVC_3_1(svcQueuePut,             osStatus,    os_queue_id, const void *, uint32_t,          RET_osStatus)
+SVC_3_1(svcQueueGet,             osStatus,    os_queue_id, void *,       uint32_t,          RET_osStatus)
+
+// Queue Service Calls
+
+/// Create and Initialize a Queue of inline payloads
+os_queue_id svcQueueCreate (const os_queue_def_t *queue_def) {
+
+  if ((queue_def == NULL) ||
+      (queue_def->queue_sz == 0) || (queue_def->queue_sz > 0xFFFF) ||
+      (queue_def->item_sz  == 0) || (queue_def->item_sz  > 1020) ||
+      (queue_def->pool == NULL)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  if (((P_QCB)queue_def->pool)->cb_type != 0) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  rt_queue_init(queue_def->pool, queue_def->queue_sz, queue_def->item_sz);
+
+  return queue_def->pool;
+}
+
+/// Copy a payload to a Queue
+osStatus svcQueuePut (os_queue_id queue_id, const void *data, uint32_t millisec) {
+  OS_RESULT res;
+
+  if ((queue_id == NULL) || (data == NULL) || ((uint32_t)data & 3)) return osErrorParameter;
+
+  if (((P_QCB)queue_id)->cb_type != QCB) return osErrorParameter;
+
+  res = rt_queue_put((P_QCB)queue_id, data, rt_ms2tick(millisec));
+
+  if (res == OS_R_TMO) {
+    return (millisec ? osErrorTimeoutResource : osErrorResource);
+  }
+
+  return osOK;
+}
+
+/// Copy the oldest payload from a Queue or Wait for one
+osStatus svcQueueGet (os_queue_id queue_id, void *data, uint32_t millisec) {
+  OS_RESULT res;
+
+  if ((queue_id == NULL) || (data == NULL) || ((uint32_t)data & 3)) return osErrorParameter;
+
+  if (((P_QCB)queue_id)->cb_type != QCB) return osErrorParameter;
+
+  res = rt_queue_get((P_QCB)queue_id, data, rt_ms2tick(millisec));
+
+  if (res == OS_R_TMO) {
+    return (millisec ? osErrorTimeoutResource : osErrorResource);
+  }
+
+  return osOK;
+}
+
+
+// Queue ISR Calls
+
+/// Copy a payload to a Queue
+static __INLINE osStatus isrQueuePut (os_queue_id queue_id, const void *data, uint32_t millisec) {
+
+  if ((queue_id == NULL) || (data == NULL) || ((uint32_t)data & 3) || (millisec != 0)) {
+    return osErrorParameter;
+  }
+
+  if (((P_QCB)queue_id)->cb_type != QCB) return osErrorParameter;
+
+  if (isr_queue_put((P_QCB)queue_id, data) != OS_R_OK) {  // Queue is full
+    return osErrorResource;
+  }
+
+  return osOK;
+}
+
+
+// Queue Public API
+
+/// Create and Initialize a Queue of inline payloads
+os_queue_id os_queue_create (const os_queue_def_t *queue_def) {
+  if (__get_IPSR() != 0) return NULL;           // Not allowed in ISR
+  if (((__get_CONTROL() & 1) == 0) && (os_running == 0)) {
+    // Privileged and not running
+    return   svcQueueCreate(queue_def);
+  } else {
+    return __svcQueueCreate(queue_def);
+  }
+}
+
+/// Copy a payload to a Queue
+osStatus os_queue_put (os_queue_id queue_id, const void *data, uint32_t millisec) {
+  if (__get_IPSR() != 0) {                      // in ISR
+    return   isrQueuePut(queue_id, data, millisec);
+  } else {                                      // in Thread
+    return __svcQueuePut(queue_id, data, millisec);
+  }
+}
+
+/// Copy the oldest payload from a Queue or Wait for one
+osStatus os_queue_get (os_queue_id queue_id, void *data, uint32_t millisec) {
+  if (__get_IPSR() != 0) return osErrorISR;     // Not allowed in ISR
+  return __svcQueueGet(queue_id, data, millisec);
+}
+
 
 // ==== Mail Queue Management Functions ====
 
@@ -1810,11 +3227,11 @@ osMailQId svcMailCreate (const osMailQDef_t *queue_def, osThreadId thread_id) {
     return NULL;
   }
 
-  blk_sz = (queue_def->item_sz + 3) & ~3;
+  blk_sz = (queue_def->item_sz + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
 
   _init_box(pool, sizeof(struct OS_BM) + queue_def->queue_sz * blk_sz, blk_sz);
 
-  rt_mbx_init(pmcb, 4*(queue_def->queue_sz + 4));
+  rt_mbx_init(pmcb, sizeof(struct OS_MCB) + sizeof(void *)*(queue_def->queue_sz - 1));
 
 
   return queue_def->pool;
@@ -1960,3 +3377,15 @@ os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec) {
 
   return ret;
 }
+
+/// Put up to count Mails to a Queue
+int32_t os_mail_put_batch (osMailQId queue_id, void *const *mail, uint32_t count) {
+  if (queue_id == NULL) return -1;
+  return messagePutBatch(*((void **)queue_id), (void *)mail, count, 0, 0);
+}
+
+/// Get up to count Mails from a Queue or Wait for the first one
+int32_t os_mail_get_batch (osMailQId queue_id, void **mail, uint32_t count, uint32_t millisec) {
+  if (queue_id == NULL) return -1;
+  return messageGetBatch(*((void **)queue_id), mail, count, millisec, 0);
+}
@@ -0,0 +1,106 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_EDF.C
+ *      Purpose: Earliest deadline first scheduling class for periodic tasks
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_List.h"
+#include "rt_Time.h"
+#include "rt_Edf.h"
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_edf_set ------------------------------------*/
+
+void rt_edf_set (P_TCB p_task, U16 period, U16 deadline) {
+  /* Put a task into the EDF class: its first job is released now. The     */
+  /* caller moves the task to the EDF priority level afterwards.           */
+  p_task->edf_period   = period;
+  p_task->edf_rel_dl   = deadline;
+  p_task->edf_release  = os_time;
+  p_task->edf_deadline = os_time + deadline;
+  p_task->edf_jobs     = 0;
+  p_task->edf_misses   = 0;
+  p_task->edf_late_max = 0;
+}
+
+
+/*--------------------------- rt_edf_wait -----------------------------------*/
+
+void rt_edf_wait (void) {
+  /* End the job of the running EDF task and wait for the release of the   */
+  /* next one, one period after the release of the ending job.             */
+  P_TCB p_run = os_tsk.run;
+  U32   late, delta;
+
+  p_run->edf_jobs++;
+  late = os_time - p_run->edf_deadline;
+  if ((S32)late > 0) {
+    /* Job finished after its deadline. */
+    p_run->edf_misses++;
+    if (late > p_run->edf_late_max) {
+      p_run->edf_late_max = late;
+    }
+  }
+
+  p_run->edf_release += p_run->edf_period;
+  if ((S32)(os_time - p_run->edf_release) >= (S32)p_run->edf_period) {
+    /* Overrun by more than a period: release the following jobs from now. */
+    p_run->edf_release = os_time;
+  }
+  p_run->edf_deadline = p_run->edf_release + p_run->edf_rel_dl;
+
+  delta = p_run->edf_release - os_time;
+  if ((S32)delta > 0) {
+    /* 0xFFFF would be an endless wait; the period is below it anyway.    */
+    rt_block ((U16)((delta > 0xFFFE) ? 0xFFFE : delta), WAIT_DLY);
+    return;
+  }
+  /* Next job released already: its deadline is later, continue with an   */
+  /* EDF task of the level that comes first now.                           */
+  if (os_rdy.p_lnk && (os_rdy.p_lnk->prio == p_run->prio) &&
+      EDF_BEFORE (os_rdy.p_lnk, p_run)) {
+    p_run->state = READY;
+    rt_put_prio (&os_rdy, p_run);
+    rt_dispatch (NULL);
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
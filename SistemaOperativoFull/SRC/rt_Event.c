@@ -138,11 +138,14 @@ void isr_evt_set (U16 event_flags, OS_TID task_id) {
   /* Same function as "os_evt_set", but to be called by ISRs. */
   P_TCB p_tcb = os_active_TCB[task_id-1];
 
-  if (p_tcb == NULL) {
+  if (p_tcb == NULL || event_flags == 0) {
     return;
   }
-  rt_psq_enq (p_tcb, event_flags);
-  rt_psh_req ();
+  /* Merge the flags into the pending ones: the first post queues the task */
+  if (rt_or16 (&p_tcb->psh_events, event_flags) == 0) {
+    rt_psq_enq (p_tcb, 0);
+    rt_psh_req ();
+  }
 }
 
 
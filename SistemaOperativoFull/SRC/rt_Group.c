@@ -0,0 +1,233 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_GROUP.C
+ *      Purpose: Implements event groups
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_List.h"
+#include "rt_Task.h"
+#include "rt_Group.h"
+#include "rt_Trace.h"
+#include "rt_Edf.h"
+#include "rt_HAL_CM.h"
+
+/* An event group holds 32 flags shared by all tasks. Any number of tasks  */
+/* wait in the list of the group, each for any or all of its own flags. A  */
+/* set checks the whole list once and makes every task ready whose wait is */
+/* met; a task service call then preempts the caller at most once. ISRs    */
+/* merge their flags into 'psh_flags', the first one queues the group for  */
+/* the post service.                                                       */
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_grp_take -----------------------------------*/
+
+static U32 rt_grp_take (P_ECB p_ECB, U32 waits, U32 opts) {
+  /* Return the flags of "waits" that are set if they end the wait, else 0 */
+  U32 got;
+
+  got = p_ECB->flags & waits;
+  if ((opts & GRP_ALL) ? (got != waits) : (got == 0)) {
+    return (0);
+  }
+  if (opts & GRP_CLEAR) {
+    p_ECB->flags &= ~got;
+  }
+  return (got);
+}
+
+
+/*--------------------------- rt_grp_pass -----------------------------------*/
+
+static U32 rt_grp_pass (P_ECB p_ECB) {
+  /* Make all waiting tasks ready whose wait is met, in priority order.    */
+  /* Returns the number of tasks made ready.                               */
+  P_TCB p_TCB, p_next;
+  U32   got, n = 0;
+
+  p_TCB = p_ECB->p_lnk;
+  while ((p_TCB != NULL) && (p_ECB->flags != 0)) {
+    p_next = p_TCB->p_lnk;
+    got = rt_grp_take (p_ECB, p_TCB->grp_waits, p_TCB->grp_opts);
+    if (got != 0) {
+      rt_rmv_list (p_TCB);
+      rt_rmv_dly (p_TCB);
+      p_TCB->state = READY;
+      rt_ret_val2 (p_TCB, 0x08/*osEventSignal*/, got);
+      rt_put_prio (&os_rdy, p_TCB);
+      TRC_EVENT(TRC_GRP_WAKE, p_TCB->task_id, p_ECB);
+      n++;
+    }
+    p_TCB = p_next;
+  }
+  return (n);
+}
+
+
+/*--------------------------- rt_grp_sched ----------------------------------*/
+
+static void rt_grp_sched (void) {
+  /* Tasks were made ready by a service call: preempt the running task if */
+  /* one of them has a higher priority.                                   */
+  if (os_rdy.p_lnk && EDF_PREEMPT (os_rdy.p_lnk, os_tsk.run)) {
+    rt_put_prio (&os_rdy, os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_grp_init -----------------------------------*/
+
+void rt_grp_init (P_ECB p_ECB, U32 flags) {
+  /* Initialize an event group with the flags "flags" set */
+  p_ECB->cb_type   = ECB;
+  p_ECB->p_lnk     = NULL;
+  p_ECB->flags     = flags;
+  p_ECB->psh_flags = 0;
+}
+
+
+/*--------------------------- rt_grp_delete ---------------------------------*/
+
+void rt_grp_delete (P_ECB p_ECB) {
+  /* Delete an event group: waiting tasks return with osErrorResource */
+  P_TCB p_TCB;
+
+  while (p_ECB->p_lnk != NULL) {
+    p_TCB = rt_get_first ((P_XCB)p_ECB);
+    rt_ret_val2 (p_TCB, 0x81/*osErrorResource*/, 0);
+    rt_rmv_dly (p_TCB);
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+  }
+  rt_grp_sched ();
+  p_ECB->cb_type = 0;
+}
+
+
+/*--------------------------- rt_grp_set ------------------------------------*/
+
+U32 rt_grp_set (P_ECB p_ECB, U32 flags) {
+  /* Set the flags "flags" and wake up all tasks whose wait is met. Returns */
+  /* the flags before the set.                                              */
+  U32 prev;
+
+  prev = p_ECB->flags;
+  p_ECB->flags |= flags;
+  if (p_ECB->p_lnk != NULL) {
+    if (rt_grp_pass (p_ECB) != 0) {
+      rt_grp_sched ();
+    }
+  }
+  return (prev);
+}
+
+
+/*--------------------------- rt_grp_clr ------------------------------------*/
+
+U32 rt_grp_clr (P_ECB p_ECB, U32 flags) {
+  /* Clear the flags "flags", returns the flags before the clear */
+  U32 prev;
+
+  prev = p_ECB->flags;
+  p_ECB->flags &= ~flags;
+  return (prev);
+}
+
+
+/*--------------------------- rt_grp_wait -----------------------------------*/
+
+U32 rt_grp_wait (P_ECB p_ECB, U32 flags, U32 opts, U16 timeout) {
+  /* Wait for any or all (GRP_ALL) of the flags "flags". Returns the flags  */
+  /* that ended the wait, or 0 if the task has to wait or "timeout" is 0.   */
+  /* A task made ready later gets its flags through rt_ret_val2.           */
+  U32 got;
+
+  got = rt_grp_take (p_ECB, flags, opts);
+  if ((got != 0) || (timeout == 0)) {
+    return (got);
+  }
+  os_tsk.run->grp_waits = flags;
+  os_tsk.run->grp_opts  = (U8)opts;
+  if (p_ECB->p_lnk != NULL) {
+    rt_put_prio ((P_XCB)p_ECB, os_tsk.run);
+  }
+  else {
+    p_ECB->p_lnk = os_tsk.run;
+    os_tsk.run->p_lnk  = NULL;
+    os_tsk.run->p_rlnk = (P_TCB)p_ECB;
+  }
+  TRC_EVENT(TRC_GRP_BLOCK, timeout, p_ECB);
+  rt_block (timeout, WAIT_GRP);
+  return (0);
+}
+
+
+/*--------------------------- isr_grp_set -----------------------------------*/
+
+void isr_grp_set (P_ECB p_ECB, U32 flags) {
+  /* Same function as "rt_grp_set", but to be called by ISRs */
+  if (flags == 0) {
+    return;
+  }
+  /* Merge the flags into the pending ones: the first post queues the group */
+  if (rt_or32 (&p_ECB->psh_flags, flags) == 0) {
+    rt_psq_enq (p_ECB, 0);
+    rt_psh_req ();
+  }
+}
+
+
+/*--------------------------- rt_grp_psh ------------------------------------*/
+
+void rt_grp_psh (P_ECB p_ECB, U32 flags) {
+  /* Pass the flags "flags" set by ISRs: wake up all tasks whose wait is met */
+  p_ECB->flags |= flags;
+  if (p_ECB->p_lnk != NULL) {
+    rt_grp_pass (p_ECB);
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
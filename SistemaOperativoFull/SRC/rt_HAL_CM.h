@@ -38,6 +38,7 @@
 #define DEMCR_TRCENA    0x01000000
 #define ITM_ITMENA      0x00000001
 #define MAGIC_WORD      0xE25A2EA5
+#define MAGIC_PATTERN   0xCCCCCCCC
 
 #if defined (__CC_ARM)          /* ARM Compiler */
 
@@ -47,6 +48,23 @@
  #undef  __USE_EXCLUSIVE_ACCESS
 #endif
 
+#elif defined (__RTX_POSIX)     /* Host port (GNU Compiler) */
+
+#undef  __USE_EXCLUSIVE_ACCESS
+
+#define __TARGET_ARCH_6S_M 0
+#define __TARGET_FPU_VFP   0
+
+#define __inline inline
+#define __weak   __attribute__((weak))
+
+#include "core_posix.h"
+
+__attribute__(( always_inline)) static inline U8 __clz(U32 value)
+{
+  return ((value == 0) ? 32 : __builtin_clz (value));
+}
+
 #elif defined (__GNUC__)        /* GNU Compiler */
 
 #undef  __USE_EXCLUSIVE_ACCESS
@@ -138,6 +156,29 @@ static inline U8 __clz(U32 value)
 
 #endif
 
+#if defined (__RTX_POSIX)
+
+/* Emulated SysTick and PendSV state of the host port (HAL_POSIX.c) */
+extern volatile U32 os_icsr;            /* PENDSTSET bit 26, PENDSVSET bit 28 */
+extern volatile U32 os_st_ctrl;         /* SysTick CTRL, TICKINT is bit 1     */
+extern void os_pend_irq (U32 pend);
+
+#define OS_PEND_IRQ()   os_pend_irq (1<<28)
+#define OS_PENDING      ((os_icsr >> 26) & (1<<2 | 1))
+#define OS_UNPEND(fl)   os_icsr &= ~((*fl = OS_PENDING) << 26)
+#define OS_PEND(fl,p)   os_pend_irq ((fl | p<<2) << 26)
+#define OS_LOCK()       os_st_ctrl = 0x0005
+#define OS_UNLOCK()     os_st_ctrl = 0x0007
+
+#define OS_X_PENDING    ((os_icsr >> 28) & 1)
+#define OS_X_UNPEND(fl) os_icsr &= ~((*fl = OS_X_PENDING) << 28)
+#define OS_X_PEND(fl,p) os_pend_irq ((fl | p) << 28)
+#define OS_X_INIT(n)
+#define OS_X_LOCK(n)
+#define OS_X_UNLOCK(n)
+
+#else
+
 /* NVIC registers */
 #define NVIC_ST_CTRL    (*((volatile unsigned int *)0xE000E010))
 #define NVIC_ST_RELOAD  (*((volatile unsigned int *)0xE000E014))
@@ -174,9 +215,15 @@ static inline U8 __clz(U32 value)
 #define OS_X_LOCK(n)    NVIC_ICER[n>>5] = 1 << (n & 0x1F)
 #define OS_X_UNLOCK(n)  NVIC_ISER[n>>5] = 1 << (n & 0x1F)
 
+#endif
+
 /* Core Debug registers */
 #define DEMCR           (*((volatile unsigned int *)0xE000EDFC))
 
+/* DWT registers */
+#define DWT_CTRL        (*((volatile unsigned int *)0xE0001000))
+#define DWT_CYCCNT      (*((volatile unsigned int *)0xE0001004))
+
 /* ITM registers */
 #define ITM_CONTROL     (*((volatile unsigned int *)0xE0000E80))
 #define ITM_ENABLE      (*((volatile unsigned int *)0xE0000E00))
@@ -197,6 +244,26 @@ extern unsigned char dbg_msg;
  #define rt_dec(p)     __disable_irq();(*p)--;__enable_irq();
 #endif
 
+#if (__TARGET_ARCH_6S_M)
+__inline static U32 rt_msb (U32 value) {
+  /* Return the index of the most significant set bit of "value" (!= 0).   */
+  /* Cortex-M0 has no CLZ instruction: use a binary search instead.         */
+  U32 n = 0;
+
+  if (value & 0xFFFF0000) { n += 16; value >>= 16; }
+  if (value & 0x0000FF00) { n +=  8; value >>=  8; }
+  if (value & 0x000000F0) { n +=  4; value >>=  4; }
+  if (value & 0x0000000C) { n +=  2; value >>=  2; }
+  if (value & 0x00000002) { n +=  1; }
+  return (n);
+}
+#else
+ #define rt_msb(value)  (31 - __clz (value))
+#endif
+
+/* Index of the least significant set bit of "value" (!= 0) */
+#define rt_lsb(value)   rt_msb ((value) & (0 - (value)))
+
 __inline static unsigned int rt_inc_qi (unsigned int size, unsigned char *count, unsigned char *first) {
   unsigned int cnt,c2;
 #ifdef __USE_EXCLUSIVE_ACCESS
@@ -222,6 +289,125 @@ __inline static unsigned int rt_inc_qi (unsigned int size, unsigned char *count,
   return (cnt);
 }
 
+__inline static unsigned int rt_or16 (unsigned short *p, unsigned int val) {
+  /* Atomic "*p |= val", returns the previous value of "*p". */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(old | val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = (unsigned short)(old | val);
+  __enable_irq();
+#endif
+  return (old);
+}
+
+__inline static unsigned int rt_add16 (unsigned short *p, unsigned int val) {
+  /* Atomic "*p += val", returns the previous value of "*p". */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(old + val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = (unsigned short)(old + val);
+  __enable_irq();
+#endif
+  return (old);
+}
+
+__inline static unsigned int rt_swp16 (unsigned short *p, unsigned int val) {
+  /* Atomic exchange of "*p" and "val", returns the previous value. */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = (unsigned short)val;
+  __enable_irq();
+#endif
+  return (old);
+}
+
+__inline static unsigned int rt_or32 (unsigned int *p, unsigned int val) {
+  /* Atomic "*p |= val", returns the previous value of "*p". */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(old | val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = old | val;
+  __enable_irq();
+#endif
+  return (old);
+}
+
+__inline static unsigned int rt_add32 (unsigned int *p, unsigned int val) {
+  /* Atomic "*p += val", returns the previous value of "*p". */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(old + val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = old + val;
+  __enable_irq();
+#endif
+  return (old);
+}
+
+__inline static unsigned int rt_swp32 (unsigned int *p, unsigned int val) {
+  /* Atomic exchange of "*p" and "val", returns the previous value. */
+  unsigned int old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex(val, p));
+#else
+  __disable_irq();
+  old = *p;
+  *p  = val;
+  __enable_irq();
+#endif
+  return (old);
+}
+
+#if defined (__RTX_POSIX)
+
+extern void rt_systick_init (void);
+extern unsigned int rt_systick_val (void);
+extern unsigned int rt_systick_ovf (void);
+extern void rt_svc_init (void);
+extern unsigned int rt_stamp_val (void);
+
+__inline static void rt_stamp_init (void) {
+  /* Host time stamps are taken from the monotonic clock. */
+}
+
+__inline static unsigned int rt_systick_stretch (unsigned int ticks) {
+  /* The interval timer of the host is not stretched. */
+  return (0);
+}
+
+__inline static unsigned int rt_systick_restore (unsigned int ticks) {
+  return (ticks);
+}
+
+#else
+
 __inline static void rt_systick_init (void) {
   NVIC_ST_RELOAD  = os_trv;
   NVIC_ST_CURRENT = 0;
@@ -237,6 +423,74 @@ __inline static unsigned int rt_systick_ovf (void) {
   return ((NVIC_INT_CTRL >> 26) & 1);
 }
 
+__inline static unsigned int rt_systick_stretch (unsigned int ticks) {
+  /* The counter is stopped only for a few cycles while it is reloaded. */
+  unsigned int max = 0x01000000 / (os_trv + 1);
+
+  if (ticks > max) ticks = max;
+  if (ticks < 2) return (0);
+  NVIC_ST_CTRL = 0x0006;
+  if (NVIC_INT_CTRL & (1 << 26)) {
+    /* Tick boundary has just passed, it must be handled first. */
+    NVIC_ST_CTRL = 0x0007;
+    return (0);
+  }
+  NVIC_ST_RELOAD  = NVIC_ST_CURRENT + (ticks - 1) * (os_trv + 1);
+  NVIC_ST_CURRENT = 0;
+  NVIC_ST_CTRL    = 0x0007;
+  while (NVIC_ST_CURRENT == 0);
+  NVIC_ST_RELOAD  = os_trv;
+  return (ticks);
+}
+
+__inline static unsigned int rt_systick_restore (unsigned int ticks) {
+  unsigned int cur, part;
+
+  NVIC_ST_CTRL = 0x0006;
+  if (NVIC_INT_CTRL & (1 << 26)) {
+    /* Stretched period is over, the counter runs a normal period already. */
+    NVIC_INT_CTRL = (1 << 25);
+    NVIC_ST_CTRL  = 0x0007;
+    return (ticks);
+  }
+  cur   = NVIC_ST_CURRENT;
+  part  = cur % (os_trv + 1);
+  ticks = ticks - 1 - cur / (os_trv + 1);
+  if (part < 32) {
+    /* Too close to the boundary to reload in time: take it now. */
+    ticks++;
+    part += os_trv + 1;
+  }
+  NVIC_ST_RELOAD  = part - 1;
+  NVIC_ST_CURRENT = 0;
+  NVIC_ST_CTRL    = 0x0007;
+  while (NVIC_ST_CURRENT == 0);
+  NVIC_ST_RELOAD  = os_trv;
+  return (ticks);
+}
+
+__inline static void rt_stamp_init (void) {
+  /* Start the free running time stamp counter (DWT cycle counter). */
+#if !(__TARGET_ARCH_6S_M)
+  DEMCR    |= DEMCR_TRCENA;
+  DWT_CTRL |= 1;
+#endif
+}
+
+#if (__TARGET_ARCH_6S_M)
+extern U32 os_time;
+#endif
+
+__inline static unsigned int rt_stamp_val (void) {
+  /* Time stamp in OS_CLOCK cycles. ARMv6-M has no cycle counter: the      */
+  /* stamp is made up from the system time and the SysTick counter.        */
+#if (__TARGET_ARCH_6S_M)
+  return (os_time * (os_trv + 1) + rt_systick_val ());
+#else
+  return (DWT_CYCCNT);
+#endif
+}
+
 __inline static void rt_svc_init (void) {
 #if !(__TARGET_ARCH_6S_M)
   int sh,prigroup;
@@ -254,13 +508,20 @@ __inline static void rt_svc_init (void) {
 #endif
 }
 
+#endif
+
 extern void rt_set_PSP (unsigned int stack);
 extern unsigned int  rt_get_PSP (void);
 extern void os_set_env (void);
 extern void *_alloc_box (void *box_mem);
 extern int  _free_box (void *box_mem, void *box);
+#if defined (__RTX_POSIX)
+extern void os_svc_enter (U32 svc);
+extern void os_svc_exit (U32 svc, U32 *regs);
+#endif
 
 extern void rt_init_stack (P_TCB p_TCB, FUNCP task_body);
+extern U32  rt_stk_peak (P_TCB p_TCB, U32 *size);
 extern void rt_ret_val  (P_TCB p_TCB, unsigned int v0);
 extern void rt_ret_val2 (P_TCB p_TCB, unsigned int v0, unsigned int v1);
 
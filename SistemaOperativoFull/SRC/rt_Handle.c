@@ -0,0 +1,239 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_HANDLE.C
+ *      Purpose: Driver handle table for peripheral ownership
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_Handle.h"
+
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Handle table in os_hnd_mem, os_hnd_cnt entries */
+#define os_hnd  ((P_HCB)os_hnd_mem)
+
+/* Release functions of the drivers, driver 0: free */
+struct OS_HDRV {
+  U32       drv;
+  HND_FUNCP release;
+} os_hnd_drv[HND_DRVCNT];
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_hnd_init -----------------------------------*/
+
+void rt_hnd_init (void) {
+  /* Mark all entries free. */
+  U32 i;
+
+  for (i = 0; i < os_hnd_cnt; i++) {
+    os_hnd[i].hnd   = i + 1;
+    os_hnd[i].owner = HND_SHARED;
+    os_hnd[i].unit  = 0;
+    os_hnd[i].obj   = NULL;
+  }
+  for (i = 0; i < HND_DRVCNT; i++) {
+    os_hnd_drv[i].drv     = 0;
+    os_hnd_drv[i].release = NULL;
+  }
+}
+
+
+/*--------------------------- rt_hnd_open -----------------------------------*/
+
+U32 rt_hnd_open (U32 drv, U32 unit, void *obj) {
+  /* Take a free entry for "unit" of driver "drv", owned by the running    */
+  /* task. Returns the handle, 0 if the unit is open or the table is full. */
+  P_HCB hcb, free = NULL;
+  U32   i;
+
+  for (i = 0; i < os_hnd_cnt; i++) {
+    hcb = &os_hnd[i];
+    if (HND_DRV(hcb->hnd) == 0) {
+      if (free == NULL) {
+        free = hcb;
+      }
+    }
+    else if ((HND_DRV(hcb->hnd) == drv) && (hcb->unit == unit) &&
+             (unit != HND_NOUNIT)) {
+      return (0);
+    }
+  }
+  if (free == NULL) {
+    return (0);
+  }
+  /* The generation of the entry is kept, it was advanced at close */
+  free->hnd   = (drv << 24) | (free->hnd & 0x00FFFFFF);
+  free->owner = os_tsk.run->task_id;
+  free->unit  = unit;
+  free->obj   = obj;
+  return (free->hnd);
+}
+
+
+/*--------------------------- rt_hnd_find -----------------------------------*/
+
+U32 rt_hnd_find (U32 drv, U32 unit) {
+  /* Return the handle of "unit" of driver "drv" if it is open and the     */
+  /* running task may use it, else 0.                                       */
+  P_HCB hcb;
+  U32   i;
+
+  for (i = 0; i < os_hnd_cnt; i++) {
+    hcb = &os_hnd[i];
+    if ((HND_DRV(hcb->hnd) == drv) && (hcb->unit == unit)) {
+      if ((hcb->owner == HND_SHARED) || (hcb->owner == os_tsk.run->task_id)) {
+        return (hcb->hnd);
+      }
+      return (0);
+    }
+  }
+  return (0);
+}
+
+
+/*--------------------------- rt_hnd_get ------------------------------------*/
+
+P_HCB rt_hnd_get (U32 hnd, U32 drv) {
+  /* Validate a handle: it must be open for driver "drv" (not 0), of the   */
+  /* current generation and owned by the running task or shared. One      */
+  /* compare of the handle word checks index, generation and driver.      */
+  P_HCB hcb;
+  U32   idx;
+
+  idx = HND_IDX(hnd);
+  if ((idx >= os_hnd_cnt) || (HND_DRV(hnd) != drv)) {
+    return (NULL);
+  }
+  hcb = &os_hnd[idx];
+  if ((hcb->hnd != hnd) ||
+      ((hcb->owner != HND_SHARED) && (hcb->owner != os_tsk.run->task_id))) {
+    return (NULL);
+  }
+  return (hcb);
+}
+
+
+/*--------------------------- rt_hnd_close ----------------------------------*/
+
+void rt_hnd_close (P_HCB hcb) {
+  /* Free a validated entry. The new generation makes all copies of the    */
+  /* handle stale.                                                          */
+  hcb->hnd   = ((hcb->hnd + HND_GEN) & 0x00FFFF00) | (hcb->hnd & 0xFF);
+  hcb->owner = HND_SHARED;
+  hcb->obj   = NULL;
+}
+
+
+/*--------------------------- rt_hnd_release --------------------------------*/
+
+void rt_hnd_release (U32 task_id) {
+  /* Close the entries owned by a terminating task, before its task id can */
+  /* be given to a new task that would pass the owner check. Nobody can    */
+  /* close them any more, so the release function of the driver runs its   */
+  /* close path: it stops the unit and frees the object. An entry of a     */
+  /* driver without one is only closed, its object stays with the driver.  */
+  P_HCB hcb;
+  U32   i, j;
+
+  for (i = 0; i < os_hnd_cnt; i++) {
+    hcb = &os_hnd[i];
+    if ((HND_DRV(hcb->hnd) != 0) && (hcb->owner == task_id)) {
+      for (j = 0; j < HND_DRVCNT; j++) {
+        if (os_hnd_drv[j].drv == HND_DRV(hcb->hnd)) {
+          break;
+        }
+      }
+      if (j < HND_DRVCNT) {
+        os_hnd_drv[j].release (hcb);
+      }
+      if (hcb->owner == task_id) {
+        /* Not closed by the driver */
+        rt_hnd_close (hcb);
+      }
+    }
+  }
+}
+
+
+/*--------------------------- rt_hnd_driver ---------------------------------*/
+
+U32 rt_hnd_driver (U32 drv, HND_FUNCP release) {
+  /* Register the release function of driver "drv", called again it       */
+  /* replaces the function. Returns 0 if done, 1 if the table is full.     */
+  U32 i, free = HND_DRVCNT;
+
+  for (i = 0; i < HND_DRVCNT; i++) {
+    if (os_hnd_drv[i].drv == drv) {
+      break;
+    }
+    if ((os_hnd_drv[i].drv == 0) && (free == HND_DRVCNT)) {
+      free = i;
+    }
+  }
+  if (i == HND_DRVCNT) {
+    if (free == HND_DRVCNT) {
+      return (1);
+    }
+    i = free;
+  }
+  os_hnd_drv[i].drv     = drv;
+  os_hnd_drv[i].release = release;
+  return (0);
+}
+
+
+/*--------------------------- rt_hnd_count ----------------------------------*/
+
+U32 rt_hnd_count (U32 drv) {
+  /* Return the number of open handles of driver "drv". */
+  U32 i, cnt = 0;
+
+  for (i = 0; i < os_hnd_cnt; i++) {
+    if (HND_DRV(os_hnd[i].hnd) == drv) {
+      cnt++;
+    }
+  }
+  return (cnt);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
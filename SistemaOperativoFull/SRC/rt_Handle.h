@@ -0,0 +1,79 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_HANDLE.H
+ *      Purpose: Driver handle definitions
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+
+/* Definitions */
+#define HND_UART        1               /* Driver ids, part of every handle  */
+#define HND_LCD         2
+#define HND_TOUCH       3
+#define HND_FILE        4
+#define HND_ETH         5
+#define HND_SHARED      0               /* Owner of a handle any thread uses */
+#define HND_NOUNIT      0xFF            /* Unit of drivers opened many times */
+
+/* Handle word: driver id << 24 | generation << 8 | table index + 1 */
+#define HND_IDX(h)      (((h) & 0xFF) - 1)
+#define HND_DRV(h)      ((h) >> 24)
+#define HND_GEN         0x00000100
+
+/* Drivers that can register a release function */
+#define HND_DRVCNT      8
+
+/* Types */
+typedef struct OS_HCB {                 /* << Driver handle entry >>         */
+  U32   hnd;                            /* Handle of the entry, driver 0:free*/
+  U8    owner;                          /* Task id of the owner or HND_SHARED*/
+  U8    unit;                           /* Unit of the driver, e.g. UART port*/
+  U16   reserved;
+  void *obj;                            /* Object of the driver or NULL      */
+} *P_HCB;
+
+/* Release function of a driver: runs its close path on an entry of a    */
+/* terminating task, the entry included (rt_hnd_close).                   */
+typedef void (*HND_FUNCP)(P_HCB hcb);
+
+/* Functions */
+extern void  rt_hnd_init  (void);
+extern U32   rt_hnd_open  (U32 drv, U32 unit, void *obj);
+extern U32   rt_hnd_find  (U32 drv, U32 unit);
+extern P_HCB rt_hnd_get   (U32 hnd, U32 drv);
+extern void  rt_hnd_close (P_HCB hcb);
+extern void  rt_hnd_release (U32 task_id);
+extern U32   rt_hnd_driver  (U32 drv, HND_FUNCP release);
+extern U32   rt_hnd_count (U32 drv);
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
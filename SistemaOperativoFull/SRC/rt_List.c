@@ -32,6 +32,7 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *---------------------------------------------------------------------------*/
 
+#include <stddef.h>
 #include "rt_TypeDef.h"
 #include "RTX_Config.h"
 #include "rt_System.h"
@@ -39,6 +40,16 @@
 #include "rt_Task.h"
 #include "rt_Time.h"
 #include "rt_HAL_CM.h"
+#include "rt_Wheel.h"
+#include "rt_Stats.h"
+#include "rt_Edf.h"
+
+/* Wait lists with back links (p_rlnk): a waiter that times out or is     */
+/* deleted leaves them from any place with rt_rmv_list. Message queues    */
+/* need them as much as mailboxes, any of their waiters can time out.     */
+#define HAS_RLNK(p_CB)  ((p_CB)->cb_type == SCB || (p_CB)->cb_type == MCB || \
+                         (p_CB)->cb_type == MUCB || (p_CB)->cb_type == QCB || \
+                         (p_CB)->cb_type == ECB)
 
 /*----------------------------------------------------------------------------
  *      Global Variables
@@ -46,8 +57,99 @@
 
 /* List head of chained ready tasks */
 struct OS_XCB  os_rdy;
-/* List head of chained delay tasks */
-struct OS_XCB  os_dly;
+/* Timing wheel of delayed tasks */
+struct OS_WHL  os_dly;
+
+/* Ready list priority bitmap: one bit per priority level, one group bit   */
+/* for each 32 levels. A bit is set while the level has a ready task.      */
+static U32 os_rdy_grp;
+static U32 os_rdy_map[8];
+/* Last ready task queued on each priority level, NULL if level is empty  */
+static P_TCB os_rdy_tail[256];
+
+/* A task is queued in the delay wheel through its 'p_dlnk' fields        */
+#define rt_tcb2dly(p_task)  ((P_WNODE)&(p_task)->p_dlnk)
+#define rt_dly2tcb(p_node)  ((P_TCB)((U8 *)(p_node) - offsetof(struct OS_TCB, p_dlnk)))
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_rdy_pred -----------------------------------*/
+
+static P_TCB rt_rdy_pred (U32 prio) {
+  /* Return the ready task after which a task with priority "prio" has to   */
+  /* be chained: it is the last task of the lowest non-empty priority level */
+  /* equal or above "prio". Return the list head if there is none.          */
+  U32 grp, map;
+
+  if (os_rdy_tail[prio] != NULL) {
+    return (os_rdy_tail[prio]);
+  }
+  grp = prio >> 5;
+  map = os_rdy_map[grp] & ~((2U << (prio & 0x1F)) - 1);
+  if (map == 0) {
+    /* No higher level in this group, search the groups above. */
+    map = os_rdy_grp & ~((2U << grp) - 1);
+    if (map == 0) {
+      return ((P_TCB)&os_rdy);
+    }
+    grp = rt_lsb (map);
+    map = os_rdy_map[grp];
+  }
+  return (os_rdy_tail[(grp << 5) + rt_lsb (map)]);
+}
+
+
+/*--------------------------- rt_rdy_edf_pred -------------------------------*/
+
+static P_TCB rt_rdy_edf_pred (P_TCB p_task) {
+  /* Return the ready task after which EDF task "p_task" has to be chained: */
+  /* the last task of its level that runs before it, else the task ahead   */
+  /* of the level. The level is walked back from its tail.                 */
+  P_TCB p_CB2;
+  U32 prio;
+
+  prio  = p_task->prio;
+  p_CB2 = rt_rdy_pred (prio);
+  while ((p_CB2 != (P_TCB)&os_rdy) && (p_CB2->rdy_prio == prio) &&
+         EDF_BEFORE (p_task, p_CB2)) {
+    p_CB2 = p_CB2->p_rblnk;
+  }
+  return (p_CB2);
+}
+
+
+/*--------------------------- rt_rmv_rdy ------------------------------------*/
+
+static void rt_rmv_rdy (P_TCB p_task) {
+  /* Unchain task "p_task" from the ready list and update the bitmap.       */
+  P_TCB p_b;
+  U32 prio;
+
+  p_b  = p_task->p_rblnk;
+  prio = p_task->rdy_prio;
+  p_b->p_lnk = p_task->p_lnk;
+  if (p_task->p_lnk != NULL) {
+    p_task->p_lnk->p_rblnk = p_b;
+  }
+  if (os_rdy_tail[prio] == p_task) {
+    if (p_b != (P_TCB)&os_rdy && p_b->rdy_prio == prio) {
+      os_rdy_tail[prio] = p_b;
+    }
+    else {
+      /* Priority level is empty now */
+      os_rdy_tail[prio] = NULL;
+      os_rdy_map[prio >> 5] &= ~(1U << (prio & 0x1F));
+      if (os_rdy_map[prio >> 5] == 0) {
+        os_rdy_grp &= ~(1U << (prio >> 5));
+      }
+    }
+  }
+  p_task->p_lnk   = NULL;
+  p_task->p_rblnk = NULL;
+}
 
 
 /*----------------------------------------------------------------------------
@@ -55,6 +157,24 @@ struct OS_XCB  os_dly;
  *---------------------------------------------------------------------------*/
 
 
+/*--------------------------- rt_init_rdy -----------------------------------*/
+
+void rt_init_rdy (void) {
+  /* Initialize the ready list head and the priority bitmap: list empty.    */
+  U32 i;
+
+  os_rdy.cb_type = HCB;
+  os_rdy.p_lnk   = NULL;
+  os_rdy_grp     = 0;
+  for (i = 0; i < 8; i++) {
+    os_rdy_map[i] = 0;
+  }
+  for (i = 0; i < 256; i++) {
+    os_rdy_tail[i] = NULL;
+  }
+}
+
+
 /*--------------------------- rt_put_prio -----------------------------------*/
 
 void rt_put_prio (P_XCB p_CB, P_TCB p_task) {
@@ -65,7 +185,37 @@ void rt_put_prio (P_XCB p_CB, P_TCB p_task) {
   U32 prio;
   BOOL sem_mbx = __FALSE;
 
-  if (p_CB->cb_type == SCB || p_CB->cb_type == MCB || p_CB->cb_type == MUCB) {
+  if (p_CB == &os_rdy) {
+    /* Ready list: chain behind the last task of the same or the next      */
+    /* higher priority level, found in constant time from the bitmap. EDF  */
+    /* tasks are ordered by their deadlines inside the EDF level.          */
+    prio  = p_task->prio;
+    if ((prio == os_edfprio) && (p_task->edf_period != 0)) {
+      p_CB2 = rt_rdy_edf_pred (p_task);
+    }
+    else {
+      p_CB2 = rt_rdy_pred (prio);
+    }
+    p_task->p_lnk = p_CB2->p_lnk;
+    if (p_task->p_lnk != NULL) {
+      p_task->p_lnk->p_rblnk = p_task;
+    }
+    p_CB2->p_lnk    = p_task;
+    p_task->p_rblnk = p_CB2;
+    p_task->p_rlnk  = NULL;
+    p_task->rdy_prio = (U8)prio;
+    STAT_READY (p_task);
+    if (os_rdy_tail[prio] == NULL) {
+      os_rdy_map[prio >> 5] |= 1U << (prio & 0x1F);
+      os_rdy_grp            |= 1U << (prio >> 5);
+      os_rdy_tail[prio] = p_task;
+    }
+    else if (os_rdy_tail[prio] == p_CB2) {
+      os_rdy_tail[prio] = p_task;
+    }
+    return;
+  }
+  if (HAS_RLNK (p_CB)) {
     sem_mbx = __TRUE;
   }
   prio = p_task->prio;
@@ -98,8 +248,12 @@ P_TCB rt_get_first (P_XCB p_CB) {
   P_TCB p_first;
 
   p_first = p_CB->p_lnk;
+  if (p_CB == &os_rdy) {
+    rt_rmv_rdy (p_first);
+    return (p_first);
+  }
   p_CB->p_lnk = p_first->p_lnk;
-  if (p_CB->cb_type == SCB || p_CB->cb_type == MCB || p_CB->cb_type == MUCB) {
+  if (HAS_RLNK (p_CB)) {
     if (p_first->p_lnk != NULL) {
       p_first->p_lnk->p_rlnk = (P_TCB)p_CB;
       p_first->p_lnk = NULL;
@@ -118,9 +272,24 @@ P_TCB rt_get_first (P_XCB p_CB) {
 void rt_put_rdy_first (P_TCB p_task) {
   /* Put task identified with "p_task" at the head of the ready list. The   */
   /* task must have at least a priority equal to highest priority in list.  */
+  U32 prio;
+
+  prio = p_task->prio;
   p_task->p_lnk = os_rdy.p_lnk;
-  p_task->p_rlnk = NULL;
+  if (p_task->p_lnk != NULL) {
+    p_task->p_lnk->p_rblnk = p_task;
+  }
+  p_task->p_rlnk   = NULL;
+  p_task->p_rblnk  = (P_TCB)&os_rdy;
+  p_task->rdy_prio = (U8)prio;
+  STAT_READY (p_task);
   os_rdy.p_lnk = p_task;
+  if (os_rdy_tail[prio] == NULL) {
+    /* Task is the only one on its level: it is the level tail too. */
+    os_rdy_map[prio >> 5] |= 1U << (prio & 0x1F);
+    os_rdy_grp            |= 1U << (prio >> 5);
+    os_rdy_tail[prio] = p_task;
+  }
 }
 
 
@@ -133,7 +302,7 @@ P_TCB rt_get_same_rdy_prio (void) {
 
   p_first = os_rdy.p_lnk;
   if (p_first->prio == os_tsk.run->prio) {
-    os_rdy.p_lnk = os_rdy.p_lnk->p_lnk;
+    rt_rmv_rdy (p_first);
     return (p_first);
   }
   return (NULL);
@@ -168,55 +337,24 @@ res:rt_rmv_list (p_task);
 /*--------------------------- rt_put_dly ------------------------------------*/
 
 void rt_put_dly (P_TCB p_task, U16 delay) {
-  /* Put a task identified with "p_task" into chained delay wait list using */
+  /* Put a task identified with "p_task" into the delay timing wheel using  */
   /* a delay value of "delay".                                              */
-  P_TCB p;
-  U32 delta,idelay = delay;
-
-  p = (P_TCB)&os_dly;
-  if (p->p_dlnk == NULL) {
-    /* Delay list empty */
-    delta = 0;
-    goto last;
-  }
-  delta = os_dly.delta_time;
-  while (delta < idelay) {
-    if (p->p_dlnk == NULL) {
-      /* End of list found */
-last: p_task->p_dlnk = NULL;
-      p->p_dlnk = p_task;
-      p_task->p_blnk = p;
-      p->delta_time = (U16)(idelay - delta);
-      p_task->delta_time = 0;
-      return;
-    }
-    p = p->p_dlnk;
-    delta += p->delta_time;
-  }
-  /* Right place found */
-  p_task->p_dlnk = p->p_dlnk;
-  p->p_dlnk = p_task;
-  p_task->p_blnk = p;
-  if (p_task->p_dlnk != NULL) {
-    p_task->p_dlnk->p_blnk = p_task;
-  }
-  p_task->delta_time = (U16)(delta - idelay);
-  p->delta_time -= p_task->delta_time;
+  rt_whl_put (&os_dly, rt_tcb2dly(p_task), delay);
 }
 
 
 /*--------------------------- rt_dec_dly ------------------------------------*/
 
 void rt_dec_dly (void) {
-  /* Decrement delta time of list head: remove tasks having a value of zero.*/
+  /* Advance the delay wheel by one tick: ready tasks whose delay expired.  */
+  P_WNODE p_node;
   P_TCB p_rdy;
 
-  if (os_dly.p_dlnk == NULL) {
-    return;
-  }
-  os_dly.delta_time--;
-  while ((os_dly.delta_time == 0) && (os_dly.p_dlnk != NULL)) {
-    p_rdy = os_dly.p_dlnk;
+  p_node = rt_whl_tick (&os_dly);
+  while (p_node != NULL) {
+    p_rdy  = rt_dly2tcb(p_node);
+    p_node = p_node->next;
+    p_rdy->p_dlnk = NULL;
     if (p_rdy->p_rlnk != NULL) {
       /* Task is really enqueued, remove task from semaphore/mailbox */
       /* timeout waiting list. */
@@ -228,18 +366,11 @@ void rt_dec_dly (void) {
       p_rdy->p_rlnk = NULL;
     }
     rt_put_prio (&os_rdy, p_rdy);
-    os_dly.delta_time = p_rdy->delta_time;
     if (p_rdy->state == WAIT_ITV) {
       /* Calculate the next time for interval wait. */
       p_rdy->delta_time = p_rdy->interval_time + (U16)os_time;
     }
     p_rdy->state   = READY;
-    os_dly.p_dlnk = p_rdy->p_dlnk;
-    if (p_rdy->p_dlnk != NULL) {
-      p_rdy->p_dlnk->p_blnk =  (P_TCB)&os_dly;
-      p_rdy->p_dlnk = NULL;
-    }
-    p_rdy->p_blnk = NULL;
   }
 }
 
@@ -247,10 +378,8 @@ void rt_dec_dly (void) {
 /*--------------------------- rt_rmv_list -----------------------------------*/
 
 void rt_rmv_list (P_TCB p_task) {
-  /* Remove task identified with "p_task" from ready, semaphore or mailbox  */
-  /* waiting list if enqueued.                                              */
-  P_TCB p_b;
-
+  /* Remove task identified with "p_task" from ready, semaphore, mailbox,   */
+  /* message queue or event group waiting list if enqueued.                 */
   if (p_task->p_rlnk != NULL) {
     /* A task is enqueued in semaphore / mailbox waiting list. */
     p_task->p_rlnk->p_lnk = p_task->p_lnk;
@@ -260,14 +389,9 @@ void rt_rmv_list (P_TCB p_task) {
     return;
   }
 
-  p_b = (P_TCB)&os_rdy;
-  while (p_b != NULL) {
-    /* Search the ready list for task "p_task" */
-    if (p_b->p_lnk == p_task) {
-      p_b->p_lnk = p_task->p_lnk;
-      return;
-    }
-    p_b = p_b->p_lnk;
+  if (p_task->p_rblnk != NULL) {
+    /* Task is chained into the ready list. */
+    rt_rmv_rdy (p_task);
   }
 }
 
@@ -275,25 +399,8 @@ void rt_rmv_list (P_TCB p_task) {
 /*--------------------------- rt_rmv_dly ------------------------------------*/
 
 void rt_rmv_dly (P_TCB p_task) {
-  /* Remove task identified with "p_task" from delay list if enqueued.      */
-  P_TCB p_b;
-
-  p_b = p_task->p_blnk;
-  if (p_b != NULL) {
-    /* Task is really enqueued */
-    p_b->p_dlnk = p_task->p_dlnk;
-    if (p_task->p_dlnk != NULL) {
-      /* 'p_task' is in the middle of list */
-      p_b->delta_time += p_task->delta_time;
-      p_task->p_dlnk->p_blnk = p_b;
-      p_task->p_dlnk = NULL;
-    }
-    else {
-      /* 'p_task' is at the end of list */
-      p_b->delta_time = 0;
-    }
-    p_task->p_blnk = NULL;
-  }
+  /* Remove task identified with "p_task" from delay wheel if enqueued.     */
+  rt_whl_rmv (&os_dly, rt_tcb2dly(p_task));
 }
 
 
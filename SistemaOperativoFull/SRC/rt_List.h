@@ -40,12 +40,15 @@
 #define SCB             2
 #define MUCB            3
 #define HCB             4
+#define QCB             5
+#define ECB             6
 
 /* Variables */
 extern struct OS_XCB os_rdy;
-extern struct OS_XCB os_dly;
+extern struct OS_WHL os_dly;
 
 /* Functions */
+extern void  rt_init_rdy      (void);
 extern void  rt_put_prio      (P_XCB p_CB, P_TCB p_task);
 extern P_TCB rt_get_first     (P_XCB p_CB);
 extern void  rt_put_rdy_first (P_TCB p_task);
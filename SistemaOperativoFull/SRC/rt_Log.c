@@ -0,0 +1,213 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_LOG.C
+ *      Purpose: Binary log records
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_Log.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      Every record takes LOG_WORDS words of the ring 'os_log_buf'
+ *      (OS_LOGSZ records, a power of 2):
+ *        [0] sequence number + 1, 0 while the record is being written
+ *        [1] time stamp in OS_CLOCK cycles
+ *        [2] message id (bits 0..15), running task id (16..23), number of
+ *            records of the message (24..31, 0 in the continuation records)
+ *        [3..7] arguments
+ *      The text is not formatted on the target: a record holds the id of
+ *      the format string and its arguments, the host decoder formats it.
+ *      A string is copied into the argument words of consecutive records,
+ *      reserved together so that other writers do not split it. Writers
+ *      reserve records like 'rt_trace' does, without locking; the oldest
+ *      records are overwritten when the reader falls behind.
+ *---------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Next record to write and next record to read (free running) */
+static volatile U32 os_log_head;
+static U32 os_log_tail;
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_log_idx ------------------------------------*/
+
+static __inline U32 rt_log_idx (U32 cnt) {
+  /* Reserve "cnt" consecutive records, returns the first sequence number. */
+  U32 idx;
+#if defined (__USE_EXCLUSIVE_ACCESS)
+  do {
+    idx = __ldrex (&os_log_head);
+  } while (__strex (idx + cnt, &os_log_head));
+#elif defined (__RTX_POSIX)
+  idx = __sync_fetch_and_add (&os_log_head, cnt);
+#else
+  U32 irq;
+
+  irq = __disable_irq ();
+  idx = os_log_head;
+  os_log_head = idx + cnt;
+  if (!irq) {
+    __enable_irq ();
+  }
+#endif
+  return (idx);
+}
+
+
+/*--------------------------- rt_log_rec ------------------------------------*/
+
+static __inline volatile U32 *rt_log_rec (U32 idx) {
+  return (&os_log_buf[(idx & (os_log_size - 1)) * LOG_WORDS]);
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_log_init -----------------------------------*/
+
+void rt_log_init (void) {
+  /* Empty the ring and start the time stamp counter. */
+  os_log_head = 0;
+  os_log_tail = 0;
+  if (os_log_size != 0) {
+    rt_stamp_init ();
+  }
+}
+
+
+/*--------------------------- rt_log ----------------------------------------*/
+
+void rt_log (U32 id, U32 *args, U32 cnt) {
+  /* Record message "id" with "cnt" argument words, the rest is zero. */
+  volatile U32 *rec;
+  U32 idx, tid, i;
+
+  if (os_log_size == 0) {
+    return;
+  }
+  idx = rt_log_idx (1);
+  rec = rt_log_rec (idx);
+  tid = (os_tsk.run != NULL) ? os_tsk.run->task_id : 0;
+  rec[0] = 0;
+  rec[1] = rt_stamp_val ();
+  rec[2] = (1 << 24) | (tid << 16) | (U16)id;
+  for (i = 0; i < LOG_ARGS; i++) {
+    rec[3+i] = (i < cnt) ? args[i] : 0;
+  }
+  rec[0] = idx + 1;
+}
+
+
+/*--------------------------- rt_log_str ------------------------------------*/
+
+void rt_log_str (U32 id, const char *str) {
+  /* Record message "id" with a copy of "str", up to LOG_STR_RECS records. */
+  volatile U32 *rec;
+  U32 idx, tid, stamp, len, cnt, n, i, j, k, w;
+
+  if (os_log_size == 0) {
+    return;
+  }
+  for (len = 0; (str[len] != 0) && (len < LOG_STR_RECS * LOG_ARGS * 4); len++);
+  cnt = (len + LOG_ARGS * 4) / (LOG_ARGS * 4);  /* room for the terminator */
+  if (cnt > LOG_STR_RECS) {
+    cnt = LOG_STR_RECS;                          /* truncated              */
+  }
+  idx   = rt_log_idx (cnt);
+  tid   = (os_tsk.run != NULL) ? os_tsk.run->task_id : 0;
+  stamp = rt_stamp_val ();
+  for (n = 0, k = 0; n < cnt; n++) {
+    rec = rt_log_rec (idx + n);
+    rec[0] = 0;
+    rec[1] = stamp;
+    rec[2] = ((n == 0 ? cnt : 0) << 24) | (tid << 16) | (U16)id;
+    for (i = 0; i < LOG_ARGS; i++, k += 4) {
+      /* Little-endian packing, bytes past the end are zero */
+      for (w = 0, j = 4; j != 0; j--) {
+        w = (w << 8) | ((k + j - 1 < len) ? (U8)str[k + j - 1] : 0);
+      }
+      rec[3+i] = w;
+    }
+    rec[0] = idx + n + 1;
+  }
+}
+
+
+/*--------------------------- rt_log_read -----------------------------------*/
+
+U32 rt_log_read (U32 *buf, U32 count) {
+  /* Copy up to "count" records, oldest first, to "buf" and return the     */
+  /* number copied. Records overwritten before they could be read are      */
+  /* skipped; a record still being written ends the copy. Single reader.   */
+  /* A writer reserves its index before it clears the sequence number, so  */
+  /* a record of the previous lap, older than the tail, is still being     */
+  /* written, not lost.                                                    */
+  volatile U32 *rec;
+  U32 head, seq, n, i;
+
+  head = os_log_head;
+  if (head - os_log_tail > os_log_size) {
+    os_log_tail = head - os_log_size;
+  }
+  for (n = 0; (n < count) && (os_log_tail != head); ) {
+    rec = rt_log_rec (os_log_tail);
+    seq = rec[0];
+    if ((seq == 0) || ((S32)(seq - (os_log_tail + 1)) < 0)) {
+      break;
+    }
+    for (i = 0; i < LOG_WORDS; i++) {
+      buf[i] = rec[i];
+    }
+    buf[0] = seq;
+    if ((rec[0] == seq) && (seq == os_log_tail + 1)) {
+      buf += LOG_WORDS;
+      n++;
+    }
+    os_log_tail++;
+  }
+  return (n);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
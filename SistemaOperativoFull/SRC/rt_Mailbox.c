@@ -39,8 +39,32 @@
 #include "rt_Mailbox.h"
 #include "rt_MemBox.h"
 #include "rt_Task.h"
+#include "rt_Trace.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
+/* Batches are arrays of messages: 32-bit message words when "words" is set */
+/* (osMessage), else message pointers (osMail, os_mbx). Both are the same   */
+/* on Cortex-M, the host port has wider pointers.                           */
+#define rt_mbx_elem(buf,i,words)  ((words) ? (void *)((U32 *)(buf))[i] : ((void **)(buf))[i])
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_mbx_preempt --------------------------------*/
+
+static void rt_mbx_preempt (void) {
+  /* Tasks were made ready by a batch: preempt the running task once if one */
+  /* of them has a higher priority.                                         */
+  if (os_rdy.p_lnk && EDF_PREEMPT (os_rdy.p_lnk, os_tsk.run)) {
+    rt_put_prio (&os_rdy, os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
 
 /*----------------------------------------------------------------------------
  *      Functions
@@ -82,6 +106,7 @@ OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U16 timeout) {
     rt_ret_val (p_TCB, OS_R_MBX);
 #endif
     rt_rmv_dly (p_TCB);
+    TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_MCB);
     rt_dispatch (p_TCB);
   }
   else {
@@ -104,6 +129,7 @@ OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U16 timeout) {
         p_MCB->state = 2;
       }
       os_tsk.run->msg = p_msg;
+      TRC_EVENT(TRC_MBX_BLOCK, timeout, p_MCB);
       rt_block (timeout, WAIT_MBX);
       return (OS_R_TMO);
     }
@@ -145,6 +171,7 @@ OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U16 timeout) {
         p_MCB->first = 0;
       }
       rt_rmv_dly (p_TCB);
+      TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_MCB);
       rt_dispatch (p_TCB);
     }
     else {
@@ -166,6 +193,7 @@ OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U16 timeout) {
     /* Task is waiting to receive a message */      
     p_MCB->state = 1;
   }
+  TRC_EVENT(TRC_MBX_BLOCK, timeout, p_MCB);
   rt_block(timeout, WAIT_MBX);
 #ifndef __CMSIS_RTOS
   os_tsk.run->msg = message;
@@ -174,6 +202,103 @@ OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U16 timeout) {
 }
 
 
+/*--------------------------- rt_mbx_send_n ---------------------------------*/
+
+U32 rt_mbx_send_n (OS_ID mailbox, void *buf, U32 cnt, U32 words) {
+  /* Send up to "cnt" messages of the array "buf" without waiting. Returns  */
+  /* the number of messages sent. Waiting tasks get their message first,    */
+  /* the running task is preempted once for the whole batch.                */
+  P_MCB p_MCB = mailbox;
+  P_TCB p_TCB;
+  U32   i = 0;
+  U32   n, idx;
+
+  while ((i < cnt) && (p_MCB->p_lnk != NULL) && (p_MCB->state == 1)) {
+    /* A task is waiting for message */
+    p_TCB = rt_get_first ((P_XCB)p_MCB);
+#ifdef __CMSIS_RTOS
+    rt_ret_val2(p_TCB, 0x10/*osEventMessage*/, (U32)rt_mbx_elem(buf, i, words));
+#else
+    *p_TCB->msg = rt_mbx_elem(buf, i, words);
+    rt_ret_val (p_TCB, OS_R_MBX);
+#endif
+    rt_rmv_dly (p_TCB);
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+    TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_MCB);
+    i++;
+  }
+  /* Store the rest in the free entries of the mailbox */
+  n = p_MCB->size - p_MCB->count;
+  if (n > cnt - i) {
+    n = cnt - i;
+  }
+  idx = p_MCB->first;
+  for (cnt = n; cnt; cnt--) {
+    p_MCB->msg[idx] = rt_mbx_elem(buf, i, words);
+    if (++idx == p_MCB->size) {
+      idx = 0;
+    }
+    i++;
+  }
+  p_MCB->first = idx;
+  rt_add16 (&p_MCB->count, n);
+  rt_mbx_preempt ();
+  return (i);
+}
+
+
+/*--------------------------- rt_mbx_wait_n ---------------------------------*/
+
+U32 rt_mbx_wait_n (OS_ID mailbox, void *buf, U32 cnt, U32 words) {
+  /* Receive up to "cnt" messages to the array "buf" without waiting.       */
+  /* Returns the number of messages received. Tasks waiting to send fill   */
+  /* the freed entries, the running task is preempted once for the batch.  */
+  P_MCB p_MCB = mailbox;
+  P_TCB p_TCB;
+  U32   i, n, idx;
+
+  n = p_MCB->count;
+  if (n > cnt) {
+    n = cnt;
+  }
+  idx = p_MCB->last;
+  for (i = 0; i < n; i++) {
+    if (words) {
+      ((U32 *)buf)[i] = (U32)p_MCB->msg[idx];
+    }
+    else {
+      ((void **)buf)[i] = p_MCB->msg[idx];
+    }
+    if (++idx == p_MCB->size) {
+      idx = 0;
+    }
+  }
+  p_MCB->last = idx;
+  for (i = n; i && (p_MCB->p_lnk != NULL) && (p_MCB->state == 2); i--) {
+    /* A task is waiting to send message */
+    p_TCB = rt_get_first ((P_XCB)p_MCB);
+#ifdef __CMSIS_RTOS
+    rt_ret_val(p_TCB, 0/*osOK*/);
+#else
+    rt_ret_val(p_TCB, OS_R_OK);
+#endif
+    p_MCB->msg[p_MCB->first] = p_TCB->msg;
+    if (++p_MCB->first == p_MCB->size) {
+      p_MCB->first = 0;
+    }
+    rt_rmv_dly (p_TCB);
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+    TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_MCB);
+  }
+  /* Entries not refilled by waiting tasks are free now */
+  rt_add16 (&p_MCB->count, 0 - i);
+  rt_mbx_preempt ();
+  return (n);
+}
+
+
 /*--------------------------- rt_mbx_check ----------------------------------*/
 
 OS_RESULT rt_mbx_check (OS_ID mailbox) {
@@ -239,6 +364,7 @@ void rt_mbx_psh (P_MCB p_CB, void *p_msg) {
       p_TCB->state = READY;
       rt_rmv_dly (p_TCB);
       rt_put_prio (&os_rdy, p_TCB);
+      TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_CB);
       break;
 #endif
     case 2:
@@ -257,6 +383,7 @@ void rt_mbx_psh (P_MCB p_CB, void *p_msg) {
       p_TCB->state = READY;
       rt_rmv_dly (p_TCB);
       rt_put_prio (&os_rdy, p_TCB);
+      TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_CB);
       break;
     case 1:
       /* Task is waiting for a message, pass the message to the task directly */
@@ -270,6 +397,7 @@ void rt_mbx_psh (P_MCB p_CB, void *p_msg) {
       p_TCB->state = READY;
       rt_rmv_dly (p_TCB);
       rt_put_prio (&os_rdy, p_TCB);
+      TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_CB);
       break;
   } else {
     /* No task is waiting for a message, store it to the mailbox queue */
@@ -59,8 +59,8 @@ int _init_box  (void *box_mem, U32 box_size, U32 blk_size) {
     sizeof_bm = (sizeof (struct OS_BM) + 7) & ~7;
   }
   else {
-    /* Memory blocks 4-byte aligned. */
-    blk_size = (blk_size + 3) & ~3;
+    /* Memory blocks 4-byte aligned, at least pointer aligned for the link. */
+    blk_size = (blk_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
     sizeof_bm = sizeof (struct OS_BM);
   }
   if (blk_size == 0) {
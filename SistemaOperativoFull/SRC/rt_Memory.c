@@ -32,27 +32,155 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *---------------------------------------------------------------------------*/
 
+#include <stddef.h>
 #include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_HAL_CM.h"
 #include "rt_Memory.h"
 
+/* Two-level segregated fit: the free blocks are kept in lists by size, the  */
+/* first level splits the sizes by powers of 2, the second level splits each */
+/* power of 2 in MEM_SL_CNT lists. Two bitmaps mark the non-empty lists, so   */
+/* allocation finds a fitting block with two bit scans, and freed blocks are  */
+/* merged with their free neighbours in memory at once. The control block is */
+/* at the pool start and has as many first level classes as the pool needs.  */
 
-/* Functions */
+/* Block at offset 'off' of the pool, offsets and sizes are in MEM_UNIT     */
+#define mem_blk(ctrl,off)   ((MEMP *)((U8 *)(ctrl) + (U32)(off) * MEM_UNIT))
+
+/* Second level bitmaps, after the list heads */
+#define mem_sl_map(ctrl)    ((U8 *)&(ctrl)->head[(ctrl)->fl_cnt * MEM_SL_CNT])
+
+/* Offset of the first block: size of the control block */
+#define mem_first(fl_cnt)   ((offsetof(MEMCTRL, head) + (fl_cnt) * \
+                             (2*MEM_SL_CNT + 1) + MEM_UNIT - 1) / MEM_UNIT)
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_mem_map ------------------------------------*/
+
+static void rt_mem_map (U32 size, U32 *fl, U32 *sl) {
+  /* Return the first and second level class of a block of "size" units.   */
+  U32 m;
+
+  if (size < MEM_SL_CNT) {
+    /* Small blocks: one list per size */
+    *fl = 0;
+    *sl = size;
+  }
+  else {
+    m   = rt_msb (size);
+    *fl = m - (MEM_SL_LOG2 - 1);
+    *sl = (size >> (m - MEM_SL_LOG2)) & (MEM_SL_CNT - 1);
+  }
+}
+
+
+/*--------------------------- rt_mem_link -----------------------------------*/
+
+static void rt_mem_link (MEMCTRL *ctrl, U32 off) {
+  /* Put the block at "off" in front of the free list of its class.         */
+  MEMP *p = mem_blk (ctrl, off);
+  U32   fl, sl, idx;
+
+  rt_mem_map (p->size, &fl, &sl);
+  idx = fl * MEM_SL_CNT + sl;
+  p->next = ctrl->head[idx];
+  p->back = 0;
+  if (p->next != 0) {
+    mem_blk (ctrl, p->next)->back = off;
+  }
+  ctrl->head[idx] = off;
+  ctrl->fl_map |= 1 << fl;
+  mem_sl_map (ctrl)[fl] |= 1 << sl;
+  ctrl->frees++;
+}
+
+
+/*--------------------------- rt_mem_unlink ---------------------------------*/
+
+static void rt_mem_unlink (MEMCTRL *ctrl, U32 off) {
+  /* Remove the block at "off" from the free list of its class.             */
+  MEMP *p = mem_blk (ctrl, off);
+  U32   fl, sl, idx;
+
+  rt_mem_map (p->size, &fl, &sl);
+  idx = fl * MEM_SL_CNT + sl;
+  if (p->back != 0) {
+    mem_blk (ctrl, p->back)->next = p->next;
+  }
+  else {
+    ctrl->head[idx] = p->next;
+  }
+  if (p->next != 0) {
+    mem_blk (ctrl, p->next)->back = p->back;
+  }
+  if (ctrl->head[idx] == 0) {
+    mem_sl_map (ctrl)[fl] &= ~(1 << sl);
+    if (mem_sl_map (ctrl)[fl] == 0) {
+      ctrl->fl_map &= ~(1 << fl);
+    }
+  }
+  ctrl->frees--;
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
 
 // Initialize Dynamic Memory pool
 //   Parameters:
-//     pool:    Pointer to memory pool
-//     size:    Size of memory pool in bytes
+//     pool:    Pointer to memory pool (8-byte aligned)
+//     size:    Size of memory pool in bytes (up to 512 KB are used)
 //   Return:    0 - OK, 1 - Error
 
 int rt_init_mem (void *pool, U32 size) {
-  MEMP *ptr;
+  MEMCTRL *ctrl = (MEMCTRL *)pool;
+  MEMP    *p;
+  U32      units, first, fl, sl, i;
 
-  if ((pool == NULL) || (size < sizeof(MEMP))) return (1);
+  if ((pool == NULL) || ((U32)pool & (MEM_UNIT - 1))) return (1);
 
-  ptr = (MEMP *)pool;
-  ptr->next = (MEMP *)((U32)pool + size - sizeof(MEMP *));
-  ptr->next->next = NULL;
-  ptr->len = 0; 
+  units = size / MEM_UNIT;
+  if (units > MEM_USED) {
+    /* Offsets are 16-bit, MEM_USED is no valid offset */
+    units = MEM_USED;
+  }
+  if (units < MEM_SL_CNT) return (1);
+
+  /* The largest block is smaller than the pool: it sets the class count */
+  rt_mem_map (units, &fl, &sl);
+  first = mem_first (fl + 1);
+  if (first + 3 > units) return (1);
+
+  ctrl->fl_cnt = fl + 1;
+  for (i = 0; i < ctrl->fl_cnt * MEM_SL_CNT; i++) {
+    ctrl->head[i] = 0;
+  }
+  for (i = 0; i < ctrl->fl_cnt; i++) {
+    mem_sl_map (ctrl)[i] = 0;
+  }
+  ctrl->fl_map   = 0;
+  ctrl->size     = (units - first - 1) * MEM_UNIT;
+  ctrl->used     = 0;
+  ctrl->max_used = 0;
+  ctrl->blocks   = 0;
+  ctrl->frees    = 0;
+
+  /* One free block and the allocated end block, which stops merging */
+  p = mem_blk (ctrl, first);
+  p->prev = 0;
+  p->size = units - first - 1;
+  p = mem_blk (ctrl, units - 1);
+  p->prev = first;
+  p->size = 0;
+  p->next = MEM_USED;
+  p->back = 0;
+  rt_mem_link (ctrl, first);
 
   return (0);
 }
@@ -61,46 +189,71 @@ int rt_init_mem (void *pool, U32 size) {
 //   Parameters:
 //     pool:    Pointer to memory pool
 //     size:    Size of memory in bytes to allocate
-//   Return:    Pointer to allocated memory
+//   Return:    Pointer to allocated memory (8-byte aligned)
 
 void *rt_alloc_mem (void *pool, U32 size) {
-  MEMP *p, *p_search, *p_new;
-  U32   hole_size;
-
-  if ((pool == NULL) || (size == 0)) return NULL;
-
-  /* Add header offset to 'size' */
-  size += sizeof(MEMP);
-  /* Make sure that block is 4-byte aligned  */
-  size = (size + 3) & ~3;
-
-  p_search = (MEMP *)pool;
-  while (1) {
-    hole_size  = (U32)p_search->next - (U32)p_search;
-    hole_size -= p_search->len;
-    /* Check if hole size is big enough */
-    if (hole_size >= size) break;
-    p_search = p_search->next;
-    if (p_search->next == NULL) {
-      /* Failed, we are at the end of the list */
-      return NULL;
+  MEMCTRL *ctrl = (MEMCTRL *)pool;
+  MEMP    *p, *p_rest;
+  U32      units, fl, sl, map, off, rest;
+
+  if ((pool == NULL) || (size == 0) || (size > ctrl->size)) return NULL;
+
+  /* Add header to 'size' */
+  units = (size + MEM_UNIT - 1) / MEM_UNIT + 1;
+
+  /* Search from the first list whose blocks are all large enough */
+  if (units < MEM_SL_CNT) {
+    rt_mem_map (units, &fl, &sl);
+  }
+  else {
+    rt_mem_map (units + (1 << (rt_msb (units) - MEM_SL_LOG2)) - 1, &fl, &sl);
+  }
+  off = 0;
+  if (fl < ctrl->fl_cnt) {
+    map = mem_sl_map (ctrl)[fl] & (~0U << sl);
+    if (map == 0) {
+      map = ctrl->fl_map & (~0U << (fl + 1));
+      if (map != 0) {
+        fl  = rt_lsb (map);
+        map = mem_sl_map (ctrl)[fl];
+      }
+    }
+    if (map != 0) {
+      off = ctrl->head[fl * MEM_SL_CNT + rt_lsb (map)];
+    }
+  }
+  if (off == 0) {
+    /* Nearly exhausted: a block in the list of 'units' itself may fit */
+    rt_mem_map (units, &fl, &sl);
+    if (fl >= ctrl->fl_cnt) return NULL;
+    off = ctrl->head[fl * MEM_SL_CNT + sl];
+    while ((off != 0) && (mem_blk (ctrl, off)->size < units)) {
+      off = mem_blk (ctrl, off)->next;
     }
+    if (off == 0) return NULL;
+  }
+
+  rt_mem_unlink (ctrl, off);
+  p    = mem_blk (ctrl, off);
+  rest = p->size - units;
+  if (rest >= 2) {
+    /* Split, the rest takes a header and at least one unit */
+    p->size = units;
+    p_rest  = mem_blk (ctrl, off + units);
+    p_rest->prev = off;
+    p_rest->size = rest;
+    mem_blk (ctrl, off + p->size + rest)->prev = off + units;
+    rt_mem_link (ctrl, off + units);
   }
+  p->next = MEM_USED;
 
-  if (p_search->len == 0) {
-    /* No block is allocated, set the Length of the first element */
-    p_search->len = size;
-    p = (MEMP *)(((U32)p_search) + sizeof(MEMP));
-  } else {
-    /* Insert new list element into the memory list */
-    p_new       = (MEMP *)((U32)p_search + p_search->len);
-    p_new->next = p_search->next;
-    p_new->len  = size;
-    p_search->next = p_new;
-    p = (MEMP *)(((U32)p_new) + sizeof(MEMP));
+  ctrl->used += p->size * MEM_UNIT;
+  if (ctrl->used > ctrl->max_used) {
+    ctrl->max_used = ctrl->used;
   }
+  ctrl->blocks++;
 
-  return (p);
+  return ((U8 *)p + sizeof(MEMP));
 }
 
 // Free Memory and return it to Memory pool
@@ -110,31 +263,81 @@ void *rt_alloc_mem (void *pool, U32 size) {
 //   Return:    0 - OK, 1 - Error
 
 int rt_free_mem (void *pool, void *mem) {
-  MEMP *p_search, *p_prev, *p_return;
+  MEMCTRL *ctrl = (MEMCTRL *)pool;
+  MEMP    *p, *p_next;
+  U32      off, first;
 
   if ((pool == NULL) || (mem == NULL)) return (1);
 
-  p_return = (MEMP *)((U32)mem - sizeof(MEMP));
-  
-  /* Set list header */
-  p_prev = NULL;
-  p_search = (MEMP *)pool;
-  while (p_search != p_return) {
-    p_prev   = p_search;
-    p_search = p_search->next;
-    if (p_search == NULL) {
-      /* Valid Memory block not found */
-      return (1);
-    }
+  /* Check that 'mem' is an allocated block of this pool */
+  first = mem_first (ctrl->fl_cnt);
+  if (((U8 *)mem < (U8 *)mem_blk (ctrl, first + 1)) ||
+      ((U8 *)mem > (U8 *)mem_blk (ctrl, first + ctrl->size / MEM_UNIT))) {
+    return (1);
   }
+  off = (U32)((U8 *)mem - (U8 *)pool);
+  if (off & (MEM_UNIT - 1)) return (1);
+  off = off / MEM_UNIT - 1;
+  p   = mem_blk (ctrl, off);
+  if ((p->next != MEM_USED) || (p->size == 0) ||
+      (off + p->size > first + ctrl->size / MEM_UNIT) ||
+      (mem_blk (ctrl, off + p->size)->prev != off)) {
+    /* Valid Memory block not found */
+    return (1);
+  }
+
+  ctrl->used -= p->size * MEM_UNIT;
+  ctrl->blocks--;
+
+  /* Merge with the free neighbours */
+  p_next = mem_blk (ctrl, off + p->size);
+  if (p_next->next != MEM_USED) {
+    rt_mem_unlink (ctrl, off + p->size);
+    p->size += p_next->size;
+  }
+  if ((p->prev != 0) && (mem_blk (ctrl, p->prev)->next != MEM_USED)) {
+    rt_mem_unlink (ctrl, p->prev);
+    mem_blk (ctrl, p->prev)->size += p->size;
+    off = p->prev;
+    p   = mem_blk (ctrl, off);
+  }
+  mem_blk (ctrl, off + p->size)->prev = off;
+  rt_mem_link (ctrl, off);
+
+  return (0);
+}
 
-  if (p_prev == NULL) {
-    /* First block to be released, only set length to 0 */
-    p_search->len = 0;
-  } else {
-    /* Discard block from chain list */
-    p_prev->next = p_search->next;
+// Get Memory pool statistics
+//   Parameters:
+//     pool:    Pointer to memory pool
+//     info:    Pointer to the statistics to fill
+//   Return:    0 - OK, 1 - Error
+
+int rt_info_mem (void *pool, MEMINFO *info) {
+  MEMCTRL *ctrl = (MEMCTRL *)pool;
+  U32      fl, off, max;
+
+  if ((pool == NULL) || (info == NULL)) return (1);
+
+  info->size     = ctrl->size;
+  info->used     = ctrl->used;
+  info->max_used = ctrl->max_used;
+  info->blocks   = ctrl->blocks;
+  info->frees    = ctrl->frees;
+
+  /* The largest free block is in the highest non-empty list */
+  max = 0;
+  if (ctrl->fl_map != 0) {
+    fl  = rt_msb (ctrl->fl_map);
+    off = ctrl->head[fl * MEM_SL_CNT + rt_msb (mem_sl_map (ctrl)[fl])];
+    while (off != 0) {
+      if (mem_blk (ctrl, off)->size > max) {
+        max = mem_blk (ctrl, off)->size;
+      }
+      off = mem_blk (ctrl, off)->next;
+    }
   }
+  info->max_free = (max != 0) ? (max - 1) * MEM_UNIT : 0;
 
   return (0);
 }
@@ -32,13 +32,43 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *---------------------------------------------------------------------------*/
 
+/* Definitions */
+#define MEM_UNIT      8           /* Allocation unit and alignment [bytes]   */
+#define MEM_SL_LOG2   3           /* 8 second level lists per power of 2     */
+#define MEM_SL_CNT    (1 << MEM_SL_LOG2)
+#define MEM_USED      0xFFFF      /* 'next' of an allocated block            */
+
 /* Types */
-typedef struct mem {              /* << Memory Pool management struct >>     */
-  struct mem *next;               /* Next Memory Block in the list           */
-  U32         len;                /* Length of data block                    */
-} MEMP;
+typedef struct mem {              /* << Memory Pool block header >>          */
+  U16   prev;                     /* Previous block in memory, 0: none       */
+  U16   size;                     /* Block size with header                  */
+  U16   next;                     /* Next free block in the list, MEM_USED   */
+  U16   back;                     /* Previous free block in the list         */
+} MEMP;                           /* All fields in MEM_UNIT from pool start  */
+
+typedef struct mem_ctrl {         /* << Memory Pool control block >>         */
+  U32   size;                     /* Bytes for blocks (pool less control)    */
+  U32   used;                     /* Allocated bytes with block headers      */
+  U32   max_used;                 /* Maximum of 'used' since init            */
+  U16   blocks;                   /* Allocated blocks                        */
+  U16   frees;                    /* Free blocks                             */
+  U16   fl_map;                   /* First level: non-empty 'sl_map' entries */
+  U8    fl_cnt;                   /* Number of first level classes           */
+  U8    reserved;
+  U16   head[1];                  /* [fl_cnt][MEM_SL_CNT] free list heads,   */
+} MEMCTRL;                        /* followed by U8 sl_map[fl_cnt]           */
+
+typedef struct mem_info {         /* << Memory Pool statistics >>            */
+  U32   size;                     /* Bytes for blocks (pool less control)    */
+  U32   used;                     /* Allocated bytes with block headers      */
+  U32   max_used;                 /* Maximum of 'used' since init            */
+  U32   max_free;                 /* Largest size rt_alloc_mem can return    */
+  U16   blocks;                   /* Allocated blocks                        */
+  U16   frees;                    /* Free blocks                             */
+} MEMINFO;
 
 /* Functions */
 extern int   rt_init_mem  (void *pool, U32  size);
 extern void *rt_alloc_mem (void *pool, U32  size);
 extern int   rt_free_mem  (void *pool, void *mem);
+extern int   rt_info_mem  (void *pool, MEMINFO *info);
@@ -37,6 +37,8 @@
 #include "rt_List.h"
 #include "rt_Task.h"
 #include "rt_Mutex.h"
+#include "rt_Trace.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
 
@@ -84,7 +86,7 @@ OS_RESULT rt_mut_delete (OS_ID mutex) {
     rt_put_prio (&os_rdy, p_TCB);
   }
 
-  if (os_rdy.p_lnk && (os_rdy.p_lnk->prio > os_tsk.run->prio)) {
+  if (os_rdy.p_lnk && EDF_PREEMPT (os_rdy.p_lnk, os_tsk.run)) {
     /* preempt running task */
     rt_put_prio (&os_rdy, os_tsk.run);
     os_tsk.run->state = READY;
@@ -127,6 +129,7 @@ OS_RESULT rt_mut_release (OS_ID mutex) {
     p_MCB->level     = 1;
     p_MCB->owner     = p_TCB;
     p_MCB->prio      = p_TCB->prio;
+    TRC_EVENT(TRC_MUT_WAKE, p_TCB->task_id, p_MCB);
     /* Priority inversion, check which task continues. */
     if (os_tsk.run->prio >= rt_rdy_prio()) {
       rt_dispatch (p_TCB);
@@ -186,6 +189,7 @@ inc:p_MCB->level++;
     os_tsk.run->p_lnk  = NULL;
     os_tsk.run->p_rlnk = (P_TCB)p_MCB;
   }
+  TRC_EVENT(TRC_MUT_BLOCK, timeout, p_MCB);
   rt_block(timeout, WAIT_MUT);
   return (OS_R_TMO);
 }
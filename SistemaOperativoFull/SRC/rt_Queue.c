@@ -0,0 +1,284 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_QUEUE.C
+ *      Purpose: Implements queues of inline payloads
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_List.h"
+#include "rt_Queue.h"
+#include "rt_Task.h"
+#include "rt_Trace.h"
+#include "rt_Edf.h"
+#include "rt_HAL_CM.h"
+
+/* A queue stores copies of fixed-size payloads in a ring of slots. Tasks  */
+/* and ISRs both write the ring, so every access to it runs with the       */
+/* interrupts disabled; that is the copy of one payload and a few list     */
+/* operations. ISRs never touch the wait list: a put with tasks waiting to */
+/* get leaves one post service request per queue, the waiting tasks get    */
+/* their payloads in rt_queue_psh.                                         */
+
+/* Slot 'idx' of the ring */
+#define rt_queue_slot(p_QCB,idx)  (&(p_QCB)->data[(U32)(idx) * (p_QCB)->words])
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_queue_copy ---------------------------------*/
+
+static __inline void rt_queue_copy (U32 *dst, const U32 *src, U32 words) {
+  /* Copy a payload word by word. */
+  while (words--) {
+    *dst++ = *src++;
+  }
+}
+
+
+/*--------------------------- rt_queue_wake ---------------------------------*/
+
+static void rt_queue_wake (P_QCB p_QCB, P_TCB p_TCB) {
+  /* Make the task "p_TCB" taken from the wait list ready, returning osOK. */
+  rt_ret_val (p_TCB, OS_R_OK);
+  p_TCB->state = READY;
+  rt_rmv_dly (p_TCB);
+  rt_put_prio (&os_rdy, p_TCB);
+  TRC_EVENT(TRC_MBX_WAKE, p_TCB->task_id, p_QCB);
+}
+
+
+/*--------------------------- rt_queue_feed ---------------------------------*/
+
+static U32 rt_queue_feed (P_QCB p_QCB) {
+  /* Pass stored payloads to tasks waiting to get and payloads of tasks    */
+  /* waiting to put to free slots. Returns the number of tasks made ready. */
+  P_TCB p_TCB;
+  U32   n = 0;
+
+  while (p_QCB->p_lnk != NULL) {
+    if ((p_QCB->state == 1) && (p_QCB->count != 0)) {
+      p_TCB = rt_get_first ((P_XCB)p_QCB);
+      rt_queue_copy ((U32 *)p_TCB->msg, rt_queue_slot (p_QCB, p_QCB->last), p_QCB->words);
+      if (++p_QCB->last == p_QCB->size) {
+        p_QCB->last = 0;
+      }
+      p_QCB->count--;
+    }
+    else if ((p_QCB->state == 2) && (p_QCB->count != p_QCB->size)) {
+      p_TCB = rt_get_first ((P_XCB)p_QCB);
+      rt_queue_copy (rt_queue_slot (p_QCB, p_QCB->first), (U32 *)p_TCB->msg, p_QCB->words);
+      if (++p_QCB->first == p_QCB->size) {
+        p_QCB->first = 0;
+      }
+      p_QCB->count++;
+    }
+    else {
+      break;
+    }
+    rt_queue_wake (p_QCB, p_TCB);
+    n++;
+  }
+  return (n);
+}
+
+
+/*--------------------------- rt_queue_wait ---------------------------------*/
+
+static void rt_queue_wait (P_QCB p_QCB, void *data, U8 state) {
+  /* Chain the running task to the wait list, "state" 1: get, 2: put.      */
+  if (p_QCB->p_lnk != NULL) {
+    rt_put_prio ((P_XCB)p_QCB, os_tsk.run);
+  }
+  else {
+    p_QCB->p_lnk = os_tsk.run;
+    os_tsk.run->p_lnk  = NULL;
+    os_tsk.run->p_rlnk = (P_TCB)p_QCB;
+    p_QCB->state = state;
+  }
+  os_tsk.run->msg = data;
+}
+
+
+/*--------------------------- rt_queue_sched --------------------------------*/
+
+static void rt_queue_sched (void) {
+  /* Tasks were made ready by a service call: preempt the running task if */
+  /* one of them has a higher priority.                                   */
+  if (os_rdy.p_lnk && EDF_PREEMPT (os_rdy.p_lnk, os_tsk.run)) {
+    rt_put_prio (&os_rdy, os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_queue_init ---------------------------------*/
+
+void rt_queue_init (P_QCB p_QCB, U32 size, U32 item_sz) {
+  /* Initialize a queue of "size" slots for payloads of "item_sz" bytes. */
+  p_QCB->cb_type = QCB;
+  p_QCB->state   = 0;
+  p_QCB->isr_st  = 0;
+  p_QCB->words   = (item_sz + 3) >> 2;
+  p_QCB->p_lnk   = NULL;
+  p_QCB->first   = 0;
+  p_QCB->last    = 0;
+  p_QCB->count   = 0;
+  p_QCB->size    = size;
+}
+
+
+/*--------------------------- rt_queue_put ----------------------------------*/
+
+OS_RESULT rt_queue_put (P_QCB p_QCB, const U32 *data, U16 timeout) {
+  /* Copy a payload to the queue; possibly wait for a free slot. */
+  U32 n;
+  int irq_dis;
+
+  irq_dis = __disable_irq ();
+  /* Payloads stored by ISRs go first to tasks waiting to get */
+  n = rt_queue_feed (p_QCB);
+  if (p_QCB->count == p_QCB->size) {
+    /* Full: no task waits to get, the wait list takes tasks to put */
+    if (timeout != 0) {
+      rt_queue_wait (p_QCB, (void *)data, 2);
+      if (!irq_dis) __enable_irq ();
+      TRC_EVENT(TRC_MBX_BLOCK, timeout, p_QCB);
+      /* Tasks made ready by the feed above run when this one blocks */
+      rt_block (timeout, WAIT_MBX);
+      return (OS_R_TMO);
+    }
+    if (!irq_dis) __enable_irq ();
+    if (n != 0) {
+      rt_queue_sched ();
+    }
+    return (OS_R_TMO);
+  }
+  rt_queue_copy (rt_queue_slot (p_QCB, p_QCB->first), data, p_QCB->words);
+  if (++p_QCB->first == p_QCB->size) {
+    p_QCB->first = 0;
+  }
+  p_QCB->count++;
+  n += rt_queue_feed (p_QCB);
+  if (!irq_dis) __enable_irq ();
+  if (n != 0) {
+    rt_queue_sched ();
+  }
+  return (OS_R_OK);
+}
+
+
+/*--------------------------- rt_queue_get ----------------------------------*/
+
+OS_RESULT rt_queue_get (P_QCB p_QCB, U32 *data, U16 timeout) {
+  /* Copy the oldest payload from the queue; possibly wait for one. */
+  U32 n;
+  int irq_dis;
+
+  irq_dis = __disable_irq ();
+  if (p_QCB->count == 0) {
+    /* Empty: no task waits to put, the wait list takes tasks to get */
+    if (timeout != 0) {
+      rt_queue_wait (p_QCB, data, 1);
+    }
+    if (!irq_dis) __enable_irq ();
+    if (timeout != 0) {
+      TRC_EVENT(TRC_MBX_BLOCK, timeout, p_QCB);
+      rt_block (timeout, WAIT_MBX);
+    }
+    return (OS_R_TMO);
+  }
+  rt_queue_copy (data, rt_queue_slot (p_QCB, p_QCB->last), p_QCB->words);
+  if (++p_QCB->last == p_QCB->size) {
+    p_QCB->last = 0;
+  }
+  p_QCB->count--;
+  /* The free slot takes the payload of a task waiting to put */
+  n = rt_queue_feed (p_QCB);
+  if (!irq_dis) __enable_irq ();
+  if (n != 0) {
+    rt_queue_sched ();
+  }
+  return (OS_R_OK);
+}
+
+
+/*--------------------------- isr_queue_put ---------------------------------*/
+
+OS_RESULT isr_queue_put (P_QCB p_QCB, const U32 *data) {
+  /* Same function as "rt_queue_put", but to be called by ISRs: no wait,  */
+  /* returns OS_R_TMO when the queue is full.                             */
+  int irq_dis;
+
+  irq_dis = __disable_irq ();
+  if (p_QCB->count == p_QCB->size) {
+    if (!irq_dis) __enable_irq ();
+    return (OS_R_TMO);
+  }
+  rt_queue_copy (rt_queue_slot (p_QCB, p_QCB->first), data, p_QCB->words);
+  if (++p_QCB->first == p_QCB->size) {
+    p_QCB->first = 0;
+  }
+  p_QCB->count++;
+  if ((p_QCB->p_lnk != NULL) && (p_QCB->state == 1) && (p_QCB->isr_st == 0)) {
+    /* Tasks wait to get: one request passes all payloads stored until then */
+    p_QCB->isr_st = 1;
+    rt_psq_enq (p_QCB, 0);
+    rt_psh_req ();
+  }
+  if (!irq_dis) __enable_irq ();
+  return (OS_R_OK);
+}
+
+
+/*--------------------------- rt_queue_psh ----------------------------------*/
+
+void rt_queue_psh (P_QCB p_QCB) {
+  /* Pass the payloads stored by ISRs to the tasks waiting to get. */
+  int irq_dis;
+
+  irq_dis = __disable_irq ();
+  p_QCB->isr_st = 0;
+  rt_queue_feed (p_QCB);
+  if (!irq_dis) __enable_irq ();
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
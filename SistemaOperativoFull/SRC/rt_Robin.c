@@ -46,6 +46,9 @@
 
 struct OS_ROBIN os_robin;
 
+/* Time slice of every priority level [ticks], 0= os_robin.tout           */
+U16 os_robin_slice[ROBIN_LEVELS];
+
 
 /*----------------------------------------------------------------------------
  *      Global Functions
@@ -55,20 +58,47 @@ struct OS_ROBIN os_robin;
 
 __weak void rt_init_robin (void) {
   /* Initialize Round Robin variables. */
+  U32 i;
+
   os_robin.task = NULL;
   os_robin.tout = (U16)os_rrobin;
+  for (i = 0; i < ROBIN_LEVELS; i++) {
+    os_robin_slice[i] = 0;
+  }
+}
+
+/*--------------------------- rt_robin_slice --------------------------------*/
+
+U32 rt_robin_slice (P_TCB p_task) {
+  /* Time slice of a task: its own, else the one of its priority level,     */
+  /* else the Round Robin timeout of the configuration.                     */
+  if (p_task->rr_slice != 0) {
+    return (p_task->rr_slice);
+  }
+  if ((p_task->prio < ROBIN_LEVELS) && (os_robin_slice[p_task->prio] != 0)) {
+    return (os_robin_slice[p_task->prio]);
+  }
+  return (os_robin.tout);
 }
 
 /*--------------------------- rt_chk_robin ----------------------------------*/
 
 __weak void rt_chk_robin (void) {
   /* Check if Round Robin timeout expired and switch to the next ready task.*/
-  P_TCB p_new;
+  /* The running task is at the head of the ready list; its slice runs only */
+  /* while another ready task shares its priority level.                    */
+  P_TCB p_run, p_new;
 
-  if (os_robin.task != os_rdy.p_lnk) {
+  p_run = os_rdy.p_lnk;
+  if ((p_run->p_lnk == NULL) || (p_run->p_lnk->prio != p_run->prio)) {
+    /* Alone on its level: no time slice. */
+    os_robin.task = NULL;
+    return;
+  }
+  if (os_robin.task != p_run) {
     /* New task was suspended, reset Round Robin timeout. */
-    os_robin.task = os_rdy.p_lnk;
-    os_robin.time = (U16)os_time + os_robin.tout - 1;
+    os_robin.task = p_run;
+    os_robin.time = (U16)os_time + rt_robin_slice (p_run) - 1;
   }
   if (os_robin.time == (U16)os_time) {
     /* Round Robin timeout has expired, swap Robin tasks. */
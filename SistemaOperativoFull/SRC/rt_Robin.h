@@ -32,12 +32,17 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *---------------------------------------------------------------------------*/
 
+/* Definitions */
+#define ROBIN_LEVELS    8               /* Priority levels with own slices   */
+
 /* Variables */
 extern struct OS_ROBIN os_robin;
+extern U16 os_robin_slice[];
 
 /* Functions */
-extern void rt_init_robin (void);
-extern void rt_chk_robin  (void);
+extern void rt_init_robin  (void);
+extern U32  rt_robin_slice (P_TCB p_task);
+extern void rt_chk_robin   (void);
 
 /*----------------------------------------------------------------------------
  * end of file
@@ -38,6 +38,8 @@
 #include "rt_List.h"
 #include "rt_Task.h"
 #include "rt_Semaphore.h"
+#include "rt_Trace.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
 
@@ -55,6 +57,7 @@ void rt_sem_init (OS_ID semaphore, U16 token_count) {
   p_SCB->cb_type = SCB;
   p_SCB->p_lnk  = NULL;
   p_SCB->tokens = token_count;
+  p_SCB->psh_tokens = 0;
 }
 
 
@@ -75,7 +78,7 @@ OS_RESULT rt_sem_delete (OS_ID semaphore) {
     rt_put_prio (&os_rdy, p_TCB);
   }
 
-  if (os_rdy.p_lnk && (os_rdy.p_lnk->prio > os_tsk.run->prio)) {
+  if (os_rdy.p_lnk && EDF_PREEMPT (os_rdy.p_lnk, os_tsk.run)) {
     /* preempt running task */
     rt_put_prio (&os_rdy, os_tsk.run);
     os_tsk.run->state = READY;
@@ -105,6 +108,7 @@ OS_RESULT rt_sem_send (OS_ID semaphore) {
     rt_ret_val(p_TCB, OS_R_SEM);
 #endif
     rt_rmv_dly (p_TCB);
+    TRC_EVENT(TRC_SEM_WAKE, p_TCB->task_id, p_SCB);
     rt_dispatch (p_TCB);
   }
   else {
@@ -137,6 +141,7 @@ OS_RESULT rt_sem_wait (OS_ID semaphore, U16 timeout) {
     os_tsk.run->p_lnk = NULL;
     os_tsk.run->p_rlnk = (P_TCB)p_SCB;
   }
+  TRC_EVENT(TRC_SEM_BLOCK, timeout, p_SCB);
   rt_block(timeout, WAIT_SEM);
   return (OS_R_TMO);
 }
@@ -148,18 +153,21 @@ void isr_sem_send (OS_ID semaphore) {
   /* Same function as "os_sem"send", but to be called by ISRs */
   P_SCB p_SCB = semaphore;
 
-  rt_psq_enq (p_SCB, 0);
-  rt_psh_req ();
+  /* Count the token as pending: the first one queues the semaphore */
+  if (rt_add16 (&p_SCB->psh_tokens, 1) == 0) {
+    rt_psq_enq (p_SCB, 0);
+    rt_psh_req ();
+  }
 }
 
 
 /*--------------------------- rt_sem_psh ------------------------------------*/
 
-void rt_sem_psh (P_SCB p_CB) {
-  /* Check if task has to be waken up */
+void rt_sem_psh (P_SCB p_CB, U32 tokens) {
+  /* Pass "tokens" sent by ISRs: wake up waiting tasks, store the rest */
   P_TCB p_TCB;
 
-  if (p_CB->p_lnk != NULL) {
+  while (tokens != 0 && p_CB->p_lnk != NULL) {
     /* A task is waiting for token */
     p_TCB = rt_get_first ((P_XCB)p_CB);
     rt_rmv_dly (p_TCB);
@@ -170,11 +178,11 @@ void rt_sem_psh (P_SCB p_CB) {
     rt_ret_val(p_TCB, OS_R_SEM);
 #endif
     rt_put_prio (&os_rdy, p_TCB);
+    TRC_EVENT(TRC_SEM_WAKE, p_TCB->task_id, p_CB);
+    tokens--;
   }
-  else {
-    /* Store token */
-    p_CB->tokens++;
-  }
+  /* Store tokens */
+  p_CB->tokens += tokens;
 }
 
 /*----------------------------------------------------------------------------
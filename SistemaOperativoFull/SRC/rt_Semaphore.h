@@ -38,7 +38,7 @@ extern OS_RESULT rt_sem_delete(OS_ID semaphore);
 extern OS_RESULT rt_sem_send  (OS_ID semaphore);
 extern OS_RESULT rt_sem_wait  (OS_ID semaphore, U16 timeout);
 extern void      isr_sem_send (OS_ID semaphore);
-extern void      rt_sem_psh (P_SCB p_CB);
+extern void      rt_sem_psh (P_SCB p_CB, U32 tokens);
 
 /*----------------------------------------------------------------------------
  * end of file
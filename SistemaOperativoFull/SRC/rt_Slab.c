@@ -0,0 +1,243 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_SLAB.C
+ *      Purpose: Size class slab memory for drivers and memory pools
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_HAL_CM.h"
+#include "rt_Slab.h"
+
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Size classes: blocks of SLAB_MIN << class bytes */
+struct OS_SLAB os_slab[SLAB_CLASSES];
+
+/* Pages of os_slab_mem handed out to the classes so far */
+static U16 os_slab_top;
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_slab_class ---------------------------------*/
+
+static U32 rt_slab_class (U32 size) {
+  /* Return the class for blocks of "size" bytes, SLAB_CLASSES if too big.  */
+  if ((size == 0) || (size > SLAB_PAGE)) {
+    return (SLAB_CLASSES);
+  }
+  if (size <= SLAB_MIN) {
+    return (0);
+  }
+  return (rt_msb (size - 1) - 2);
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_slab_init ----------------------------------*/
+
+void rt_slab_init (void) {
+  /* Give all pages back and clear the statistics. */
+  U32 i;
+
+  for (i = 0; i < SLAB_CLASSES; i++) {
+    os_slab[i].free     = NULL;
+    os_slab[i].bump     = NULL;
+    os_slab[i].left     = 0;
+    os_slab[i].pages    = 0;
+    os_slab[i].used     = 0;
+    os_slab[i].max_used = 0;
+    os_slab[i].allocs   = 0;
+    os_slab[i].fails    = 0;
+  }
+  os_slab_top = 0;
+}
+
+
+/*--------------------------- rt_slab_alloc ---------------------------------*/
+
+void *rt_slab_alloc (U32 size) {
+  /* Allocate a block of at least "size" bytes, 8-byte aligned. Freed      */
+  /* blocks of the class are used first, then the rest of its last page,   */
+  /* then a new page.                                                       */
+  P_SLAB slab;
+  void **blk;
+  U32    cls;
+  int    irq_dis;
+
+  cls = rt_slab_class (size);
+  if (cls == SLAB_CLASSES) {
+    return (NULL);
+  }
+  slab = &os_slab[cls];
+
+  irq_dis = __disable_irq ();
+  blk = slab->free;
+  if (blk != NULL) {
+    slab->free = *blk;
+  }
+  else {
+    if ((slab->left == 0) && (os_slab_top < os_slab_pages)) {
+      slab->bump = (U8 *)os_slab_mem + (U32)os_slab_top * SLAB_PAGE;
+      slab->left = SLAB_PAGE / (SLAB_MIN << cls);
+      os_slab_page[os_slab_top++] = cls;
+      slab->pages++;
+    }
+    if (slab->left != 0) {
+      blk = (void **)slab->bump;
+      slab->bump += SLAB_MIN << cls;
+      slab->left--;
+    }
+  }
+  if (blk != NULL) {
+    slab->allocs++;
+    if (++slab->used > slab->max_used) {
+      slab->max_used = slab->used;
+    }
+  }
+  else {
+    slab->fails++;
+  }
+  if (!irq_dis) __enable_irq ();
+  return (blk);
+}
+
+
+/*--------------------------- rt_slab_free ----------------------------------*/
+
+int rt_slab_free (void *block) {
+  /* Free a block, returns 0 if OK, 1 if it is no allocated slab block.    */
+  /* Refused: blocks outside the pages of the slab, misaligned for their   */
+  /* class, never handed out from the page of the class that is being     */
+  /* split, or freed while the class has no block in use. A block freed   */
+  /* twice in a row is the head of the free list; a debug build (DBG_MSG) */
+  /* looks for it in the whole list.                                       */
+  P_SLAB slab;
+  U32    off, cls;
+  int    irq_dis, res;
+#ifdef DBG_MSG
+  void **blk;
+#endif
+
+  if (((U8 *)block < (U8 *)os_slab_mem) ||
+      ((U8 *)block >= (U8 *)os_slab_mem + (U32)os_slab_top * SLAB_PAGE)) {
+    return (1);
+  }
+  off = (U32)((U8 *)block - (U8 *)os_slab_mem);
+  cls = os_slab_page[off / SLAB_PAGE];
+  if (off & ((SLAB_MIN << cls) - 1)) {
+    return (1);
+  }
+  slab = &os_slab[cls];
+
+  irq_dis = __disable_irq ();
+  res = 0;
+  if ((slab->used == 0) || (block == slab->free) ||
+      ((slab->left != 0) && ((U8 *)block >= slab->bump))) {
+    res = 1;
+  }
+#ifdef DBG_MSG
+  for (blk = slab->free; (res == 0) && (blk != NULL); blk = *blk) {
+    if (blk == block) {
+      res = 1;
+    }
+  }
+#endif
+  if (res == 0) {
+    *((void **)block) = slab->free;
+    slab->free = block;
+    slab->used--;
+  }
+  if (!irq_dis) __enable_irq ();
+  return (res);
+}
+
+
+/*--------------------------- rt_slab_pool_alloc ----------------------------*/
+
+void *rt_slab_pool_alloc (P_SP pool) {
+  /* Allocate a block of a memory pool drawn from the slab. */
+  void *blk;
+  int   irq_dis;
+
+  irq_dis = __disable_irq ();
+  if (pool->cnt < pool->max) {
+    blk = rt_slab_alloc (pool->blk_size);
+    if (blk != NULL) {
+      pool->cnt++;
+    }
+  }
+  else {
+    /* Pool limit reached: counts as failure of the class */
+    os_slab[rt_slab_class (pool->blk_size)].fails++;
+    blk = NULL;
+  }
+  if (!irq_dis) __enable_irq ();
+  return (blk);
+}
+
+
+/*--------------------------- rt_slab_pool_free -----------------------------*/
+
+int rt_slab_pool_free (P_SP pool, void *block) {
+  /* Free a block of a memory pool drawn from the slab, returns 0 if OK.   */
+  U32 off;
+  int irq_dis, res;
+
+  /* The block must be of the class of the pool */
+  off = (U32)((U8 *)block - (U8 *)os_slab_mem) / SLAB_PAGE;
+  if (((U8 *)block < (U8 *)os_slab_mem) || (off >= os_slab_top) ||
+      (os_slab_page[off] != rt_slab_class (pool->blk_size))) {
+    return (1);
+  }
+
+  irq_dis = __disable_irq ();
+  res = rt_slab_free (block);
+  if (res == 0) {
+    pool->cnt--;
+  }
+  if (!irq_dis) __enable_irq ();
+  return (res);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
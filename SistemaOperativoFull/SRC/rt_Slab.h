@@ -0,0 +1,65 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_SLAB.H
+ *      Purpose: Size class slab memory definitions
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+/* Definitions */
+#define SLAB_MIN        8               /* Block size of the first class     */
+#define SLAB_CLASSES    6               /* Classes of 8, 16 .. 256 bytes     */
+#define SLAB_PAGE       256             /* Page size, holds one largest block*/
+
+/* Types */
+typedef struct OS_SLAB {                /* << Slab size class >>             */
+  void *free;                           /* Freed blocks list                 */
+  U8   *bump;                           /* Next never used block of the page */
+  U16   left;                           /* Never used blocks in the page     */
+  U16   pages;                          /* Pages taken by the class          */
+  U16   used;                           /* Blocks in use                     */
+  U16   max_used;                       /* High-water mark of 'used'         */
+  U32   allocs;                         /* Successful allocations            */
+  U32   fails;                          /* Failed allocations                */
+} *P_SLAB;
+
+/* Variables */
+extern struct OS_SLAB os_slab[SLAB_CLASSES];
+
+/* Functions */
+extern void  rt_slab_init       (void);
+extern void *rt_slab_alloc      (U32 size);
+extern int   rt_slab_free       (void *block);
+extern void *rt_slab_pool_alloc (P_SP pool);
+extern int   rt_slab_pool_free  (P_SP pool, void *block);
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
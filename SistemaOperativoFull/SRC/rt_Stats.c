@@ -0,0 +1,214 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_STATS.C
+ *      Purpose: Thread runtime statistics
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_Time.h"
+#include "rt_Stats.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      The running time of the tasks is kept in OS_CLOCK cycles, OS_STATS
+ *      selects how it is measured:
+ *        STAT_EXACT    at every task switch the time stamp counter delta
+ *                      since the previous switch goes to the task switched
+ *                      out; the system tick does the same, so the counter
+ *                      can not wrap around unnoticed.
+ *        STAT_SAMPLED  every system tick goes to the interrupted task, the
+ *                      task switch only counts; the latency is sampled
+ *                      for every STAT_SAMPLE-th task put into the ready list.
+ *      The idle time is the wall clock time less the time of all other
+ *      tasks: it includes the time slept by the idle demon, when the cycle
+ *      counter may be stopped. The ready to running latency starts at the
+ *      time stamp set when the task is put into the ready list (STAT_READY).
+ *      Latency bin n < 7 counts latencies below 256 << 2n cycles, bin 7 all
+ *      longer ones; the bins saturate at 65535.
+ *---------------------------------------------------------------------------*/
+
+#define STAT_SAMPLE     16              /* Latency sample rate, power of 2   */
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Time stamp of the last accounting, running time of all tasks but idle */
+static U32 os_stat_stamp;
+static U64 os_stat_busy;
+
+/* Ready counter for the latency sampling */
+static U32 os_stat_cnt;
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_stat_flush ---------------------------------*/
+
+static void rt_stat_flush (void) {
+  /* Account the time since the last accounting to the running task. */
+  U32 now, delta;
+
+  now   = rt_stamp_val ();
+  delta = now - os_stat_stamp;
+  os_stat_stamp = now;
+  if (os_tsk.run != NULL) {
+    os_tsk.run->run_time += delta;
+  }
+  if (os_tsk.run != &os_idle_TCB) {
+    os_stat_busy += delta;
+  }
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_stat_init ----------------------------------*/
+
+void rt_stat_init (void) {
+  /* Start the time stamp counter used for the statistics. */
+  if (os_statmode != STAT_OFF) {
+    rt_stamp_init ();
+    os_stat_stamp = rt_stamp_val ();
+  }
+}
+
+
+/*--------------------------- rt_stat_ready ---------------------------------*/
+
+void rt_stat_ready (P_TCB p_TCB) {
+  /* Task "p_TCB" becomes ready: start its latency measurement. In sampled */
+  /* mode only every STAT_SAMPLE-th one is measured, the others get the    */
+  /* time stamp 0.                                                         */
+  U32 stamp;
+
+  if (os_statmode == STAT_SAMPLED && (++os_stat_cnt & (STAT_SAMPLE - 1))) {
+    p_TCB->rdy_stamp = 0;
+    return;
+  }
+  stamp = rt_stamp_val ();
+  p_TCB->rdy_stamp = (stamp != 0) ? stamp : 1;
+}
+
+
+/*--------------------------- rt_stat_switch --------------------------------*/
+
+void rt_stat_switch (P_TCB p_new) {
+  /* Account a switch from 'os_tsk.run' to task "p_new". */
+  U32 lat, bin;
+
+  p_new->switches++;
+  if (os_statmode == STAT_EXACT) {
+    rt_stat_flush ();
+    lat = os_stat_stamp - p_new->rdy_stamp;
+  }
+  else {
+    if (p_new->rdy_stamp == 0) {
+      return;
+    }
+    lat = rt_stamp_val () - p_new->rdy_stamp;
+    p_new->rdy_stamp = 0;
+  }
+  if (lat > p_new->lat_max) {
+    p_new->lat_max = lat;
+  }
+  for (bin = 0, lat >>= 8; lat != 0 && bin < STAT_BINS - 1; lat >>= 2) {
+    bin++;
+  }
+  if (p_new->lat_hist[bin] != 0xFFFF) {
+    p_new->lat_hist[bin]++;
+  }
+}
+
+
+/*--------------------------- rt_stat_tick ----------------------------------*/
+
+void rt_stat_tick (U32 ticks) {
+  /* Account "ticks" system ticks to the running task. */
+  U64 time;
+
+  if (os_statmode == STAT_EXACT) {
+    rt_stat_flush ();
+    return;
+  }
+  time = (U64)ticks * (os_trv + 1);
+  if (os_tsk.run != NULL) {
+    os_tsk.run->run_time += time;
+  }
+  if (os_tsk.run != &os_idle_TCB) {
+    os_stat_busy += time;
+  }
+}
+
+
+/*--------------------------- rt_stat_run -----------------------------------*/
+
+U64 rt_stat_run (P_TCB p_TCB) {
+  /* Return the running time of task "p_TCB" up to now. */
+  U64 wall;
+
+  if (os_statmode == STAT_EXACT) {
+    rt_stat_flush ();
+  }
+  if (p_TCB != &os_idle_TCB) {
+    return (p_TCB->run_time);
+  }
+  wall = rt_stat_wall ();
+  return ((wall > os_stat_busy) ? wall - os_stat_busy : 0);
+}
+
+
+/*--------------------------- rt_stat_wall ----------------------------------*/
+
+U64 rt_stat_wall (void) {
+  /* Return the wall clock time since the system start. */
+  U32 tick, tick0, time;
+
+  tick = os_tick_val ();
+  time = os_time;
+  if (os_tick_ovf ()) {
+    tick0 = os_tick_val ();
+    if (tick0 < tick) tick = tick0;
+    time++;
+  }
+  return ((U64)time * (os_trv + 1) + tick);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -39,15 +39,16 @@
 #include "rt_Event.h"
 #include "rt_List.h"
 #include "rt_Mailbox.h"
+#include "rt_Queue.h"
+#include "rt_Group.h"
 #include "rt_Semaphore.h"
 #include "rt_Time.h"
 #include "rt_Timer.h"
+#include "rt_Wheel.h"
 #include "rt_Robin.h"
+#include "rt_Trace.h"
+#include "rt_Stats.h"
 #include "rt_HAL_CM.h"
-#include "tcpip.h"
-#include "easyweb.h"
-
-unsigned long TimeTick=0;
 
 /*----------------------------------------------------------------------------
  *      Global Variables
@@ -62,6 +63,14 @@ int os_tick_irqn;
 static volatile BIT os_lock;
 static volatile BIT os_psh_flag;
 static          U8  pend_flags;
+static          U32 os_tick_sleep;
+
+#ifdef __CMSIS_RTOS
+extern U32  sysUserTimerWakeupTime (void);
+extern void sysUserTimerUpdate (U32 sleep_time);
+extern U32  sysWorkWakeupTime (void);
+extern void sysWorkUpdate (U32 sleep_time);
+#endif
 
 /*----------------------------------------------------------------------------
  *      Global Functions
@@ -78,24 +87,32 @@ __RL_RTX_VER    EQU     0x450
 #endif
 
 
+/*--------------------------- rt_next_wakeup --------------------------------*/
+
+static U32 rt_next_wakeup (void) {
+  /* Return the number of ticks until the next kernel deadline: the next    */
+  /* event of the delay wheel, of the user timers or of delayed work items. */
+  U32 delta;
+
+  delta = rt_whl_next (&os_dly);
+#ifdef __CMSIS_RTOS
+  if (sysUserTimerWakeupTime() < delta) delta = sysUserTimerWakeupTime();
+  if (sysWorkWakeupTime() < delta) delta = sysWorkWakeupTime();
+#else
+  if (rt_whl_next (&os_tmr) < delta) delta = rt_whl_next (&os_tmr);
+#endif
+
+  return (delta);
+}
+
+
 /*--------------------------- rt_suspend ------------------------------------*/
 
 U32 rt_suspend (void) {
   /* Suspend OS scheduler */
-  U32 delta = 0xFFFF;
-  
   rt_tsk_lock();
-  
-  if (os_dly.p_dlnk) {
-    delta = os_dly.delta_time;
-  }
-#ifndef __CMSIS_RTOS
-  if (os_tmr.next) {
-    if (os_tmr.tcnt < delta) delta = os_tmr.tcnt;
-  }
-#endif
 
-  return (delta);
+  return (rt_next_wakeup ());
 }
 
 
@@ -104,50 +121,41 @@ U32 rt_suspend (void) {
 void rt_resume (U32 sleep_time) {
   /* Resume OS scheduler after suspend */
   P_TCB next;
-  U32   delta;
+  U32   delta, n;
 
+  if (os_statmode) {
+    rt_stat_tick (sleep_time);
+  }
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
 
   os_robin.task = NULL;
 
-  /* Update delays. */
-  if (os_dly.p_dlnk) {
-    delta = sleep_time;
-    if (delta >= os_dly.delta_time) {
-      delta   -= os_dly.delta_time;
-      os_time += os_dly.delta_time;
-      os_dly.delta_time = 1;
-      while (os_dly.p_dlnk) {
-        rt_dec_dly();
-        if (delta == 0) break;
-        delta--;
-        os_time++;
-      }
-    } else {
-      os_time           += delta;
-      os_dly.delta_time -= delta;
-    }
-  } else {
-    os_time += sleep_time;
+  /* Update delays: skip the idle ticks, step through the due ones. */
+  delta = sleep_time;
+  while (delta) {
+    n = rt_whl_skip (&os_dly, delta);
+    os_time += n;
+    delta   -= n;
+    if (delta == 0) break;
+    os_time++;
+    rt_dec_dly ();
+    delta--;
   }
 
 #ifndef __CMSIS_RTOS
   /* Check the user timers. */
-  if (os_tmr.next) {
-    delta = sleep_time;
-    if (delta >= os_tmr.tcnt) {
-      delta   -= os_tmr.tcnt;
-      os_tmr.tcnt = 1;
-      while (os_tmr.next) {
-        rt_tmr_tick();
-        if (delta == 0) break;
-        delta--;
-      }
-    } else {
-      os_tmr.tcnt -= delta;
-    }
+  delta = sleep_time;
+  while (delta) {
+    n = rt_whl_skip (&os_tmr, delta);
+    delta -= n;
+    if (delta == 0) break;
+    rt_tmr_tick ();
+    delta--;
   }
+#else
+  sysUserTimerUpdate (sleep_time);
+  sysWorkUpdate (sleep_time);
 #endif
 
   /* Switch back to highest ready task */
@@ -158,6 +166,62 @@ void rt_resume (U32 sleep_time) {
 }
 
 
+/*--------------------------- rt_tickless_enter -----------------------------*/
+
+U32 rt_tickless_enter (void) {
+  /* Stretch the current tick period up to the next kernel deadline and     */
+  /* suspend the scheduler. Called by the idle demon before it sleeps. The  */
+  /* tick interrupt stays enabled as wake-up source, all other post service */
+  /* requests are held back until 'rt_tickless_exit' resumes the scheduler. */
+  U32 sleep;
+
+  sleep = os_tick_stretch (rt_next_wakeup ());
+  if (sleep == 0) {
+    return (0);
+  }
+  rt_suspend ();
+  if ((pend_flags != 0) || (os_psh_flag != __FALSE)) {
+    /* A service request is already pending, do not sleep. */
+    rt_resume (os_tick_restore (sleep));
+    return (0);
+  }
+  if (os_tick_irqn < 0) {
+    OS_UNLOCK();
+  } else {
+    OS_X_UNLOCK(os_tick_irqn);
+  }
+  os_tick_sleep = sleep;
+  return (sleep);
+}
+
+
+/*--------------------------- rt_tickless_sleep -----------------------------*/
+
+U32 rt_tickless_sleep (void) {
+  /* Check from the idle demon whether the tickless sleep goes on: neither  */
+  /* the tick ended it nor an interrupt requested a post service since.    */
+  /* Read only, so the idle demon calls it without a supervisor call.      */
+  return ((os_tick_sleep != 0) && (os_psh_flag == __FALSE));
+}
+
+
+/*--------------------------- rt_tickless_exit ------------------------------*/
+
+void rt_tickless_exit (void) {
+  /* Restore the periodic tick after an early wake-up from tickless sleep,  */
+  /* catch up the kernel time and resume the scheduler.                     */
+  U32 sleep;
+
+  if (os_tick_sleep == 0) {
+    /* Tick interrupt has already ended the sleep. */
+    return;
+  }
+  sleep = os_tick_sleep;
+  os_tick_sleep = 0;
+  rt_resume (os_tick_restore (sleep));
+}
+
+
 /*--------------------------- rt_tsk_lock -----------------------------------*/
 
 void rt_tsk_lock (void) {
@@ -211,8 +275,9 @@ void rt_pop_req (void) {
   /* Process an ISR post service requests. */
   struct OS_XCB *p_CB;
   P_TCB next;
-  U32  idx;
+  U32  idx, flags;
 
+  TRC_EVENT(TRC_ISR_ENTER, 0, 14);
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
 
@@ -220,16 +285,27 @@ void rt_pop_req (void) {
   while (os_psq->count) {
     p_CB = os_psq->q[idx].id;
     if (p_CB->cb_type == TCB) {
-      /* Is of TCB type */
-      rt_evt_psh ((P_TCB)p_CB, (U16)os_psq->q[idx].arg);
+      /* Is of TCB type: pass all event flags merged so far */
+      flags = rt_swp16 (&((P_TCB)p_CB)->psh_events, 0);
+      if (flags != 0) {
+        rt_evt_psh ((P_TCB)p_CB, (U16)flags);
+      }
     }
     else if (p_CB->cb_type == MCB) {
       /* Is of MCB type */
       rt_mbx_psh ((P_MCB)p_CB, (void *)os_psq->q[idx].arg);
     }
-    else {
-      /* Must be of SCB type */
-      rt_sem_psh ((P_SCB)p_CB);
+    else if (p_CB->cb_type == SCB) {
+      /* Is of SCB type: pass all tokens counted so far */
+      rt_sem_psh ((P_SCB)p_CB, rt_swp16 (&((P_SCB)p_CB)->psh_tokens, 0));
+    }
+    else if (p_CB->cb_type == QCB) {
+      /* Is of QCB type: pass all payloads stored so far */
+      rt_queue_psh ((P_QCB)p_CB);
+    }
+    else if (p_CB->cb_type == ECB) {
+      /* Is of ECB type: pass all flags merged so far */
+      rt_grp_psh ((P_ECB)p_CB, rt_swp32 (&((P_ECB)p_CB)->psh_flags, 0));
     }
     if (++idx == os_psq->size) idx = 0;
     rt_dec (&os_psq->count);
@@ -269,14 +345,48 @@ __weak void os_tick_irqack (void) {
   /* Acknowledge timer interrupt. */
 }
 
+/*--------------------------- os_tick_stretch -------------------------------*/
+
+__weak U32 os_tick_stretch (U32 ticks) {
+  /* Stretch the SysTick period to end "ticks" ticks later. Return the num- */
+  /* ber of ticks the period covers now, 0 if it was not stretched.         */
+  if (os_tick_irqn >= 0) {
+    /* Alternative timer has to provide its own implementation. */
+    return (0);
+  }
+  return rt_systick_stretch (ticks);
+}
+
+/*--------------------------- os_tick_restore -------------------------------*/
+
+__weak U32 os_tick_restore (U32 ticks) {
+  /* Restart the normal SysTick period at the next tick boundary. Return    */
+  /* the number of ticks elapsed of the "ticks" stretched ones.             */
+  return rt_systick_restore (ticks);
+}
+
 
 /*--------------------------- rt_systick ------------------------------------*/
 
 extern void sysTimerTick(void);
+extern void sysWorkTick(void);
 
 void rt_systick (void) {
   /* Check for system clock update, suspend running task. */
   P_TCB next;
+  U32   sleep;
+
+  TRC_EVENT(TRC_ISR_ENTER, 0, (os_tick_irqn < 0) ? 15 : os_tick_irqn + 16);
+  if (os_tick_sleep != 0) {
+    /* End of a stretched tick period: catch up the time slept. */
+    sleep = os_tick_sleep;
+    os_tick_sleep = 0;
+    rt_resume (sleep);
+    return;
+  }
+  if (os_statmode) {
+    rt_stat_tick (1);
+  }
 
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
@@ -287,18 +397,11 @@ void rt_systick (void) {
   /* Update delays. */
   os_time++;
   rt_dec_dly ();
-	
-	if(activar_systick==1){
-		DoNetworkStuff();
-		TimeTick++;
-  if (TimeTick >= 210) {
-    TimeTick = 0;
-    TCPClockHandler();  
-  }
-}
+
   /* Check the user timers. */
 #ifdef __CMSIS_RTOS
   sysTimerTick();
+  sysWorkTick();
 #else
   rt_tmr_tick ();
 #endif
@@ -38,7 +38,14 @@
 #include "rt_Task.h"
 #include "rt_List.h"
 #include "rt_MemBox.h"
+#include "rt_Wheel.h"
 #include "rt_Robin.h"
+#include "rt_Trace.h"
+#include "rt_Stats.h"
+#include "rt_Slab.h"
+#include "rt_Handle.h"
+#include "rt_Log.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
 /*----------------------------------------------------------------------------
@@ -57,21 +64,37 @@ struct OS_TCB os_idle_TCB;
  *---------------------------------------------------------------------------*/
 
 static OS_TID rt_get_TID (void) {
-  U32 tid;
-
-  for (tid = 1; tid <= os_maxtaskrun; tid++) {
-    if (os_active_TCB[tid-1] == NULL) {
-      return ((OS_TID)tid);
+  /* Take the lowest free task ID. Bit 31 of word n of "os_tid_map" stands  */
+  /* for task ID 32*n+1, so one __clz finds the lowest free ID of a word.   */
+  U32 w, bit;
+
+  for (w = 0; w <= (U32)(os_maxtaskrun - 1) >> 5; w++) {
+    if (os_tid_map[w] != 0) {
+      bit = __clz (os_tid_map[w]);
+      os_tid_map[w] &= ~(0x80000000 >> bit);
+      return ((OS_TID)((w << 5) + bit + 1));
     }
   }
   return (0);
 }
 
 
+/*--------------------------- rt_put_TID ------------------------------------*/
+
+static void rt_put_TID (OS_TID task_id) {
+  /* Return task ID "task_id" to the free map. */
+  U32 n = task_id - 1;
+
+  os_tid_map[n >> 5] |= 0x80000000 >> (n & 31);
+}
+
+
 /*--------------------------- rt_init_context -------------------------------*/
 
 static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
   /* Initialize general part of the Task Control Block. */
+  U32 i;
+
   p_TCB->cb_type = TCB;
   p_TCB->state   = READY;
   p_TCB->prio    = priority;
@@ -79,11 +102,22 @@ static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
   p_TCB->p_rlnk  = NULL;
   p_TCB->p_dlnk  = NULL;
   p_TCB->p_blnk  = NULL;
+  p_TCB->p_rblnk = NULL;
   p_TCB->delta_time    = 0;
   p_TCB->interval_time = 0;
   p_TCB->events  = 0;
   p_TCB->waits   = 0;
+  p_TCB->psh_events  = 0;
   p_TCB->stack_frame = 0;
+  p_TCB->rr_slice    = 0;
+  p_TCB->edf_period  = 0;
+  p_TCB->switches = 0;
+  p_TCB->run_time = 0;
+  p_TCB->lat_max  = 0;
+  for (i = 0; i < STAT_BINS; i++) {
+    p_TCB->lat_hist[i] = 0;
+  }
+  STAT_READY (p_TCB);
 
   if (p_TCB->priv_stack == 0) {
     /* Allocate the memory space for the stack. */
@@ -103,6 +137,18 @@ void rt_switch_req (P_TCB p_new) {
 }
 
 
+/*--------------------------- rt_tsk_switch ---------------------------------*/
+
+void rt_tsk_switch (P_TCB p_new) {
+  /* Called by the HAL when the context is switched to task "p_new", right */
+  /* before 'os_tsk.run' is updated.                                       */
+  TRC_EVENT(TRC_TASK_SWITCH, 0, p_new->task_id);
+  if (os_statmode) {
+    rt_stat_switch (p_new);
+  }
+}
+
+
 /*--------------------------- rt_dispatch -----------------------------------*/
 
 void rt_dispatch (P_TCB next_TCB) {
@@ -115,10 +161,11 @@ void rt_dispatch (P_TCB next_TCB) {
   }
   else {
     /* Check which task continues */
-    if (next_TCB->prio > os_tsk.run->prio) {
+    if (EDF_PREEMPT (next_TCB, os_tsk.run)) {
       /* preempt running task */
       rt_put_rdy_first (os_tsk.run);
       os_tsk.run->state = READY;
+      STAT_READY (next_TCB);
       rt_switch_req (next_TCB);
     }
     else {
@@ -227,6 +274,11 @@ OS_TID rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv) {
   if (task_context == NULL) {
     return (0);
   }
+  i = rt_get_TID ();
+  if (i == 0) {
+    rt_free_box (mp_tcb, task_context);
+    return (0);
+  }
   /* If "size != 0" use a private user provided stack. */
   task_context->stack      = stk;
   task_context->priv_stack = prio_stksz >> 8;
@@ -235,8 +287,6 @@ OS_TID rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv) {
   /* For 'size == 0' system allocates the user stack from the memory pool. */
   rt_init_context (task_context, prio_stksz & 0xFF, task);
 
-  /* Find a free entry in 'os_active_TCB' table. */
-  i = rt_get_TID ();
   os_active_TCB[i-1] = task_context;
   task_context->task_id = i;
   DBG_TASK_NOTIFY(task_context, __TRUE);
@@ -257,6 +307,8 @@ OS_RESULT rt_tsk_delete (OS_TID task_id) {
     os_tsk.run->tsk_stack = rt_get_PSP ();
     rt_stk_check ();
     os_active_TCB[os_tsk.run->task_id-1] = NULL;
+    rt_hnd_release (os_tsk.run->task_id);
+    rt_put_TID (os_tsk.run->task_id);
     rt_free_box (mp_stk, os_tsk.run->stack);
     os_tsk.run->stack = NULL;
     DBG_TASK_NOTIFY(os_tsk.run, __FALSE);
@@ -275,6 +327,8 @@ OS_RESULT rt_tsk_delete (OS_TID task_id) {
     rt_rmv_list (task_context);
     rt_rmv_dly (task_context);
     os_active_TCB[task_id-1] = NULL;
+    rt_hnd_release (task_id);
+    rt_put_TID (task_id);
     rt_free_box (mp_stk, task_context->stack);
     task_context->stack = NULL;
     DBG_TASK_NOTIFY(task_context, __FALSE);
@@ -295,11 +349,20 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
   U32 i;
 
   DBG_INIT();
+  rt_stat_init ();
+  rt_slab_init ();
+  rt_hnd_init ();
+  rt_log_init ();
 
   /* Initialize dynamic memory and task TCB pointers to NULL. */
   for (i = 0; i < os_maxtaskrun; i++) {
     os_active_TCB[i] = NULL;
   }
+  /* All task IDs free. */
+  for (i = 0; i < os_maxtaskrun; i += 32) {
+    os_tid_map[i >> 5] = (os_maxtaskrun - i >= 32) ? 0xFFFFFFFF :
+                         ~(0xFFFFFFFF >> (os_maxtaskrun - i));
+  }
   rt_init_box (&mp_tcb, mp_tcb_size, sizeof(struct OS_TCB));
   rt_init_box (&mp_stk, mp_stk_size, BOX_ALIGN_8 | (U16)(os_stackinfo));
   rt_init_box ((U32 *)m_tmr, mp_tmr_size, sizeof(struct OS_TMR));
@@ -310,13 +373,9 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
   rt_init_context (&os_idle_TCB, 0, os_idle_demon);
 
   /* Set up ready list: initially empty */
-  os_rdy.cb_type = HCB;
-  os_rdy.p_lnk   = NULL;
-  /* Set up delay list: initially empty */
-  os_dly.cb_type = HCB;
-  os_dly.p_dlnk  = NULL;
-  os_dly.p_blnk  = NULL;
-  os_dly.delta_time = 0;
+  rt_init_rdy ();
+  /* Set up delay wheel: initially empty */
+  rt_whl_init (&os_dly);
 
   /* Fix SP and systemvariables to assume idle task is running  */
   /* Transform main program into idle task by assuming idle TCB */
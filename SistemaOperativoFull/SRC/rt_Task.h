@@ -45,6 +45,7 @@
 #define WAIT_SEM        7
 #define WAIT_MBX        8
 #define WAIT_MUT        9
+#define WAIT_GRP        10
 
 /* Return codes */
 #define OS_R_TMO        0x01
@@ -62,6 +63,7 @@ extern struct OS_TCB os_idle_TCB;
 
 /* Functions */
 extern void      rt_switch_req (P_TCB p_new);
+extern void      rt_tsk_switch (P_TCB p_new);
 extern void      rt_dispatch   (P_TCB next_TCB);
 extern void      rt_block      (U16 timeout, U8 block_state);
 extern void      rt_tsk_pass   (void);
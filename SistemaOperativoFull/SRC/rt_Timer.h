@@ -33,7 +33,7 @@
  *---------------------------------------------------------------------------*/
 
 /* Variables */
-extern struct OS_XTMR os_tmr;
+extern struct OS_WHL os_tmr;
 
 /* Functions */
 extern void  rt_tmr_tick   (void);
@@ -0,0 +1,168 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_TRACE.C
+ *      Purpose: Kernel event trace recorder
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_Trace.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      Every event takes 4 words of the ring 'os_trace_buf' (OS_TRACESZ
+ *      entries, a power of 2):
+ *        [0] sequence number + 1, 0 while the entry is being written
+ *        [1] time stamp in OS_CLOCK cycles
+ *        [2] event code (bits 0..7), running task id (8..15), par (16..31)
+ *        [3] arg
+ *      Writers reserve an entry by incrementing 'os_trace_head' atomically,
+ *      so interrupt handlers record their events without locking while a
+ *      preempted context completes its own entry. The oldest entries are
+ *      overwritten when the reader falls behind; the reader detects them by
+ *      the sequence number.
+ *---------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Recording enabled */
+volatile U8 os_trace_on;
+
+/* Next entry to write and next entry to read (free running) */
+static volatile U32 os_trace_head;
+static U32 os_trace_tail;
+
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_trace_idx ----------------------------------*/
+
+static __inline U32 rt_trace_idx (void) {
+  /* Reserve the next entry of the ring, returns its sequence number. */
+  U32 idx;
+#if defined (__USE_EXCLUSIVE_ACCESS)
+  do {
+    idx = __ldrex (&os_trace_head);
+  } while (__strex (idx + 1, &os_trace_head));
+#elif defined (__RTX_POSIX)
+  idx = __sync_fetch_and_add (&os_trace_head, 1);
+#else
+  U32 irq;
+
+  irq = __disable_irq ();
+  idx = os_trace_head++;
+  if (!irq) {
+    __enable_irq ();
+  }
+#endif
+  return (idx);
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_trace --------------------------------------*/
+
+void rt_trace (U32 event, U32 par, U32 arg) {
+  /* Record an event with the current time stamp and running task. */
+  volatile U32 *rec;
+  U32 idx, tid;
+
+  idx = rt_trace_idx ();
+  rec = &os_trace_buf[(idx & (os_trace_size - 1)) * 4];
+  tid = (os_tsk.run != NULL) ? os_tsk.run->task_id : 0;
+  rec[0] = 0;
+  rec[1] = rt_stamp_val ();
+  rec[2] = (par << 16) | (tid << 8) | (U8)event;
+  rec[3] = arg;
+  rec[0] = idx + 1;
+}
+
+
+/*--------------------------- rt_trace_start --------------------------------*/
+
+U32 rt_trace_start (void) {
+  /* Start recording, returns __FALSE when no trace buffer is configured. */
+  if (os_trace_size == 0) {
+    return (__FALSE);
+  }
+  rt_stamp_init ();
+  os_trace_on = 1;
+  return (__TRUE);
+}
+
+
+/*--------------------------- rt_trace_read ---------------------------------*/
+
+U32 rt_trace_read (U32 *buf, U32 count) {
+  /* Copy up to "count" recorded entries, oldest first, to "buf" and return */
+  /* the number copied. Entries overwritten before they could be read are  */
+  /* skipped; an entry still being written ends the copy. Single reader.   */
+  /* A writer reserves its index before it clears the sequence number, so  */
+  /* an entry of the previous lap, older than the tail, is still being     */
+  /* written, not lost.                                                    */
+  volatile U32 *rec;
+  U32 head, seq, n;
+
+  head = os_trace_head;
+  if (head - os_trace_tail > os_trace_size) {
+    os_trace_tail = head - os_trace_size;
+  }
+  for (n = 0; (n < count) && (os_trace_tail != head); ) {
+    rec = &os_trace_buf[(os_trace_tail & (os_trace_size - 1)) * 4];
+    seq = rec[0];
+    if ((seq == 0) || ((S32)(seq - (os_trace_tail + 1)) < 0)) {
+      break;
+    }
+    buf[0] = seq;
+    buf[1] = rec[1];
+    buf[2] = rec[2];
+    buf[3] = rec[3];
+    if ((rec[0] == seq) && (seq == os_trace_tail + 1)) {
+      buf += 4;
+      n++;
+    }
+    os_trace_tail++;
+  }
+  return (n);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
+
@@ -0,0 +1,64 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_TRACE.H
+ *      Purpose: Kernel event trace recorder definitions
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+/* Trace event codes */
+#define TRC_TASK_SWITCH 0x01            /* arg: new task id                  */
+#define TRC_SVC_ENTER   0x02            /* arg: SVC function or SVC number   */
+#define TRC_SVC_EXIT    0x03            /* arg: SVC function or SVC number   */
+#define TRC_ISR_ENTER   0x04            /* arg: exception number             */
+#define TRC_SEM_BLOCK   0x10            /* par: timeout,  arg: semaphore     */
+#define TRC_SEM_WAKE    0x11            /* par: task id,  arg: semaphore     */
+#define TRC_MUT_BLOCK   0x12            /* par: timeout,  arg: mutex         */
+#define TRC_MUT_WAKE    0x13            /* par: task id,  arg: mutex         */
+#define TRC_MBX_BLOCK   0x14            /* par: timeout,  arg: mailbox       */
+#define TRC_MBX_WAKE    0x15            /* par: task id,  arg: mailbox       */
+#define TRC_GRP_BLOCK   0x16            /* par: timeout,  arg: event group   */
+#define TRC_GRP_WAKE    0x17            /* par: task id,  arg: event group   */
+#define TRC_USER        0x80            /* par: user id,  arg: user value    */
+
+/* Variables */
+extern volatile U8 os_trace_on;
+
+/* Functions */
+extern void rt_trace       (U32 event, U32 par, U32 arg);
+extern U32  rt_trace_start (void);
+extern U32  rt_trace_read  (U32 *buf, U32 count);
+
+#define TRC_EVENT(event,par,arg) \
+  do { if (os_trace_on) rt_trace(event,par,(U32)(arg)); } while (0)
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
+
@@ -57,9 +57,9 @@ typedef struct OS_TCB {
   U8     task_id;                 /* Task ID value for optimized TCB access  */
   struct OS_TCB *p_lnk;           /* Link pointer for ready/sem. wait list   */
   struct OS_TCB *p_rlnk;          /* Link pointer for sem./mbx lst backwards */
-  struct OS_TCB *p_dlnk;          /* Link pointer for delay list             */
-  struct OS_TCB *p_blnk;          /* Link pointer for delay list backwards   */
-  U16    delta_time;              /* Time until time out                     */
+  struct OS_TCB *p_dlnk;          /* Link pointer for delay wheel slot       */
+  struct OS_TCB *p_blnk;          /* Delay wheel link backwards (OS_WNODE)   */
+  U16    delta_time;              /* Time of time out                        */
   U16    interval_time;           /* Time interval for periodic waits        */
   U16    events;                  /* Event flags                             */
   U16    waits;                   /* Wait flags                              */
@@ -74,6 +74,36 @@ typedef struct OS_TCB {
 
   /* Task entry point used for uVision debugger                              */
   FUNCP  ptask;                   /* Task entry address                      */
+
+  /* Ready list bookkeeping for constant time insert and remove              */
+  struct OS_TCB *p_rblnk;         /* Link pointer for ready list backwards   */
+  U8     rdy_prio;                /* Priority level queued in ready list     */
+
+  /* Runtime statistics (OS_STATS)                                           */
+  U32    rdy_stamp;               /* Time stamp when the task became ready   */
+  U32    switches;                /* Number of times the task was run        */
+  U64    run_time;                /* Accumulated running time [cycles]       */
+  U32    lat_max;                 /* Longest ready to running latency        */
+  U16    lat_hist[8];             /* Ready to running latency histogram      */
+
+  /* Event flags set by ISRs, not passed to the task yet                     */
+  U16    psh_events;
+
+  /* Round robin time slice [ticks], 0= slice of the priority level         */
+  U16    rr_slice;
+
+  /* Earliest deadline first class (OS_EDFPRIO)                              */
+  U16    edf_period;              /* Period [ticks], 0= fixed priority task  */
+  U16    edf_rel_dl;              /* Deadline relative to the release        */
+  U16    edf_misses;              /* Jobs finished after their deadline      */
+  U32    edf_release;             /* Release time of the current job         */
+  U32    edf_deadline;            /* Absolute deadline of the current job    */
+  U32    edf_jobs;                /* Jobs finished                           */
+  U32    edf_late_max;            /* Longest lateness of a job [ticks]       */
+
+  /* Event group wait (WAIT_GRP)                                             */
+  U32    grp_waits;               /* Flags the task waits for                */
+  U8     grp_opts;                /* Wait options: all flags, clear flags    */
 } *P_TCB;
 #define TCB_STACKF      32        /* 'stack_frame' offset                    */
 #define TCB_TSTACK      36        /* 'tsk_stack' offset                      */
@@ -123,13 +153,35 @@ typedef struct OS_MCB {
   void   *msg[1];                 /* FIFO for Message pointers 1st element   */
 } *P_MCB;
 
+typedef struct OS_QCB {
+  U8     cb_type;                 /* Control Block Type                      */
+  U8     state;                   /* 1: tasks wait to get, 2: to put         */
+  U8     isr_st;                  /* Post service request of ISRs pending    */
+  U8     words;                   /* Payload size in words                   */
+  struct OS_TCB *p_lnk;           /* Chain of waiting tasks                  */
+  U16    first;                   /* Index of the next slot to put           */
+  U16    last;                    /* Index of the next slot to get           */
+  U16    count;                   /* Stored payloads                         */
+  U16    size;                    /* Number of slots                         */
+  U32    data[1];                 /* Ring of payloads, 'words' per slot      */
+} *P_QCB;
+
 typedef struct OS_SCB {
   U8     cb_type;                 /* Control Block Type                      */
   U8     mask;                    /* Semaphore token mask                    */
   U16    tokens;                  /* Semaphore tokens                        */
   struct OS_TCB *p_lnk;           /* Chain of tasks waiting for tokens       */
+  U16    psh_tokens;              /* Tokens sent by ISRs, not passed yet     */
 } *P_SCB;
 
+typedef struct OS_ECB {
+  U8     cb_type;                 /* Control Block Type                      */
+  U8     reserved[3];
+  struct OS_TCB *p_lnk;           /* Chain of tasks waiting for flags        */
+  U32    flags;                   /* Event flags of the group                */
+  U32    psh_flags;               /* Flags set by ISRs, not passed yet       */
+} *P_ECB;
+
 typedef struct OS_MUCB {
   U8     cb_type;                 /* Control Block Type                      */
   U8     prio;                    /* Owner task default priority             */
@@ -138,14 +190,26 @@ typedef struct OS_MUCB {
   struct OS_TCB *owner;           /* Mutex owner task                        */
 } *P_MUCB;
 
-typedef struct OS_XTMR {
-  struct OS_TMR  *next;
-  U16    tcnt;
-} *P_XTMR;
+typedef struct OS_WNODE {         /* Timing Wheel entry                      */
+  struct OS_WNODE  *next;         /* Link pointer to next entry in slot      */
+  struct OS_WNODE **pprev;        /* Link to this entry, NULL if not queued  */
+  U16    time;                    /* Expiry time in wheel ticks              */
+} *P_WNODE;
+
+#define WHL_BITS        4         /* Slot index bits of a wheel level        */
+#define WHL_SLOTS       16        /* Number of slots of a wheel level        */
+#define WHL_LEVELS      4         /* Number of levels: 16 bit time range     */
+
+typedef struct OS_WHL {           /* Hierarchical Timing Wheel               */
+  U16    time;                    /* Current wheel time                      */
+  U16    map[WHL_LEVELS];         /* Bitmap of non-empty slots per level     */
+  P_WNODE slot[WHL_LEVELS][WHL_SLOTS]; /* Slot list heads                    */
+} *P_WHL;
 
 typedef struct OS_TMR {
   struct OS_TMR  *next;           /* Link pointer to Next timer              */
-  U16    tcnt;                    /* Timer delay count                       */
+  struct OS_TMR **pprev;          /* Link to this timer, NULL if not queued  */
+  U16    tcnt;                    /* Timer expiry time                       */
   U16    info;                    /* User defined call info                  */
 } *P_TMR;
 
@@ -155,6 +219,13 @@ typedef struct OS_BM {
   U32  blk_size;                  /* Memory block size                       */
 } *P_BM;
 
+typedef struct OS_SP {            /* Memory pool drawn from the slab         */
+  U32  cnt;                       /* Blocks in use                           */
+  void *end;                      /* NULL: no memory box, see struct OS_BM   */
+  U32  blk_size;                  /* Memory block size                       */
+  U32  max;                       /* Maximum of blocks in use                */
+} *P_SP;
+
 /* Definitions */
 #define __TRUE          1
 #define __FALSE         0
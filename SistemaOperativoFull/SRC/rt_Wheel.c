@@ -0,0 +1,244 @@
+/*----------------------------------------------------------------------------
+ *      RL-ARM - RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_WHEEL.C
+ *      Purpose: Hierarchical timing wheel functions
+ *      Rev.:    V4.70
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2013 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include "rt_TypeDef.h"
+#include "rt_Wheel.h"
+
+/*----------------------------------------------------------------------------
+ *      The wheel has WHL_LEVELS levels of WHL_SLOTS slots. An entry expiring
+ *      less than 16^(n+1) ticks from now is kept on level n, in the slot
+ *      selected by bits [4n+3:4n] of its expiry time. Every 16^n ticks the
+ *      due slot of level n is cascaded down to the lower levels, so that
+ *      all entries expiring in the same tick end up in one level 0 slot
+ *      and are returned to the caller as one batch.
+ *---------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_whl_link -----------------------------------*/
+
+static void rt_whl_link (P_WHL whl, P_WNODE node) {
+  /* Link entry "node" into the wheel slot matching its expiry time.        */
+  U32 delta, lvl, idx;
+  P_WNODE *head;
+
+  delta = (U16)(node->time - whl->time);
+  if (delta < 0x0010) {
+    lvl = 0;
+  }
+  else if (delta < 0x0100) {
+    lvl = 1;
+  }
+  else if (delta < 0x1000) {
+    lvl = 2;
+  }
+  else {
+    lvl = 3;
+  }
+  idx  = (node->time >> (lvl * WHL_BITS)) & (WHL_SLOTS - 1);
+  head = &whl->slot[lvl][idx];
+  node->next  = *head;
+  node->pprev = head;
+  if (*head != NULL) {
+    (*head)->pprev = &node->next;
+  }
+  *head = node;
+  whl->map[lvl] |= 1 << idx;
+}
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_whl_init -----------------------------------*/
+
+void rt_whl_init (P_WHL whl) {
+  /* Initialize an empty timing wheel. */
+  U32 lvl, idx;
+
+  whl->time = 0;
+  for (lvl = 0; lvl < WHL_LEVELS; lvl++) {
+    whl->map[lvl] = 0;
+    for (idx = 0; idx < WHL_SLOTS; idx++) {
+      whl->slot[lvl][idx] = NULL;
+    }
+  }
+}
+
+
+/*--------------------------- rt_whl_put ------------------------------------*/
+
+void rt_whl_put (P_WHL whl, P_WNODE node, U16 delay) {
+  /* Put entry "node" into the wheel to expire "delay" ticks from now.      */
+  if (delay == 0) {
+    delay = 1;
+  }
+  node->time = whl->time + delay;
+  rt_whl_link (whl, node);
+}
+
+
+/*--------------------------- rt_whl_rmv ------------------------------------*/
+
+void rt_whl_rmv (P_WHL whl, P_WNODE node) {
+  /* Remove entry "node" from the wheel if it is queued.                    */
+  uintptr_t off;
+  U32 lvl, idx;
+
+  if (node->pprev == NULL) {
+    return;
+  }
+  *node->pprev = node->next;
+  if (node->next != NULL) {
+    node->next->pprev = node->pprev;
+  }
+  else {
+    /* Entry was last in its slot: update the bitmap if the slot is empty. */
+    /* "pprev" is a slot head only if the entry was also first, otherwise  */
+    /* it points into another entry: compare the addresses as integers.    */
+    off = (uintptr_t)node->pprev - (uintptr_t)&whl->slot[0][0];
+    if (off < sizeof(whl->slot)) {
+      lvl = (U32)(off / sizeof(whl->slot[0]));
+      idx = (U32)(off % sizeof(whl->slot[0])) / sizeof(P_WNODE);
+      if (whl->slot[lvl][idx] == NULL) {
+        whl->map[lvl] &= ~(1 << idx);
+      }
+    }
+  }
+  node->next  = NULL;
+  node->pprev = NULL;
+}
+
+
+/*--------------------------- rt_whl_tick -----------------------------------*/
+
+P_WNODE rt_whl_tick (P_WHL whl) {
+  /* Advance the wheel by one tick. Return the chain of entries expiring    */
+  /* now, linked with "next", or NULL. Returned entries are not queued.     */
+  U32 lvl, idx;
+  P_WNODE p, next;
+
+  whl->time++;
+  for (lvl = 1; lvl < WHL_LEVELS; lvl++) {
+    if (whl->time & ((1 << (lvl * WHL_BITS)) - 1)) {
+      break;
+    }
+    /* Level "lvl" moves on to the next slot: cascade it down. */
+    idx = (whl->time >> (lvl * WHL_BITS)) & (WHL_SLOTS - 1);
+    if (whl->map[lvl] & (1 << idx)) {
+      p = whl->slot[lvl][idx];
+      whl->slot[lvl][idx] = NULL;
+      whl->map[lvl] &= ~(1 << idx);
+      while (p != NULL) {
+        next = p->next;
+        rt_whl_link (whl, p);
+        p = next;
+      }
+    }
+  }
+  idx = whl->time & (WHL_SLOTS - 1);
+  if ((whl->map[0] & (1 << idx)) == 0) {
+    return (NULL);
+  }
+  p = whl->slot[0][idx];
+  whl->slot[0][idx] = NULL;
+  whl->map[0] &= ~(1 << idx);
+  for (next = p; next != NULL; next = next->next) {
+    next->pprev = NULL;
+  }
+  return (p);
+}
+
+
+/*--------------------------- rt_whl_next -----------------------------------*/
+
+U32 rt_whl_next (P_WHL whl) {
+  /* Return the number of ticks until the next wheel event: exact for level */
+  /* 0 entries, the next cascade for higher levels. 0xFFFF if wheel empty.  */
+  U32 lvl, shift, cur, j, ticks, next;
+
+  next = 0xFFFF;
+  for (lvl = 0; lvl < WHL_LEVELS; lvl++) {
+    if (whl->map[lvl] == 0) {
+      continue;
+    }
+    shift = lvl * WHL_BITS;
+    cur   = (whl->time >> shift) & (WHL_SLOTS - 1);
+    for (j = 1; j < WHL_SLOTS; j++) {
+      if (whl->map[lvl] & (1 << ((cur + j) & (WHL_SLOTS - 1)))) {
+        break;
+      }
+    }
+    ticks = (j << shift) - (whl->time & ((1 << shift) - 1));
+    if (ticks > 0xFFFE) {
+      ticks = 0xFFFE;
+    }
+    if (ticks < next) {
+      next = ticks;
+    }
+  }
+  return (next);
+}
+
+
+/*--------------------------- rt_whl_skip -----------------------------------*/
+
+U32 rt_whl_skip (P_WHL whl, U32 ticks) {
+  /* Advance the wheel by up to "ticks" ticks in which no entry expires or  */
+  /* cascades. Return the number of ticks skipped.                          */
+  U32 n;
+
+  n = rt_whl_next (whl);
+  if (n == 0xFFFF) {
+    /* Wheel is empty */
+    n = ticks;
+  }
+  else {
+    n--;
+  }
+  if (n > ticks) {
+    n = ticks;
+  }
+  whl->time += (U16)n;
+  return (n);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
+